@@ -91,6 +91,15 @@ class execute( Gaffer.Application ) :
 						},
 					},
 				),
+
+				IECore.BoolParameter(
+					name = "performanceMonitor",
+					description = "Turns on a performance monitor to provide "
+						"diagnostic information about which nodes are "
+						"taking the most time to compute. A report is "
+						"printed once execution is complete.",
+					defaultValue = False,
+				),
 				
 			]
 			
@@ -143,7 +152,21 @@ class execute( Gaffer.Application ) :
 			context[entry] = eval( args["context"][i+1] )
 		
 		frames = self.parameters()["frames"].getFrameListValue().asList()
-		
+
+		performanceMonitor = None
+		if args["performanceMonitor"].value :
+			performanceMonitor = Gaffer.PerformanceMonitor()
+			performanceMonitor.setActive( True )
+
+		try :
+			return self.__execute( nodes, frames, context, scriptNode )
+		finally :
+			if performanceMonitor is not None :
+				performanceMonitor.setActive( False )
+				IECore.msg( IECore.Msg.Level.Info, "gaffer execute : performance monitor", "\n" + performanceMonitor.report() )
+
+	def __execute( self, nodes, frames, context, scriptNode ) :
+
 		with context :
 			for node in nodes :
 				try :
@@ -66,6 +66,15 @@ class gui( Gaffer.Application ) :
 					description = "Opens the UI in full screen mode.",
 					defaultValue = False,
 				),
+
+				IECore.BoolParameter(
+					name = "performanceMonitor",
+					description = "Turns on a performance monitor to provide "
+						"diagnostic information about which nodes are "
+						"taking the most time to compute. A report is "
+						"printed when the application exits.",
+					defaultValue = False,
+				),
 			]
 			
 		)
@@ -81,6 +90,11 @@ class gui( Gaffer.Application ) :
 	def _run( self, args ) :
 		
 		GafferUI.ScriptWindow.connect( self.root() )
+
+		performanceMonitor = None
+		if args["performanceMonitor"].value :
+			performanceMonitor = Gaffer.PerformanceMonitor()
+			performanceMonitor.setActive( True )
 		
 		if len( args["scripts"] ) :
 			for fileName in args["scripts"] :
@@ -100,6 +114,10 @@ class gui( Gaffer.Application ) :
 			primaryWindow.setFullScreen( True )
 			
 		GafferUI.EventLoop.mainEventLoop().start()		
+
+		if performanceMonitor is not None :
+			performanceMonitor.setActive( False )
+			IECore.msg( IECore.Msg.Level.Info, "gaffer gui : performance monitor", "\n" + performanceMonitor.report() )
 		
 		return 0
 
@@ -0,0 +1,183 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2015, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifndef GAFFER_PERFORMANCEMONITOR_H
+#define GAFFER_PERFORMANCEMONITOR_H
+
+#include "boost/unordered_map.hpp"
+
+#include "tbb/enumerable_thread_specific.h"
+#include "tbb/tick_count.h"
+#include "tbb/atomic.h"
+
+#include "IECore/RefCounted.h"
+
+#include "Gaffer/Plug.h"
+
+namespace Gaffer
+{
+
+IE_CORE_FORWARDDECLARE( PerformanceMonitor )
+
+/// The PerformanceMonitor class records statistics about the computations
+/// performed by ValuePlugs, so that the nodes responsible for the majority
+/// of the processing time in a script can be identified. Statistics are
+/// accumulated per plug, and are only recorded while the monitor is active.
+///
+/// Hash and compute times are exclusive - the time spent evaluating upstream
+/// plugs is attributed to those plugs rather than to the plug which requested
+/// them. Times are measured in seconds of wall clock time, summed across all
+/// threads.
+class PerformanceMonitor : public IECore::RefCounted
+{
+
+	public :
+
+		PerformanceMonitor();
+		virtual ~PerformanceMonitor();
+
+		IE_CORE_DECLAREMEMBERPTR( PerformanceMonitor )
+
+		struct Statistics
+		{
+
+			Statistics();
+
+			/// Number of calls to ComputeNode::hash() or equivalent.
+			size_t hashCount;
+			/// Number of calls to ComputeNode::compute() or equivalent.
+			size_t computeCount;
+			/// Number of value requests satisfied by the cache.
+			size_t cacheHits;
+			/// Number of value requests which missed the cache.
+			size_t cacheMisses;
+			/// Memory added to the value cache, in bytes.
+			size_t cacheMemory;
+			double hashTime;
+			double computeTime;
+
+			Statistics &operator += ( const Statistics &rhs );
+			bool operator == ( const Statistics &rhs ) const;
+			bool operator != ( const Statistics &rhs ) const;
+
+		};
+
+		typedef boost::unordered_map<ConstPlugPtr, Statistics> StatisticsMap;
+
+		/// Activates or deactivates monitoring. Only one monitor
+		/// may be active at a time, so an exception is thrown if
+		/// another monitor is already active. An active monitor
+		/// remains alive until it is deactivated, even if all other
+		/// references to it are released. Monitors should not be
+		/// deactivated while computations are being started.
+		void setActive( bool active );
+		bool getActive() const;
+		/// Returns the currently active monitor, or NULL.
+		static PerformanceMonitor *active();
+
+		/// Returns the statistics for all plugs. It is not valid to
+		/// call this while computations are in progress.
+		StatisticsMap allStatistics() const;
+		/// Returns the statistics for the specified plug.
+		Statistics plugStatistics( const Plug *plug ) const;
+		/// Returns the statistics for all plugs, summed together.
+		Statistics combinedStatistics() const;
+		/// Discards all statistics recorded so far.
+		void clear();
+
+		/// Returns a human readable report listing the plugs with the
+		/// highest hash time, compute time, hash count and compute count.
+		std::string report( size_t maxLinesPerMetric = 50 ) const;
+
+		/// @name Instrumentation
+		/// These methods are called by ValuePlug to record statistics,
+		/// and shouldn't be called from elsewhere. Calls to started() and
+		/// finished() must be paired, and made on the same thread.
+		////////////////////////////////////////////////////////////////////
+		//@{
+		enum Phase
+		{
+			Hash,
+			Compute
+		};
+		void started( const Plug *plug, Phase phase );
+		void finished();
+		void cacheLookup( const Plug *plug, bool hit );
+		void cacheInsertion( const Plug *plug, size_t bytes );
+		//@}
+
+	private :
+
+		struct Frame
+		{
+			Statistics *statistics;
+			Phase phase;
+			tbb::tick_count start;
+			// Time spent in nested frames, to be
+			// subtracted from our own duration.
+			double nestedTime;
+		};
+
+		// Keyed by raw pointer so that looking up statistics doesn't
+		// incur reference counting. The reference held alongside is
+		// taken only when a plug is first recorded, and keeps the plug
+		// alive so that its address can't be reused by another plug.
+		struct PlugStatistics
+		{
+			ConstPlugPtr plug;
+			Statistics statistics;
+		};
+		typedef boost::unordered_map<const Plug *, PlugStatistics> PlugStatisticsMap;
+
+		struct ThreadData
+		{
+			PlugStatisticsMap statistics;
+			std::vector<Frame> stack;
+		};
+
+		Statistics &statistics( ThreadData &threadData, const Plug *plug );
+
+		typedef tbb::enumerable_thread_specific<ThreadData> ThreadDataContainer;
+		mutable ThreadDataContainer m_threadData;
+
+		static tbb::atomic<PerformanceMonitor *> g_active;
+
+};
+
+} // namespace Gaffer
+
+#endif // GAFFER_PERFORMANCEMONITOR_H
@@ -105,10 +105,29 @@ class Plug : public GraphComponent
 			/// not valid to make an output plug read only - in the case of an attempt to
 			/// do so an exception will be thrown from setFlags().
 			ReadOnly = 0x00000020,
+			/// If the SharedCompute flag is set then when several threads request
+			/// the same uncached value concurrently, only the first performs the
+			/// computation, and the others wait to share its result. This is
+			/// beneficial for expensive computations which are likely to be requested
+			/// by many threads at once. It has no effect unless Cacheable is also set.
+			/// Waiting threads block without doing other TBB work, so this flag must
+			/// not be used for plugs whose compute spawns TBB tasks : a waiter could
+			/// be holding a task that the computation depends on, causing deadlock.
+			SharedCompute = 0x00000040,
+			/// If the DiskCacheable flag is set then computed values are also
+			/// stored in the disk cache, if one has been enabled using
+			/// ValuePlug::setDiskCacheDirectory(). This is only worthwhile for
+			/// values which are expensive to compute relative to their size.
+			/// It has no effect unless Cacheable is also set. No plugs have
+			/// this flag by default - it is for users to opt into on a per-plug
+			/// basis. Values must be determined entirely by their hash, so it
+			/// must not be used for plugs whose nodes read files, because the
+			/// hashes identify files by name rather than by content.
+			DiskCacheable = 0x00000080,
 			/// When adding values, don't forget to update the Default and All values below,
 			/// and to update PlugBinding.cpp too!
 			Default = Serialisable | AcceptsInputs | PerformsSubstitutions | Cacheable,
-			All = Dynamic | Serialisable | AcceptsInputs | PerformsSubstitutions | Cacheable | ReadOnly
+			All = Dynamic | Serialisable | AcceptsInputs | PerformsSubstitutions | Cacheable | ReadOnly | SharedCompute | DiskCacheable
 		};
 
 		Plug( const std::string &name=defaultName<Plug>(), Direction direction=In, unsigned flags=Default );
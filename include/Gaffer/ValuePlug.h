@@ -102,7 +102,10 @@ class ValuePlug : public Plug
 		/// @name Cache management
 		/// ValuePlug optimises repeated computation by storing a cache of
 		/// recently computed values. These functions allow for management
-		/// of the cache.
+		/// of the cache. When the cache is full, values which were quick to
+		/// compute relative to their size are evicted in preference to those
+		/// which were slow. Memory usage is approximate - for some types of
+		/// value it is estimated from previous values computed by the same plug.
 		////////////////////////////////////////////////////////////////////
 		//@{
 		/// Returns the maximum amount of memory in bytes to use for the cache.
@@ -111,6 +114,58 @@ class ValuePlug : public Plug
 		static void setCacheMemoryLimit( size_t bytes );
 		/// Returns the current memory usage of the cache in bytes.
 		static size_t cacheMemoryUsage();
+
+		/// Returns the maximum amount of memory in bytes to use for values
+		/// computed by plugs of the specified type. Unless set explicitly,
+		/// this is the same as the overall limit.
+		static size_t getCacheMemoryLimit( IECore::TypeId plugType );
+		/// Sets a limit for the memory used by values computed by plugs of
+		/// the specified type, in addition to the overall limit. This can be
+		/// used to prevent a few large values of one type from evicting many
+		/// small values of another. Limits may be set for a small number of
+		/// types only - an exception is thrown if this number is exceeded.
+		static void setCacheMemoryLimit( IECore::TypeId plugType, size_t bytes );
+		/// Returns the memory used by values computed by plugs of the specified
+		/// type. This is only tracked for types with an explicit limit - for all
+		/// others the overall usage is returned.
+		static size_t cacheMemoryUsage( IECore::TypeId plugType );
+
+		/// Counters describing the effectiveness of the cache.
+		struct CacheStatistics
+		{
+			CacheStatistics();
+			/// Number of lookups satisfied by the shared cache.
+			size_t hits;
+			/// Number of lookups satisfied by the per-thread
+			/// cache, without accessing the shared cache at all.
+			size_t threadHits;
+			/// Number of lookups which required a computation.
+			size_t misses;
+			/// Number of times a thread had to wait for another
+			/// thread to finish accessing the cache.
+			size_t contentions;
+			/// Number of values removed to stay within the
+			/// memory limit.
+			size_t evictions;
+		};
+
+		/// Returns the statistics accumulated since the last call
+		/// to resetCacheStatistics().
+		static CacheStatistics cacheStatistics();
+		static void resetCacheStatistics();
+
+		/// Values computed by plugs with the DiskCacheable flag may
+		/// additionally be stored in a directory on disk, so that they
+		/// can be reused by later processes. The disk cache is disabled
+		/// when the directory is empty, which is the default unless the
+		/// GAFFER_DISK_CACHE_DIRECTORY environment variable is set.
+		static std::string getDiskCacheDirectory();
+		static void setDiskCacheDirectory( const std::string &directory );
+		/// Returns the maximum size of the disk cache in bytes. When
+		/// the limit is exceeded, the least recently used files are
+		/// removed.
+		static size_t getDiskCacheSizeLimit();
+		static void setDiskCacheSizeLimit( size_t bytes );
 		//@}
 
 	protected :
@@ -69,13 +69,16 @@ class ColorProcessor : public ImageProcessor
 		virtual void hashFormat( const GafferImage::ImagePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
 		virtual GafferImage::Format computeFormat( const Gaffer::Context *context, const ImagePlug *parent ) const;
 		
-		virtual void hash( const Gaffer::ValuePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
 		virtual void hashChannelData( const GafferImage::ImagePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
-		
-		/// Implemented to process the color data and stash the results on colorDataPlug()
-		/// format, dataWindow, metadata, and channelNames are passed through via direct connection to the input values.
-		virtual void compute( Gaffer::ValuePlug *output, const Gaffer::Context *context ) const;
-		/// Implemented to use the results of colorDataPlug() via processColorData()
+		virtual void hashMultiChannelData( const GafferImage::ImagePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
+
+		/// Implemented to process R, G and B together when all three are requested via
+		/// multiChannelDataPlug(). format, dataWindow, metadata, and channelNames are passed
+		/// through via direct connection to the input values. Where the input is provided
+		/// directly by other ColorProcessors, their processColorData() methods are applied
+		/// in the same pass, so that intermediate results are neither copied nor cached.
+		virtual IECore::ConstObjectVectorPtr computeMultiChannelData( const std::vector<std::string> &channelNames, const Imath::V2i &tileOrigin, const Gaffer::Context *context, const ImagePlug *parent ) const;
+		/// Implemented to extract the channel from the result of computeMultiChannelData().
 		virtual IECore::ConstFloatVectorDataPtr computeChannelData( const std::string &channelName, const Imath::V2i &tileOrigin, const Gaffer::Context *context, const ImagePlug *parent ) const;
 
 		/// May be implemented by derived classes to return true if the specified input is used in processColorData().
@@ -84,15 +87,14 @@ class ColorProcessor : public ImageProcessor
 		/// May be implemented by derived classes to compute the hash for the color processing - all implementations
 		/// must call their base class implementation first.
 		virtual void hashColorData( const Gaffer::Context *context, IECore::MurmurHash &h ) const;
-		/// Must be implemented by derived classes to modify R, G and B in place.
+		/// Must be implemented by derived classes to modify R, G and B in place. Note that this
+		/// may be called as part of the computation for a downstream ColorProcessor, so
+		/// implementations must not assume that the data came from inPlug(), and must not
+		/// access it directly.
 		virtual void processColorData( const Gaffer::Context *context, IECore::FloatVectorData *r, IECore::FloatVectorData *g, IECore::FloatVectorData *b ) const = 0;
 
 	private :
 
-		// Used to store the result of processColorData(), so that it can be reused in computeChannelData().
-		Gaffer::ObjectPlug *colorDataPlug();
-		const Gaffer::ObjectPlug *colorDataPlug() const;
-
 		static size_t g_firstPlugIndex;
 
 };
@@ -111,6 +111,26 @@ public :
 		float t = ( center - samplePosition - .5 ) / m_scale;
 		return (*m_lut)( fabs( t ) );
 	}
+	/// Fills weights with the weights of the width() consecutive samples
+	/// starting at firstSample, and returns their sum. This gives the same
+	/// results as calling weight( center, firstSample + i ) for each sample,
+	/// but hoists the per-sample setup out of the loop so that filtering code
+	/// can compute a whole row of weights at once and reuse it for every
+	/// row of the kernel.
+	inline float weights( float center, int firstSample, float *weights ) const
+	{
+		const int w = width();
+		const float offset = center - firstSample - .5f;
+		const float inverseScale = 1.f / m_scale;
+		const IECore::Lookupff &lut = *m_lut;
+		float sum = 0.f;
+		for( int i = 0; i < w; ++i )
+		{
+			weights[i] = lut( fabs( ( offset - i ) * inverseScale ) );
+			sum += weights[i];
+		}
+		return sum;
+	}
 	/// Returns the position of the first sample influenced by the kernel.
 	/// Use this function to get the index of the first pixel to convolve
 	/// the filter with.
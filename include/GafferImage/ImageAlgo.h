@@ -0,0 +1,73 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2015, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef GAFFERIMAGE_IMAGEALGO_H
+#define GAFFERIMAGE_IMAGEALGO_H
+
+#include <vector>
+#include <string>
+
+#include "OpenEXR/ImathBox.h"
+
+#include "GafferImage/ImagePlug.h"
+
+namespace GafferImage
+{
+
+/// Calls a functor on all tiles of the image, in parallel. The functor must
+/// take ( const ImagePlug *imagePlug, const Imath::V2i &tileOrigin ), and is
+/// called with a current context in which "image:tileOrigin" is set
+/// appropriately. Tiles are visited within the data window, or within the
+/// specified window if it is not empty.
+template <class ThreadableFunctor>
+void parallelProcessTiles( const ImagePlug *imagePlug, ThreadableFunctor &functor, const Imath::Box2i &window = Imath::Box2i() );
+
+/// As above, but calling the functor for every tile of every channel. The
+/// functor must take ( const ImagePlug *imagePlug, const std::string &channelName, const Imath::V2i &tileOrigin ),
+/// and "image:channelName" is also set in the current context.
+template <class ThreadableFunctor>
+void parallelProcessTiles( const ImagePlug *imagePlug, const std::vector<std::string> &channelNames, ThreadableFunctor &functor, const Imath::Box2i &window = Imath::Box2i() );
+
+/// Returns the number of tiles in the window, and the origin
+/// of the first, as used by parallelProcessTiles(). Tiles may be
+/// numbered for storing per-tile results by iterating in x, then y.
+size_t numTiles( const Imath::Box2i &window, Imath::V2i &firstTileOrigin, Imath::V2i &numTilesXY );
+
+} // namespace GafferImage
+
+#include "GafferImage/ImageAlgo.inl"
+
+#endif // GAFFERIMAGE_IMAGEALGO_H
@@ -0,0 +1,182 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2015, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef GAFFERIMAGE_IMAGEALGO_INL
+#define GAFFERIMAGE_IMAGEALGO_INL
+
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
+#include "Gaffer/Context.h"
+
+namespace GafferImage
+{
+
+namespace Detail
+{
+
+// We flatten the channels and tiles into a single range, so that
+// the work is distributed evenly between threads regardless of
+// the shape of the image or the number of channels.
+class TileRange
+{
+
+	public :
+
+		TileRange( const Imath::V2i &firstTileOrigin, const Imath::V2i &numTiles )
+			:	m_firstTileOrigin( firstTileOrigin ), m_numTiles( numTiles )
+		{
+		}
+
+		size_t tilesPerChannel() const
+		{
+			return m_numTiles.x * m_numTiles.y;
+		}
+
+		Imath::V2i tileOrigin( size_t index ) const
+		{
+			const size_t tileIndex = index % tilesPerChannel();
+			return Imath::V2i(
+				m_firstTileOrigin.x + ( tileIndex % m_numTiles.x ) * ImagePlug::tileSize(),
+				m_firstTileOrigin.y + ( tileIndex / m_numTiles.x ) * ImagePlug::tileSize()
+			);
+		}
+
+	private :
+
+		const Imath::V2i m_firstTileOrigin;
+		const Imath::V2i m_numTiles;
+
+};
+
+template <class ThreadableFunctor>
+class ProcessTiles
+{
+
+	public :
+
+		ProcessTiles( const ImagePlug *imagePlug, ThreadableFunctor &functor, const TileRange &tileRange, const Gaffer::Context *context )
+			:	m_imagePlug( imagePlug ), m_functor( functor ), m_tileRange( tileRange ), m_parentContext( context )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			Gaffer::ContextPtr context = new Gaffer::Context( *m_parentContext, Gaffer::Context::Borrowed );
+			Gaffer::Context::Scope scopedContext( context.get() );
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				const Imath::V2i tileOrigin = m_tileRange.tileOrigin( i );
+				context->set( ImagePlug::tileOriginContextName, tileOrigin );
+				m_functor( m_imagePlug, tileOrigin );
+			}
+		}
+
+	private :
+
+		const ImagePlug *m_imagePlug;
+		ThreadableFunctor &m_functor;
+		const TileRange &m_tileRange;
+		const Gaffer::Context *m_parentContext;
+
+};
+
+template <class ThreadableFunctor>
+class ProcessChannelTiles
+{
+
+	public :
+
+		ProcessChannelTiles( const ImagePlug *imagePlug, const std::vector<std::string> &channelNames, ThreadableFunctor &functor, const TileRange &tileRange, const Gaffer::Context *context )
+			:	m_imagePlug( imagePlug ), m_channelNames( channelNames ), m_functor( functor ), m_tileRange( tileRange ), m_parentContext( context )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			Gaffer::ContextPtr context = new Gaffer::Context( *m_parentContext, Gaffer::Context::Borrowed );
+			Gaffer::Context::Scope scopedContext( context.get() );
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				const std::string &channelName = m_channelNames[i / m_tileRange.tilesPerChannel()];
+				const Imath::V2i tileOrigin = m_tileRange.tileOrigin( i );
+				context->set( ImagePlug::channelNameContextName, channelName );
+				context->set( ImagePlug::tileOriginContextName, tileOrigin );
+				m_functor( m_imagePlug, channelName, tileOrigin );
+			}
+		}
+
+	private :
+
+		const ImagePlug *m_imagePlug;
+		const std::vector<std::string> &m_channelNames;
+		ThreadableFunctor &m_functor;
+		const TileRange &m_tileRange;
+		const Gaffer::Context *m_parentContext;
+
+};
+
+} // namespace Detail
+
+template <class ThreadableFunctor>
+void parallelProcessTiles( const ImagePlug *imagePlug, ThreadableFunctor &functor, const Imath::Box2i &window )
+{
+	const Imath::Box2i processWindow = window.isEmpty() ? imagePlug->dataWindowPlug()->getValue() : window;
+
+	Imath::V2i firstTileOrigin, numTilesXY;
+	const size_t n = numTiles( processWindow, firstTileOrigin, numTilesXY );
+
+	const Detail::TileRange tileRange( firstTileOrigin, numTilesXY );
+	Detail::ProcessTiles<ThreadableFunctor> processTiles( imagePlug, functor, tileRange, Gaffer::Context::current() );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, n ), processTiles );
+}
+
+template <class ThreadableFunctor>
+void parallelProcessTiles( const ImagePlug *imagePlug, const std::vector<std::string> &channelNames, ThreadableFunctor &functor, const Imath::Box2i &window )
+{
+	const Imath::Box2i processWindow = window.isEmpty() ? imagePlug->dataWindowPlug()->getValue() : window;
+
+	Imath::V2i firstTileOrigin, numTilesXY;
+	const size_t n = numTiles( processWindow, firstTileOrigin, numTilesXY );
+
+	const Detail::TileRange tileRange( firstTileOrigin, numTilesXY );
+	Detail::ProcessChannelTiles<ThreadableFunctor> processTiles( imagePlug, channelNames, functor, tileRange, Gaffer::Context::current() );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, n * channelNames.size() ), processTiles );
+}
+
+} // namespace GafferImage
+
+#endif // GAFFERIMAGE_IMAGEALGO_INL
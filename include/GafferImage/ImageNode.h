@@ -114,6 +114,10 @@ class ImageNode : public Gaffer::ComputeNode
 		virtual void hashMetadata( const GafferImage::ImagePlug *parent, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
 		virtual void hashChannelNames( const GafferImage::ImagePlug *parent, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
 		virtual void hashChannelData( const GafferImage::ImagePlug *parent, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
+		/// The default implementation combines the hashes of channelDataPlug() for each of
+		/// the channels named by the image:channelNames context variable. Derived classes
+		/// which reimplement computeMultiChannelData() must reimplement this to match.
+		virtual void hashMultiChannelData( const GafferImage::ImagePlug *parent, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
 
 		/// Implemented to call the compute*() methods below whenever output is part of an ImagePlug.
 		/// Derived classes should reimplement the specific compute*() methods rather than compute() itself.
@@ -125,6 +129,13 @@ class ImageNode : public Gaffer::ComputeNode
 		virtual IECore::ConstCompoundObjectPtr computeMetadata( const Gaffer::Context *context, const ImagePlug *parent ) const;
 		virtual IECore::ConstStringVectorDataPtr computeChannelNames( const Gaffer::Context *context, const ImagePlug *parent ) const;
 		virtual IECore::ConstFloatVectorDataPtr computeChannelData( const std::string &channelName, const Imath::V2i &tileOrigin, const Gaffer::Context *context, const ImagePlug *parent ) const;
+		/// The default implementation gathers the result from channelDataPlug(), one
+		/// channel at a time. Derived classes which can compute several channels more
+		/// efficiently together may reimplement it, in which case they are responsible
+		/// for respecting channelEnabled() for each channel, and should turn on the
+		/// Cacheable flag for multiChannelDataPlug(). It is not called if enabled()
+		/// is false.
+		virtual IECore::ConstObjectVectorPtr computeMultiChannelData( const std::vector<std::string> &channelNames, const Imath::V2i &tileOrigin, const Gaffer::Context *context, const ImagePlug *parent ) const;
 
 		/// Implemented to initialize the default format settings if they don't exist already.
 		void parentChanging( Gaffer::GraphComponent *newParent );
@@ -39,6 +39,7 @@
 #define GAFFER_IMAGEPLUG_H
 
 #include "IECore/ImagePrimitive.h"
+#include "IECore/ObjectVector.h"
 
 #include "Gaffer/CompoundPlug.h"
 #include "Gaffer/TypedObjectPlug.h"
@@ -106,6 +107,13 @@ class ImagePlug : public Gaffer::CompoundPlug
 		const Gaffer::StringVectorDataPlug *channelNamesPlug() const;
 		Gaffer::FloatVectorDataPlug *channelDataPlug();
 		const Gaffer::FloatVectorDataPlug *channelDataPlug() const;
+		/// Provides the data for several channels of a tile at once,
+		/// as an ObjectVector containing one FloatVectorData per channel
+		/// named by the image:channelNames context variable. This allows
+		/// consumers to fetch whole tiles with a single compute, and
+		/// allows nodes to compute several channels together.
+		Gaffer::ObjectVectorPlug *multiChannelDataPlug();
+		const Gaffer::ObjectVectorPlug *multiChannelDataPlug() const;
 		//@}
 
 		/// The names used to specify the channel name and tile of
@@ -114,7 +122,17 @@ class ImagePlug : public Gaffer::CompoundPlug
 		/// both less error prone and quicker than constructing
 		/// InternedStrings on every lookup.
 		static const IECore::InternedString channelNameContextName;
+		static const IECore::InternedString channelNamesContextName;
 		static const IECore::InternedString tileOriginContextName;
+		/// The name of an optional int context variable specifying a
+		/// proxy level at which the image is required, with each level
+		/// halving the resolution. Sources such as the ImageReader may use
+		/// it to compute pixels more cheaply from lower resolution data,
+		/// but must not change the format or data window in response, so
+		/// that nodes which ignore the proxy level remain consistent with
+		/// those that don't. When it is not present, full resolution is
+		/// assumed.
+		static const IECore::InternedString proxyLevelContextName;
 
 		/// @name Convenience accessors
 		/// These functions create temporary Contexts specifying image:channelName
@@ -126,6 +144,10 @@ class ImagePlug : public Gaffer::CompoundPlug
 		//@{
 		IECore::ConstFloatVectorDataPtr channelData( const std::string &channelName, const Imath::V2i &tileOrigin ) const;
 		IECore::MurmurHash channelDataHash( const std::string &channelName, const Imath::V2i &tileOrigin ) const;
+		/// Returns the data for several channels of a tile, in the same order
+		/// as channelNames.
+		IECore::ConstObjectVectorPtr multiChannelData( const std::vector<std::string> &channelNames, const Imath::V2i &tileOrigin ) const;
+		IECore::MurmurHash multiChannelDataHash( const std::vector<std::string> &channelNames, const Imath::V2i &tileOrigin ) const;
 		/// Returns a pointer to an IECore::ImagePrimitive. Note that the image's
 		/// coordinate system will be converted to the OpenEXR and Cortex specification
 		/// and have it's origin in the top left of it's display window with the positive
@@ -136,10 +158,23 @@ class ImagePlug : public Gaffer::CompoundPlug
 		IECore::MurmurHash imageHash() const;
 		//@}
 
-		static int tileSize() { return 64; };
+		/// Returns the size of the tiles used to represent images. This
+		/// defaults to 64, unless the GAFFER_IMAGE_TILE_SIZE environment
+		/// variable specifies otherwise.
+		static int tileSize() { return g_tileSize; };
+		/// Sets the tile size for the whole process. Larger tiles reduce
+		/// the per-tile overhead of simple operations on large images, at
+		/// the expense of computing more pixels outside the area of
+		/// interest. The size must be a power of two between 16 and 1024.
+		/// Hashes account for the tile size, so previously cached tiles
+		/// are not reused, but this must not be called while images are
+		/// being computed or received by a Display node.
+		static void setTileSize( int tileSize );
 		static Imath::Box2i tileBound( const Imath::V2i &tileOrigin ) { return Imath::Box2i( tileOrigin * tileSize(), ( tileOrigin + Imath::V2i( 1 ) ) * tileSize() - Imath::V2i( 1 ) ); }
-		static const IECore::FloatVectorData *blackTile();
-		static const IECore::FloatVectorData *whiteTile();
+		/// Return tiles filled with 0 and 1 respectively, sized for the
+		/// current tile size. These are shared, so must not be modified.
+		static IECore::ConstFloatVectorDataPtr blackTile();
+		static IECore::ConstFloatVectorDataPtr whiteTile();
 
 		/// Returns the origin of the tile that contains the point.
 		inline static Imath::V2i tileOrigin( const Imath::V2i &point )
@@ -155,6 +190,7 @@ class ImagePlug : public Gaffer::CompoundPlug
 		static void compoundObjectToCompoundData( const IECore::CompoundObject *object, IECore::CompoundData *data );
 		
 		static size_t g_firstPlugIndex;
+		static int g_tileSize;
 };
 
 IE_CORE_DECLAREPTR( ImagePlug );
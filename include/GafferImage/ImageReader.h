@@ -73,6 +73,19 @@ class ImageReader : public ImageNode
 		/// Number of times the node has been refreshed.
 		Gaffer::IntPlug *refreshCountPlug();
 		const Gaffer::IntPlug *refreshCountPlug() const;
+
+		/// The subimage to be read from multi-part files.
+		Gaffer::IntPlug *subimagePlug();
+		const Gaffer::IntPlug *subimagePlug() const;
+
+		/// The mip level to be read, with 0 being full resolution.
+		/// The level is clamped to those actually available in the file.
+		/// The value of the ImagePlug::proxyLevelContextName context
+		/// variable is added to this when reading pixels, but the pixels
+		/// are upsampled back to the resolution of this level, so that the
+		/// format and data window are unaffected by proxying.
+		Gaffer::IntPlug *mipLevelPlug();
+		const Gaffer::IntPlug *mipLevelPlug() const;
 		
 		virtual void affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs ) const;
 		virtual bool enabled() const;
@@ -86,15 +99,19 @@ class ImageReader : public ImageNode
 		virtual void hashMetadata( const GafferImage::ImagePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
 		virtual void hashChannelNames( const GafferImage::ImagePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
 		virtual void hashChannelData( const GafferImage::ImagePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
+		virtual void hashMultiChannelData( const GafferImage::ImagePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
 
 		virtual GafferImage::Format computeFormat( const Gaffer::Context *context, const ImagePlug *parent ) const;
 		virtual Imath::Box2i computeDataWindow( const Gaffer::Context *context, const ImagePlug *parent ) const;
 		virtual IECore::ConstCompoundObjectPtr computeMetadata( const Gaffer::Context *context, const ImagePlug *parent ) const;
 		virtual IECore::ConstStringVectorDataPtr computeChannelNames( const Gaffer::Context *context, const ImagePlug *parent ) const;
 		virtual IECore::ConstFloatVectorDataPtr computeChannelData( const std::string &channelName, const Imath::V2i &tileOrigin, const Gaffer::Context *context, const ImagePlug *parent ) const;
+		/// Reads all the requested channels with a single call to OIIO.
+		virtual IECore::ConstObjectVectorPtr computeMultiChannelData( const std::vector<std::string> &channelNames, const Imath::V2i &tileOrigin, const Gaffer::Context *context, const ImagePlug *parent ) const;
 
 	private :
 
+		void hashFileAndLevel( IECore::MurmurHash &h ) const;
 		void plugSet( Gaffer::Plug *plug );
 		
 		static size_t g_firstPlugIndex;
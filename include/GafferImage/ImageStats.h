@@ -40,6 +40,7 @@
 #include "Gaffer/ComputeNode.h"
 #include "Gaffer/CompoundNumericPlug.h"
 #include "Gaffer/BoxPlug.h"
+#include "Gaffer/TypedObjectPlug.h"
 
 #include "GafferImage/ImagePlug.h"
 #include "GafferImage/ChannelMaskPlug.h"
@@ -48,7 +49,9 @@ namespace GafferImage
 {
 
 /// Provides statistics on an image's colour profile.
-/// The ImageStats node outputs the minimum, maximum and average values of the pixel values within a region of interest in the image.
+/// The ImageStats node outputs the minimum, maximum and average values of the pixel values within a region of interest in the image,
+/// along with a histogram and an arbitrary percentile. Statistics are computed per tile, in parallel, and the partial results
+/// are cached so that edits to a few tiles of a large image only need to reanalyse those tiles.
 class ImageStats : public Gaffer::ComputeNode
 {
 
@@ -73,6 +76,22 @@ class ImageStats : public Gaffer::ComputeNode
 		const Gaffer::Color4fPlug *minPlug() const;
 		Gaffer::Color4fPlug *maxPlug();
 		const Gaffer::Color4fPlug *maxPlug() const;
+		Gaffer::V2fPlug *histogramRangePlug();
+		const Gaffer::V2fPlug *histogramRangePlug() const;
+		Gaffer::IntPlug *histogramBinsPlug();
+		const Gaffer::IntPlug *histogramBinsPlug() const;
+		Gaffer::FloatPlug *percentilePlug();
+		const Gaffer::FloatPlug *percentilePlug() const;
+		/// Outputs a UInt64VectorData of bin counts for each of the analysed channels,
+		/// keyed by channel name. Values outside the histogram range are counted in
+		/// the first or last bin.
+		Gaffer::CompoundObjectPlug *histogramPlug();
+		const Gaffer::CompoundObjectPlug *histogramPlug() const;
+		/// The per-channel values below which percentilePlug() percent of the pixels
+		/// fall. This is interpolated from the histogram, so is only accurate to the
+		/// width of a single bin.
+		Gaffer::Color4fPlug *percentileValuePlug();
+		const Gaffer::Color4fPlug *percentileValuePlug() const;
 
 	protected :
 
@@ -84,6 +103,24 @@ class ImageStats : public Gaffer::ComputeNode
 
 	private :
 
+		/// Statistics for a single tile of a single channel, restricted to the
+		/// region of interest. Computed in a context containing "image:channelName"
+		/// and "image:tileOrigin".
+		Gaffer::CompoundObjectPlug *tileStatsPlug();
+		const Gaffer::CompoundObjectPlug *tileStatsPlug() const;
+		/// Statistics for the whole region of interest for a single channel, reduced
+		/// from the tile statistics. Computed in a context containing "image:channelName".
+		Gaffer::CompoundObjectPlug *channelStatsPlug();
+		const Gaffer::CompoundObjectPlug *channelStatsPlug() const;
+
+		void hashTileStats( const Gaffer::Context *context, IECore::MurmurHash &h ) const;
+		IECore::ConstCompoundObjectPtr computeTileStats( const Gaffer::Context *context ) const;
+		void hashChannelStats( const Gaffer::Context *context, IECore::MurmurHash &h ) const;
+		IECore::ConstCompoundObjectPtr computeChannelStats( const Gaffer::Context *context ) const;
+
+		/// Returns the input channels which pass through the channels mask.
+		std::vector<std::string> maskedChannels() const;
+
 		void inputChanged( Gaffer::Plug *plug );
 
 		/// Sets channelName to the channel which corresponds to the output plug. The channel name is
@@ -92,6 +129,10 @@ class ImageStats : public Gaffer::ComputeNode
 		/// For more information on this, please see ChannelMaskPlug::removeDuplicateIndices().
 		void channelNameFromOutput( const Gaffer::ValuePlug *output, std::string &channelName ) const;
 
+		/// Returns the statistics for a channel, computed in a context derived from the current one.
+		IECore::ConstCompoundObjectPtr channelStats( const std::string &channelName ) const;
+		IECore::MurmurHash channelStatsHash( const std::string &channelName ) const;
+
 		/// A convenience function to just set the plug to 0 or 1 depending on what it's index is.
 		void setOutputToDefault( Gaffer::FloatPlug *output ) const;
 
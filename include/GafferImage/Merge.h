@@ -128,9 +128,15 @@ class Merge : public ImageProcessor
 		// A convenience method to return an index for a channel that can be used to address Color4f plugs.
 		inline int channelIndex( const std::string &channelName ) const { return channelName == "R" ? 0 : channelName == "G" ? 1 : channelName == "B" ? 2 : 3; };
 
-		/// Performs the merge operation using the functor 'F'.
+		/// Performs the merge operation using the functor 'F', in a single pass over
+		/// the tile. Null entries in inData and inAlpha represent inputs which are empty
+		/// over the tile. F must provide a static skipEmptyB member which is true if
+		/// merging a black B input leaves A unchanged.
 		template< typename F >
-		IECore::ConstFloatVectorDataPtr doMergeOperation( F f, std::vector< IECore::ConstFloatVectorDataPtr > &inData, std::vector< IECore::ConstFloatVectorDataPtr > &inAlpha, const Imath::V2i &tileOrigin ) const;
+		IECore::ConstFloatVectorDataPtr doMergeOperation( F f, const std::vector< IECore::ConstFloatVectorDataPtr > &inData, const std::vector< IECore::ConstFloatVectorDataPtr > &inAlpha, const Imath::V2i &tileOrigin ) const;
+
+		/// Returns true if the input has no data within the tile.
+		bool inputIsEmpty( const ImagePlug *input, const Imath::V2i &tileOrigin ) const;
 
 		/// A useful method which returns true if the StringVector contains the channel "A".
 		inline bool hasAlpha( IECore::ConstStringVectorDataPtr channelNamesData ) const;
@@ -35,42 +35,62 @@
 //////////////////////////////////////////////////////////////////////////
 
 template< typename F >
-IECore::ConstFloatVectorDataPtr Merge::doMergeOperation( F f, std::vector< IECore::ConstFloatVectorDataPtr > &inData, std::vector< IECore::ConstFloatVectorDataPtr > &inAlpha, const Imath::V2i &tileOrigin ) const
+IECore::ConstFloatVectorDataPtr Merge::doMergeOperation( F f, const std::vector< IECore::ConstFloatVectorDataPtr > &inData, const std::vector< IECore::ConstFloatVectorDataPtr > &inAlpha, const Imath::V2i &tileOrigin ) const
 {
-	// Allocate the new tile
-	Imath::Box2i tile( tileOrigin, Imath::V2i( tileOrigin.x + ImagePlug::tileSize() - 1, tileOrigin.y + ImagePlug::tileSize() - 1 ) );
-	IECore::FloatVectorDataPtr outDataPtr = inData.back()->copy();
-	std::vector<float> &outData = outDataPtr->writable();
+	// Gather the tiles to be merged, from the top (last) input to the bottom (first) one.
+	// Inputs which are empty over this tile have null data, and are treated as black. When
+	// merging black as the B input doesn't change the result we can skip them entirely.
+	IECore::ConstFloatVectorDataPtr blackTile = ImagePlug::blackTile();
+	const float *black = &blackTile->readable().front();
+	std::vector<const float *> data;
+	std::vector<const float *> alpha;
+	for( int i = inData.size() - 1; i >= 0; --i )
+	{
+		if( inData[i] )
+		{
+			data.push_back( &inData[i]->readable().front() );
+			alpha.push_back( &inAlpha[i]->readable().front() );
+		}
+		else if( data.empty() || !F::skipEmptyB )
+		{
+			data.push_back( black );
+			alpha.push_back( black );
+		}
+	}
 
-	// Allocate a temporary tile that will hold the intermediate values of the alpha channel.
-	IECore::FloatVectorDataPtr aOut = inAlpha.back()->copy();
-	std::vector<float> &outAlpha = aOut->writable();
+	// Merge a scanline at a time, applying all the inputs to the scanline before
+	// moving on to the next, so that the intermediate results stay in cache and
+	// the output is only written once. The inner loops are simple enough for the
+	// compiler to vectorise.
+	const int tileSize = ImagePlug::tileSize();
+	IECore::FloatVectorDataPtr outDataPtr = new IECore::FloatVectorData;
+	std::vector<float> &outData = outDataPtr->writable();
+	outData.resize( tileSize * tileSize );
+	std::vector<float> alphaRow( tileSize );
 
-	// Perform the operation.
-	unsigned int nIterations( inData.size() -1 );
-	for( unsigned int i = nIterations; i > 0; --i )
+	const size_t nInputs = data.size();
+	for( int y = 0; y < tileSize; ++y )
 	{
-		for( int y = tile.min.y; y<=tile.max.y; y++ )
-		{
-			// Compute the data values and afterwards, the intermediate alpha values.
-			const float *dIn1 = &(outData[0]) + ( y - tileOrigin.y ) * ImagePlug::tileSize() + (tile.min.x - tileOrigin.x);
-			const float *dIn2 = &(inData[i-1]->readable()[0]) + (y - tileOrigin.y) * ImagePlug::tileSize() + (tile.min.x - tileOrigin.x);
-			const float *aIn1 = &(outAlpha[0]) + ( y - tileOrigin.y ) * ImagePlug::tileSize() + (tile.min.x - tileOrigin.x);
-			const float *aIn2 = &(inAlpha[i-1]->readable()[0]) + (y - tileOrigin.y) * ImagePlug::tileSize() + (tile.min.x - tileOrigin.x);
+		const int offset = y * tileSize;
+		float *dOut = &outData[offset];
+		float *aOut = &alphaRow.front();
 
-			float *dOut = &(outData[0]) + ( y - tileOrigin.y ) * ImagePlug::tileSize() + (tile.min.x - tileOrigin.x);
-			float *aOut = &(outAlpha[0]) + ( y - tileOrigin.y ) * ImagePlug::tileSize() + (tile.min.x - tileOrigin.x);
+		std::copy( data[0] + offset, data[0] + offset + tileSize, dOut );
+		std::copy( alpha[0] + offset, alpha[0] + offset + tileSize, aOut );
 
-			const float *END = dOut+(tile.max.x-tile.min.x)+1;
-			while( dOut != END )
+		for( size_t i = 1; i < nInputs; ++i )
+		{
+			const float *dIn = data[i] + offset;
+			const float *aIn = alpha[i] + offset;
+			for( int x = 0; x < tileSize; ++x )
 			{
-				*dOut++ = f( *dIn1++, *dIn2++, *aIn1, *aIn2 );
-				*aOut++ = f( *aIn1, *aIn2, *aIn1, *aIn2 );
-				++aIn1;
-				++aIn2;
+				const float a = aOut[x];
+				const float b = aIn[x];
+				dOut[x] = f( dOut[x], dIn[x], a, b );
+				aOut[x] = f( a, b, a, b );
 			}
 		}
 	}
+
 	return outDataPtr;
 }
-
@@ -38,6 +38,8 @@
 #ifndef GAFFERIMAGE_OPENCOLORIO_H
 #define GAFFERIMAGE_OPENCOLORIO_H
 
+#include "Gaffer/TypedPlug.h"
+
 #include "GafferImage/ColorProcessor.h"
 
 namespace Gaffer
@@ -66,6 +68,12 @@ class OpenColorIO : public ColorProcessor
 		Gaffer::StringPlug *outputSpacePlug();
 		const Gaffer::StringPlug *outputSpacePlug() const;
 
+		/// When on, the transform is applied via a 3D LUT baked from
+		/// the OpenColorIO processor. This is faster but less accurate,
+		/// so is intended for display purposes.
+		Gaffer::BoolPlug *bakedLUTPlug();
+		const Gaffer::BoolPlug *bakedLUTPlug() const;
+
 	protected :
 
 		/// Overrides the default implementation to disable the node when the input color space is
@@ -40,6 +40,8 @@
 #include "GafferImage/ImageProcessor.h"
 #include "GafferImage/FilterPlug.h"
 
+#include "Gaffer/TypedObjectPlug.h"
+
 namespace GafferImage
 {
 
@@ -68,6 +70,9 @@ class Reformat : public ImageProcessor
 
 	protected :
 
+		virtual void hash( const Gaffer::ValuePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
+		virtual void compute( Gaffer::ValuePlug *output, const Gaffer::Context *context ) const;
+
 		virtual void hashFormat( const GafferImage::ImagePlug *parent, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
 		virtual void hashDataWindow( const GafferImage::ImagePlug *parent, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
 		virtual void hashChannelData( const GafferImage::ImagePlug *parent, const Gaffer::Context *context, IECore::MurmurHash &h ) const;
@@ -78,7 +83,8 @@ class Reformat : public ImageProcessor
 		/// We reformat the image by doing two passes over the input in first the horizontal and then vertical directions.
 		/// On each pass we use the chosen filter to create a (row or column) buffer of pixels their weighted contributeion to each pixel on the row or column.
 		/// Using this column/row buffer we iterate over the input and sum the contributing pixels. The result is normalized by the sum of weights.
-		/// This process is repeated once for the vertical and horizontal passes and the final result is written into the output buffer.
+		/// The horizontal pass is computed by horizontalPassPlug(), so that it is cached and shared between all the output
+		/// tiles which need it, and the vertical pass is then computed here.
 		virtual IECore::ConstFloatVectorDataPtr computeChannelData( const std::string &channelName, const Imath::V2i &tileOrigin, const Gaffer::Context *context, const ImagePlug *parent ) const;
 
 		// Computes the output scale factor from the input and output formats.
@@ -86,6 +92,20 @@ class Reformat : public ImageProcessor
 
 	private :
 
+		/// Tiles of the image resampled horizontally but not vertically, with the
+		/// x coordinates of the output and the y coordinates of the input. Computed
+		/// in a context containing "image:channelName" and "image:tileOrigin".
+		Gaffer::FloatVectorDataPlug *horizontalPassPlug();
+		const Gaffer::FloatVectorDataPlug *horizontalPassPlug() const;
+
+		void hashHorizontalPass( const Gaffer::Context *context, IECore::MurmurHash &h ) const;
+		IECore::ConstFloatVectorDataPtr computeHorizontalPass( const Gaffer::Context *context ) const;
+		/// Returns the horizontal pass tile at the specified origin, for the current channel.
+		IECore::ConstFloatVectorDataPtr horizontalPass( const Imath::V2i &tileOrigin ) const;
+
+		/// Returns the input region point sampled by the box filter for an output tile.
+		Imath::Box2i boxFilterSampleBox( const Imath::V2i &tileOrigin ) const;
+
 		static size_t g_firstPlugIndex;
 
 };
@@ -87,6 +87,12 @@ class Sampler
 
 	private:
 
+		/// Returns the sum of the samples in row y, starting at x, weighted by
+		/// the first width elements of weights. Contiguous runs of samples are read
+		/// directly from the tile data, so that only one cache lookup is needed per
+		/// tile rather than one per sample.
+		inline float sampleRow( int x, int y, const float *weights, int width );
+
 		/// Cached data access
 		/// @param p Any point within the cache that we wish to retrieve the data for.
 		/// @param tileData Is set to the tile's channel data.
@@ -105,6 +111,7 @@ class Sampler
 
 		BoundingMode m_boundingMode;
 		ConstFilterPtr m_filter;
+		bool m_isBoxFilter;
 
 };
 
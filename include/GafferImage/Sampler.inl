@@ -45,50 +45,131 @@ Imath::Box2i Sampler::getSampleWindow() const
 	return m_userSampleWindow;
 }
 
+namespace Detail
+{
+
+/// Returns the dot product of a and b. The size is a template
+/// parameter so that the loop can be fully unrolled and vectorised
+/// by the compiler for the kernel widths in common use.
+template<int N>
+inline float dot( const float *a, const float *b )
+{
+	float result = 0.f;
+	for( int i = 0; i < N; ++i )
+	{
+		result += a[i] * b[i];
+	}
+	return result;
+}
+
+inline float dot( const float *a, const float *b, int n )
+{
+	switch( n )
+	{
+		case 1 : return a[0] * b[0];
+		case 2 : return dot<2>( a, b );
+		case 3 : return dot<3>( a, b );
+		case 4 : return dot<4>( a, b );
+		case 5 : return dot<5>( a, b );
+		case 6 : return dot<6>( a, b );
+		case 7 : return dot<7>( a, b );
+		case 8 : return dot<8>( a, b );
+		default :
+		{
+			float result = 0.f;
+			for( int i = 0; i < n; ++i )
+			{
+				result += a[i] * b[i];
+			}
+			return result;
+		}
+	}
+}
+
+} // namespace Detail
+
 float Sampler::sample( float x, float y )
 {
 	// Perform an early-out for the box filter.
-	if ( static_cast<GafferImage::TypeId>( m_filter->typeId() ) == GafferImage::BoxFilterTypeId )
+	if ( m_isBoxFilter )
 	{
 		return sample( IECore::fastFloatFloor( x ), IECore::fastFloatFloor( y ) );
 	}
 
-	// Otherwise do a filtered lookup.
-	int tapX = m_filter->tap( x - m_cacheWindow.min.x );
+	// Otherwise do a filtered lookup. The filter is separable, so we compute
+	// a single row and column of weights, filter each row of the kernel with
+	// the row weights and then filter the results with the column weights.
 	const int width = m_filter->width();
+
+	const int tapX = m_filter->tap( x - m_cacheWindow.min.x ) + m_cacheWindow.min.x;
 	float weightsX[width];
+	const float weightSumX = m_filter->weights( x, tapX, weightsX );
+
+	const int tapY = m_filter->tap( y - m_cacheWindow.min.y ) + m_cacheWindow.min.y;
+	float weightsY[width];
+	const float weightSumY = m_filter->weights( y, tapY, weightsY );
 
+	float colour = 0.f;
 	for ( int i = 0; i < width; ++i )
 	{
-		weightsX[i] = m_filter->weight( x, tapX+i+m_cacheWindow.min.x );
+		if( weightsY[i] != 0.f )
+		{
+			colour += weightsY[i] * sampleRow( tapX, tapY + i, weightsX, width );
+		}
 	}
 
-	int tapY = m_filter->tap( y - m_cacheWindow.min.y );
-	const int height = m_filter->width();
-	float weightsY[height];
+	const float weightedSum = weightSumX * weightSumY;
+	return weightedSum == 0 ? 0 : colour / weightedSum;
+}
 
-	for ( int i = 0; i < height; ++i )
+float Sampler::sampleRow( int x, int y, const float *weights, int width )
+{
+	if ( m_boundingMode == Black )
 	{
-		weightsY[i] = m_filter->weight( y, tapY+i+m_cacheWindow.min.y );
+		if ( y < m_sampleWindow.min.y || y > m_sampleWindow.max.y )
+		{
+			return 0.;
+		}
+	}
+	else if ( m_boundingMode == Clamp )
+	{
+		y = std::max( std::min( y, m_sampleWindow.max.y ), m_sampleWindow.min.y );
 	}
 
-	float weightedSum = 0.;
-	float colour = 0.f;
-	int absY = tapY + m_cacheWindow.min.y;
-	for ( int y = 0; y < height; ++y, ++absY )
+	// Find the range of taps which lie within the sample window.
+	int i = std::max( 0, m_sampleWindow.min.x - x );
+	const int end = std::min( width, m_sampleWindow.max.x - x + 1 );
+
+	float result = 0.f;
+	if ( m_boundingMode == Clamp )
 	{
-		int absX = tapX + m_cacheWindow.min.x;
-		for ( int x = 0; x < width; ++x, ++absX )
+		// Taps outside the window take the value of the nearest edge.
+		for( int j = 0; j < std::min( i, width ); ++j )
+		{
+			result += weights[j] * sample( m_sampleWindow.min.x, y );
+		}
+		for( int j = std::max( end, 0 ); j < width; ++j )
 		{
-			float c = 0.;
-			float w = weightsX[x] * weightsY[y];
-			c = sample( absX, absY );
-			weightedSum += w;
-			colour += c * w;
+			result += weights[j] * sample( m_sampleWindow.max.x, y );
 		}
 	}
 
-	return weightedSum == 0 ? 0 : colour / weightedSum;
+	// Read the taps within the window directly from the tile data,
+	// one contiguous run per tile.
+	const int tileSize = ImagePlug::tileSize();
+	while( i < end )
+	{
+		const float *tileData;
+		Imath::V2i tileOrigin;
+		Imath::V2i tileIndex;
+		cachedData( Imath::V2i( x + i, y ), tileData, tileOrigin, tileIndex );
+
+		const int runLength = std::min( end - i, tileSize - tileIndex.x );
+		result += Detail::dot( tileData + tileIndex.y * tileSize + tileIndex.x, weights + i, runLength );
+		i += runLength;
+	}
+
+	return result;
 }
 
 float Sampler::sample( int x, int y )
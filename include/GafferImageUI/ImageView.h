@@ -67,15 +67,21 @@ IE_CORE_FORWARDDECLARE( ImageSampler )
 namespace GafferImageUI
 {
 
+namespace Detail
+{
+
+IE_CORE_FORWARDDECLARE( ImageTiles )
+
+} // namespace Detail
+
+/// The image is drawn as a collection of tiles, each corresponding to a single tile from
+/// the ImagePlug. Only the visible tiles whose hashes have changed are recomputed, in the
+/// background, so that nodes like the Display node which are continuously updating isolated
+/// regions of the image can be displayed efficiently.
 /// \todo Refactor this into smaller components, along the lines of the SceneView class.
 /// Consider redesigning the View/Tool classes so that view functionality can be built up
 /// by adding tools like samplers etc. A good starting point for this refactoring would be
-/// to create an ImageGadget analogous to the SceneGadget. This could offer much improved
-/// performance over the existing implementation by drawing the image with many small tiles
-/// each corresponding to a single tile from the ImagePlug. This would mean that nodes like
-/// the Display node which are continuously updating isolated regions of the image could
-/// be displayed much more efficiently - just updating the few tiles which had changed rather
-/// than the whole image.
+/// to move the tile drawing into an ImageGadget analogous to the SceneGadget.
 class ImageView : public GafferUI::View
 {
 
@@ -117,6 +123,8 @@ class ImageView : public GafferUI::View
 		void insertConverter( Gaffer::NodePtr converter );
 
 		virtual void update();
+		/// Reimplemented to stop the background computation of tiles.
+		virtual void plugDirtied( const Gaffer::Plug *plug );
 
 	private:
 
@@ -138,6 +146,13 @@ class ImageView : public GafferUI::View
 		void plugSet( Gaffer::Plug *plug );
 		void insertDisplayTransform();
 
+		/// Returns the proxy level appropriate for the current zoom, where
+		/// each level halves the resolution at which sources such as the
+		/// ImageReader read pixels. The level is passed to the input via
+		/// ImagePlug::proxyLevelContextName.
+		int idealProxyLevel() const;
+		void viewportChanged();
+
 		typedef std::map<std::string, GafferImage::ImageProcessorPtr> DisplayTransformMap;
 		DisplayTransformMap m_displayTransforms;
 
@@ -147,6 +162,10 @@ class ImageView : public GafferUI::View
 		Imath::Color4f m_minColor;
 		Imath::Color4f m_maxColor;
 		Imath::Color4f m_averageColor;
+		int m_proxyLevel;
+		static const int g_maxProxyLevel;
+
+		Detail::ImageTilesPtr m_imageTiles;
 
 		typedef std::map<std::string, DisplayTransformCreator> DisplayTransformCreatorMap;
 		static DisplayTransformCreatorMap &displayTransformCreators();
@@ -80,8 +80,8 @@ class ExecutableRender : public Gaffer::ExecutableNode
 		/// May be implemented by derived classes to change the way the procedural that
 		/// generates the world is output. We need this method because Cortex has no mechanism for getting
 		/// a delayed load procedural into a rib or ass file, and derived classes may want to be
-		/// generating just such a file. The default implementation just outputs a SceneProcedural
-		/// which is suitable for immediate mode rendering.
+		/// generating just such a file. The default implementation uses outputWorld() to output
+		/// the scene directly, which is suitable for immediate mode rendering.
 		virtual void outputWorldProcedural( const ScenePlug *scene, IECore::Renderer *renderer ) const;
 		/// May be implemented to return a shell command which should be run after doing the "render".
 		/// This can be useful for nodes which wish to render in two stages by creating a scene file
@@ -37,13 +37,12 @@
 #ifndef GAFFERSCENE_INTERACTIVERENDER_H
 #define GAFFERSCENE_INTERACTIVERENDER_H
 
-#include "tbb/pipeline.h"
-
 #include "IECore/Renderer.h"
 
 #include "Gaffer/Node.h"
 
 #include "GafferScene/ScenePlug.h"
+#include "GafferScene/SceneMirror.h"
 
 namespace Gaffer
 {
@@ -97,6 +96,12 @@ class InteractiveRender : public Gaffer::Node
 		Gaffer::BoolPlug *updateCoordinateSystemsPlug();
 		const Gaffer::BoolPlug *updateCoordinateSystemsPlug() const;
 
+		Gaffer::BoolPlug *updateTransformsPlug();
+		const Gaffer::BoolPlug *updateTransformsPlug() const;
+
+		Gaffer::BoolPlug *updateObjectsPlug();
+		const Gaffer::BoolPlug *updateObjectsPlug() const;
+
 		/// The Context in which the InteractiveRender should operate.
 		Gaffer::Context *getContext();
 		const Gaffer::Context *getContext() const;
@@ -114,11 +119,12 @@ class InteractiveRender : public Gaffer::Node
 
 		void update();
 		
-		static void runPipeline(tbb::pipeline *p);
 		void outputScene( bool update );
+		void outputLocation( const SceneMirror::Location *location );
+		void outputEdits( const SceneMirror::Location *location, const Imath::M44f &parentTransform, bool parentTransformChanged, size_t attributesGeneration, size_t transformsGeneration, size_t objectsGeneration );
 		
 		void updateLights();
-		void updateAttributes();
+		void updateScene();
 		void updateCameras();
 		void updateCoordinateSystems();
 
@@ -128,24 +134,23 @@ class InteractiveRender : public Gaffer::Node
 
 		typedef std::set<std::string> LightHandles;
 
-		// hierarchical structure for tracking scene information:
-		class SceneGraph;
-		boost::shared_ptr<SceneGraph> m_sceneGraph;
+		// hierarchical structure for tracking scene information, and the
+		// generations at which we last output each component from it, and
+		// at which we last output it in full:
+		SceneMirrorPtr m_sceneMirror;
+		size_t m_attributesGeneration;
+		size_t m_transformsGeneration;
+		size_t m_objectsGeneration;
+		size_t m_outputGeneration;
 
-		// tbb classes for performing multithreaded traversals of the scene graph, etc.
-		class SceneGraphBuildTask;
-		class ChildNamesUpdateTask;
-
-		class SceneGraphIteratorFilter;
-		class SceneGraphEvaluatorFilter;
-		class SceneGraphOutputFilter;
-		
 		IECore::RendererPtr m_renderer;
 		ConstScenePlugPtr m_scene;
 		State m_state;
 		LightHandles m_lightHandles;
 		bool m_lightsDirty;
 		bool m_attributesDirty;
+		bool m_transformsDirty;
+		bool m_objectsDirty;
 		bool m_camerasDirty;
 		bool m_coordinateSystemsDirty;
 
@@ -38,9 +38,8 @@
 #ifndef GAFFER_PATHMATCHER_H
 #define GAFFER_PATHMATCHER_H
 
-#include "boost/shared_ptr.hpp"
-
 #include "IECore/TypedData.h"
+#include "IECore/RefCounted.h"
 
 #include "GafferScene/Filter.h"
 
@@ -50,13 +49,19 @@ namespace GafferScene
 /// The PathMatcher class provides an acceleration structure for matching
 /// paths against a sequence of reference paths. It provides the internal
 /// implementation for the PathFilter.
+///
+/// The tree of paths is reference counted and shared between copies,
+/// so copying a PathMatcher is cheap. When a PathMatcher is modified,
+/// only the parts of the tree along the modified paths are duplicated,
+/// and all other parts remain shared with the copies.
 class PathMatcher
 {
 
 	public :
 
 		PathMatcher();
-		/// Constructs a deep copy of other.
+		/// Constructs a copy of other, sharing the tree
+		/// of paths until either of them is modified.
 		PathMatcher( const PathMatcher &other );
 
 		template<typename PathIterator>
@@ -154,7 +159,14 @@ class PathMatcher
 
 		};
 
-		struct Node
+		struct Node;
+		IE_CORE_DECLAREPTR( Node )
+
+		// Node in the tree of paths. Nodes may be shared between
+		// several PathMatchers (and several parent nodes), so must
+		// only be modified when they are known to be unique - see
+		// writableRoot() and writableChild().
+		struct Node : public IECore::RefCounted
 		{
 
 			// Container used to store all the children of the node.
@@ -164,14 +176,15 @@ class PathMatcher
 			// achieved by using an ordered container, and having the
 			// less than operation for Names sort first on hasWildcards
 			// and second on the name.
-			typedef std::map<Name, Node *> ChildMap;
+			typedef std::map<Name, NodePtr> ChildMap;
 			typedef ChildMap::iterator ChildMapIterator;
 			typedef ChildMap::value_type ChildMapValue;
 			typedef ChildMap::const_iterator ConstChildMapIterator;
 
 			Node();
+			// Shallow copy - the children are shared with other.
 			Node( const Node &other );
-			~Node();
+			virtual ~Node();
 
 			// Returns an iterator to the first child whose name contains wildcards.
 			// All children between here and children.end() will also contain wildcards.
@@ -185,24 +198,40 @@ class PathMatcher
 			bool operator != ( const Node &other );
 
 			bool clearChildren();
-			bool isEmpty();
+			bool isEmpty() const;
 
 			bool terminator;
 			ChildMap children;
 
 		};
 
+		// Returns the root node, first duplicating it if
+		// it is shared with another PathMatcher.
+		Node *writableRoot();
+		// Returns the child at it, first duplicating it if it
+		// is shared. The parent node must itself be writable.
+		static Node *writableChild( Node::ChildMapIterator it );
+
+		template<typename NameIterator>
+		const Node *find( const NameIterator &start, const NameIterator &end ) const;
 		template<typename NameIterator>
 		bool addPath( const NameIterator &start, const NameIterator &end );
 		template<typename NameIterator>
 		void removeWalk( Node *node, const NameIterator &start, const NameIterator &end, const bool prune, bool &removed );
-		bool addPathsWalk( Node *node, const Node *srcNode );
-		bool removePathsWalk( Node *node, const Node *srcNode );
+		// Merge srcNode into node, returning NULL if nothing changed, and
+		// otherwise the modified node. If unique is true then node is known
+		// not to be shared, and will be modified in place, otherwise it is
+		// duplicated first.
+		static NodePtr addPathsWalk( Node *node, const Node *srcNode, bool unique );
+		static NodePtr removePathsWalk( Node *node, const Node *srcNode, bool unique );
+		// Utility for the above, returning result, having first initialised
+		// it with node or a copy of node, as appropriate.
+		static Node *writable( Node *node, bool unique, NodePtr &result );
 
 		template<typename NameIterator>
 		void matchWalk( const Node *node, const NameIterator &start, const NameIterator &end, unsigned &result ) const;
 
-		boost::shared_ptr<Node> m_root;
+		NodePtr m_root;
 
 };
 
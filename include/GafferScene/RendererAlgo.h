@@ -46,10 +46,17 @@
 namespace GafferScene
 {
 
-/// Outputs an entire scene, using a SceneProcedural for the main body of the world.
+/// Outputs an entire scene, using outputWorld() for the main body of the world.
 /// Individual parts of a scene may be output more specifically using the methods below.
 void outputScene( const ScenePlug *scene, IECore::Renderer *renderer );
 
+/// Outputs every visible location in the scene, in hierarchical attribute blocks. The scene
+/// is evaluated in parallel, but the renderer is only ever called from the calling thread,
+/// so this is suitable for immediate mode output to any renderer. The number of threads used
+/// for evaluation is limited by the "option:render:translationThreads" global, with 0 meaning
+/// one thread per core.
+void outputWorld( const ScenePlug *scene, const IECore::CompoundObject *globals, IECore::Renderer *renderer );
+
 /// Outputs the output declarations from the globals.
 void outputOutputs( const IECore::CompoundObject *globals, IECore::Renderer *renderer );
 
@@ -0,0 +1,240 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2015, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef GAFFERSCENE_SCENEMIRROR_H
+#define GAFFERSCENE_SCENEMIRROR_H
+
+#include <map>
+
+#include "tbb/recursive_mutex.h"
+
+#include "IECore/RefCounted.h"
+#include "IECore/CompoundObject.h"
+
+#include "Gaffer/Context.h"
+
+#include "GafferScene/ScenePlug.h"
+#include "GafferScene/PathMatcherData.h"
+
+namespace GafferScene
+{
+
+IE_CORE_FORWARDDECLARE( SceneMirror )
+
+/// Maintains a hierarchical copy of a scene, tracking the hashes of the
+/// attributes, transform, object, bound and child names at every location
+/// so that it can be updated incrementally and in parallel as the scene is
+/// dirtied. Mirrors are shared between all clients which acquire them for
+/// the same plug and the same Context object, so that such clients traverse
+/// the scene only once per edit. Note that the Viewer mirrors the output of
+/// the SceneView's preprocessor while an InteractiveRender mirrors its own
+/// input plug, so the two never share a mirror. Clients record the generation
+/// at which they last synchronised themselves with the mirror, and use
+/// Location::changes() to find out what they need to update.
+///
+/// Updates and traversals of the mirror must be performed while holding
+/// a lock on mutex(), to prevent a different client from updating the
+/// mirror concurrently.
+class SceneMirror : public IECore::RefCounted
+{
+
+	public :
+
+		virtual ~SceneMirror();
+
+		IE_CORE_DECLAREMEMBERPTR( SceneMirror );
+
+		/// Returns the mirror for the specified scene and context, creating
+		/// it if it doesn't exist already. Note that the context is referenced
+		/// rather than copied, so that the mirror follows changes to it.
+		static SceneMirrorPtr acquire( const ScenePlug *scene, const Gaffer::Context *context );
+
+		const ScenePlug *scene() const;
+		const Gaffer::Context *context() const;
+
+		enum DirtyFlags
+		{
+			NothingDirty = 0,
+			BoundDirty = 1,
+			TransformDirty = 2,
+			AttributesDirty = 4,
+			ObjectDirty = 8,
+			ChildNamesDirty = 16,
+			ExpansionDirty = 32,
+			AllDirty = BoundDirty | TransformDirty | AttributesDirty | ObjectDirty | ChildNamesDirty | ExpansionDirty
+		};
+
+		/// Must be called by clients to inform the mirror that parts of the
+		/// scene have been dirtied. The work is deferred until the next call
+		/// to update().
+		void dirty( unsigned dirtyFlags );
+
+		/// By default, the entire scene is mirrored. Clients which only
+		/// need part of the scene may restrict the mirror to the children of
+		/// the locations matched by expandedPaths, plus any locations at a depth
+		/// less than minimumExpansionDepth. A null expandedPaths requests the
+		/// whole scene. The mirror expands the union of the requests from all
+		/// clients.
+		void setExpansion( const void *client, ConstPathMatcherDataPtr expandedPaths, size_t minimumExpansionDepth = 0 );
+		/// Removes the expansion request made by the client.
+		void removeExpansion( const void *client );
+
+		/// Updates all the dirty parts of the mirror in parallel, incrementing
+		/// the generation if anything was dirty. If an exception occurs, the
+		/// mirror is cleared before it is rethrown, and the next update will
+		/// be a complete one.
+		void update();
+		/// Returns the generation number of the most recent update. Generations
+		/// start at 1, so clients may use 0 to mean they have never synchronised.
+		size_t generation() const;
+
+		class Location;
+		/// Returns the root of the mirrored hierarchy.
+		const Location *root() const;
+
+		typedef tbb::recursive_mutex Mutex;
+		Mutex &mutex() const;
+
+		class Location
+		{
+
+			public :
+
+				typedef std::vector<Location *> Children;
+
+				const IECore::InternedString &name() const;
+				const Location *parent() const;
+				void path( ScenePlug::ScenePath &path ) const;
+
+				/// False if the location has been hidden by the
+				/// "scene:visible" attribute. The data for invisible
+				/// locations is not updated beyond the attributes, and
+				/// they have no children.
+				bool visible() const;
+				/// True if the children of the location are mirrored.
+				bool expanded() const;
+				/// True if the location has children, even if they
+				/// aren't expanded.
+				bool hasChildren() const;
+
+				const IECore::CompoundObject *attributes() const;
+				const Imath::M44f &transform() const;
+				/// May be null if nothing has been evaluated yet.
+				const IECore::Object *object() const;
+				/// The bound is only tracked for locations which
+				/// aren't expanded.
+				const Imath::Box3f &bound() const;
+				const Children &children() const;
+
+				/// Returns the DirtyFlags for the data which has changed
+				/// since the specified generation. ChildNamesDirty means that
+				/// the children have been replaced, in which case all their
+				/// data is new.
+				unsigned changes( size_t sinceGeneration ) const;
+
+			private :
+
+				friend class SceneMirror;
+
+				Location( const IECore::InternedString &name, const Location *parent, size_t generation );
+				~Location();
+
+				void clearChildren();
+
+				IECore::InternedString m_name;
+				const Location *m_parent;
+				Children m_children;
+
+				bool m_visible;
+				bool m_expanded;
+				bool m_hasChildren;
+
+				IECore::ConstCompoundObjectPtr m_attributes;
+				Imath::M44f m_transform;
+				IECore::ConstObjectPtr m_object;
+				Imath::Box3f m_bound;
+
+				IECore::MurmurHash m_attributesHash;
+				IECore::MurmurHash m_transformHash;
+				IECore::MurmurHash m_objectHash;
+				IECore::MurmurHash m_boundHash;
+				IECore::MurmurHash m_childNamesHash;
+
+				// The generation at which each component last
+				// changed, indexed by the log2 of its DirtyFlag.
+				size_t m_generations[5];
+
+		};
+
+	private :
+
+		SceneMirror( const ScenePlug *scene, const Gaffer::Context *context );
+
+		bool expanded( const ScenePlug::ScenePath &path ) const;
+
+		class UpdateTask;
+
+		ConstScenePlugPtr m_scene;
+		Gaffer::ConstContextPtr m_context;
+
+		unsigned m_dirtyFlags;
+		size_t m_generation;
+		Location *m_root;
+
+		struct Expansion
+		{
+			ConstPathMatcherDataPtr paths;
+			size_t minimumDepth;
+		};
+		typedef std::map<const void *, Expansion> Expansions;
+		Expansions m_expansions;
+
+		mutable Mutex m_mutex;
+
+		friend void intrusive_ptr_release( const SceneMirror *mirror );
+
+};
+
+/// Releases a reference to the mirror, removing it from the registry
+/// used by SceneMirror::acquire() when the last reference is released.
+/// This overrides the standard IECore::RefCounted behaviour so that the
+/// removal is made atomically with the release - otherwise acquire()
+/// could return a mirror which was in the process of being destroyed.
+void intrusive_ptr_release( const SceneMirror *mirror );
+
+} // namespace GafferScene
+
+#endif // GAFFERSCENE_SCENEMIRROR_H
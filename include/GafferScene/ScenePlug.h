@@ -38,6 +38,8 @@
 #ifndef GAFFER_SCENEPLUG_H
 #define GAFFER_SCENEPLUG_H
 
+#include "tbb/atomic.h"
+
 #include "Gaffer/CompoundPlug.h"
 #include "Gaffer/TypedObjectPlug.h"
 #include "Gaffer/TypedPlug.h"
@@ -157,12 +159,42 @@ class ScenePlug : public Gaffer::CompoundPlug
 		IECore::MurmurHash setHash( const IECore::InternedString &setName ) const;
 		//@}
 
+		/// @name Accumulation cache management
+		/// The results of fullTransform() and fullAttributes() are cached
+		/// for each location, along with the hashes accumulated from the root
+		/// to compute them. These functions limit the number of locations
+		/// held in each cache, in addition to the limits on the ValuePlug cache.
+		////////////////////////////////////////////////////////////////////
+		//@{
+		static size_t getFullTransformCacheLimit();
+		static void setFullTransformCacheLimit( size_t entries );
+		static size_t getFullAttributesCacheLimit();
+		static void setFullAttributesCacheLimit( size_t entries );
+		static size_t getFullHashCacheLimit();
+		static void setFullHashCacheLimit( size_t entries );
+		//@}
+
 		/// Utility function to convert a string into a path by splitting on '/'.
 		/// \todo Many of the places we use this, it would be preferable if the source data was already
 		/// a path. Perhaps a ScenePathPlug could take care of this for us?
 		static void stringToPath( const std::string &s, ScenePlug::ScenePath &path );
 		static void pathToString( const ScenePlug::ScenePath &path, std::string &s );
 
+	protected :
+
+		/// Reimplemented to invalidate the accumulated hashes
+		/// used by fullTransform() and fullAttributes().
+		virtual void dirty();
+
+	private :
+
+		// Included in the keys for the accumulated hashes, so that
+		// dirtying this plug invalidates only its own entries. The id
+		// distinguishes us from any destroyed plug whose address we
+		// may have reused.
+		const uint64_t m_accumulationId;
+		tbb::atomic<uint64_t> m_dirtyCount;
+
 };
 
 IE_CORE_DECLAREPTR( ScenePlug );
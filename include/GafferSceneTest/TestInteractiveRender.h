@@ -0,0 +1,89 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2015, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef GAFFERSCENETEST_TESTINTERACTIVERENDER_H
+#define GAFFERSCENETEST_TESTINTERACTIVERENDER_H
+
+#include "IECore/VectorTypedData.h"
+#include "IECore/ObjectVector.h"
+
+#include "GafferScene/InteractiveRender.h"
+
+#include "GafferSceneTest/TypeIds.h"
+
+namespace GafferSceneTest
+{
+
+/// An InteractiveRender which records the calls made to its renderer,
+/// so that unit tests can check the output and the edits that are made.
+class TestInteractiveRender : public GafferScene::InteractiveRender
+{
+
+	public :
+
+		TestInteractiveRender( const std::string &name=defaultName<TestInteractiveRender>() );
+		virtual ~TestInteractiveRender();
+
+		IE_CORE_DECLARERUNTIMETYPEDEXTENSION( GafferSceneTest::TestInteractiveRender, TestInteractiveRenderTypeId, GafferScene::InteractiveRender );
+
+		/// Returns the calls made to the renderer since the render
+		/// was started or clearLog() was last called. Each call is
+		/// recorded as a CompoundData, with a "call" member holding
+		/// the name of the method, and additional members for the
+		/// interesting arguments :
+		///
+		/// - "name" and "value" for setAttribute().
+		/// - "transform" for setTransform() and concatTransform().
+		/// - "type" and "scope" for editBegin(), where "scope" holds
+		///   the "exactscopename" parameter, if any.
+		const IECore::ObjectVector *log() const;
+		void clearLog();
+
+	protected :
+
+		virtual IECore::RendererPtr createRenderer() const;
+
+	private :
+
+		IECore::ObjectVectorPtr m_log;
+
+};
+
+IE_CORE_DECLAREPTR( TestInteractiveRender )
+
+} // namespace GafferSceneTest
+
+#endif // GAFFERSCENETEST_TESTINTERACTIVERENDER_H
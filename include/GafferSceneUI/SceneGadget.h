@@ -45,6 +45,7 @@
 
 #include "GafferScene/ScenePlug.h"
 #include "GafferScene/PathMatcherData.h"
+#include "GafferScene/SceneMirror.h"
 
 #include "GafferSceneUI/TypeIds.h"
 
@@ -118,6 +119,7 @@ class SceneGadget : public GafferUI::Gadget
 		void plugDirtied( const Gaffer::Plug *plug );
 		void contextChanged( const IECore::InternedString &name );
 		void updateSceneGraph() const;
+		void releaseSceneMirror();
 		void renderSceneGraph( const IECoreGL::State *stateToBind ) const;
 
 		boost::signals::scoped_connection m_plugDirtiedConnection;
@@ -130,10 +132,15 @@ class SceneGadget : public GafferUI::Gadget
 		size_t m_minimumExpansionDepth;
 
 		class SceneGraph;
-		class UpdateTask;
+		class SyncTask;
 
 		IECoreGL::StatePtr m_baseState;
 		boost::shared_ptr<SceneGraph> m_sceneGraph;
+		// The SceneGraph holds only the IECoreGL representation of
+		// the scene, which we synchronise from a SceneMirror which
+		// may be shared with other clients.
+		mutable GafferScene::SceneMirrorPtr m_sceneMirror;
+		mutable size_t m_generation;
 
 		GafferScene::ConstPathMatcherDataPtr m_selection;
 
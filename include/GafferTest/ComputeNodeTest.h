@@ -41,6 +41,7 @@ namespace GafferTest
 {
 
 void testComputeNodeThreading();
+void testComputeNodeChainHashThreading();
 
 } // namespace GafferTest
 
@@ -90,24 +90,6 @@ class AppleseedRender( GafferScene.ExecutableRender ) :
 		renderer = IECoreAppleseed.Renderer( fileName )
 		return renderer
 
-	def _outputWorldProcedural( self, scenePlug, renderer ) :
-
-		scriptNode = scenePlug.node().scriptNode()
-
-		args = [ '-fileName',
-				str( scriptNode["fileName"].getValue() ),
-				'-node',
-				str( scenePlug.node().relativeName( scriptNode ) ),
-				'-frame',
-				str( Gaffer.Context.current().getFrame() ) ]
-
-		procedural = IECore.ClassLoader.defaultProceduralLoader().load( 'gaffer/script', 1, )()
-
-		if procedural :
-
-			IECore.ParameterParser().parse( args, procedural.parameters() )
-			procedural.render( renderer, inAttributeBlock=False, withState=False, withGeometry=True, immediateGeometry=True )
-
 	def _command( self ) :
 		if self["mode"].getValue() == "render" :
 			return "appleseed.cli --message-verbosity %s -c final '%s'" % ( self["verbosity"].getValue(), self.__fileName() )
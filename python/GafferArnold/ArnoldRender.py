@@ -90,34 +90,6 @@ class ArnoldRender( GafferScene.ExecutableRender ) :
 
 		return renderer
 
-	def _outputWorldProcedural( self, scenePlug, renderer ) :
-
-		import arnold
-
-		node = arnold.AiNode( "procedural" )
-		arnold.AiNodeSetStr( node, "dso", "ieProcedural.so" )
-
-		arnold.AiNodeSetPnt( node, "min", -1e30, -1e30, -1e30 )
-		arnold.AiNodeSetPnt( node, "max", 1e30, 1e30, 1e30 )
-
-		arnold.AiNodeDeclare( node, "className", "constant STRING" )
-		arnold.AiNodeDeclare( node, "classVersion", "constant INT" )
-		arnold.AiNodeDeclare( node, "parameterValues", "constant ARRAY STRING" )
-
-		arnold.AiNodeSetStr( node, "className", "gaffer/script" )
-		arnold.AiNodeSetInt( node, "classVersion", 1 )
-
-		scriptNode = scenePlug.node().scriptNode()
-		parameterValues = [
-			"-fileName", scriptNode["fileName"].getValue(),
-			"-node", scenePlug.node().relativeName( scriptNode ),
-			"-frame", str( Gaffer.Context.current().getFrame() ),
-		]
-		stringArray = arnold.AiArrayAllocate( len( parameterValues ), 1, arnold.AI_TYPE_STRING )
-		for i in range( 0, len( parameterValues ) ) :
-			arnold.AiArraySetStr( stringArray, i, parameterValues[i] )
-		arnold.AiNodeSetArray( node, "parameterValues", stringArray )
-
 	def _command( self ) :
 
 		mode = self["mode"].getValue()
@@ -230,6 +230,26 @@ class ArnoldRenderTest( GafferTest.TestCase ) :
 		self.assertTrue( os.path.exists( "/tmp/assTests" ) )
 		self.assertTrue( os.path.exists( "/tmp/assTests/test.0001.ass" ) )
 
+	def testWorldOutputDirectly( self ) :
+
+		s = Gaffer.ScriptNode()
+
+		s["plane"] = GafferScene.Plane()
+		s["render"] = GafferArnold.ArnoldRender()
+		s["render"]["mode"].setValue( "generate" )
+		s["render"]["in"].setInput( s["plane"]["out"] )
+		s["render"]["fileName"].setValue( "/tmp/test.ass" )
+
+		s["render"].execute()
+
+		# The geometry should be in the ass file itself, rather
+		# than being deferred to a procedural which must reload
+		# the script.
+
+		ass = open( "/tmp/test.ass" ).read()
+		self.assertTrue( "polymesh" in ass )
+		self.assertFalse( "ieProcedural" in ass )
+
 	def setUp( self ) :
 
 		for i in range( 1, 4 ) :
@@ -245,6 +265,7 @@ class ArnoldRenderTest( GafferTest.TestCase ) :
 			"/tmp/assTests/test.0001.ass",
 			"/tmp/assTests",
 			"/tmp/test.tif",
+			"/tmp/test.ass",
 		) :
 			if os.path.isfile( f ) :
 				os.remove( f )
@@ -38,6 +38,7 @@ import os
 import unittest
 import random
 import threading
+import time
 
 import IECore
 
@@ -152,6 +153,54 @@ class DisplayTest( unittest.TestCase ) :
 			blackTile
 		)
 
+	def testDataReceivedSignalForEveryBucket( self ) :
+
+		node = GafferImage.Display()
+		node["port"].setValue( 2500 )
+
+		# Other listeners may not increment "__updateCount", but
+		# must still be told about every bucket.
+
+		received = []
+		def dataReceived( plug ) :
+			received.append( plug )
+
+		c = GafferImage.Display.dataReceivedSignal().connect( dataReceived )
+
+		displayWindow = IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( 99 ) )
+		driver = IECore.ClientDisplayDriver(
+			displayWindow,
+			displayWindow,
+			[ "Y" ],
+			{
+				"displayHost" : "localHost",
+				"displayPort" : "2500",
+				"remoteDisplayType" : "GafferImage::GafferDisplayDriver",
+			}
+		)
+
+		numBuckets = 10
+		for i in range( 0, numBuckets ) :
+			bucketWindow = IECore.Box2i( IECore.V2i( 0, i * 10 ), IECore.V2i( 99, i * 10 + 9 ) )
+			bucketData = IECore.FloatVectorData()
+			bucketData.resize( 100 * 10, i + 1 )
+			driver.imageData( bucketWindow, bucketData )
+
+		driver.imageClose()
+		self.__imageReceivedSemaphore.acquire()
+
+		t = time.time()
+		while len( received ) < numBuckets and time.time() - t < 10 :
+			time.sleep( 0.01 )
+
+		self.assertEqual( len( received ), numBuckets )
+		for plug in received :
+			self.assertTrue( plug.isSame( node["out"] ) )
+
+		# And the data from the last bucket must be visible.
+
+		self.assertEqual( node["out"].channelData( "Y", IECore.V2i( 0 ) )[0], numBuckets )
+
 	def __testTransferImage( self, fileName ) :
 
 		imageReader = GafferImage.ImageReader()
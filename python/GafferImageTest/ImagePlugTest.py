@@ -35,6 +35,7 @@
 #
 ##########################################################################
 
+import os
 import unittest
 
 import IECore
@@ -132,6 +133,134 @@ class ImagePlugTest( GafferTest.TestCase ) :
 		self.assertTrue( b.plugIsPromoted( b["n"]["in"] ) )
 		self.assertTrue( b.plugIsPromoted( b["n"]["out"] ) )
 
+	def testMultiChannelData( self ) :
+
+		r = GafferImage.ImageReader()
+		r["fileName"].setValue( os.path.expandvars( "$GAFFER_ROOT/python/GafferTest/images/checker.exr" ) )
+
+		o = GafferImage.OpenColorIO()
+		o["in"].setInput( r["out"] )
+		o["inputSpace"].setValue( "linear" )
+		o["outputSpace"].setValue( "sRGB" )
+
+		for node in ( r, o ) :
+			for channelNames in ( [ "R" ], [ "R", "G", "B" ], [ "B", "G", "R" ] ) :
+				for tileOrigin in ( IECore.V2i( 0 ), IECore.V2i( GafferImage.ImagePlug.tileSize() ) ) :
+					d = node["out"].multiChannelData( channelNames, tileOrigin )
+					self.assertEqual( len( d ), len( channelNames ) )
+					for i, c in enumerate( channelNames ) :
+						self.assertEqual( d[i], node["out"].channelData( c, tileOrigin ) )
+
+		self.assertEqual(
+			o["out"].multiChannelDataHash( [ "R", "G", "B" ], IECore.V2i( 0 ) ),
+			o["out"].multiChannelDataHash( [ "R", "G", "B" ], IECore.V2i( 0 ) ),
+		)
+		self.assertNotEqual(
+			o["out"].multiChannelDataHash( [ "R", "G", "B" ], IECore.V2i( 0 ) ),
+			r["out"].multiChannelDataHash( [ "R", "G", "B" ], IECore.V2i( 0 ) ),
+		)
+
+	def testMultiChannelDataDirtyPropagation( self ) :
+
+		c = GafferImage.Constant()
+		cs = GafferTest.CapturingSlot( c.plugDirtiedSignal() )
+		c["color"]["r"].setValue( 0.5 )
+
+		dirtied = set( [ x[0].relativeName( x[0].node() ) for x in cs ] )
+		self.assertTrue( "out.channelData" in dirtied )
+		self.assertTrue( "out.multiChannelData" in dirtied )
+
+	def testSetTileSize( self ) :
+
+		c = GafferImage.Constant()
+		c["color"].setValue( IECore.Color4f( 1, 0.5, 0.25, 1 ) )
+
+		h64 = c["out"].channelDataHash( "R", IECore.V2i( 0 ) )
+		i64 = c["out"].image()
+
+		GafferImage.ImagePlug.setTileSize( 128 )
+		self.assertEqual( GafferImage.ImagePlug.tileSize(), 128 )
+		self.assertEqual( GafferImage.ImagePlug.tileOrigin( IECore.V2i( 100 ) ), IECore.V2i( 0 ) )
+
+		self.assertNotEqual( c["out"].channelDataHash( "R", IECore.V2i( 0 ) ), h64 )
+		self.assertEqual( len( c["out"].channelData( "R", IECore.V2i( 0 ) ) ), 128 * 128 )
+		self.assertEqual( c["out"].image(), i64 )
+
+		c["enabled"].setValue( False )
+		self.assertEqual( len( c["out"].channelData( "R", IECore.V2i( 0 ) ) ), 128 * 128 )
+
+		self.assertRaises( RuntimeError, GafferImage.ImagePlug.setTileSize, 100 )
+		self.assertRaises( RuntimeError, GafferImage.ImagePlug.setTileSize, 4096 )
+		self.assertEqual( GafferImage.ImagePlug.tileSize(), 128 )
+
+	def testTileSizeDoesntAffectResults( self ) :
+
+		# A typical comp graph, with a format which isn't a
+		# multiple of any tile size, so that edge tiles are
+		# partially filled.
+
+		c1 = GafferImage.Constant()
+		c1["format"].setValue( GafferImage.Format( 500, 300, 1. ) )
+		c1["color"].setValue( IECore.Color4f( 0.5, 0.25, 0.1, 0.5 ) )
+
+		grade = GafferImage.Grade()
+		grade["in"].setInput( c1["out"] )
+		grade["gain"].setValue( IECore.Color3f( 2, 1, 0.5 ) )
+
+		clamp = GafferImage.Clamp()
+		clamp["in"].setInput( grade["out"] )
+
+		c2 = GafferImage.Constant()
+		c2["format"].setValue( GafferImage.Format( 500, 300, 1. ) )
+		c2["color"].setValue( IECore.Color4f( 0, 0, 1, 1 ) )
+
+		merge = GafferImage.Merge()
+		merge["in"].setInput( c2["out"] )
+		merge["in1"].setInput( clamp["out"] )
+		merge["operation"].setValue( GafferImage.Merge.Operation.Over )
+
+		images = []
+		for tileSize in ( 64, 128, 256 ) :
+			GafferImage.ImagePlug.setTileSize( tileSize )
+			images.append( merge["out"].image() )
+
+		for image in images[1:] :
+			self.assertEqual( image, images[0] )
+
+	def testImageHashMatchesTileHashes( self ) :
+
+		r = GafferImage.ImageReader()
+		r["fileName"].setValue( os.path.expandvars( "$GAFFER_ROOT/python/GafferTest/images/checkerWithNegativeDataWindow.200x150.exr" ) )
+
+		for tileSize in ( 16, 64 ) :
+
+			GafferImage.ImagePlug.setTileSize( tileSize )
+
+			expected = r["out"]["format"].hash()
+			expected.append( r["out"]["dataWindow"].hash() )
+			expected.append( r["out"]["metadata"].hash() )
+			expected.append( r["out"]["channelNames"].hash() )
+
+			dataWindow = r["out"]["dataWindow"].getValue()
+			minTileOrigin = GafferImage.ImagePlug.tileOrigin( dataWindow.min )
+			maxTileOrigin = GafferImage.ImagePlug.tileOrigin( dataWindow.max )
+			for channelName in r["out"]["channelNames"].getValue() :
+				for y in range( minTileOrigin.y, maxTileOrigin.y + 1, tileSize ) :
+					for x in range( minTileOrigin.x, maxTileOrigin.x + 1, tileSize ) :
+						expected.append( r["out"].channelDataHash( channelName, IECore.V2i( x, y ) ) )
+
+			self.assertEqual( r["out"].imageHash(), expected )
+
+	def setUp( self ) :
+
+		GafferTest.TestCase.setUp( self )
+		self.__originalTileSize = GafferImage.ImagePlug.tileSize()
+
+	def tearDown( self ) :
+
+		GafferTest.TestCase.tearDown( self )
+		GafferImage.ImagePlug.setTileSize( self.__originalTileSize )
+
 	def testTypeNamePrefixes( self ) :
 
 		self.assertTypeNamesArePrefixed( GafferImage )
@@ -269,10 +269,8 @@ class ImageReaderTest( unittest.TestCase ) :
 		dataWindow = reader["out"]["dataWindow"].getValue()
 		
 		shutil.copyfile( self.fileName, testFile )
-		# the default image is cached
-		self.assertEqual( dataWindow, reader["out"]["dataWindow"].getValue() )
-		# until we force a refresh
-		reader["refreshCount"].setValue( reader["refreshCount"].getValue() + 1 )
+		# failure to find the file is not cached, so the
+		# new file is found without needing a refresh
 		newDataWindow = reader["out"]["dataWindow"].getValue()
 		self.assertNotEqual( dataWindow, newDataWindow )
 		
@@ -283,6 +281,79 @@ class ImageReaderTest( unittest.TestCase ) :
 		reader["refreshCount"].setValue( reader["refreshCount"].getValue() + 1 )
 		self.assertNotEqual( newDataWindow, reader["out"]["dataWindow"].getValue() )
 	
+	def testMultiChannelData( self ) :
+
+		for fileName in ( self.fileName, self.negativeDataWindowFileName, self.circlesJpgFileName ) :
+
+			n = GafferImage.ImageReader()
+			n["fileName"].setValue( fileName )
+
+			dataWindow = n["out"]["dataWindow"].getValue()
+			channelNames = list( n["out"]["channelNames"].getValue() )
+			for requested in ( channelNames, list( reversed( channelNames ) ), [ channelNames[-1], "Z", channelNames[0] ] ) :
+				for tileOrigin in ( GafferImage.ImagePlug.tileOrigin( dataWindow.min ), GafferImage.ImagePlug.tileOrigin( dataWindow.max ) ) :
+					tiles = n["out"].multiChannelData( requested, tileOrigin )
+					self.assertEqual( len( tiles ), len( requested ) )
+					for channelName, tile in zip( requested, tiles ) :
+						self.assertEqual( tile, n["out"].channelData( channelName, tileOrigin ) )
+
+	def testMipLevelClamping( self ) :
+
+		n = GafferImage.ImageReader()
+		n["fileName"].setValue( self.fileName )
+
+		dataWindow = n["out"]["dataWindow"].getValue()
+		tile = n["out"].channelData( "R", IECore.V2i( 0 ) )
+
+		# The file has no mip levels, so we should clamp to the full resolution one.
+		n["mipLevel"].setValue( 2 )
+		self.assertEqual( n["out"]["dataWindow"].getValue(), dataWindow )
+		self.assertEqual( n["out"].channelData( "R", IECore.V2i( 0 ) ), tile )
+
+	def testProxyLevelContext( self ) :
+
+		n = GafferImage.ImageReader()
+		n["fileName"].setValue( self.fileName )
+
+		c = Gaffer.Context()
+		c["image:channelName"] = "R"
+		c["image:tileOrigin"] = IECore.V2i( 0 )
+		with c :
+			h1 = n["out"]["channelData"].hash()
+			t1 = n["out"]["channelData"].getValue()
+			c["image:proxyLevel"] = 1
+			h2 = n["out"]["channelData"].hash()
+			t2 = n["out"]["channelData"].getValue()
+
+		self.assertNotEqual( h1, h2 )
+		self.assertEqual( t1, t2 )
+
+	def testProxyLevelDoesntAffectFormatOrDataWindow( self ) :
+
+		n = GafferImage.ImageReader()
+		n["fileName"].setValue( self.fileName )
+
+		format = n["out"]["format"].getValue()
+		dataWindow = n["out"]["dataWindow"].getValue()
+		formatHash = n["out"]["format"].hash()
+		dataWindowHash = n["out"]["dataWindow"].hash()
+
+		with Gaffer.Context() as c :
+			c["image:proxyLevel"] = 2
+			self.assertEqual( n["out"]["format"].getValue(), format )
+			self.assertEqual( n["out"]["dataWindow"].getValue(), dataWindow )
+			self.assertEqual( n["out"]["format"].hash(), formatHash )
+			self.assertEqual( n["out"]["dataWindow"].hash(), dataWindowHash )
+
+	def testSubimage( self ) :
+
+		n = GafferImage.ImageReader()
+		n["fileName"].setValue( self.fileName )
+		n["out"]["format"].getValue()
+
+		n["subimage"].setValue( 1 )
+		self.assertRaises( RuntimeError, n["out"]["format"].getValue )
+
 	def setUp( self ) :
 		
 		os.mkdir( self.__testDir )
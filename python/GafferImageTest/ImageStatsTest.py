@@ -39,6 +39,7 @@ import unittest
 import IECore
 import Gaffer
 import GafferImage
+import GafferImageTest
 import GafferTest
 import sys
 import math
@@ -198,6 +199,139 @@ class ImageStatsTest( unittest.TestCase ) :
 		self.__assertColour( s["min"].getValue(), IECore.Color4f( 0.25, 0, 0, 0.5 ) )
 		self.__assertColour( s["max"].getValue(), IECore.Color4f( 0.5, 0.5, 0, 0.75 ) )
 
+	def testMinWithNegativeValues( self ) :
+
+		c = GafferImage.Constant()
+		c["format"].setValue( GafferImage.Format( 100, 100, 1. ) )
+		c["color"].setValue( IECore.Color4f( -1, -0.5, -0.25, -2 ) )
+
+		s = GafferImage.ImageStats()
+		s["in"].setInput( c["out"] )
+		s["channels"].setValue( IECore.StringVectorData( [ "R", "G", "B", "A" ] ) )
+		s["regionOfInterest"].setValue( c["out"]["format"].getValue().getDisplayWindow() )
+
+		self.__assertColour( s["min"].getValue(), IECore.Color4f( -1, -0.5, -0.25, -2 ) )
+		self.__assertColour( s["max"].getValue(), IECore.Color4f( -1, -0.5, -0.25, -2 ) )
+		self.__assertColour( s["average"].getValue(), IECore.Color4f( -1, -0.5, -0.25, -2 ) )
+
+	def testHistogram( self ) :
+
+		r = GafferImage.ImageReader()
+		r["fileName"].setValue( self.__rgbFilePath )
+
+		s = GafferImage.ImageStats()
+		s["in"].setInput( r["out"] )
+		s["channels"].setValue( IECore.StringVectorData( [ "R", "G", "B", "A" ] ) )
+		s["regionOfInterest"].setValue( IECore.Box2i( IECore.V2i( 20, 20 ), IECore.V2i( 24, 24 ) ) )
+		s["histogramBins"].setValue( 4 )
+
+		histogram = s["histogram"].getValue()
+		self.assertEqual( set( histogram.keys() ), set( [ "R", "G", "B", "A" ] ) )
+		self.assertEqual( histogram["R"], IECore.UInt64VectorData( [ 0, 0, 25, 0 ] ) )
+		self.assertEqual( histogram["G"], IECore.UInt64VectorData( [ 25, 0, 0, 0 ] ) )
+		self.assertEqual( histogram["A"], IECore.UInt64VectorData( [ 0, 0, 25, 0 ] ) )
+
+		# Values outside the range should be clamped into the end bins.
+		s["histogramRange"].setValue( IECore.V2f( 0.6, 1 ) )
+		self.assertEqual( s["histogram"].getValue()["R"], IECore.UInt64VectorData( [ 25, 0, 0, 0 ] ) )
+
+		# The counts should always cover the whole region of interest.
+		s["regionOfInterest"].setValue( r["out"]["format"].getValue().getDisplayWindow() )
+		for c in "RGBA" :
+			self.assertEqual( sum( s["histogram"].getValue()[c] ), 100 * 100 )
+
+		s["regionOfInterest"].setValue( IECore.Box2i() )
+		self.assertEqual( s["histogram"].getValue(), IECore.CompoundObject() )
+
+	def testPercentile( self ) :
+
+		r = GafferImage.ImageReader()
+		r["fileName"].setValue( self.__rgbFilePath )
+
+		s = GafferImage.ImageStats()
+		s["in"].setInput( r["out"] )
+		s["channels"].setValue( IECore.StringVectorData( [ "R", "G", "B", "A" ] ) )
+		s["regionOfInterest"].setValue( r["out"]["format"].getValue().getDisplayWindow() )
+
+		s["percentile"].setValue( 0 )
+		self.__assertColour( s["percentileValue"].getValue(), s["min"].getValue() )
+		s["percentile"].setValue( 100 )
+		self.__assertColour( s["percentileValue"].getValue(), s["max"].getValue() )
+
+		previous = s["min"].getValue()
+		for percentile in range( 10, 100, 10 ) :
+			s["percentile"].setValue( percentile )
+			value = s["percentileValue"].getValue()
+			for i in range( 0, 4 ) :
+				self.assertTrue( value[i] >= previous[i] )
+			previous = value
+
+		# A constant region has the same value at every percentile.
+		s["regionOfInterest"].setValue( IECore.Box2i( IECore.V2i( 20, 20 ), IECore.V2i( 24, 24 ) ) )
+		s["percentile"].setValue( 50 )
+		self.__assertColour( s["percentileValue"].getValue(), IECore.Color4f( 0.5, 0, 0, 0.5 ) )
+
+	def testTileStatsIndependentOfTileSize( self ) :
+
+		r = GafferImage.ImageReader()
+		r["fileName"].setValue( self.__rgbFilePath )
+
+		s = GafferImage.ImageStats()
+		s["in"].setInput( r["out"] )
+		s["channels"].setValue( IECore.StringVectorData( [ "R", "G", "B", "A" ] ) )
+		s["regionOfInterest"].setValue( IECore.Box2i( IECore.V2i( 20, 20 ), IECore.V2i( 40, 29 ) ) )
+
+		average = s["average"].getValue()
+		histogram = s["histogram"].getValue()
+
+		tileSize = GafferImage.ImagePlug.tileSize()
+		try :
+			GafferImage.ImagePlug.setTileSize( 16 )
+			self.__assertColour( s["average"].getValue(), average )
+			self.assertEqual( s["histogram"].getValue(), histogram )
+		finally :
+			GafferImage.ImagePlug.setTileSize( tileSize )
+
+	def testTileStatsReusedWhenRegionMoves( self ) :
+
+		r = GafferImageTest.rampImage( 300 )
+
+		s = GafferImage.ImageStats()
+		s["in"].setInput( r["out"] )
+		s["channels"].setValue( IECore.StringVectorData( [ "R" ] ) )
+		s["regionOfInterest"].setValue( IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( 299 ) ) )
+
+		m = Gaffer.PerformanceMonitor()
+		m.setActive( True )
+		try :
+			with Gaffer.Context() :
+				s["average"].getValue()
+			initialComputes = m.plugStatistics( s["__tileStats"] ).computeCount
+			# Shrinking the region vertically changes the coverage of only
+			# one row of tiles. The statistics for all the others should be
+			# reused from the cache.
+			with Gaffer.Context() :
+				s["regionOfInterest"].setValue( IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( 299, 200 ) ) )
+				average = s["average"].getValue()
+			movedComputes = m.plugStatistics( s["__tileStats"] ).computeCount - initialComputes
+		finally :
+			m.setActive( False )
+
+		tileSize = GafferImage.ImagePlug.tileSize()
+		tilesPerRow = ( 300 + tileSize - 1 ) / tileSize
+		self.assertEqual( initialComputes, tilesPerRow * tilesPerRow )
+		self.assertEqual( movedComputes, tilesPerRow )
+
+		# And the result should be the same as computing from scratch. We
+		# use a different number of histogram bins so that nothing is
+		# shared with the first node via the cache.
+		s2 = GafferImage.ImageStats()
+		s2["in"].setInput( r["out"] )
+		s2["channels"].setValue( IECore.StringVectorData( [ "R" ] ) )
+		s2["regionOfInterest"].setValue( s["regionOfInterest"].getValue() )
+		s2["histogramBins"].setValue( 100 )
+		self.__assertColour( s2["average"].getValue(), average )
+
 	def __assertColour( self, colour1, colour2 ) :
 		for i in range( 0, 4 ):
 			self.assertEqual( "%.4f" % colour2[i], "%.4f" % colour1[i] )
@@ -66,7 +66,7 @@ class ImageSwitchTest( GafferTest.TestCase ) :
 		switch["in1"].setInput( in1["out"] )
 
 		for p in [ switch["in"], switch["in1"] ] :
-			for n in [ "format", "dataWindow", "metadata", "channelNames", "channelData" ] :
+			for n in [ "format", "dataWindow", "metadata", "channelNames", "channelData", "multiChannelData" ] :
 				a = switch.affects( p[n] )
 				self.assertEqual( len( a ), 1 )
 				self.assertTrue( a[0].isSame( switch["out"][n] ) )
@@ -75,7 +75,7 @@ class ImageSwitchTest( GafferTest.TestCase ) :
 		self.assertEqual(
 			a,
 			set( [
-				"out.format", "out.dataWindow", "out.metadata", "out.channelNames", "out.channelData",
+				"out.format", "out.dataWindow", "out.metadata", "out.channelNames", "out.channelData", "out.multiChannelData",
 			] ),
 		)
 
@@ -83,7 +83,7 @@ class ImageSwitchTest( GafferTest.TestCase ) :
 		self.assertEqual(
 			a,
 			set( [
-				"out.format", "out.dataWindow", "out.metadata", "out.channelNames", "out.channelData",
+				"out.format", "out.dataWindow", "out.metadata", "out.channelNames", "out.channelData", "out.multiChannelData",
 			] ),
 		)
 
@@ -58,7 +58,7 @@ class ImageTimeWarpTest( GafferTest.TestCase ) :
 
 		timeWarp = GafferImage.ImageTimeWarp()
 
-		for n in [ "format", "dataWindow", "metadata", "channelNames", "channelData" ] :
+		for n in [ "format", "dataWindow", "metadata", "channelNames", "channelData", "multiChannelData" ] :
 			a = timeWarp.affects( timeWarp["in"][n] )
 			self.assertEqual( len( a ), 1 )
 			self.assertTrue( a[0].isSame( timeWarp["out"][n] ) )
@@ -68,7 +68,7 @@ class ImageTimeWarpTest( GafferTest.TestCase ) :
 			self.assertEqual(
 				a,
 				set( [
-					"out.format", "out.dataWindow", "out.metadata", "out.channelNames", "out.channelData",
+					"out.format", "out.dataWindow", "out.metadata", "out.channelNames", "out.channelData", "out.multiChannelData",
 				] ),
 			)
 
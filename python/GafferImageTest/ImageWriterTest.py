@@ -44,6 +44,7 @@ import IECore
 
 import Gaffer
 import GafferImage
+import GafferImageTest
 
 class ImageWriterTest( unittest.TestCase ) :
 
@@ -470,7 +471,61 @@ class ImageWriterTest( unittest.TestCase ) :
 		self.assertEqual( after["out"]["format"].getValue().getPixelAspect(), 2 )
 		# the metadata reflects this as well
 		self.assertEqual( after["out"]["metadata"].getValue()["PixelAspectRatio"], IECore.FloatData( 2 ) )
-	
+
+	def testStreamedWriteMatchesInput( self ) :
+
+		r = GafferImage.ImageReader()
+		r["fileName"].setValue( os.path.expandvars( "$GAFFER_ROOT/python/GafferTest/images/checkerWithNegativeDataWindow.200x150.exr" ) )
+
+		for name, mode in self.__writeModes :
+
+			testFile = self.__testFile( name, "RGBA", "exr" )
+
+			w = GafferImage.ImageWriter()
+			w["in"].setInput( r["out"] )
+			w["fileName"].setValue( testFile )
+			w["writeMode"].setValue( mode )
+
+			with Gaffer.Context() :
+				w.execute()
+
+			after = GafferImage.ImageReader()
+			after["fileName"].setValue( testFile )
+
+			self.assertEqual( after["out"]["format"].getValue(), r["out"]["format"].getValue() )
+			self.assertEqual( after["out"]["dataWindow"].getValue(), r["out"]["dataWindow"].getValue() )
+			self.assertEqual( after["out"].image(), r["out"].image() )
+
+	def testStreamedWriteOfManyTiles( self ) :
+
+		# Enough tiles to be streamed by many tasks at once, and
+		# values which differ between neighbouring pixels, so that
+		# any misplaced tile or scanline shows up.
+
+		r = GafferImageTest.rampImage( 300 )
+
+		g = GafferImage.Grade()
+		g["in"].setInput( r["out"] )
+		g["gain"].setValue( IECore.Color3f( 2, 1, 0.5 ) )
+
+		for name, mode in self.__writeModes :
+
+			testFile = self.__testFile( "manyTiles" + name, "RGBA", "exr" )
+
+			w = GafferImage.ImageWriter()
+			w["in"].setInput( g["out"] )
+			w["fileName"].setValue( testFile )
+			w["writeMode"].setValue( mode )
+
+			with Gaffer.Context() :
+				w.execute()
+
+			after = GafferImage.ImageReader()
+			after["fileName"].setValue( testFile )
+
+			self.assertEqual( after["out"]["dataWindow"].getValue(), g["out"]["dataWindow"].getValue() )
+			self.assertEqual( after["out"].image(), g["out"].image() )
+
 	def tearDown( self ) :
 
 		if os.path.isdir( self.__testDir ) :
@@ -39,6 +39,7 @@ import unittest
 
 import IECore
 
+import Gaffer
 import GafferTest
 import GafferImage
 
@@ -189,21 +190,24 @@ class MergeTest( GafferTest.TestCase ) :
 
 		c1["color"]["r"].setValue( 0.1 )
 
-		self.assertEqual( len( cs ), 4 )
-		self.assertTrue( cs[0][0].isSame( m["in"]["channelData"] ) )
-		self.assertTrue( cs[1][0].isSame( m["in"] ) )
-		self.assertTrue( cs[2][0].isSame( m["out"]["channelData"] ) )
-		self.assertTrue( cs[3][0].isSame( m["out"] ) )
+		self.__assertDirtied( cs, [ "in.channelData", "in.multiChannelData", "in", "out.channelData", "out.multiChannelData", "out" ] )
 
 		del cs[:]
 
 		c2["color"]["g"].setValue( 0.2 )
 
-		self.assertEqual( len( cs ), 4 )
-		self.assertTrue( cs[0][0].isSame( m["in1"]["channelData"] ) )
-		self.assertTrue( cs[1][0].isSame( m["in1"] ) )
-		self.assertTrue( cs[2][0].isSame( m["out"]["channelData"] ) )
-		self.assertTrue( cs[3][0].isSame( m["out"] ) )
+		self.__assertDirtied( cs, [ "in1.channelData", "in1.multiChannelData", "in1", "out.channelData", "out.multiChannelData", "out" ] )
+
+	def __assertDirtied( self, cs, expected ) :
+
+		dirtied = [ x[0].relativeName( x[0].node() ) for x in cs ]
+		self.assertEqual( len( dirtied ), len( expected ) )
+		self.assertEqual( set( dirtied ), set( expected ) )
+
+		# Parents must be dirtied after their children.
+		for name in dirtied :
+			if "." in name :
+				self.assertTrue( dirtied.index( name ) < dirtied.index( name.rpartition( "." )[0] ) )
 
 	def testEnabledAffects( self ) :
 
@@ -241,5 +245,112 @@ class MergeTest( GafferTest.TestCase ) :
 		self.assertEqual( m["out"]["format"].getValue(), d["out"]["format"].getValue() )
 		self.assertEqual( m["out"]["metadata"].getValue(), d["out"]["metadata"].getValue() )
 
+	def __constantImage( self, dataWindow, value ) :
+
+		image = IECore.ImagePrimitive( dataWindow, IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( 199 ) ) )
+		numPixels = ( dataWindow.size().x + 1 ) * ( dataWindow.size().y + 1 )
+		for channel in "RGBA" :
+			image[channel] = IECore.PrimitiveVariable( IECore.PrimitiveVariable.Interpolation.Vertex, IECore.FloatVectorData( [ value ] * numPixels ) )
+
+		node = GafferImage.ObjectToImage()
+		node["object"].setValue( image )
+		return node
+
+	# Inputs are treated as black outside their data windows, regardless
+	# of whether or not the operation allows them to be skipped.
+	def testEmptyInputs( self ) :
+
+		a = self.__constantImage( IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( 199 ) ), 0.5 )
+		b = self.__constantImage( IECore.Box2i( IECore.V2i( 0 ), IECore.V2i( 20 ) ), 0.25 )
+
+		merge = GafferImage.Merge()
+		merge["in"].setInput( b["out"] )
+		merge["in1"].setInput( a["out"] )
+
+		tileOrigin = IECore.V2i( GafferImage.ImagePlug.tileSize() * 2 )
+
+		hashes = set()
+		for operation, expected in [
+			( GafferImage.Merge.Operation.Add, 0.5 ),
+			( GafferImage.Merge.Operation.Atop, 0 ),
+			( GafferImage.Merge.Operation.In, 0 ),
+			( GafferImage.Merge.Operation.Out, 0.5 ),
+			( GafferImage.Merge.Operation.Mask, 0 ),
+			( GafferImage.Merge.Operation.Matte, 0.25 ),
+			( GafferImage.Merge.Operation.Multiply, 0 ),
+			( GafferImage.Merge.Operation.Over, 0.5 ),
+			( GafferImage.Merge.Operation.Subtract, 0.5 ),
+			( GafferImage.Merge.Operation.Under, 0.5 ),
+		] :
+			merge["operation"].setValue( operation )
+			tile = merge["out"].channelData( "R", tileOrigin )
+			self.assertEqual( tile, IECore.FloatVectorData( [ expected ] * len( tile ) ) )
+			hashes.add( merge["out"].channelDataHash( "R", tileOrigin ) )
+
+		self.assertEqual( len( hashes ), 10 )
+
+		# If all inputs are empty, the result is black.
+		tileOrigin = IECore.V2i( GafferImage.ImagePlug.tileSize() * 4 )
+		merge["operation"].setValue( GafferImage.Merge.Operation.Over )
+		tile = merge["out"].channelData( "R", tileOrigin )
+		self.assertEqual( tile, IECore.FloatVectorData( [ 0 ] * len( tile ) ) )
+
+	def testManyInputs( self ) :
+
+		merge = GafferImage.Merge()
+		merge["operation"].setValue( GafferImage.Merge.Operation.Add )
+
+		constants = []
+		for i in range( 0, 20 ) :
+			c = GafferImage.Constant()
+			c["format"].setValue( GafferImage.Format( 100, 100, 1. ) )
+			c["color"].setValue( IECore.Color4f( 0.01 * i, 0, 0, 0.01 ) )
+			constants.append( c )
+			merge["in%s" % ( i if i else "" )].setInput( c["out"] )
+
+		tile = merge["out"].channelData( "R", IECore.V2i( 0 ) )
+		expected = sum( [ 0.01 * i for i in range( 0, 20 ) ] )
+		for v in tile :
+			self.assertAlmostEqual( v, expected, 5 )
+
+	# Test that merging many inputs in a single pass gives the same result
+	# as compositing them one at a time with a chain of two-input merges.
+	def testManyInputsMatchChainedMerges( self ) :
+
+		merge = GafferImage.Merge()
+		merge["operation"].setValue( GafferImage.Merge.Operation.Over )
+
+		nodes = []
+		chained = None
+		for i in range( 0, 8 ) :
+
+			# Differently sized inputs, so that each tile sees
+			# a different subset of them.
+			c = GafferImage.Constant()
+			c["format"].setValue( GafferImage.Format( 60 + i * 20, 200 - i * 20, 1. ) )
+			c["color"].setValue( IECore.Color4f( 0.1 * i, 0.5, 1 - 0.1 * i, 0.1 + 0.1 * i ) )
+			nodes.append( c )
+			merge["in%s" % ( i if i else "" )].setInput( c["out"] )
+
+			if chained is None :
+				chained = c
+			else :
+				m = GafferImage.Merge()
+				m["operation"].setValue( GafferImage.Merge.Operation.Over )
+				m["in"].setInput( chained["out"] )
+				m["in1"].setInput( c["out"] )
+				nodes.append( m )
+				chained = m
+
+		self.assertEqual( merge["out"]["dataWindow"].getValue(), chained["out"]["dataWindow"].getValue() )
+		self.assertFalse(
+			IECore.ImageDiffOp()(
+				imageA = chained["out"].image(),
+				imageB = merge["out"].image(),
+				skipMissingChannels = False,
+				maxError = 0.0001
+			).value
+		)
+
 if __name__ == "__main__":
 	unittest.main()
@@ -150,5 +150,95 @@ class OpenColorIOTest( unittest.TestCase ) :
 		self.assertEqual( i["out"]["dataWindow"].getValue(), o["out"]["dataWindow"].getValue() )
 		self.assertEqual( i["out"]["channelNames"].getValue(), o["out"]["channelNames"].getValue() )
 
+	def testBakedLUT( self ) :
+
+		i = GafferImage.ImageReader()
+		i["fileName"].setValue( os.path.expandvars( "$GAFFER_ROOT/python/GafferTest/images/circles.exr" ) )
+
+		o = GafferImage.OpenColorIO()
+		o["in"].setInput( i["out"] )
+		o["inputSpace"].setValue( "linear" )
+		o["outputSpace"].setValue( "sRGB" )
+
+		exactHash = o["out"].channelDataHash( "R", IECore.V2i( 0 ) )
+		exact = o["out"].channelData( "R", IECore.V2i( 0 ) )
+
+		o["bakedLUT"].setValue( True )
+
+		self.assertNotEqual( o["out"].channelDataHash( "R", IECore.V2i( 0 ) ), exactHash )
+
+		baked = o["out"].channelData( "R", IECore.V2i( 0 ) )
+		self.assertEqual( len( baked ), len( exact ) )
+		for b, e in zip( baked, exact ) :
+			self.assertAlmostEqual( b, e, delta = 0.01 )
+
+	def testChainMatchesUnfusedChain( self ) :
+
+		i = GafferImage.ImageReader()
+		i["fileName"].setValue( os.path.expandvars( "$GAFFER_ROOT/python/GafferTest/images/circles.exr" ) )
+
+		spaces = [ ( "linear", "sRGB" ), ( "sRGB", "linear" ), ( "linear", "sRGB" ) ]
+
+		chain = []
+		for inputSpace, outputSpace in spaces :
+			o = GafferImage.OpenColorIO()
+			o["in"].setInput( chain[-1]["out"] if chain else i["out"] )
+			o["inputSpace"].setValue( inputSpace )
+			o["outputSpace"].setValue( outputSpace )
+			chain.append( o )
+
+		# Builds the reference result by pulling the output of each
+		# transform separately, and feeding it into a lone transform
+		# via an ObjectToImage node, so that no two transforms can
+		# be processed in the same pass.
+		def unfused() :
+
+			image = i["out"].image()
+			for o in chain :
+				objectToImage = GafferImage.ObjectToImage()
+				objectToImage["object"].setValue( image )
+				single = GafferImage.OpenColorIO()
+				single["in"].setInput( objectToImage["out"] )
+				single["inputSpace"].setValue( o["inputSpace"].getValue() )
+				single["outputSpace"].setValue( o["outputSpace"].getValue() )
+				single["enabled"].setValue( o["enabled"].getValue() )
+				image = single["out"].image()
+
+			# ObjectToImage doesn't preserve metadata.
+			image.blindData().clear()
+			return image
+
+		def fused() :
+
+			image = chain[-1]["out"].image()
+			image.blindData().clear()
+			return image
+
+		self.assertEqual( fused(), unfused() )
+
+		chain[1]["enabled"].setValue( False )
+		self.assertEqual( fused(), unfused() )
+
+	def testParallelTilesShareProcessor( self ) :
+
+		# Every tile is processed concurrently by image(), using the
+		# same cached processor. Since the input is constant, so must
+		# be the output.
+
+		c = GafferImage.Constant()
+		c["format"].setValue( GafferImage.Format( 500, 500, 1. ) )
+		c["color"].setValue( IECore.Color4f( 0.25, 0.5, 0.75, 1 ) )
+
+		o = GafferImage.OpenColorIO()
+		o["in"].setInput( c["out"] )
+		o["inputSpace"].setValue( "linear" )
+		o["outputSpace"].setValue( "sRGB" )
+
+		image = o["out"].image()
+		for i, channelName in enumerate( "RGB" ) :
+			tile = o["out"].channelData( channelName, IECore.V2i( 0 ) )
+			self.assertNotAlmostEqual( tile[0], c["color"].getValue()[i], 2 )
+			self.assertEqual( image[channelName].data, IECore.FloatVectorData( [ tile[0] ] * 500 * 500 ) )
+
 if __name__ == "__main__":
 	unittest.main()
@@ -40,6 +40,7 @@ import IECore
 import Gaffer
 import GafferTest
 import GafferImage
+import GafferImageTest
 import os
 
 class ReformatTest( unittest.TestCase ) :
@@ -73,11 +74,13 @@ class ReformatTest( unittest.TestCase ) :
 		reformat["format"].setValue( GafferImage.Format( 150, 125, 1. ) )
 
 		dirtiedPlugs = set( [ x[0].relativeName( x[0].node() ) for x in cs ] )
-		self.assertEqual( len( dirtiedPlugs ), 5 )
+		self.assertEqual( len( dirtiedPlugs ), 7 )
 		self.assertTrue( "format" in dirtiedPlugs )
+		self.assertTrue( "__horizontalPass" in dirtiedPlugs )
 		self.assertTrue( "out" in dirtiedPlugs )
 		self.assertTrue( "out.dataWindow" in dirtiedPlugs )
 		self.assertTrue( "out.channelData" in dirtiedPlugs )
+		self.assertTrue( "out.multiChannelData" in dirtiedPlugs )
 		self.assertTrue( "out.format" in dirtiedPlugs )
 
 	# Test a reformat on an image with a data window that is different to the display window.
@@ -191,3 +194,58 @@ class ReformatTest( unittest.TestCase ) :
 		
 		self.assertEqual( r["out"]["metadata"].getValue(), c["out"]["metadata"].getValue() )
 		self.assertEqual( r["out"]["channelNames"].getValue(), c["out"]["channelNames"].getValue() )
+
+	# Test that the separable resampling matches filtering
+	# the input directly with a Sampler.
+	def testDownscaleMatchesSampler( self ) :
+
+		imageNode = GafferImageTest.rampImage( 200 )
+		dataWindow = imageNode["out"]["dataWindow"].getValue()
+
+		reformat = GafferImage.Reformat()
+		reformat["in"].setInput( imageNode["out"] )
+		reformat["format"].setValue( GafferImage.Format( 50, 50, 1. ) )
+
+		tileSize = GafferImage.ImagePlug.tileSize()
+		for filterName in ( "Bilinear", "Lanczos", "Mitchell" ) :
+
+			reformat["filter"].setValue( filterName )
+
+			f = GafferImage.Filter.create( filterName )
+			f.setScale( 4 )
+			sampler = GafferImage.Sampler( imageNode["out"], "R", dataWindow, f, GafferImage.BoundingMode.Clamp )
+
+			c = Gaffer.Context()
+			c["image:channelName"] = "R"
+			c["image:tileOrigin"] = IECore.V2i( 0 )
+			with c :
+				for x, y in [ ( 0, 0 ), ( 10, 20 ), ( 25, 49 ), ( 49, 3 ), ( 31, 32 ) ] :
+					tileOrigin = GafferImage.ImagePlug.tileOrigin( IECore.V2i( x, y ) )
+					tile = reformat["out"].channelData( "R", tileOrigin )
+					value = tile[ ( y - tileOrigin.y ) * tileSize + x - tileOrigin.x ]
+					self.assertAlmostEqual( value, sampler.sample( ( x + 0.5 ) * 4, ( y + 0.5 ) * 4 ), 4 )
+
+	# Test that the normalised weights of both passes preserve
+	# constant values everywhere, including near the edges where
+	# the taps are clamped to the data window.
+	def testLargeDownscalePreservesConstants( self ) :
+
+		c = GafferImage.Constant()
+		c["format"].setValue( GafferImage.Format( 1000, 600, 1. ) )
+		c["color"].setValue( IECore.Color4f( 0.5, 0.25, 0.1, 0.5 ) )
+
+		r = GafferImage.Reformat()
+		r["in"].setInput( c["out"] )
+		r["format"].setValue( GafferImage.Format( 250, 150, 1. ) )
+
+		for filterName in ( "Bilinear", "Lanczos" ) :
+
+			r["filter"].setValue( filterName )
+			image = r["out"].image()
+			for i, channelName in enumerate( "RGBA" ) :
+				expected = c["color"].getValue()[i]
+				for value in image[channelName].data :
+					self.assertAlmostEqual( value, expected, 5 )
+
+if __name__ == "__main__":
+	unittest.main()
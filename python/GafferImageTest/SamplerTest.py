@@ -39,6 +39,7 @@ import unittest
 import IECore
 import Gaffer
 import GafferImage
+import GafferImageTest
 import os
 
 class SamplerTest( unittest.TestCase ) :
@@ -194,6 +195,54 @@ class SamplerTest( unittest.TestCase ) :
 					self.__testHashOfBounds( sampleBox, "R", r["out"] )
 
 
+	# Test that filtered samples match a straightforward evaluation of the
+	# filter, including samples whose kernels straddle tile boundaries and
+	# the edges of the sample window.
+	def testFilteredSampleMatchesReference( self ) :
+
+		imageNode = GafferImageTest.rampImage( 150 )
+		dataWindow = imageNode["out"]["dataWindow"].getValue()
+
+		tileSize = GafferImage.ImagePlug.tileSize()
+		positions = [
+			( 10.25, 20.75 ),
+			( tileSize - 0.3, tileSize + 0.6 ),
+			( tileSize + 0.5, tileSize - 1.5 ),
+			( 0.5, 0.5 ),
+			( 1.2, 148.9 ),
+			( 149.5, 75.1 ),
+		]
+
+		c = Gaffer.Context()
+		c["image:channelName"] = "R"
+		c["image:tileOrigin"] = IECore.V2i( 0 )
+		with c :
+
+			for mode in ( GafferImage.BoundingMode.Black, GafferImage.BoundingMode.Clamp ) :
+
+				pixelSampler = GafferImage.Sampler( imageNode["out"], "R", dataWindow, GafferImage.Filter.create( "Box" ), mode )
+				for filterName in ( "Bilinear", "Lanczos", "Mitchell", "Cubic", "Sinc" ) :
+					for scale in ( 1.0, 2.5 ) :
+
+						f = GafferImage.Filter.create( filterName )
+						f.setScale( scale )
+						sampler = GafferImage.Sampler( imageNode["out"], "R", dataWindow, f, mode )
+
+						for x, y in positions :
+
+							tapX = f.tap( x )
+							tapY = f.tap( y )
+							weightedSum = 0.0
+							expected = 0.0
+							for j in range( 0, f.width() ) :
+								for i in range( 0, f.width() ) :
+									w = f.weight( x, tapX + i ) * f.weight( y, tapY + j )
+									weightedSum += w
+									expected += w * pixelSampler.sample( tapX + i + 0.5, tapY + j + 0.5 )
+							expected = expected / weightedSum if weightedSum else 0
+
+							self.assertAlmostEqual( sampler.sample( x, y ), expected, 5 )
+
 	# A private method that acumulates the hashes of the tiles within
 	# a box and compares them to the hash returned by the sampler.
 	def __testHashOfBounds( self, box, channel, plug ) :
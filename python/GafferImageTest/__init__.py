@@ -37,6 +37,8 @@
 
 from _GafferImageTest import *
 
+from RampImage import rampImage
+
 from ImagePlugTest import ImagePlugTest
 from ImageReaderTest import ImageReaderTest
 from OpenColorIOTest import OpenColorIOTest
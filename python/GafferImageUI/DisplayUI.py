@@ -105,19 +105,23 @@ def __scheduleUpdate( plug, force = False ) :
 	GafferUI.EventLoop.executeOnUIThread( lambda : __update( plug ) )
 
 def __update( plug ) :
-	
+
+	# we must remove the plug from the pending list before we trigger the
+	# update, otherwise data arriving after the update but before the removal
+	# would be ignored by __scheduleUpdate() and never displayed.
+
+	global __plugsPendingUpdate
+	global __plugsPendingUpdateLock
+	with __plugsPendingUpdateLock :
+		__plugsPendingUpdate = [ p for p in __plugsPendingUpdate if not p.isSame( plug ) ]
+
 	# it's possible that this function can get called on a plug whose node has
 	# been deleted, so we always check if the node exists:
-	
+
 	node = plug.node()
 	if node:
 		updateCountPlug = node["__updateCount"]
 		updateCountPlug.setValue( updateCountPlug.getValue() + 1 )
 
-	global __plugsPendingUpdate
-	global __plugsPendingUpdateLock
-	with __plugsPendingUpdateLock :
-		__plugsPendingUpdate = [ p for p in __plugsPendingUpdate if not p.isSame( plug ) ]
-
 __displayDataReceivedConnection = GafferImage.Display.dataReceivedSignal().connect( __scheduleUpdate )
 __displayImageReceivedConnection = GafferImage.Display.imageReceivedSignal().connect( IECore.curry( __scheduleUpdate, force = True ) )
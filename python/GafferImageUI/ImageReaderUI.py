@@ -72,6 +72,31 @@ Gaffer.Metadata.registerNode(
 
 		],
 
+		"subimage" : [
+
+			"description",
+			"""
+			The subimage to be read from files which contain
+			several, such as multi-part EXRs.
+			""",
+
+		],
+
+		"mipLevel" : [
+
+			"description",
+			"""
+			The mip level to be read from mipmapped files, with
+			0 being full resolution and each subsequent level
+			halving it. Levels beyond those available in the
+			file are clamped to the lowest resolution available.
+			Any proxy level requested by the Viewer is added to
+			this when reading pixels, but the image keeps the
+			format and data window of this level.
+			""",
+
+		],
+
 	}
 
 )
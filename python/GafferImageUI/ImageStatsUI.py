@@ -46,8 +46,8 @@ Gaffer.Metadata.registerNode(
 	"description",
 	"""
 	Calculates minimum, maximum and average colours for a region of
-	an image. These outputs can then be used to drive other plugs
-	within the node graph.
+	an image, along with a histogram and a percentile. These outputs
+	can then be used to drive other plugs within the node graph.
 	""",
 
 	plugs = {
@@ -110,6 +110,64 @@ Gaffer.Metadata.registerNode(
 
 		],
 
+		"histogramRange" : [
+
+			"description",
+			"""
+			The range of values covered by the histogram. Values outside
+			the range are counted in the first or last bin.
+			""",
+
+			"nodule:type", "",
+
+		],
+
+		"histogramBins" : [
+
+			"description",
+			"""
+			The number of bins in the histogram.
+			""",
+
+			"nodule:type", "",
+
+		],
+
+		"percentile" : [
+
+			"description",
+			"""
+			The percentile output by the percentileValue plug, in
+			the range 0-100. A value of 50 gives the median.
+			""",
+
+			"nodule:type", "",
+
+		],
+
+		"histogram" : [
+
+			"description",
+			"""
+			The per-channel histograms computed from the input image region,
+			keyed by channel name.
+			""",
+
+			"nodule:type", "",
+
+		],
+
+		"percentileValue" : [
+
+			"description",
+			"""
+			The per-channel values below which the chosen percentage of the
+			pixels in the region fall. These are interpolated from the histogram,
+			so their accuracy is limited by the width of the histogram bins.
+			""",
+
+		],
+
 	}
 
 )
@@ -90,7 +90,19 @@ Gaffer.Metadata.registerNode(
 			"presetNames", __colorSpacePresetNames,
 			"presetValues", __colorSpacePresetValues,
 
-		]
+		],
+
+		"bakedLUT" : [
+
+			"description",
+			"""
+			Applies the transform using a 3D LUT baked
+			from the OpenColorIO processor. This is faster
+			but less accurate than applying the transform
+			directly, and is intended for viewing purposes.
+			""",
+
+		],
 
 	}
 
@@ -35,6 +35,8 @@
 ##########################################################################
 
 import unittest
+import threading
+import time
 
 import IECore
 
@@ -45,6 +47,48 @@ import GafferUITest
 import GafferImage
 import GafferImageUI
 
+# A node which is slow to compute, and which is recomputed for
+# every tile, so that we can track the background computation
+# performed by the ImageView.
+class SlowNode( Gaffer.ComputeNode ) :
+
+	def __init__( self, name = "SlowNode" ) :
+
+		Gaffer.ComputeNode.__init__( self, name )
+
+		self["in"] = Gaffer.FloatPlug()
+		self["out"] = Gaffer.FloatPlug( direction = Gaffer.Plug.Direction.Out )
+
+		self.numComputeCalls = 0
+		self.numComputesInFlight = 0
+		self.__lock = threading.Lock()
+
+	def affects( self, input ) :
+
+		if input.isSame( self["in"] ) :
+			return [ self["out"] ]
+
+		return []
+
+	def hash( self, output, context, h ) :
+
+		self["in"].hash( h )
+		h.append( context.get( "image:tileOrigin", IECore.V2i( 0 ) ) )
+
+	def compute( self, plug, context ) :
+
+		with self.__lock :
+			self.numComputesInFlight += 1
+
+		time.sleep( 0.01 )
+		plug.setValue( self["in"].getValue() )
+
+		with self.__lock :
+			self.numComputesInFlight -= 1
+			self.numComputeCalls += 1
+
+IECore.registerRunTimeTyped( SlowNode, typeName = "GafferImageUITest::SlowNode" )
+
 class ImageViewTest( GafferUITest.TestCase ) :
 
 	def testFactory( self ) :
@@ -87,6 +131,83 @@ class ImageViewTest( GafferUITest.TestCase ) :
 
 		view._update()
 
+	def __viewSlowImage( self, script ) :
+
+		script["slow"] = SlowNode()
+		script["constant"] = GafferImage.Constant()
+		script["constant"]["format"].setValue( GafferImage.Format( 512, 512, 1 ) )
+		script["constant"]["color"]["r"].setInput( script["slow"]["out"] )
+
+		view = GafferUI.View.create( script["constant"]["out"] )
+		view.setContext( script.context() )
+		view._update()
+
+		with GafferUI.Window() as window :
+			GafferUI.GadgetWidget( view.viewportGadget() )
+
+		window.setVisible( True )
+
+		return view, window
+
+	def __waitForTiles( self, view, node ) :
+
+		# Run the event loop until the background computations have
+		# settled, so that all the visible tiles are up to date.
+		numComputeCalls = -1
+		for i in range( 0, 1000 ) :
+			view._update()
+			self.waitForIdle( 10 )
+			time.sleep( 0.05 )
+			if node.numComputesInFlight == 0 and node.numComputeCalls == numComputeCalls :
+				return
+			numComputeCalls = node.numComputeCalls
+
+	def testTilesInvalidatedOnDirty( self ) :
+
+		s = Gaffer.ScriptNode()
+		view, window = self.__viewSlowImage( s )
+
+		self.__waitForTiles( view, s["slow"] )
+		numComputeCalls = s["slow"].numComputeCalls
+		self.assertTrue( numComputeCalls > 0 )
+
+		# Edits which don't affect the image shouldn't
+		# cause any tiles to be recomputed.
+
+		s["unrelated"] = GafferTest.AddNode()
+		s["unrelated"]["op1"].setValue( 1 )
+		self.__waitForTiles( view, s["slow"] )
+		self.assertEqual( s["slow"].numComputeCalls, numComputeCalls )
+
+		# But dirtying the image should.
+
+		s["slow"]["in"].setValue( 0.5 )
+		self.__waitForTiles( view, s["slow"] )
+		self.assertTrue( s["slow"].numComputeCalls > numComputeCalls )
+
+	def testBackgroundComputationCancelledOnDirty( self ) :
+
+		s = Gaffer.ScriptNode()
+		view, window = self.__viewSlowImage( s )
+
+		# We're editing on the UI thread, so the view cancels its
+		# computations before the edit returns.
+
+		numComputesInFlight = []
+		for i in range( 0, 20 ) :
+			view._update()
+			self.waitForIdle( 10 )
+			s["slow"]["in"].setValue( i / 20.0 )
+			numComputesInFlight.append( s["slow"].numComputesInFlight )
+
+		self.assertEqual( max( numComputesInFlight ), 0 )
+
+		# And the cancelled tiles must still be computed eventually.
+
+		numComputeCalls = s["slow"].numComputeCalls
+		self.__waitForTiles( view, s["slow"] )
+		self.assertTrue( s["slow"].numComputeCalls > numComputeCalls )
+
 if __name__ == "__main__":
 	unittest.main()
 
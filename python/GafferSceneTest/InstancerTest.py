@@ -35,6 +35,8 @@
 #
 ##########################################################################
 
+import threading
+
 import IECore
 
 import Gaffer
@@ -159,6 +161,46 @@ class InstancerTest( GafferSceneTest.SceneTestCase ) :
 
 		GafferSceneTest.traverseScene( instancer["out"] )
 
+	def testBoundThreading( self ) :
+
+		# The bound is computed with a parallel reduction over all the
+		# instances. Request it from many threads at once, with each
+		# request triggering a fresh computation, to check that threads
+		# waiting on one another can't deadlock.
+
+		script = Gaffer.ScriptNode()
+
+		script["plane"] = GafferScene.Plane()
+		script["plane"]["divisions"].setValue( IECore.V2i( 100 ) )
+
+		script["sphere"] = GafferScene.Sphere()
+
+		script["instancer"] = GafferScene.Instancer()
+		script["instancer"]["in"].setInput( script["plane"]["out"] )
+		script["instancer"]["instance"].setInput( script["sphere"]["out"] )
+		script["instancer"]["parent"].setValue( "/plane" )
+
+		for radius in range( 1, 6 ) :
+
+			script["sphere"]["radius"].setValue( radius )
+
+			bounds = []
+			def f() :
+				bounds.append( script["instancer"]["out"].bound( "/plane" ) )
+
+			threads = [ threading.Thread( target = f ) for i in range( 0, 10 ) ]
+			for t in threads :
+				t.start()
+			for t in threads :
+				t.join()
+
+			self.assertEqual( len( bounds ), 10 )
+			for b in bounds :
+				self.assertEqual( b, bounds[0] )
+			self.assertEqual( bounds[0].size().z, radius * 2 )
+
+			GafferSceneTest.traverseScene( script["instancer"]["out"] )
+
 	def testNamePlugDefaultValue( self ) :
 
 		n = GafferScene.Instancer()
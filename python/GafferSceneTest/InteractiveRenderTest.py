@@ -0,0 +1,175 @@
+##########################################################################
+#
+#  Copyright (c) 2015, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#      * Redistributions of source code must retain the above
+#        copyright notice, this list of conditions and the following
+#        disclaimer.
+#
+#      * Redistributions in binary form must reproduce the above
+#        copyright notice, this list of conditions and the following
+#        disclaimer in the documentation and/or other materials provided with
+#        the distribution.
+#
+#      * Neither the name of John Haddon nor the names of
+#        any other contributors to this software may be used to endorse or
+#        promote products derived from this software without specific prior
+#        written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+import unittest
+
+import IECore
+
+import Gaffer
+import GafferScene
+import GafferSceneTest
+
+class InteractiveRenderTest( GafferSceneTest.SceneTestCase ) :
+
+	def __edits( self, render, type ) :
+
+		return [ c for c in render.log() if c["call"].value == "editBegin" and c["type"].value == type ]
+
+	def __editedScopes( self, render, type ) :
+
+		return set( [ c["scope"].value for c in self.__edits( render, type ) ] )
+
+	def testTransformEditsSendFullTransformToDescendants( self ) :
+
+		s = Gaffer.ScriptNode()
+		s["s"] = GafferScene.Sphere()
+		s["s"]["transform"]["translate"]["y"].setValue( 2 )
+		s["g"] = GafferScene.Group()
+		s["g"]["in"].setInput( s["s"]["out"] )
+
+		s["r"] = GafferSceneTest.TestInteractiveRender()
+		s["r"]["in"].setInput( s["g"]["out"] )
+		s["r"]["state"].setValue( GafferScene.InteractiveRender.State.Running )
+
+		s["r"].clearLog()
+		s["g"]["transform"]["translate"]["x"].setValue( 3 )
+
+		self.assertEqual( self.__editedScopes( s["r"], "transform" ), set( [ "/group", "/group/sphere" ] ) )
+
+		log = list( s["r"].log() )
+		transforms = {}
+		for i, c in enumerate( log ) :
+			if c["call"].value == "editBegin" and c["type"].value == "transform" :
+				self.assertEqual( log[i+1]["call"].value, "setTransform" )
+				transforms[c["scope"].value] = log[i+1]["transform"].value
+
+		self.assertEqual( transforms["/group"], IECore.M44f.createTranslated( IECore.V3f( 3, 0, 0 ) ) )
+		self.assertEqual( transforms["/group/sphere"], IECore.M44f.createTranslated( IECore.V3f( 3, 2, 0 ) ) )
+
+		# Editing the sphere alone shouldn't touch the group.
+
+		s["r"].clearLog()
+		s["s"]["transform"]["translate"]["y"].setValue( 4 )
+		self.assertEqual( self.__editedScopes( s["r"], "transform" ), set( [ "/group/sphere" ] ) )
+
+		# And disabling transform updates should send nothing.
+
+		s["r"]["updateTransforms"].setValue( False )
+		s["r"].clearLog()
+		s["g"]["transform"]["translate"]["x"].setValue( 4 )
+		self.assertEqual( self.__editedScopes( s["r"], "transform" ), set() )
+
+	def testObjectEdits( self ) :
+
+		s = Gaffer.ScriptNode()
+		s["s"] = GafferScene.Sphere()
+		s["g"] = GafferScene.Group()
+		s["g"]["in"].setInput( s["s"]["out"] )
+
+		s["r"] = GafferSceneTest.TestInteractiveRender()
+		s["r"]["in"].setInput( s["g"]["out"] )
+		s["r"]["state"].setValue( GafferScene.InteractiveRender.State.Running )
+
+		s["r"].clearLog()
+		s["s"]["radius"].setValue( 2 )
+
+		self.assertEqual( self.__editedScopes( s["r"], "object" ), set( [ "/group/sphere" ] ) )
+		self.assertEqual( self.__editedScopes( s["r"], "transform" ), set() )
+
+	def testNoEditsForNewLocations( self ) :
+
+		s = Gaffer.ScriptNode()
+		s["s"] = GafferScene.Sphere()
+		s["p"] = GafferScene.Plane()
+		s["g"] = GafferScene.Group()
+		s["g"]["in"].setInput( s["s"]["out"] )
+
+		s["r"] = GafferSceneTest.TestInteractiveRender()
+		s["r"]["in"].setInput( s["g"]["out"] )
+		s["r"]["state"].setValue( GafferScene.InteractiveRender.State.Running )
+
+		# The plane has never been output to the renderer, so
+		# it would be an error to send edits for it.
+
+		s["r"].clearLog()
+		s["g"]["in1"].setInput( s["p"]["out"] )
+		s["p"]["dimensions"]["x"].setValue( 2 )
+		s["g"]["transform"]["translate"]["x"].setValue( 1 )
+
+		for type in ( "attribute", "transform", "object" ) :
+			self.assertFalse( "/group/plane" in self.__editedScopes( s["r"], type ) )
+
+		# Until the render is restarted.
+
+		s["r"]["state"].setValue( GafferScene.InteractiveRender.State.Stopped )
+		s["r"]["state"].setValue( GafferScene.InteractiveRender.State.Running )
+
+		s["r"].clearLog()
+		s["p"]["dimensions"]["x"].setValue( 3 )
+		self.assertEqual( self.__editedScopes( s["r"], "object" ), set( [ "/group/plane" ] ) )
+
+	def testReconnectionUpstreamOfDot( self ) :
+
+		s = Gaffer.ScriptNode()
+		s["s1"] = GafferScene.Sphere()
+		s["s2"] = GafferScene.Sphere()
+		s["s2"]["radius"].setValue( 2 )
+
+		s["d"] = Gaffer.Dot()
+		s["d"].setup( s["s1"]["out"] )
+		s["d"]["in"].setInput( s["s1"]["out"] )
+
+		s["r"] = GafferSceneTest.TestInteractiveRender()
+		s["r"]["in"].setInput( s["d"]["out"] )
+		s["r"]["state"].setValue( GafferScene.InteractiveRender.State.Running )
+
+		# Reconnecting the Dot doesn't change the input to the
+		# render, but the render must still follow it.
+
+		s["r"].clearLog()
+		s["d"]["in"].setInput( s["s2"]["out"] )
+		self.assertEqual( self.__editedScopes( s["r"], "object" ), set( [ "/sphere" ] ) )
+
+		s["r"].clearLog()
+		s["s2"]["radius"].setValue( 3 )
+		self.assertEqual( self.__editedScopes( s["r"], "object" ), set( [ "/sphere" ] ) )
+
+		s["r"].clearLog()
+		s["s1"]["radius"].setValue( 3 )
+		self.assertEqual( self.__editedScopes( s["r"], "object" ), set() )
+
+if __name__ == "__main__":
+	unittest.main()
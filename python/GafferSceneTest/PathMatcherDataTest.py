@@ -95,5 +95,20 @@ class PathMatcherDataTest( unittest.TestCase ) :
 
 		self.assertNotEqual( d1.hash(), d2.hash() )
 
+	def testSaveAndLoad( self ) :
+
+		for paths in [ [], [ "/a", "/a/b/c", "/d" ] ] :
+
+			d = GafferScene.PathMatcherData( GafferScene.PathMatcher( paths ) )
+
+			io = IECore.MemoryIndexedIO( IECore.CharVectorData(), [], IECore.IndexedIO.OpenMode.Write )
+			d.save( io, "d" )
+
+			io = IECore.MemoryIndexedIO( io.buffer(), [], IECore.IndexedIO.OpenMode.Read )
+			d2 = IECore.Object.load( io, "d" )
+
+			self.assertEqual( d2, d )
+			self.assertEqual( d2.hash(), d.hash() )
+
 if __name__ == "__main__":
 	unittest.main()
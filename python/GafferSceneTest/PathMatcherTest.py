@@ -739,5 +739,79 @@ class PathMatcherTest( unittest.TestCase ) :
 
 		GafferSceneTest.testPathMatcherIteratorPrune()
 
+	def testCopiesAreIndependent( self ) :
+
+		m = GafferScene.PathMatcher( [ "/a/b/c", "/a/b/d", "/e/f" ] )
+		original = m.paths()
+
+		def assertUnchanged() :
+			self.assertEqual( sorted( m.paths() ), sorted( original ) )
+
+		m2 = GafferScene.PathMatcher( m )
+		self.assertEqual( m2, m )
+
+		self.assertTrue( m2.addPath( "/a/b/c/g" ) )
+		self.assertFalse( m2.addPath( "/a/b/c" ) )
+		assertUnchanged()
+		self.assertEqual( m2.match( "/a/b/c/g" ), GafferScene.Filter.Result.ExactMatch )
+		self.assertEqual( m.match( "/a/b/c/g" ), GafferScene.Filter.Result.AncestorMatch )
+
+		self.assertTrue( m2.removePath( "/a/b/d" ) )
+		assertUnchanged()
+
+		self.assertTrue( m2.prune( "/a" ) )
+		assertUnchanged()
+		self.assertEqual( m2.paths(), [ "/e/f" ] )
+
+		m3 = GafferScene.PathMatcher( m )
+		self.assertTrue( m3.removePaths( m ) )
+		self.assertTrue( m3.isEmpty() )
+		assertUnchanged()
+
+		m3.clear()
+		self.assertTrue( m3.addPaths( m ) )
+		self.assertEqual( m3, m )
+		self.assertTrue( m3.addPath( "/a/h" ) )
+		assertUnchanged()
+
+		# Subtrees added with addPaths() are shared with
+		# the source, so must be unaffected by later edits
+		# to either matcher.
+		m4 = GafferScene.PathMatcher( [ "/x" ] )
+		self.assertTrue( m4.addPaths( m ) )
+		self.assertFalse( m4.addPaths( m ) )
+		self.assertTrue( m4.prune( "/a/b/c" ) )
+		self.assertTrue( m4.removePath( "/e/f" ) )
+		assertUnchanged()
+		self.assertEqual( sorted( m4.paths() ), [ "/a/b/d", "/x" ] )
+
+		self.assertTrue( m.addPath( "/a/b/z" ) )
+		self.assertEqual( sorted( m4.paths() ), [ "/a/b/d", "/x" ] )
+
+		self.assertTrue( m4.removePaths( m ) )
+		self.assertEqual( m4.paths(), [ "/x" ] )
+		self.assertFalse( m4.removePaths( m ) )
+
+	def testCopyAndModifyLargeMatcher( self ) :
+
+		# Typical of a selection update, where a large set is
+		# copied and then modified slightly. Each copy must see
+		# only its own modification.
+
+		paths = self.generatePaths( seed = 10, depthRange = ( 3, 14 ), numChildrenRange = ( 2, 6 ) )
+		matcher = GafferScene.PathMatcher( paths )
+
+		for i in range( 0, 100 ) :
+			m = GafferScene.PathMatcher( matcher )
+			path = paths[i % len( paths )].copy()
+			path.append( "new" )
+			self.assertTrue( m.addPath( path ) )
+			self.assertEqual( m.match( path ), GafferScene.Filter.Result.ExactMatch )
+			self.assertFalse( matcher.match( path ) & GafferScene.Filter.Result.ExactMatch )
+			self.assertTrue( m.removePath( path ) )
+			self.assertEqual( m, matcher )
+
+		self.assertEqual( matcher, GafferScene.PathMatcher( paths ) )
+
 if __name__ == "__main__":
 	unittest.main()
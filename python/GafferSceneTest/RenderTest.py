@@ -35,6 +35,8 @@
 ##########################################################################
 
 import unittest
+import threading
+import subprocess32 as subprocess
 
 import IECore
 
@@ -42,6 +44,37 @@ import Gaffer
 import GafferScene
 import GafferSceneTest
 
+# Records the threads on which it is computed. The
+# result varies with the instance id, so that it is
+# recomputed for every instance.
+class ThreadRecorder( Gaffer.ComputeNode ) :
+
+	def __init__( self, name = "ThreadRecorder" ) :
+
+		Gaffer.ComputeNode.__init__( self, name )
+
+		self["out"] = Gaffer.FloatPlug( direction = Gaffer.Plug.Direction.Out )
+
+		self.threads = set()
+		self.__lock = threading.Lock()
+
+	def affects( self, input ) :
+
+		return []
+
+	def hash( self, output, context, h ) :
+
+		h.append( context.get( "instancer:id", 0 ) )
+
+	def compute( self, plug, context ) :
+
+		with self.__lock :
+			self.threads.add( threading.current_thread().ident )
+
+		plug.setValue( 1 + context.get( "instancer:id", 0 ) * 0.001 )
+
+IECore.registerRunTimeTyped( ThreadRecorder, typeName = "GafferSceneTest::ThreadRecorder" )
+
 class RenderTest( GafferSceneTest.SceneTestCase ) :
 
 	def __allState( self, group, type, state=None ) :
@@ -253,6 +286,146 @@ class RenderTest( GafferSceneTest.SceneTestCase ) :
 
 		self.assertEqual( s["r"].world().state()[0].attributes["doubleSided"], IECore.BoolData( False ) )
 
+	def __names( self, group, names=None ) :
+
+		if names is None :
+			names = []
+
+		for s in group.state() :
+			if isinstance( s, IECore.AttributeState ) and "name" in s.attributes :
+				names.append( s.attributes["name"].value )
+
+		for child in group.children() :
+			if isinstance( child, IECore.Group ) :
+				self.__names( child, names )
+
+		return names
+
+	def testWorldOutput( self ) :
+
+		s = Gaffer.ScriptNode()
+
+		s["p"] = GafferScene.Plane()
+		s["s"] = GafferScene.Sphere()
+		s["s"]["transform"]["translate"].setValue( IECore.V3f( 1, 2, 3 ) )
+
+		s["g"] = GafferScene.Group()
+		s["g"]["in"].setInput( s["p"]["out"] )
+		s["g"]["in1"].setInput( s["s"]["out"] )
+
+		s["f"] = GafferScene.PathFilter()
+		s["f"]["paths"].setValue( IECore.StringVectorData( [ "/group/plane" ] ) )
+
+		s["a"] = GafferScene.StandardAttributes()
+		s["a"]["in"].setInput( s["g"]["out"] )
+		s["a"]["filter"].setInput( s["f"]["match"] )
+
+		s["o"] = GafferScene.StandardOptions()
+		s["o"]["in"].setInput( s["a"]["out"] )
+
+		s["r"] = GafferSceneTest.TestRender()
+		s["r"]["in"].setInput( s["o"]["out"] )
+
+		# CapturingRenderer outputs some spurious errors which
+		# we suppress by capturing them.
+		with IECore.CapturingMessageHandler() :
+			s["r"].execute()
+
+		self.assertEqual( self.__names( s["r"].world() ), [ "/", "/group", "/group/plane", "/group/sphere" ] )
+
+		# The hierarchy should be reflected in the nesting of attribute blocks.
+
+		root = s["r"].world().children()[0]
+		group = root.children()[0]
+		self.assertEqual( len( group.children() ), 2 )
+		self.assertTrue( isinstance( group.children()[0].children()[0], IECore.MeshPrimitive ) )
+		self.assertTrue( isinstance( group.children()[1].children()[0], IECore.SpherePrimitive ) )
+		self.assertEqual( group.children()[1].getTransform().transform(), IECore.M44f.createTranslated( IECore.V3f( 1, 2, 3 ) ) )
+
+		# Invisible locations shouldn't be output, and the thread count
+		# shouldn't affect the result.
+
+		s["a"]["attributes"]["visibility"]["enabled"].setValue( True )
+		s["a"]["attributes"]["visibility"]["value"].setValue( False )
+		s["o"]["options"]["translationThreads"]["enabled"].setValue( True )
+
+		for threads in ( 1, 2, 0 ) :
+			s["o"]["options"]["translationThreads"]["value"].setValue( threads )
+			with IECore.CapturingMessageHandler() :
+				s["r"].execute()
+			self.assertEqual( self.__names( s["r"].world() ), [ "/", "/group", "/group/sphere" ] )
+
+	def testTranslationThreads( self ) :
+
+		s = Gaffer.ScriptNode()
+
+		s["p"] = GafferScene.Plane()
+		s["p"]["divisions"].setValue( IECore.V2i( 20 ) )
+
+		s["t"] = ThreadRecorder()
+		s["s"] = GafferScene.Sphere()
+		s["s"]["radius"].setInput( s["t"]["out"] )
+
+		s["i"] = GafferScene.Instancer()
+		s["i"]["in"].setInput( s["p"]["out"] )
+		s["i"]["instance"].setInput( s["s"]["out"] )
+		s["i"]["parent"].setValue( "/plane" )
+
+		s["o"] = GafferScene.StandardOptions()
+		s["o"]["in"].setInput( s["i"]["out"] )
+		s["o"]["options"]["translationThreads"]["enabled"].setValue( True )
+		s["o"]["options"]["translationThreads"]["value"].setValue( 2 )
+
+		s["r"] = GafferSceneTest.TestRender()
+		s["r"]["in"].setInput( s["o"]["out"] )
+
+		# Do some parallel work first, so that this thread already has
+		# a task scheduler with the default number of threads.
+		GafferSceneTest.traverseScene( s["p"]["out"] )
+
+		with IECore.CapturingMessageHandler() :
+			s["r"].execute()
+
+		# The instances should have been computed by at most two threads,
+		# regardless of the number of threads in the existing scheduler.
+		self.assertTrue( len( s["t"].threads ) >= 1 )
+		self.assertTrue( len( s["t"].threads ) <= 2 )
+
+	def testSingleThreadedScheduler( self ) :
+
+		# There are no TBB worker threads at all when the scheduler is
+		# limited to a single thread, so the render must not depend on
+		# them to make progress. We run it in a separate process, as the
+		# scheduler for this one has already been initialised.
+
+		s = Gaffer.ScriptNode()
+
+		s["p"] = GafferScene.Plane()
+		s["p"]["divisions"].setValue( IECore.V2i( 10 ) )
+
+		s["s"] = GafferScene.Sphere()
+
+		s["i"] = GafferScene.Instancer()
+		s["i"]["in"].setInput( s["p"]["out"] )
+		s["i"]["instance"].setInput( s["s"]["out"] )
+		s["i"]["parent"].setValue( "/plane" )
+
+		s["r"] = GafferSceneTest.TestRender()
+		s["r"]["in"].setInput( s["i"]["out"] )
+
+		s["fileName"].setValue( "/tmp/test.gfr" )
+		s.save()
+
+		p = subprocess.Popen(
+			"gaffer execute -threads 1 /tmp/test.gfr -nodes r",
+			shell = True,
+			stderr = subprocess.PIPE,
+		)
+		p.wait( timeout = 60 )
+
+		self.assertEqual( "".join( p.stderr.readlines() ), "" )
+		self.failIf( p.returncode )
+
 	def testPassThrough( self ) :
 
 		s = Gaffer.ScriptNode()
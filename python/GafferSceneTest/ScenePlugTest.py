@@ -212,6 +212,136 @@ class ScenePlugTest( unittest.TestCase ) :
 		self.assertTrue( isinstance( p["set"], GafferScene.PathMatcherDataPlug ) )
 		self.assertEqual( p["set"].defaultValue(), GafferScene.PathMatcherData() )
 
+	def __deepHierarchy( self, depth, numLeaves ) :
+
+		# Makes a chain of `depth` locations, each with a
+		# transform and attributes, with `numLeaves` children
+		# at the bottom.
+
+		leaves = {}
+		for i in range( 0, numLeaves ) :
+			leaves["leaf%d" % i] = {
+				"transform" : IECore.M44fData( IECore.M44f.createTranslated( IECore.V3f( i, 0, 0 ) ) ),
+				"attributes" : { "leaf" : IECore.IntData( i ) },
+			}
+
+		location = { "children" : leaves }
+		for i in reversed( range( 0, depth ) ) :
+			location = {
+				"transform" : IECore.M44fData( IECore.M44f.createTranslated( IECore.V3f( 0, 1, 0 ) ) ),
+				"attributes" : {
+					"depth" : IECore.IntData( i ),
+					"level%d" % i : IECore.BoolData( True ),
+				},
+				"children" : { "l%d" % i : location },
+			}
+
+		n = GafferSceneTest.CompoundObjectSource()
+		n["in"].setValue( IECore.CompoundObject( { "children" : location["children"] } ) )
+
+		parentPath = "/" + "/".join( [ "l%d" % i for i in range( 0, depth ) ] )
+		return n, [ parentPath + "/leaf%d" % i for i in range( 0, numLeaves ) ]
+
+	def testFullTransformAndAttributesInDeepHierarchy( self ) :
+
+		depth = 20
+		n, leafPaths = self.__deepHierarchy( depth, 10 )
+
+		for i, path in enumerate( leafPaths ) :
+
+			self.assertEqual(
+				n["out"].fullTransform( path ),
+				IECore.M44f.createTranslated( IECore.V3f( i, depth, 0 ) )
+			)
+
+			a = n["out"].fullAttributes( path )
+			self.assertEqual( a["leaf"], IECore.IntData( i ) )
+			self.assertEqual( a["depth"], IECore.IntData( depth - 1 ) )
+			for d in range( 0, depth ) :
+				self.assertEqual( a["level%d" % d], IECore.BoolData( True ) )
+
+			# The result must be ours to modify, without
+			# affecting subsequent queries.
+			del a["depth"]
+			self.assertTrue( "depth" in n["out"].fullAttributes( path ) )
+
+		# Hashes must differ wherever the values do.
+		self.assertNotEqual( n["out"].fullTransformHash( leafPaths[0] ), n["out"].fullTransformHash( leafPaths[1] ) )
+		self.assertNotEqual( n["out"].fullAttributesHash( leafPaths[0] ), n["out"].fullAttributesHash( leafPaths[1] ) )
+		self.assertNotEqual( n["out"].fullTransformHash( leafPaths[0] ), n["out"].fullTransformHash( leafPaths[0].rpartition( "/" )[0] ) )
+
+	def testFullTransformUpdatesAfterEdits( self ) :
+
+		n, leafPaths = self.__deepHierarchy( 10, 2 )
+
+		h = n["out"].fullTransformHash( leafPaths[0] )
+		self.assertEqual( n["out"].fullTransform( leafPaths[0] ), IECore.M44f.createTranslated( IECore.V3f( 0, 10, 0 ) ) )
+
+		c = n["in"].getValue()
+		c["children"]["l0"]["transform"] = IECore.M44fData( IECore.M44f.createTranslated( IECore.V3f( 0, 2, 0 ) ) )
+		n["in"].setValue( c )
+
+		self.assertNotEqual( n["out"].fullTransformHash( leafPaths[0] ), h )
+		self.assertEqual( n["out"].fullTransform( leafPaths[0] ), IECore.M44f.createTranslated( IECore.V3f( 0, 11, 0 ) ) )
+
+	def testAccumulationCacheLimits( self ) :
+
+		for get, set in [
+			( GafferScene.ScenePlug.getFullTransformCacheLimit, GafferScene.ScenePlug.setFullTransformCacheLimit ),
+			( GafferScene.ScenePlug.getFullAttributesCacheLimit, GafferScene.ScenePlug.setFullAttributesCacheLimit ),
+			( GafferScene.ScenePlug.getFullHashCacheLimit, GafferScene.ScenePlug.setFullHashCacheLimit ),
+		] :
+			limit = get()
+			try :
+				set( 5 )
+				self.assertEqual( get(), 5 )
+				n, leafPaths = self.__deepHierarchy( 20, 10 )
+				for i, path in enumerate( leafPaths ) :
+					self.assertEqual(
+						n["out"].fullTransform( path ),
+						IECore.M44f.createTranslated( IECore.V3f( i, 20, 0 ) )
+					)
+					self.assertEqual( n["out"].fullAttributes( path )["leaf"], IECore.IntData( i ) )
+			finally :
+				set( limit )
+			self.assertEqual( get(), limit )
+
+	def testAccumulatedHashesSurviveUnrelatedEdits( self ) :
+
+		n, leafPaths = self.__deepHierarchy( 10, 100 )
+
+		hashes = [ n["out"].fullTransformHash( path ) for path in leafPaths ]
+
+		def hashCount() :
+
+			m = Gaffer.PerformanceMonitor()
+			m.setActive( True )
+			result = [ n["out"].fullTransformHash( path ) for path in leafPaths ]
+			m.setActive( False )
+
+			return result, m.plugStatistics( n["out"]["transform"] ).hashCount
+
+		# Dirtying an unrelated node shouldn't invalidate the
+		# accumulated hashes for our scene, so none of the
+		# transforms should need hashing again.
+
+		p = GafferScene.Plane()
+		p["dimensions"]["x"].setValue( 2 )
+
+		result, count = hashCount()
+		self.assertEqual( result, hashes )
+		self.assertEqual( count, 0 )
+
+		# But editing the scene itself must.
+
+		c = n["in"].getValue()
+		c["children"]["l0"]["transform"] = IECore.M44fData( IECore.M44f.createTranslated( IECore.V3f( 0, 2, 0 ) ) )
+		n["in"].setValue( c )
+
+		result, count = hashCount()
+		self.assertNotEqual( result, hashes )
+		self.assertTrue( count > 0 )
+
 if __name__ == "__main__":
 	unittest.main()
 
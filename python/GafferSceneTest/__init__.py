@@ -108,6 +108,8 @@ from PointsTypeTest import PointsTypeTest
 from ParametersTest import ParametersTest
 from SceneFilterPathFilterTest import SceneFilterPathFilterTest
 from AttributeVisualiserTest  import AttributeVisualiserTest
+from SceneMirrorTest import SceneMirrorTest
+from InteractiveRenderTest import InteractiveRenderTest
 
 if __name__ == "__main__":
 	import unittest
@@ -137,6 +137,28 @@ Gaffer.Metadata.registerNode(
 
 		],
 
+		"updateTransforms" : [
+
+			"description",
+			"""
+			When on, changes to transforms are reflected in the
+			interactive render, by sending edits for only the
+			locations which have moved.
+			""",
+
+		],
+
+		"updateObjects" : [
+
+			"description",
+			"""
+			When on, changes to objects (geometry) are reflected in
+			the interactive render, by sending edits for only the
+			locations whose objects have changed.
+			""",
+
+		],
+
 	}
 )
 
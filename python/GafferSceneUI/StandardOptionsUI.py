@@ -303,6 +303,23 @@ Gaffer.Metadata.registerNode(
 
 		],
 
+		# performance plugs
+
+		"options.translationThreads" : [
+
+			"description",
+			"""
+			The maximum number of threads used to generate
+			the scene for the renderer. A value of 0 uses
+			one thread per core. Limiting this is useful when
+			running several renders side by side on the same
+			machine.
+			""",
+
+			"layout:section", "Performance",
+
+		],
+
 	}
 
 )
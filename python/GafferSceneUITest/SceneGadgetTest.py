@@ -42,6 +42,7 @@ import GafferUI
 import GafferUITest
 import GafferScene
 import GafferSceneUI
+import GafferSceneTest
 
 class SceneGadgetTest( GafferUITest.TestCase ) :
 
@@ -153,6 +154,49 @@ class SceneGadgetTest( GafferUITest.TestCase ) :
 		self.assertObjectAt( sg, IECore.V2f( 0.5 ), None )
 		self.assertObjectsAt( sg, IECore.Box2f( IECore.V2f( 0 ), IECore.V2f( 1 ) ), [ "/group" ] )
 
+	def testSharedMirrorWithRender( self ) :
+
+		s = Gaffer.ScriptNode()
+		s["s"] = GafferScene.Sphere()
+		s["g"] = GafferScene.Group()
+		s["g"]["in"].setInput( s["s"]["out"] )
+
+		sg = GafferSceneUI.SceneGadget()
+		sg.setContext( s.context() )
+		sg.setScene( s["g"]["out"] )
+
+		with GafferUI.Window() as w :
+			gw = GafferUI.GadgetWidget( sg )
+
+		w.setVisible( True )
+		self.waitForIdle( 1000 )
+
+		gw.getViewportGadget().frame( sg.bound() )
+		self.assertObjectsAt( sg, IECore.Box2f( IECore.V2f( 0 ), IECore.V2f( 1 ) ), [ "/group" ] )
+
+		# The render shares the gadget's mirror, but must still see
+		# the whole scene even though the gadget has it collapsed.
+
+		s["r"] = GafferSceneTest.TestInteractiveRender()
+		s["r"]["in"].setInput( s["g"]["out"] )
+		s["r"]["state"].setValue( GafferScene.InteractiveRender.State.Running )
+
+		names = [ c["value"].value for c in s["r"].log() if c["call"].value == "setAttribute" and c["name"].value == "name" ]
+		self.assertTrue( "/group/sphere" in names )
+
+		s["r"].clearLog()
+		s["s"]["transform"]["translate"]["x"].setValue( 0.1 )
+
+		edits = [ c["scope"].value for c in s["r"].log() if c["call"].value == "editBegin" and c["type"].value == "transform" ]
+		self.assertTrue( "/group/sphere" in edits )
+
+		# And the render's expansion mustn't leak into the gadget.
+
+		self.waitForIdle( 1000 )
+		self.assertObjectsAt( sg, IECore.Box2f( IECore.V2f( 0 ), IECore.V2f( 1 ) ), [ "/group" ] )
+
+		s["r"]["state"].setValue( GafferScene.InteractiveRender.State.Stopped )
+
 	def testExpressions( self ) :
 
 		s = Gaffer.ScriptNode()
@@ -456,5 +456,9 @@ class ComputeNodeTest( GafferTest.TestCase ) :
 
 		GafferTest.testComputeNodeThreading()
 
+	def testChainHashThreading( self ) :
+
+		GafferTest.testComputeNodeChainHashThreading()
+
 if __name__ == "__main__":
 	unittest.main()
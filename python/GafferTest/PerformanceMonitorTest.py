@@ -0,0 +1,147 @@
+##########################################################################
+#
+#  Copyright (c) 2015, Image Engine Design Inc. All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions are
+#  met:
+#
+#      * Redistributions of source code must retain the above
+#        copyright notice, this list of conditions and the following
+#        disclaimer.
+#
+#      * Redistributions in binary form must reproduce the above
+#        copyright notice, this list of conditions and the following
+#        disclaimer in the documentation and/or other materials provided with
+#        the distribution.
+#
+#      * Neither the name of John Haddon nor the names of
+#        any other contributors to this software may be used to endorse or
+#        promote products derived from this software without specific prior
+#        written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+#  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+#  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+#  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+#  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+#  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+#  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+#  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+#  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+#  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+#  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+##########################################################################
+
+
+import unittest
+
+import IECore
+
+import Gaffer
+import GafferTest
+
+class PerformanceMonitorTest( GafferTest.TestCase ) :
+
+	def testActivation( self ) :
+
+		m1 = Gaffer.PerformanceMonitor()
+		m2 = Gaffer.PerformanceMonitor()
+		self.assertFalse( m1.getActive() )
+
+		m1.setActive( True )
+		self.assertTrue( m1.getActive() )
+		self.assertRaises( RuntimeError, m2.setActive, True )
+		self.assertFalse( m2.getActive() )
+
+		m1.setActive( False )
+		self.assertFalse( m1.getActive() )
+
+		m2.setActive( True )
+		self.assertTrue( m2.getActive() )
+		m2.setActive( False )
+
+	def testStatistics( self ) :
+
+		Gaffer.ValuePlug.setCacheMemoryLimit( 0 )
+		Gaffer.ValuePlug.setCacheMemoryLimit( self.__originalCacheMemoryLimit )
+
+		n1 = GafferTest.AddNode()
+		n2 = GafferTest.AddNode()
+		n2["op1"].setInput( n1["sum"] )
+		n1["op1"].setValue( 1 )
+
+		m = Gaffer.PerformanceMonitor()
+		m.setActive( True )
+
+		with Gaffer.Context() :
+			n2["sum"].getValue()
+			n2["sum"].getValue()
+
+		m.setActive( False )
+
+		s1 = m.plugStatistics( n1["sum"] )
+		s2 = m.plugStatistics( n2["sum"] )
+
+		self.assertEqual( s1.hashCount, 1 )
+		self.assertEqual( s2.hashCount, 1 )
+		self.assertEqual( s1.computeCount, 1 )
+		self.assertEqual( s2.computeCount, 1 )
+		self.assertEqual( s2.cacheMisses, 1 )
+		self.assertEqual( s2.cacheHits, 1 )
+		self.assertTrue( s1.cacheMemory > 0 )
+		self.assertTrue( s2.hashTime >= 0 )
+		self.assertTrue( s2.computeTime >= 0 )
+
+		c = m.combinedStatistics()
+		self.assertEqual( c.hashCount, 2 )
+		self.assertEqual( c.computeCount, 2 )
+
+		a = dict( ( p.fullName(), s ) for p, s in m.allStatistics() )
+		self.assertEqual( a[n1["sum"].fullName()], s1 )
+		self.assertEqual( a[n2["sum"].fullName()], s2 )
+
+		self.assertTrue( n2["sum"].fullName() in m.report() )
+
+		# Nothing should be recorded while inactive.
+
+		n1["op1"].setValue( 2 )
+		n2["sum"].getValue()
+		self.assertEqual( m.combinedStatistics(), c )
+
+		m.clear()
+		self.assertEqual( m.combinedStatistics(), Gaffer.PerformanceMonitor.Statistics() )
+
+	def testDeletedPlugs( self ) :
+
+		Gaffer.ValuePlug.setCacheMemoryLimit( 0 )
+		Gaffer.ValuePlug.setCacheMemoryLimit( self.__originalCacheMemoryLimit )
+
+		s = Gaffer.ScriptNode()
+		s["n"] = GafferTest.AddNode()
+		s["n"]["op1"].setValue( 10 )
+
+		m = Gaffer.PerformanceMonitor()
+		m.setActive( True )
+		with Gaffer.Context() :
+			s["n"]["sum"].getValue()
+		m.setActive( False )
+
+		# The statistics must remain valid after the
+		# node has been deleted.
+		del s["n"]
+		a = dict( ( p.getName(), st ) for p, st in m.allStatistics() )
+		self.assertEqual( a["sum"].computeCount, 1 )
+		self.assertTrue( "sum" in m.report() )
+
+	def setUp( self ) :
+
+		self.__originalCacheMemoryLimit = Gaffer.ValuePlug.getCacheMemoryLimit()
+
+	def tearDown( self ) :
+
+		Gaffer.ValuePlug.setCacheMemoryLimit( self.__originalCacheMemoryLimit )
+
+if __name__ == "__main__":
+	unittest.main()
@@ -35,6 +35,12 @@
 #
 ##########################################################################
 
+import os
+import time
+import shutil
+import tempfile
+import threading
+
 import IECore
 
 import Gaffer
@@ -271,13 +277,347 @@ class ValuePlugTest( GafferTest.TestCase ) :
 		self.assertEqual( n.numHashCalls, numHashCalls )
 		self.assertTrue( a3.isSame( a1 ) )
 
+	def testCacheStatistics( self ) :
+
+		Gaffer.ValuePlug.setCacheMemoryLimit( 0 )
+		Gaffer.ValuePlug.setCacheMemoryLimit( self.__originalCacheMemoryLimit )
+		Gaffer.ValuePlug.resetCacheStatistics()
+
+		s = Gaffer.ValuePlug.cacheStatistics()
+		self.assertEqual( s.hits, 0 )
+		self.assertEqual( s.threadHits, 0 )
+		self.assertEqual( s.misses, 0 )
+
+		n = GafferTest.CachingTestNode()
+		n["in"].setValue( "statistics" )
+
+		v1 = n["out"].getValue( _copy = False )
+		s = Gaffer.ValuePlug.cacheStatistics()
+		self.assertEqual( s.misses, 1 )
+		self.assertEqual( s.hits + s.threadHits, 0 )
+
+		v2 = n["out"].getValue( _copy = False )
+		self.assertTrue( v1.isSame( v2 ) )
+		s = Gaffer.ValuePlug.cacheStatistics()
+		self.assertEqual( s.misses, 1 )
+		self.assertEqual( s.hits + s.threadHits, 1 )
+
+		Gaffer.ValuePlug.resetCacheStatistics()
+		s = Gaffer.ValuePlug.cacheStatistics()
+		self.assertEqual( s.hits + s.threadHits + s.misses, 0 )
+
+	def testEvictedValuesAreReleased( self ) :
+
+		n = GafferTest.CachingTestNode()
+
+		n["in"].setValue( "a" )
+		a = n["out"].getValue( _copy = False )
+		self.assertTrue( a.refCount() > 1 )
+
+		# Evict "a" by computing other values, rather than by
+		# changing the limit. Neither the main cache nor the thread
+		# caches should keep it alive afterwards.
+		Gaffer.ValuePlug.setCacheMemoryLimit( a.memoryUsage() )
+		for v in "bcdefg" :
+			n["in"].setValue( v )
+			n["out"].getValue( _copy = False )
+
+		self.assertEqual( a.refCount(), 1 )
+
+	def testCacheEvictsToMemoryLimit( self ) :
+
+		n = GafferTest.CachingTestNode()
+
+		n["in"].setValue( "a" )
+		a = n["out"].getValue( _copy = False )
+
+		Gaffer.ValuePlug.setCacheMemoryLimit( a.memoryUsage() )
+		self.assertTrue( Gaffer.ValuePlug.cacheMemoryUsage() <= a.memoryUsage() )
+
+		for v in "bcdefg" :
+			n["in"].setValue( v )
+			n["out"].getValue( _copy = False )
+			self.assertTrue( Gaffer.ValuePlug.cacheMemoryUsage() <= a.memoryUsage() )
+
+	def testCheapValuesAreEvictedFirst( self ) :
+
+		class VectorNode( Gaffer.ComputeNode ) :
+
+			def __init__( self, size = 1, name = "VectorNode" ) :
+
+				Gaffer.ComputeNode.__init__( self, name )
+
+				self["in"] = Gaffer.IntPlug()
+				self["out"] = Gaffer.ObjectPlug( direction = Gaffer.Plug.Direction.Out, defaultValue = IECore.NullObject() )
+
+				self.__size = size
+
+			def affects( self, input ) :
+
+				return [ self["out"] ] if input.isSame( self["in"] ) else []
+
+			def hash( self, output, context, h ) :
+
+				self["in"].hash( h )
+				h.append( self.__size )
+
+			def compute( self, plug, context ) :
+
+				plug.setValue( IECore.IntVectorData( [ self["in"].getValue() ] * self.__size ) )
+
+		# Values from `small` take much longer to compute per byte
+		# than values from `large`, so are more expensive to evict.
+
+		small = VectorNode( 1 )
+		large = VectorNode( 10000 )
+
+		Gaffer.ValuePlug.setCacheMemoryLimit( 0 )
+		Gaffer.ValuePlug.setCacheMemoryLimit( self.__originalCacheMemoryLimit )
+
+		smallValues = []
+		largeValues = []
+		for i in range( 0, 200 ) :
+			small["in"].setValue( i )
+			large["in"].setValue( i )
+			smallValues.append( small["out"].getValue( _copy = False ) )
+			largeValues.append( large["out"].getValue( _copy = False ) )
+
+		# Halve the cache. Strict LRU eviction would remove the oldest
+		# half of both sets of values, but the small values should
+		# almost all survive at the expense of the large ones.
+
+		Gaffer.ValuePlug.setCacheMemoryLimit( Gaffer.ValuePlug.cacheMemoryUsage() / 2 )
+
+		smallCached = len( [ v for v in smallValues if v.refCount() > 1 ] )
+		largeCached = len( [ v for v in largeValues if v.refCount() > 1 ] )
+
+		self.assertTrue( smallCached > 180 )
+		self.assertTrue( largeCached < 120 )
+
+	def testPlugTypeCacheMemoryLimit( self ) :
+
+		t = Gaffer.ObjectPlug.staticTypeId()
+		self.assertEqual( Gaffer.ValuePlug.getCacheMemoryLimit( t ), Gaffer.ValuePlug.getCacheMemoryLimit() )
+
+		n = GafferTest.CachingTestNode()
+		n["in"].setValue( "typeLimit" )
+
+		Gaffer.ValuePlug.setCacheMemoryLimit( t, 0 )
+		self.assertEqual( Gaffer.ValuePlug.getCacheMemoryLimit( t ), 0 )
+		self.assertEqual( Gaffer.ValuePlug.cacheMemoryUsage( t ), 0 )
+
+		# Nothing from an ObjectPlug may be cached now.
+		v1 = n["out"].getValue( _copy = False )
+		v2 = n["out"].getValue( _copy = False )
+		self.assertEqual( v1, v2 )
+		self.assertFalse( v1.isSame( v2 ) )
+
+		# But the overall limit is unaffected, and other
+		# types are still cached.
+		self.assertEqual( Gaffer.ValuePlug.getCacheMemoryLimit(), self.__originalCacheMemoryLimit )
+		a = GafferTest.AddNode()
+		a["op1"].setValue( 1001 )
+		a["sum"].getValue()
+		self.assertTrue( Gaffer.ValuePlug.cacheMemoryUsage() > 0 )
+
+		Gaffer.ValuePlug.setCacheMemoryLimit( t, self.__originalCacheMemoryLimit )
+
+		v1 = n["out"].getValue( _copy = False )
+		v2 = n["out"].getValue( _copy = False )
+		self.assertTrue( v1.isSame( v2 ) )
+		self.assertEqual( Gaffer.ValuePlug.cacheMemoryUsage( t ), v1.memoryUsage() )
+
+	def testSharedCompute( self ) :
+
+		class SlowNode( Gaffer.ComputeNode ) :
+
+			def __init__( self, name = "SlowNode" ) :
+
+				Gaffer.ComputeNode.__init__( self, name )
+
+				self["in"] = Gaffer.StringPlug()
+				self["out"] = Gaffer.ObjectPlug( direction = Gaffer.Plug.Direction.Out, defaultValue = IECore.NullObject() )
+
+				self.numComputeCalls = 0
+
+			def affects( self, input ) :
+
+				return [ self["out"] ] if input.isSame( self["in"] ) else []
+
+			def hash( self, output, context, h ) :
+
+				self["in"].hash( h )
+
+			def compute( self, plug, context ) :
+
+				self.numComputeCalls += 1
+				time.sleep( 0.25 )
+				plug.setValue( IECore.StringData( self["in"].getValue() ) )
+
+		n = SlowNode()
+		n["in"].setValue( "shared" )
+		n["out"].setFlags( Gaffer.Plug.Flags.SharedCompute, True )
+		self.assertTrue( n["out"].getFlags( Gaffer.Plug.Flags.SharedCompute ) )
+
+		results = []
+		def f() :
+			results.append( n["out"].getValue( _copy = False ) )
+
+		threads = [ threading.Thread( target = f ) for i in range( 0, 10 ) ]
+		for t in threads :
+			t.start()
+		for t in threads :
+			t.join()
+
+		self.assertEqual( n.numComputeCalls, 1 )
+		self.assertEqual( len( results ), 10 )
+		for r in results :
+			self.assertTrue( r.isSame( results[0] ) )
+
+	def testDiskCache( self ) :
+
+		class CountingNode( Gaffer.ComputeNode ) :
+
+			def __init__( self, name = "CountingNode" ) :
+
+				Gaffer.ComputeNode.__init__( self, name )
+
+				self["in"] = Gaffer.StringPlug()
+				self["out"] = Gaffer.ObjectPlug( direction = Gaffer.Plug.Direction.Out, defaultValue = IECore.NullObject() )
+
+				self.numComputeCalls = 0
+
+			def affects( self, input ) :
+
+				return [ self["out"] ] if input.isSame( self["in"] ) else []
+
+			def hash( self, output, context, h ) :
+
+				self["in"].hash( h )
+
+			def compute( self, plug, context ) :
+
+				self.numComputeCalls += 1
+				plug.setValue( IECore.StringData( self["in"].getValue() ) )
+
+		directory = tempfile.mkdtemp( prefix = "gafferValuePlugTest" )
+		self.addCleanup( shutil.rmtree, directory )
+
+		Gaffer.ValuePlug.setDiskCacheDirectory( directory )
+		self.assertEqual( Gaffer.ValuePlug.getDiskCacheDirectory(), directory )
+
+		n = CountingNode()
+		n["in"].setValue( "disk" )
+		n["out"].setFlags( Gaffer.Plug.Flags.DiskCacheable, True )
+
+		# Cold. The value must be computed, and is written to disk.
+
+		Gaffer.ValuePlug.setCacheMemoryLimit( 0 )
+		Gaffer.ValuePlug.setCacheMemoryLimit( self.__originalCacheMemoryLimit )
+
+		self.assertEqual( n["out"].getValue(), IECore.StringData( "disk" ) )
+		self.assertEqual( n.numComputeCalls, 1 )
+		self.assertEqual( len( os.listdir( directory ) ), 1 )
+
+		# Warm. Even with an empty memory cache, the value is
+		# loaded from disk rather than being computed again.
+
+		Gaffer.ValuePlug.setCacheMemoryLimit( 0 )
+		Gaffer.ValuePlug.setCacheMemoryLimit( self.__originalCacheMemoryLimit )
+
+		self.assertEqual( n["out"].getValue(), IECore.StringData( "disk" ) )
+		self.assertEqual( n.numComputeCalls, 1 )
+
+		# Disabled.
+
+		Gaffer.ValuePlug.setDiskCacheDirectory( "" )
+		Gaffer.ValuePlug.setCacheMemoryLimit( 0 )
+		Gaffer.ValuePlug.setCacheMemoryLimit( self.__originalCacheMemoryLimit )
+
+		self.assertEqual( n["out"].getValue(), IECore.StringData( "disk" ) )
+		self.assertEqual( n.numComputeCalls, 2 )
+
+	def testDiskCacheSizeLimit( self ) :
+
+		directory = tempfile.mkdtemp( prefix = "gafferValuePlugTest" )
+		self.addCleanup( shutil.rmtree, directory )
+
+		Gaffer.ValuePlug.setDiskCacheDirectory( directory )
+		Gaffer.ValuePlug.setDiskCacheSizeLimit( 1024 )
+		self.assertEqual( Gaffer.ValuePlug.getDiskCacheSizeLimit(), 1024 )
+
+		n = GafferTest.CachingTestNode()
+		n["out"].setFlags( Gaffer.Plug.Flags.DiskCacheable, True )
+		for i in range( 0, 100 ) :
+			n["in"].setValue( "value%d" % i )
+			n["out"].getValue( _copy = False )
+
+		size = sum( os.path.getsize( os.path.join( directory, f ) ) for f in os.listdir( directory ) )
+		self.assertTrue( size <= 1024 )
+		self.assertTrue( len( os.listdir( directory ) ) > 0 )
+
+	def testDiskCacheLargeValues( self ) :
+
+		class VectorNode( Gaffer.ComputeNode ) :
+
+			def __init__( self, name = "VectorNode" ) :
+
+				Gaffer.ComputeNode.__init__( self, name )
+
+				self["in"] = Gaffer.IntPlug()
+				self["out"] = Gaffer.ObjectPlug( direction = Gaffer.Plug.Direction.Out, defaultValue = IECore.NullObject() )
+
+				self.numComputeCalls = 0
+
+			def affects( self, input ) :
+
+				return [ self["out"] ] if input.isSame( self["in"] ) else []
+
+			def hash( self, output, context, h ) :
+
+				self["in"].hash( h )
+
+			def compute( self, plug, context ) :
+
+				self.numComputeCalls += 1
+				plug.setValue( IECore.FloatVectorData( [ self["in"].getValue() ] * 1000000 ) )
+
+		directory = tempfile.mkdtemp( prefix = "gafferValuePlugTest" )
+		self.addCleanup( shutil.rmtree, directory )
+		Gaffer.ValuePlug.setDiskCacheDirectory( directory )
+
+		n = VectorNode()
+		n["out"].setFlags( Gaffer.Plug.Flags.DiskCacheable, True )
+
+		def pull() :
+
+			Gaffer.ValuePlug.setCacheMemoryLimit( 0 )
+			Gaffer.ValuePlug.setCacheMemoryLimit( self.__originalCacheMemoryLimit )
+
+			for i in range( 0, 5 ) :
+				n["in"].setValue( i )
+				self.assertEqual( n["out"].getValue(), IECore.FloatVectorData( [ i ] * 1000000 ) )
+
+		# Cold : every value is computed and written to disk.
+		pull()
+		self.assertEqual( n.numComputeCalls, 5 )
+		self.assertEqual( len( os.listdir( directory ) ), 5 )
+
+		# Warm : every value is read back from disk intact.
+		pull()
+		self.assertEqual( n.numComputeCalls, 5 )
+
 	def setUp( self ) :
 
 		self.__originalCacheMemoryLimit = Gaffer.ValuePlug.getCacheMemoryLimit()
+		self.__originalDiskCacheDirectory = Gaffer.ValuePlug.getDiskCacheDirectory()
+		self.__originalDiskCacheSizeLimit = Gaffer.ValuePlug.getDiskCacheSizeLimit()
 
 	def tearDown( self ) :
 
 		Gaffer.ValuePlug.setCacheMemoryLimit( self.__originalCacheMemoryLimit )
+		Gaffer.ValuePlug.setDiskCacheDirectory( self.__originalDiskCacheDirectory )
+		Gaffer.ValuePlug.setDiskCacheSizeLimit( self.__originalDiskCacheSizeLimit )
 
 if __name__ == "__main__":
 	unittest.main()
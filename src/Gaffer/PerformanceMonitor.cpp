@@ -0,0 +1,343 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2015, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#include <algorithm>
+
+#include "boost/format.hpp"
+
+#include "IECore/Exception.h"
+
+#include "Gaffer/PerformanceMonitor.h"
+
+using namespace Gaffer;
+
+//////////////////////////////////////////////////////////////////////////
+// Internal utilities
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+typedef std::pair<ConstPlugPtr, PerformanceMonitor::Statistics> Item;
+
+struct HashTime
+{
+	static const char *name() { return "Hash time"; }
+	static double value( const PerformanceMonitor::Statistics &s ) { return s.hashTime; }
+	static std::string format( const PerformanceMonitor::Statistics &s ) { return boost::str( boost::format( "%.3fs" ) % s.hashTime ); }
+};
+
+struct ComputeTime
+{
+	static const char *name() { return "Compute time"; }
+	static double value( const PerformanceMonitor::Statistics &s ) { return s.computeTime; }
+	static std::string format( const PerformanceMonitor::Statistics &s ) { return boost::str( boost::format( "%.3fs" ) % s.computeTime ); }
+};
+
+struct HashCount
+{
+	static const char *name() { return "Hash count"; }
+	static double value( const PerformanceMonitor::Statistics &s ) { return s.hashCount; }
+	static std::string format( const PerformanceMonitor::Statistics &s ) { return boost::str( boost::format( "%d" ) % s.hashCount ); }
+};
+
+struct ComputeCount
+{
+	static const char *name() { return "Compute count"; }
+	static double value( const PerformanceMonitor::Statistics &s ) { return s.computeCount; }
+	static std::string format( const PerformanceMonitor::Statistics &s ) { return boost::str( boost::format( "%d" ) % s.computeCount ); }
+};
+
+struct CacheMemory
+{
+	static const char *name() { return "Cache memory"; }
+	static double value( const PerformanceMonitor::Statistics &s ) { return s.cacheMemory; }
+	static std::string format( const PerformanceMonitor::Statistics &s ) { return boost::str( boost::format( "%.2fM" ) % ( s.cacheMemory / ( 1024.0 * 1024.0 ) ) ); }
+};
+
+template<typename Metric>
+struct Greater
+{
+	bool operator()( const Item &a, const Item &b ) const
+	{
+		return Metric::value( a.second ) > Metric::value( b.second );
+	}
+};
+
+template<typename Metric>
+void appendReport( std::vector<Item> &items, size_t maxLines, std::string &report )
+{
+	const size_t n = std::min( maxLines, items.size() );
+	std::partial_sort( items.begin(), items.begin() + n, items.end(), Greater<Metric>() );
+
+	report += std::string( Metric::name() ) + " :\n\n";
+	for( size_t i = 0; i < n; ++i )
+	{
+		if( Metric::value( items[i].second ) == 0 )
+		{
+			break;
+		}
+		report += boost::str( boost::format( "  %-60s : %s\n" ) % items[i].first->fullName() % Metric::format( items[i].second ) );
+	}
+	report += "\n";
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// Statistics
+//////////////////////////////////////////////////////////////////////////
+
+PerformanceMonitor::Statistics::Statistics()
+	:	hashCount( 0 ), computeCount( 0 ), cacheHits( 0 ), cacheMisses( 0 ), cacheMemory( 0 ), hashTime( 0 ), computeTime( 0 )
+{
+}
+
+PerformanceMonitor::Statistics &PerformanceMonitor::Statistics::operator += ( const Statistics &rhs )
+{
+	hashCount += rhs.hashCount;
+	computeCount += rhs.computeCount;
+	cacheHits += rhs.cacheHits;
+	cacheMisses += rhs.cacheMisses;
+	cacheMemory += rhs.cacheMemory;
+	hashTime += rhs.hashTime;
+	computeTime += rhs.computeTime;
+	return *this;
+}
+
+bool PerformanceMonitor::Statistics::operator == ( const Statistics &rhs ) const
+{
+	return
+		hashCount == rhs.hashCount &&
+		computeCount == rhs.computeCount &&
+		cacheHits == rhs.cacheHits &&
+		cacheMisses == rhs.cacheMisses &&
+		cacheMemory == rhs.cacheMemory &&
+		hashTime == rhs.hashTime &&
+		computeTime == rhs.computeTime
+	;
+}
+
+bool PerformanceMonitor::Statistics::operator != ( const Statistics &rhs ) const
+{
+	return !(*this == rhs );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// PerformanceMonitor
+//////////////////////////////////////////////////////////////////////////
+
+tbb::atomic<PerformanceMonitor *> PerformanceMonitor::g_active;
+
+PerformanceMonitor::PerformanceMonitor()
+{
+}
+
+PerformanceMonitor::~PerformanceMonitor()
+{
+}
+
+void PerformanceMonitor::setActive( bool active )
+{
+	// While active, we hold a reference to ourselves so
+	// that we can't be destroyed while computations may
+	// still be reporting to us.
+	if( active )
+	{
+		PerformanceMonitor *previous = g_active.compare_and_swap( this, NULL );
+		if( !previous )
+		{
+			addRef();
+		}
+		else if( previous != this )
+		{
+			throw IECore::Exception( "Another PerformanceMonitor is already active" );
+		}
+	}
+	else
+	{
+		if( g_active.compare_and_swap( NULL, this ) == this )
+		{
+			removeRef();
+		}
+	}
+}
+
+bool PerformanceMonitor::getActive() const
+{
+	return g_active == this;
+}
+
+PerformanceMonitor *PerformanceMonitor::active()
+{
+	return g_active;
+}
+
+PerformanceMonitor::StatisticsMap PerformanceMonitor::allStatistics() const
+{
+	StatisticsMap result;
+	for( ThreadDataContainer::const_iterator it = m_threadData.begin(), eIt = m_threadData.end(); it != eIt; ++it )
+	{
+		for( PlugStatisticsMap::const_iterator sIt = it->statistics.begin(), sEIt = it->statistics.end(); sIt != sEIt; ++sIt )
+		{
+			result[sIt->second.plug] += sIt->second.statistics;
+		}
+	}
+	return result;
+}
+
+PerformanceMonitor::Statistics PerformanceMonitor::plugStatistics( const Plug *plug ) const
+{
+	Statistics result;
+	for( ThreadDataContainer::const_iterator it = m_threadData.begin(), eIt = m_threadData.end(); it != eIt; ++it )
+	{
+		PlugStatisticsMap::const_iterator sIt = it->statistics.find( plug );
+		if( sIt != it->statistics.end() )
+		{
+			result += sIt->second.statistics;
+		}
+	}
+	return result;
+}
+
+PerformanceMonitor::Statistics PerformanceMonitor::combinedStatistics() const
+{
+	Statistics result;
+	for( ThreadDataContainer::const_iterator it = m_threadData.begin(), eIt = m_threadData.end(); it != eIt; ++it )
+	{
+		for( PlugStatisticsMap::const_iterator sIt = it->statistics.begin(), sEIt = it->statistics.end(); sIt != sEIt; ++sIt )
+		{
+			result += sIt->second.statistics;
+		}
+	}
+	return result;
+}
+
+void PerformanceMonitor::clear()
+{
+	m_threadData.clear();
+}
+
+std::string PerformanceMonitor::report( size_t maxLinesPerMetric ) const
+{
+	const StatisticsMap statistics = allStatistics();
+	std::vector<Item> items( statistics.begin(), statistics.end() );
+
+	Statistics combined;
+	for( std::vector<Item>::const_iterator it = items.begin(), eIt = items.end(); it != eIt; ++it )
+	{
+		combined += it->second;
+	}
+
+	std::string result;
+	result += boost::str( boost::format( "Hash count : %d\nCompute count : %d\nHash time : %.3fs\nCompute time : %.3fs\n" ) % combined.hashCount % combined.computeCount % combined.hashTime % combined.computeTime );
+	const size_t lookups = combined.cacheHits + combined.cacheMisses;
+	result += boost::str( boost::format( "Cache hit rate : %.1f%%\n\n" ) % ( lookups ? 100.0 * combined.cacheHits / lookups : 0.0 ) );
+
+	appendReport<HashTime>( items, maxLinesPerMetric, result );
+	appendReport<ComputeTime>( items, maxLinesPerMetric, result );
+	appendReport<HashCount>( items, maxLinesPerMetric, result );
+	appendReport<ComputeCount>( items, maxLinesPerMetric, result );
+	appendReport<CacheMemory>( items, maxLinesPerMetric, result );
+
+	return result;
+}
+
+void PerformanceMonitor::started( const Plug *plug, Phase phase )
+{
+	ThreadData &threadData = m_threadData.local();
+
+	Frame frame;
+	frame.statistics = &statistics( threadData, plug );
+	frame.phase = phase;
+	frame.nestedTime = 0;
+	frame.start = tbb::tick_count::now();
+	threadData.stack.push_back( frame );
+}
+
+void PerformanceMonitor::finished()
+{
+	ThreadData &threadData = m_threadData.local();
+
+	const Frame &frame = threadData.stack.back();
+	const double duration = ( tbb::tick_count::now() - frame.start ).seconds();
+	const double exclusiveDuration = duration - frame.nestedTime;
+	if( frame.phase == Hash )
+	{
+		frame.statistics->hashCount++;
+		frame.statistics->hashTime += exclusiveDuration;
+	}
+	else
+	{
+		frame.statistics->computeCount++;
+		frame.statistics->computeTime += exclusiveDuration;
+	}
+
+	threadData.stack.pop_back();
+	if( !threadData.stack.empty() )
+	{
+		threadData.stack.back().nestedTime += duration;
+	}
+}
+
+void PerformanceMonitor::cacheLookup( const Plug *plug, bool hit )
+{
+	Statistics &statistics = this->statistics( m_threadData.local(), plug );
+	if( hit )
+	{
+		statistics.cacheHits++;
+	}
+	else
+	{
+		statistics.cacheMisses++;
+	}
+}
+
+void PerformanceMonitor::cacheInsertion( const Plug *plug, size_t bytes )
+{
+	statistics( m_threadData.local(), plug ).cacheMemory += bytes;
+}
+
+PerformanceMonitor::Statistics &PerformanceMonitor::statistics( ThreadData &threadData, const Plug *plug )
+{
+	PlugStatistics &s = threadData.statistics[plug];
+	if( !s.plug )
+	{
+		s.plug = plug;
+	}
+	return s.statistics;
+}
@@ -36,22 +36,978 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include <stack>
+#include <list>
+#include <limits>
+#include <algorithm>
+#include <fstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <utime.h>
+#include <sys/stat.h>
 
 #include "tbb/enumerable_thread_specific.h"
 #include "tbb/spin_mutex.h"
+#include "tbb/mutex.h"
+#include "tbb/atomic.h"
+#include "tbb/tick_count.h"
+
+#include "boost/bind.hpp"
+#include "boost/format.hpp"
+#include "boost/noncopyable.hpp"
+#include "boost/unordered_map.hpp"
+#include "boost/filesystem.hpp"
+
+#include "IECore/CompoundObject.h"
+#include "IECore/MemoryIndexedIO.h"
+#include "IECore/MessageHandler.h"
+
+#include "Gaffer/ValuePlug.h"
+#include "Gaffer/ComputeNode.h"
+#include "Gaffer/Context.h"
+#include "Gaffer/Action.h"
+#include "Gaffer/PerformanceMonitor.h"
+
+using namespace Gaffer;
+
+//////////////////////////////////////////////////////////////////////////
+//
+// The ValueCache class provides the storage for computed values, keyed
+// by ValuePlug::hash(). It is accessed concurrently by every thread
+// performing a computation, so rather than protect a single LRU list
+// with a single mutex, we split the cache into a number of shards, each
+// with its own lock and its own LRU lists. Threads accessing different
+// shards therefore never contend with one another.
+//
+// The memory limit is applied to the cache as a whole rather than to
+// each shard individually, so that a single large value may still be
+// cached when the limit is small. Additional limits may be applied to
+// the values computed for specific types of plug, so that for instance
+// large geometry can't evict all the image tiles. Each such budget has
+// its own LRU list within each shard.
+//
+// When a limit is exceeded, we visit each shard in turn, evicting one
+// item at a time until we're back within budget. Rather than evict
+// strictly the least recently used item, we consider several items from
+// the end of the LRU list, and evict the one which is cheapest to
+// recompute relative to the memory it frees.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+class ValueCache
+{
+
+	public :
+
+		typedef IECore::MurmurHash Key;
+		typedef IECore::ConstObjectPtr Value;
+		/// Called whenever an item is removed from the cache. It is
+		/// called with the shard lock held, so must not call back into
+		/// the cache.
+		typedef void (*EvictionFunction)( const Key &key );
+
+		ValueCache( size_t maxCost, EvictionFunction evictionFunction = NULL )
+			:	m_evictionFunction( evictionFunction )
+		{
+			m_maxCost = maxCost;
+			m_currentCost = 0;
+			m_evictionShard = 0;
+			for( size_t i = 0; i < numBudgets; ++i )
+			{
+				m_budgets[i].plugType = IECore::InvalidTypeId;
+				m_budgets[i].maxCost = std::numeric_limits<size_t>::max();
+				m_budgets[i].currentCost = 0;
+			}
+		}
+
+		/// Returns the cached value for key, or NULL if it
+		/// is not in the cache.
+		Value get( const Key &key )
+		{
+			Shard &shard = this->shard( key );
+			Shard::Lock lock;
+			shard.acquire( lock );
+
+			Shard::Map::iterator it = shard.map.find( key );
+			if( it == shard.map.end() )
+			{
+				shard.misses++;
+				return NULL;
+			}
+
+			// Move to the front of the LRU list.
+			Shard::List &list = shard.lists[it->second->budget];
+			list.splice( list.begin(), list, it->second );
+			shard.hits++;
+			return it->second->value;
+		}
+
+		/// Returns true if key is in the cache, without
+		/// affecting the LRU order or the statistics.
+		bool contains( const Key &key )
+		{
+			Shard &shard = this->shard( key );
+			Shard::Lock lock;
+			shard.acquire( lock );
+			return shard.map.find( key ) != shard.map.end();
+		}
+
+		/// Stores the value in the cache, returning true on
+		/// success and false if the value was too costly to
+		/// be cached at all. The computeTime is the time in
+		/// seconds it took to compute the value, and is used
+		/// to prioritise eviction.
+		bool set( const Key &key, const Value &value, size_t cost, double computeTime, IECore::TypeId plugType )
+		{
+			const size_t budgetIndex = this->budgetIndex( plugType );
+			if( cost > m_maxCost || cost > m_budgets[budgetIndex].maxCost )
+			{
+				return false;
+			}
+
+			{
+				Shard &shard = this->shard( key );
+				Shard::Lock lock;
+				shard.acquire( lock );
+
+				Shard::Map::iterator it = shard.map.find( key );
+				if( it != shard.map.end() )
+				{
+					// Already stored by another thread.
+					Shard::List &list = shard.lists[it->second->budget];
+					list.splice( list.begin(), list, it->second );
+					return true;
+				}
+
+				Shard::List &list = shard.lists[budgetIndex];
+				list.push_front( Item( key, value, cost, computeTime, budgetIndex ) );
+				shard.map[key] = list.begin();
+				m_budgets[budgetIndex].currentCost += cost;
+				m_currentCost += cost;
+			}
+
+			limitCost( budgetIndex );
+			limitCost( anyBudget );
+			return true;
+		}
+
+		void clear()
+		{
+			for( size_t i = 0; i < numShards; ++i )
+			{
+				Shard &shard = m_shards[i];
+				Shard::Lock lock;
+				shard.acquire( lock );
+				for( size_t b = 0; b < numBudgets; ++b )
+				{
+					for( Shard::List::const_iterator it = shard.lists[b].begin(), eIt = shard.lists[b].end(); it != eIt; ++it )
+					{
+						m_budgets[b].currentCost -= it->cost;
+						m_currentCost -= it->cost;
+						evicted( it->key );
+					}
+					shard.lists[b].clear();
+				}
+				shard.map.clear();
+			}
+		}
+
+		size_t getMaxCost() const
+		{
+			return m_maxCost;
+		}
+
+		void setMaxCost( size_t maxCost )
+		{
+			m_maxCost = maxCost;
+			limitCost( anyBudget );
+		}
+
+		size_t currentCost() const
+		{
+			return m_currentCost;
+		}
+
+		/// Returns the limit for values computed by plugs of
+		/// the specified type. This defaults to the overall
+		/// limit.
+		size_t getMaxCost( IECore::TypeId plugType ) const
+		{
+			const size_t budgetIndex = this->budgetIndex( plugType );
+			if( budgetIndex == generalBudget )
+			{
+				return m_maxCost;
+			}
+			return m_budgets[budgetIndex].maxCost;
+		}
+
+		void setMaxCost( IECore::TypeId plugType, size_t maxCost )
+		{
+			size_t budgetIndex;
+			{
+				tbb::spin_mutex::scoped_lock lock( m_budgetsMutex );
+				budgetIndex = this->budgetIndex( plugType );
+				if( budgetIndex == generalBudget )
+				{
+					for( budgetIndex = generalBudget + 1; budgetIndex < numBudgets; ++budgetIndex )
+					{
+						if( m_budgets[budgetIndex].plugType == IECore::InvalidTypeId )
+						{
+							break;
+						}
+					}
+					if( budgetIndex == numBudgets )
+					{
+						throw IECore::Exception( "Too many plug types with cache memory limits" );
+					}
+				}
+				// Set the cost before the type, so that the budget is
+				// never visible to other threads with a stale limit.
+				m_budgets[budgetIndex].maxCost = maxCost;
+				m_budgets[budgetIndex].plugType = plugType;
+			}
+			limitCost( budgetIndex );
+		}
+
+		/// Returns the memory used by values computed by plugs
+		/// of the specified type. Only types which have had a
+		/// limit set are tracked individually - for all others
+		/// the overall usage is returned.
+		size_t currentCost( IECore::TypeId plugType ) const
+		{
+			const size_t budgetIndex = this->budgetIndex( plugType );
+			if( budgetIndex == generalBudget )
+			{
+				return m_currentCost;
+			}
+			return m_budgets[budgetIndex].currentCost;
+		}
+
+		// The statistics are read without locking the shards,
+		// so that querying them doesn't contend with the threads
+		// using the cache, nor inflate the contention count.
+		void statistics( ValuePlug::CacheStatistics &statistics )
+		{
+			for( size_t i = 0; i < numShards; ++i )
+			{
+				const Shard &shard = m_shards[i];
+				statistics.hits += shard.hits;
+				statistics.misses += shard.misses;
+				statistics.contentions += shard.contentions;
+				statistics.evictions += shard.evictions;
+			}
+		}
+
+		void resetStatistics()
+		{
+			for( size_t i = 0; i < numShards; ++i )
+			{
+				Shard &shard = m_shards[i];
+				shard.hits = 0;
+				shard.misses = 0;
+				shard.contentions = 0;
+				shard.evictions = 0;
+			}
+		}
+
+	private :
+
+		// Budget 0 holds all values computed by plugs
+		// without a specific limit. Passing anyBudget
+		// to limitCost() applies the overall limit.
+		static const size_t numBudgets = 8;
+		static const size_t generalBudget = 0;
+		static const size_t anyBudget = numBudgets;
+
+		// The number of items at the end of an LRU list
+		// that are considered for eviction.
+		static const size_t evictionCandidates = 4;
+
+		struct Item
+		{
+			Item( const Key &key, const Value &value, size_t cost, double computeTime, size_t budget )
+				:	key( key ), value( value ), cost( cost ), computeTime( computeTime ), budget( budget )
+			{
+			}
+
+			// The lower the score, the more
+			// we prefer to evict this item.
+			double evictionScore() const
+			{
+				return computeTime / (double)std::max( cost, size_t( 1 ) );
+			}
+
+			Key key;
+			Value value;
+			size_t cost;
+			double computeTime;
+			size_t budget;
+		};
+
+		// Padded to a cache line, so that threads locking
+		// neighbouring shards don't suffer from false sharing.
+		struct Shard
+		{
+			Shard()
+			{
+				hits = misses = contentions = evictions = 0;
+			}
+
+			typedef tbb::spin_mutex Mutex;
+			typedef Mutex::scoped_lock Lock;
+			typedef std::list<Item> List;
+			typedef boost::unordered_map<Key, List::iterator> Map;
+
+			// Acquires the lock, recording whether or not
+			// we had to wait for another thread to release it.
+			void acquire( Lock &lock )
+			{
+				if( !lock.try_acquire( mutex ) )
+				{
+					lock.acquire( mutex );
+					contentions++;
+				}
+			}
+
+			Mutex mutex;
+			List lists[numBudgets];
+			Map map;
+			// Statistics are only modified while the mutex
+			// is held, but are atomic so that statistics()
+			// can read them without taking the lock.
+			tbb::atomic<size_t> hits;
+			tbb::atomic<size_t> misses;
+			tbb::atomic<size_t> contentions;
+			tbb::atomic<size_t> evictions;
+
+			char padding[64];
+		};
+
+		struct Budget
+		{
+			tbb::atomic<IECore::TypeId> plugType;
+			tbb::atomic<size_t> maxCost;
+			tbb::atomic<size_t> currentCost;
+		};
+
+		static const size_t numShards = 64;
+
+		Shard &shard( const Key &key )
+		{
+			// The shard maps use the low bits of the hash
+			// for bucketing, so we use the high ones here.
+			const size_t h = hash_value( key );
+			return m_shards[(h >> ( sizeof( size_t ) * 4 )) % numShards];
+		}
+
+		size_t budgetIndex( IECore::TypeId plugType ) const
+		{
+			for( size_t i = generalBudget + 1; i < numBudgets; ++i )
+			{
+				if( m_budgets[i].plugType == plugType )
+				{
+					return i;
+				}
+			}
+			return generalBudget;
+		}
+
+		// Evicts items until the cost is within the limit
+		// for the specified budget. Only one shard is locked
+		// at a time.
+		void limitCost( size_t budgetIndex )
+		{
+			const tbb::atomic<size_t> &currentCost = budgetIndex == anyBudget ? m_currentCost : m_budgets[budgetIndex].currentCost;
+			const tbb::atomic<size_t> &maxCost = budgetIndex == anyBudget ? m_maxCost : m_budgets[budgetIndex].maxCost;
+
+			size_t emptyShards = 0;
+			while( currentCost > maxCost && emptyShards < numShards )
+			{
+				Shard &shard = m_shards[m_evictionShard.fetch_and_increment() % numShards];
+				Shard::Lock lock;
+				shard.acquire( lock );
+
+				// Find the candidate we'd most like to evict.
+				Shard::List::iterator victim;
+				bool haveVictim = false;
+				const size_t firstBudget = budgetIndex == anyBudget ? 0 : budgetIndex;
+				const size_t lastBudget = budgetIndex == anyBudget ? numBudgets - 1 : budgetIndex;
+				for( size_t b = firstBudget; b <= lastBudget; ++b )
+				{
+					Shard::List &list = shard.lists[b];
+					Shard::List::iterator it = list.end();
+					for( size_t i = 0; i < evictionCandidates && it != list.begin(); ++i )
+					{
+						--it;
+						if( !haveVictim || it->evictionScore() < victim->evictionScore() )
+						{
+							victim = it;
+							haveVictim = true;
+						}
+					}
+				}
+
+				if( !haveVictim )
+				{
+					emptyShards++;
+					continue;
+				}
+				emptyShards = 0;
+
+				m_budgets[victim->budget].currentCost -= victim->cost;
+				m_currentCost -= victim->cost;
+				evicted( victim->key );
+				shard.map.erase( victim->key );
+				shard.lists[victim->budget].erase( victim );
+				shard.evictions++;
+			}
+		}
+
+		void evicted( const Key &key )
+		{
+			if( m_evictionFunction )
+			{
+				m_evictionFunction( key );
+			}
+		}
+
+		Shard m_shards[numShards];
+		EvictionFunction m_evictionFunction;
+
+		tbb::atomic<size_t> m_maxCost;
+		tbb::atomic<size_t> m_currentCost;
+		tbb::atomic<size_t> m_evictionShard;
+
+		Budget m_budgets[numBudgets];
+		tbb::spin_mutex m_budgetsMutex;
+
+};
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+//
+// During a single graph evaluation, we actually call ValuePlug::hash()
+// many times for the same plugs. First hash() is called for the terminating plug,
+// which will call hash() for all the upstream plugs, and then compute() is called
+// for the terminating plug, which will call getValue() on the upstream plugs. But
+// those upstream plugs will need to call their hash() again in getValue(), so their
+// value can be cached. This ripples on up the chain, leading to quadratic complexity
+// in the length of the chain of nodes - not good. Thanks is due to David Minor for
+// being the first to point this out.
+//
+// We address this problem by keeping a cache of hashes, indexed by the plug
+// the hash is for and the context the hash was performed in. The cache is
+// shared by all threads, so that when many threads traverse the same graph,
+// each hash is only computed once. Like the ValueCache, it is split into
+// independently locked shards to keep contention down.
+//
+// Hashes are invalidated whenever an upstream value or connection is changed.
+// Rather than visit every entry to clear it, we tag each entry with the
+// generation in which it was computed, and simply increment the current
+// generation in Plug::dirty(). Stale entries are then ignored by get() and
+// replaced by set(). To prevent unbounded growth, a shard is cleared entirely
+// whenever it reaches a maximum size.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+class HashCache
+{
+
+	public :
+
+		typedef std::pair<const ValuePlug *, IECore::MurmurHash> Key;
+
+		HashCache()
+		{
+			m_generation = 0;
+		}
+
+		size_t generation() const
+		{
+			return m_generation;
+		}
+
+		/// Returns true and fills in hash if a current entry
+		/// exists for key.
+		bool get( const Key &key, IECore::MurmurHash &hash )
+		{
+			const size_t generation = m_generation;
+
+			Shard &shard = this->shard( key );
+			Shard::Mutex::scoped_lock lock( shard.mutex );
+			Shard::Map::const_iterator it = shard.map.find( key );
+			if( it == shard.map.end() || it->second.generation != generation )
+			{
+				return false;
+			}
+
+			hash = it->second.hash;
+			return true;
+		}
+
+		/// Stores the hash for key. The generation must be the one
+		/// retrieved before starting to compute the hash, so that
+		/// we don't store a stale result if the graph is dirtied
+		/// concurrently.
+		void set( const Key &key, const IECore::MurmurHash &hash, size_t generation )
+		{
+			Shard &shard = this->shard( key );
+			Shard::Mutex::scoped_lock lock( shard.mutex );
+			if( shard.map.size() >= maxShardSize )
+			{
+				shard.map.clear();
+			}
+			Entry &entry = shard.map[key];
+			entry.hash = hash;
+			entry.generation = generation;
+		}
+
+		/// Invalidates all entries.
+		void invalidate()
+		{
+			m_generation++;
+		}
+
+	private :
+
+		struct Entry
+		{
+			IECore::MurmurHash hash;
+			size_t generation;
+		};
+
+		struct Shard
+		{
+			typedef tbb::spin_mutex Mutex;
+			typedef boost::unordered_map<Key, Entry> Map;
+
+			Mutex mutex;
+			Map map;
+
+			char padding[64];
+		};
+
+		static const size_t numShards = 64;
+		// Chosen so that the cache as a whole holds
+		// around half a million hashes.
+		static const size_t maxShardSize = 8192;
+
+		Shard &shard( const Key &key )
+		{
+			const size_t h = boost::hash<Key>()( key );
+			return m_shards[(h >> ( sizeof( size_t ) * 4 )) % numShards];
+		}
+
+		Shard m_shards[numShards];
+		tbb::atomic<size_t> m_generation;
+
+};
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+//
+// The InFlightTable keeps track of computations which are currently in
+// progress for plugs with the SharedCompute flag, so that other threads
+// requesting the same value can wait for the result rather than repeat
+// the work.
+//
+// The owner of an entry holds its mutex for the duration of the
+// computation, so waiting is simply a matter of acquiring the mutex.
+// To avoid deadlock, a thread which is itself the owner of an in-flight
+// computation never waits for another - any cycle of waiting threads
+// would otherwise be possible when TBB schedules an unrelated task onto
+// a thread which is waiting for tasks spawned by its own compute().
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+class InFlightTable
+{
+
+	public :
+
+		struct Entry : public IECore::RefCounted
+		{
+			typedef tbb::mutex Mutex;
+			Mutex mutex;
+			// Remains NULL if the owner failed
+			// to compute a value.
+			IECore::ConstObjectPtr value;
+		};
+
+		IE_CORE_DECLAREPTR( Entry );
+
+		/// Returns the entry for the hash, creating it if necessary.
+		/// When created, the entry's mutex is locked using ownerLock,
+		/// and true is returned to indicate that the caller is now
+		/// responsible for the computation, and for calling remove()
+		/// when it is done.
+		bool acquire( const IECore::MurmurHash &hash, EntryPtr &entry, Entry::Mutex::scoped_lock &ownerLock )
+		{
+			Shard &shard = this->shard( hash );
+			Shard::Mutex::scoped_lock lock( shard.mutex );
+			Shard::Map::const_iterator it = shard.map.find( hash );
+			if( it != shard.map.end() )
+			{
+				entry = it->second;
+				return false;
+			}
+
+			entry = new Entry;
+			ownerLock.acquire( entry->mutex );
+			shard.map[hash] = entry;
+			return true;
+		}
+
+		void remove( const IECore::MurmurHash &hash )
+		{
+			Shard &shard = this->shard( hash );
+			Shard::Mutex::scoped_lock lock( shard.mutex );
+			shard.map.erase( hash );
+		}
+
+	private :
+
+		struct Shard
+		{
+			typedef tbb::spin_mutex Mutex;
+			typedef boost::unordered_map<IECore::MurmurHash, EntryPtr> Map;
+
+			Mutex mutex;
+			Map map;
+
+			char padding[64];
+		};
+
+		static const size_t numShards = 64;
+
+		Shard &shard( const IECore::MurmurHash &hash )
+		{
+			const size_t h = hash_value( hash );
+			return m_shards[(h >> ( sizeof( size_t ) * 4 )) % numShards];
+		}
+
+		Shard m_shards[numShards];
+
+};
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+//
+// The PersistentCache class provides an optional second level of caching
+// behind the ValueCache, for plugs with the DiskCacheable flag. Values
+// are serialised into a directory on disk, with one file per value named
+// using the hash, so they can be reused by subsequent processes - for
+// instance when a farm job is retried. Files are written under temporary
+// names and then renamed into place, so that several processes may share
+// the same directory safely.
+//
+// The total size of the directory is bounded. When the limit is exceeded
+// we scan the directory and remove the least recently used files, using
+// the modification time, which we update whenever a file is read.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+class PersistentCache
+{
+
+	public :
+
+		PersistentCache()
+		{
+			m_maxSize = 10 * 1024 * 1024 * 1024ull;
+			m_currentSize = 0;
+			m_enabled = false;
+			if( const char *d = getenv( "GAFFER_DISK_CACHE_DIRECTORY" ) )
+			{
+				setDirectory( d );
+			}
+		}
+
+		bool enabled() const
+		{
+			return m_enabled;
+		}
+
+		void setDirectory( const std::string &directory )
+		{
+			// We do the filesystem work before taking the lock,
+			// so that we don't block other threads while we wait
+			// on the disk.
+			bool enabled = false;
+			size_t currentSize = 0;
+			if( !directory.empty() )
+			{
+				try
+				{
+					boost::filesystem::create_directories( directory );
+					currentSize = directorySize( directory );
+					enabled = true;
+				}
+				catch( const std::exception &e )
+				{
+					IECore::msg( IECore::Msg::Error, "ValuePlug::setDiskCacheDirectory", e.what() );
+				}
+			}
+
+			tbb::mutex::scoped_lock lock( m_mutex );
+			m_directory = directory;
+			m_currentSize = currentSize;
+			m_enabled = enabled;
+		}
+
+		std::string getDirectory() const
+		{
+			tbb::mutex::scoped_lock lock( m_mutex );
+			return m_directory;
+		}
+
+		void setMaxSize( size_t maxSize )
+		{
+			m_maxSize = maxSize;
+			limitSize();
+		}
+
+		size_t getMaxSize() const
+		{
+			return m_maxSize;
+		}
+
+		/// Returns the value for the hash, or NULL if it is
+		/// not in the cache. The file is read directly into
+		/// the buffer we load from.
+		IECore::ConstObjectPtr get( const IECore::MurmurHash &hash )
+		{
+			const std::string fileName = this->fileName( hash );
+
+			const int fd = open( fileName.c_str(), O_RDONLY );
+			if( fd == -1 )
+			{
+				return NULL;
+			}
+
+			IECore::ConstObjectPtr result;
+			struct stat s;
+			if( fstat( fd, &s ) == 0 && s.st_size > 0 )
+			{
+				IECore::CharVectorDataPtr buffer = new IECore::CharVectorData;
+				std::vector<char> &data = buffer->writable();
+				data.resize( s.st_size );
+
+				size_t offset = 0;
+				while( offset < data.size() )
+				{
+					const ssize_t n = read( fd, &data[offset], data.size() - offset );
+					if( n <= 0 )
+					{
+						break;
+					}
+					offset += n;
+				}
+
+				if( offset == data.size() )
+				{
+					try
+					{
+						IECore::IndexedIOPtr io = new IECore::MemoryIndexedIO( buffer, IECore::IndexedIO::rootPath, IECore::IndexedIO::Exclusive | IECore::IndexedIO::Read );
+						result = IECore::Object::load( io, g_entryName );
+					}
+					catch( const std::exception &e )
+					{
+						// Most likely a file written by an incompatible
+						// version. Treat it as a miss, and it'll be replaced.
+						IECore::msg( IECore::Msg::Debug, "ValuePlug disk cache", e.what() );
+					}
+				}
+			}
+			close( fd );
+
+			if( result )
+			{
+				// Update the modification time, so that
+				// limitSize() treats it as recently used.
+				utime( fileName.c_str(), NULL );
+			}
+
+			return result;
+		}
+
+		void set( const IECore::MurmurHash &hash, const IECore::Object *value )
+		{
+			IECore::ConstCharVectorDataPtr buffer;
+			try
+			{
+				IECore::MemoryIndexedIOPtr io = new IECore::MemoryIndexedIO( NULL, IECore::IndexedIO::rootPath, IECore::IndexedIO::Exclusive | IECore::IndexedIO::Write );
+				value->save( io, g_entryName );
+				buffer = io->buffer();
+			}
+			catch( const std::exception &e )
+			{
+				// Not all types can be serialised.
+				IECore::msg( IECore::Msg::Debug, "ValuePlug disk cache", e.what() );
+				return;
+			}
 
-#include "boost/bind.hpp"
-#include "boost/format.hpp"
-#include "boost/unordered_map.hpp"
+			const size_t size = buffer->readable().size();
+			if( size > m_maxSize )
+			{
+				return;
+			}
+
+			const std::string fileName = this->fileName( hash );
+			const std::string tmpFileName = boost::str( boost::format( "%s.%d.%d.tmp" ) % fileName % getpid() % m_tmpCounter.fetch_and_increment() );
+			std::ofstream f( tmpFileName.c_str(), std::ios::binary );
+			f.write( &buffer->readable()[0], size );
+			f.close();
+			if( !f || rename( tmpFileName.c_str(), fileName.c_str() ) != 0 )
+			{
+				remove( tmpFileName.c_str() );
+				return;
+			}
 
-#include "IECore/LRUCache.h"
+			m_currentSize += size;
+			limitSize();
+		}
 
-#include "Gaffer/ValuePlug.h"
-#include "Gaffer/ComputeNode.h"
-#include "Gaffer/Context.h"
-#include "Gaffer/Action.h"
+	private :
 
-using namespace Gaffer;
+		std::string fileName( const IECore::MurmurHash &hash ) const
+		{
+			return getDirectory() + "/" + hash.toString() + ".cache";
+		}
+
+		static size_t directorySize( const std::string &directory )
+		{
+			size_t result = 0;
+			boost::system::error_code ec;
+			for( boost::filesystem::directory_iterator it( directory, ec ), eIt; it != eIt; it.increment( ec ) )
+			{
+				if( ec )
+				{
+					break;
+				}
+				result += boost::filesystem::file_size( it->path(), ec );
+			}
+			return result;
+		}
+
+		// Removes the least recently used files until the
+		// directory is back below 90% of the limit. Our
+		// count is only an estimate, since other processes
+		// may be using the same directory, so we rescan the
+		// directory to find the true size.
+		void limitSize()
+		{
+			if( m_currentSize <= m_maxSize )
+			{
+				return;
+			}
+
+			tbb::mutex::scoped_lock lock( m_limitMutex );
+			if( m_currentSize <= m_maxSize )
+			{
+				// Another thread got here first.
+				return;
+			}
+
+			typedef std::pair<std::time_t, boost::filesystem::path> File;
+			std::vector<File> files;
+			size_t size = 0;
+			boost::system::error_code ec;
+			for( boost::filesystem::directory_iterator it( getDirectory(), ec ), eIt; it != eIt; it.increment( ec ) )
+			{
+				if( ec )
+				{
+					break;
+				}
+				files.push_back( File( boost::filesystem::last_write_time( it->path(), ec ), it->path() ) );
+				size += boost::filesystem::file_size( it->path(), ec );
+			}
+
+			std::sort( files.begin(), files.end() );
+			const size_t targetSize = m_maxSize / 10 * 9;
+			for( std::vector<File>::const_iterator it = files.begin(), eIt = files.end(); it != eIt && size > targetSize; ++it )
+			{
+				const size_t fileSize = boost::filesystem::file_size( it->second, ec );
+				if( boost::filesystem::remove( it->second, ec ) )
+				{
+					size -= fileSize;
+				}
+			}
+
+			m_currentSize = size;
+		}
+
+		mutable tbb::mutex m_mutex;
+		tbb::mutex m_limitMutex;
+		std::string m_directory;
+		tbb::atomic<bool> m_enabled;
+		tbb::atomic<size_t> m_maxSize;
+		tbb::atomic<size_t> m_currentSize;
+		tbb::atomic<size_t> m_tmpCounter;
+
+		static const IECore::IndexedIO::EntryID g_entryName;
+
+};
+
+const IECore::IndexedIO::EntryID PersistentCache::g_entryName( "value" );
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+//
+// The MonitorScope class reports a phase of a computation to the
+// active PerformanceMonitor, if there is one. When no monitor is active
+// the overhead is limited to a single atomic read.
+//
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+class MonitorScope : boost::noncopyable
+{
+
+	public :
+
+		MonitorScope( const Plug *plug, PerformanceMonitor::Phase phase )
+			:	m_monitor( PerformanceMonitor::active() )
+		{
+			if( m_monitor )
+			{
+				m_monitor->started( plug, phase );
+			}
+		}
+
+		~MonitorScope()
+		{
+			if( m_monitor )
+			{
+				m_monitor->finished();
+			}
+		}
+
+	private :
+
+		PerformanceMonitorPtr m_monitor;
+
+};
+
+} // namespace
 
 //////////////////////////////////////////////////////////////////////////
 //
@@ -184,7 +1140,7 @@ class ValuePlug::Computation
 
 		static void setCacheMemoryLimit( size_t bytes )
 		{
-			return g_valueCache.setMaxCost( bytes );
+			g_valueCache.setMaxCost( bytes );
 		}
 
 		static size_t cacheMemoryUsage()
@@ -192,30 +1148,81 @@ class ValuePlug::Computation
 			return g_valueCache.currentCost();
 		}
 
-		static void clearHashCaches()
+		static size_t getCacheMemoryLimit( IECore::TypeId plugType )
+		{
+			return g_valueCache.getMaxCost( plugType );
+		}
+
+		static void setCacheMemoryLimit( IECore::TypeId plugType, size_t bytes )
 		{
-			// The docs for enumerable_thread_specific aren't particularly clear
-			// on whether or not it's ok to iterate an e_t_s while concurrently using
-			// local(), which is what we do here. So far in practice it seems to be
-			// sufficient just to mutex the access to the hash cache within.
-			tbb::enumerable_thread_specific<ValuePlug::Computation::ThreadData>::iterator it, eIt;
-			for( it = g_threadData.begin(), eIt = g_threadData.end(); it != eIt; ++it )
+			g_valueCache.setMaxCost( plugType, bytes );
+		}
+
+		static size_t cacheMemoryUsage( IECore::TypeId plugType )
+		{
+			return g_valueCache.currentCost( plugType );
+		}
+
+		static CacheStatistics cacheStatistics()
+		{
+			CacheStatistics result;
+			g_valueCache.statistics( result );
+			for( tbb::enumerable_thread_specific<ThreadData>::iterator it = g_threadData.begin(), eIt = g_threadData.end(); it != eIt; ++it )
 			{
-				HashCacheMutex::scoped_lock lock( it->hashCacheMutex );
-				it->hashCache.clear();
+				result.threadHits += it->valueCache.hits;
 			}
+			return result;
 		}
 
-	private :
+		static void resetCacheStatistics()
+		{
+			g_valueCache.resetStatistics();
+			for( tbb::enumerable_thread_specific<ThreadData>::iterator it = g_threadData.begin(), eIt = g_threadData.end(); it != eIt; ++it )
+			{
+				it->valueCache.hits = 0;
+			}
+		}
 
-		Computation( const ValuePlug *resultPlug, const IECore::MurmurHash *precomputedHash = NULL )
-			:	m_resultPlug( resultPlug ), m_precomputedHash( precomputedHash ), m_resultValue( NULL ), m_threadData( &g_threadData.local() )
+		// Passed to g_valueCache, to remove evicted
+		// values from all the thread caches.
+		static void evictFromThreadCaches( const IECore::MurmurHash &hash )
 		{
-			if( m_threadData->computationStack.empty() )
+			for( tbb::enumerable_thread_specific<ThreadData>::iterator it = g_threadData.begin(), eIt = g_threadData.end(); it != eIt; ++it )
 			{
-				m_threadData->hashCacheComputationLock.acquire( m_threadData->hashCacheMutex );
+				it->valueCache.erase( hash );
 			}
+		}
+
+		static void invalidateHashCache()
+		{
+			g_hashCache.invalidate();
+		}
+
+		static std::string getDiskCacheDirectory()
+		{
+			return g_persistentCache.getDirectory();
+		}
+
+		static void setDiskCacheDirectory( const std::string &directory )
+		{
+			g_persistentCache.setDirectory( directory );
+		}
+
+		static size_t getDiskCacheSizeLimit()
+		{
+			return g_persistentCache.getMaxSize();
+		}
+
+		static void setDiskCacheSizeLimit( size_t bytes )
+		{
+			g_persistentCache.setMaxSize( bytes );
+		}
+
+	private :
 
+		Computation( const ValuePlug *resultPlug, const IECore::MurmurHash *precomputedHash = NULL )
+			:	m_resultPlug( resultPlug ), m_precomputedHash( precomputedHash ), m_resultValue( NULL ), m_threadData( &g_threadData.local() )
+		{
 			m_threadData->computationStack.push( this );
 		}
 
@@ -224,19 +1231,7 @@ class ValuePlug::Computation
 			m_threadData->computationStack.pop();
 			if( m_threadData->computationStack.empty() )
 			{
-				if( ++(m_threadData->hashCacheClearCount) == 100 )
-				{
-					// Prevent unbounded growth in the hash cache
-					// if many computations are being performed
-					// without any plugs being dirtied in between,
-					// by clearing it after every Nth computation.
-					// N == 100 was chosen based on memory/performance
-					// analysis of a particularly heavy render process.
-					m_threadData->hashCacheClearCount = 0;
-					m_threadData->hashCache.clear();
-				}
 				m_threadData->errorSource = NULL;
-				m_threadData->hashCacheComputationLock.release();
 			}
 		}
 
@@ -266,16 +1261,20 @@ class ValuePlug::Computation
 				return *m_precomputedHash;
 			}
 
-			HashCache &hashCache = m_threadData->hashCache;
-			HashCacheKey key( m_resultPlug, Context::current()->hash() );
-			HashCache::iterator it = hashCache.find( key );
-			if( it != hashCache.end() )
+			const HashCache::Key key( m_resultPlug, Context::current()->hash() );
+			const size_t generation = g_hashCache.generation();
+
+			IECore::MurmurHash h;
+			if( g_hashCache.get( key, h ) )
 			{
-				return it->second;
+				return h;
 			}
 
-			IECore::MurmurHash h = hashInternal();
-			hashCache[key] = h;
+			{
+				MonitorScope monitorScope( m_resultPlug, PerformanceMonitor::Hash );
+				h = hashInternal();
+			}
+			g_hashCache.set( key, h, generation );
 			return h;
 		}
 
@@ -285,29 +1284,38 @@ class ValuePlug::Computation
 			if( m_resultPlug->getFlags( Plug::Cacheable ) )
 			{
 				IECore::MurmurHash hash = this->hash();
+				// Check the per-thread cache first - this requires
+				// no contended locking.
+				if( m_threadData->valueCache.get( hash, m_resultValue ) )
+				{
+					reportCacheLookup( true );
+					return m_resultValue;
+				}
+
 				m_resultValue = g_valueCache.get( hash );
+				reportCacheLookup( m_resultValue.get() );
 				if( !m_resultValue )
 				{
-					computeOrSetFromInput();
-
-					// Store the value in the cache, after first checking that this hasn't
-					// been done already. The check is useful because it's common for an
-					// upstream compute triggered by computeOrSetFromInput() to have already
-					// done the work, and calling memoryUsage() can be very expensive for some
-					// datatypes. A prime example of this is the attribute state passed around
-					// in GafferScene - it's common for a selective filter to mean that the
-					// attribute compute is implemented as a pass-through (thus an upstream node
-					// will already have computed the same result) and the attribute data itself
-					// consists of many small objects for which computing memory usage is slow.
-					/// \todo Accessing the LRUCache multiple times like this does have an
-					/// overhead, and at some point we'll need to address that.
-					/// Perhaps we can augment our HashCache to also store computed values
-					/// temporarily - because the HashCache is per-thread, this would avoid
-					/// the locking associated with LRUCache::get().
-					if( !g_valueCache.get( hash ) )
+					if( m_resultPlug->getFlags( Plug::SharedCompute ) )
 					{
-						g_valueCache.set( hash, m_resultValue, m_resultValue->memoryUsage() );
+						sharedComputeAndCache( hash );
 					}
+					else
+					{
+						computeAndCache( hash );
+					}
+
+				}
+
+				// Only keep the value in the thread cache if it is in the
+				// main cache, so that the thread cache never keeps alive
+				// values that the memory limit wouldn't allow. We store
+				// before checking, so that an eviction which races with
+				// us is guaranteed to remove the entry one way or another.
+				m_threadData->valueCache.set( hash, m_resultValue );
+				if( !g_valueCache.contains( hash ) )
+				{
+					m_threadData->valueCache.erase( hash );
 				}
 			}
 			else
@@ -320,6 +1328,150 @@ class ValuePlug::Computation
 			return m_resultValue;
 		}
 
+		// Fills in m_resultValue using computeOrSetFromInput(), and
+		// then stores it in the value cache. For DiskCacheable plugs
+		// the persistent cache is checked before computing, and
+		// updated afterwards.
+		void computeAndCache( const IECore::MurmurHash &hash )
+		{
+			const bool usePersistentCache = g_persistentCache.enabled() && m_resultPlug->getFlags( Plug::DiskCacheable );
+
+			const tbb::tick_count startTime = tbb::tick_count::now();
+			if( usePersistentCache )
+			{
+				m_resultValue = g_persistentCache.get( hash );
+			}
+			if( !m_resultValue )
+			{
+				computeOrSetFromInput();
+				if( usePersistentCache )
+				{
+					g_persistentCache.set( hash, m_resultValue.get() );
+				}
+			}
+			// When the value was loaded from disk, this is the time taken
+			// to load it, which is what it would cost to get it back again.
+			const double computeTime = ( tbb::tick_count::now() - startTime ).seconds();
+
+			// Store the value in the cache, after first checking that this hasn't
+			// been done already. The check is useful because it's common for an
+			// upstream compute triggered by computeOrSetFromInput() to have already
+			// done the work, and calling memoryUsage() can be very expensive for some
+			// datatypes. A prime example of this is the attribute state passed around
+			// in GafferScene - it's common for a selective filter to mean that the
+			// attribute compute is implemented as a pass-through (thus an upstream node
+			// will already have computed the same result) and the attribute data itself
+			// consists of many small objects for which computing memory usage is slow.
+			if( !g_valueCache.contains( hash ) )
+			{
+				const size_t cost = memoryUsage();
+				if( g_valueCache.set( hash, m_resultValue, cost, computeTime, m_resultPlug->typeId() ) )
+				{
+					if( PerformanceMonitor *monitor = PerformanceMonitor::active() )
+					{
+						monitor->cacheInsertion( m_resultPlug, cost );
+					}
+				}
+			}
+		}
+
+		// Returns the memory usage of m_resultValue for the purposes
+		// of cache accounting. For the datatypes where memoryUsage() is
+		// slow, we only measure every Nth value computed for each plug,
+		// and use the last measurement as an approximation for the
+		// others. Successive values for the same plug tend to be
+		// similar in size, and the cache limit needn't be exact.
+		size_t memoryUsage()
+		{
+			if( m_resultValue->typeId() != IECore::CompoundObjectTypeId )
+			{
+				return m_resultValue->memoryUsage();
+			}
+
+			MemoryEstimates &estimates = m_threadData->memoryEstimates;
+			if( estimates.size() >= maxMemoryEstimates )
+			{
+				estimates.clear();
+			}
+
+			MemoryEstimate &estimate = estimates[m_resultPlug];
+			if( estimate.count++ % memoryEstimateInterval == 0 )
+			{
+				estimate.memoryUsage = m_resultValue->memoryUsage();
+			}
+			return estimate.memoryUsage;
+		}
+
+		void reportCacheLookup( bool hit ) const
+		{
+			if( PerformanceMonitor *monitor = PerformanceMonitor::active() )
+			{
+				monitor->cacheLookup( m_resultPlug, hit );
+			}
+		}
+
+		// As for computeAndCache(), but sharing the work with any other
+		// threads requesting the same value at the same time.
+		void sharedComputeAndCache( const IECore::MurmurHash &hash )
+		{
+			InFlightTable::EntryPtr inFlight;
+			InFlightTable::Entry::Mutex::scoped_lock lock;
+			if( g_inFlightTable.acquire( hash, inFlight, lock ) )
+			{
+				// We're responsible for the computation. Ownership is
+				// released on scope exit, including when computation
+				// throws, in which case waiters will find a NULL value
+				// and compute for themselves.
+				InFlightOwnership ownership( hash, lock, m_threadData );
+				computeAndCache( hash );
+				inFlight->value = m_resultValue;
+				return;
+			}
+
+			if( !m_threadData->inFlightOwnerships )
+			{
+				// Wait for the owner to finish.
+				lock.acquire( inFlight->mutex );
+				m_resultValue = inFlight->value;
+				lock.release();
+				if( m_resultValue )
+				{
+					return;
+				}
+			}
+
+			// Either the owner failed or we can't safely wait
+			// for it, so we must do the work ourselves.
+			computeAndCache( hash );
+		}
+
+		struct InFlightOwnership : boost::noncopyable
+		{
+
+			InFlightOwnership( const IECore::MurmurHash &hash, InFlightTable::Entry::Mutex::scoped_lock &lock, ThreadData *threadData )
+				:	m_hash( hash ), m_lock( lock ), m_threadData( threadData )
+			{
+				m_threadData->inFlightOwnerships++;
+			}
+
+			~InFlightOwnership()
+			{
+				// Remove from the table before releasing the lock,
+				// so that any new requests will find the result
+				// in the value cache instead.
+				g_inFlightTable.remove( m_hash );
+				m_lock.release();
+				m_threadData->inFlightOwnerships--;
+			}
+
+			private :
+
+				const IECore::MurmurHash m_hash;
+				InFlightTable::Entry::Mutex::scoped_lock &m_lock;
+				ThreadData *m_threadData;
+
+		};
+
 		// Calculates the hash for m_resultPlug - not using any cache at all.
 		IECore::MurmurHash hashInternal() const
 		{
@@ -358,6 +1510,8 @@ class ValuePlug::Computation
 		// Throws if the result was not successfully retrieved.
 		void computeOrSetFromInput()
 		{
+			MonitorScope monitorScope( m_resultPlug, PerformanceMonitor::Compute );
+
 			if( const ValuePlug *input = m_resultPlug->getInput<ValuePlug>() )
 			{
 				// cast is ok, because we know that the resulting setValue() call won't
@@ -401,27 +1555,6 @@ class ValuePlug::Computation
 			}
 		}
 
-		// During a single graph evaluation, we actually call ValuePlug::hash()
-		// many times for the same plugs. First hash() is called for the terminating plug,
-		// which will call hash() for all the upstream plugs, and then compute() is called
-		// for the terminating plug, which will call getValue() on the upstream plugs. But
-		// those upstream plugs will need to call their hash() again in getValue(), so their
-		// value can be cached. This ripples on up the chain, leading to quadratic complexity
-		// in the length of the chain of nodes - not good. Thanks is due to David Minor for
-		// being the first to point this out.
-		//
-		// We address this problem by keeping a per-thread cache of hashes, indexed
-		// by the plug the hash is for and the context the hash was performed in. The
-		// typedefs below describe that data structure. We use Plug::dirty() to empty
-		// the caches, because they are invalidated whenever an upstream value or
-		// connection is changed. We also clear the cache unconditionally every N
-		// computations, to prevent unbounded growth.
-		typedef std::pair<const ValuePlug *, IECore::MurmurHash> HashCacheKey;
-		typedef boost::unordered_map<HashCacheKey, IECore::MurmurHash> HashCache;
-		// Even though the hash cache is per-thread, we do need to visit all caches
-		// in clearHashCaches(), so we protect each hash cache with a mutex.
-		typedef tbb::spin_mutex HashCacheMutex;
-
 		// A computation starts with a call to ValuePlug::getValue(), but the compute()
 		// that triggers will make calls to getValue() on upstream plugs too. We use this
 		// stack to keep track of the current computation - each upstream evaluation pushes
@@ -429,21 +1562,101 @@ class ValuePlug::Computation
 		// the last entry.
 		typedef std::stack<Computation *> ComputationStack;
 
+		// A small direct-mapped cache of recently computed values, which sits
+		// in front of the shared g_valueCache. Being per-thread, its lock is
+		// almost never contended, and it frequently satisfies the repeated
+		// requests for the same value that are made when a compute() pulls on
+		// several outputs of the same upstream node. Entries are only kept for
+		// values held by g_valueCache, and are removed by evictFromThreadCaches()
+		// when g_valueCache evicts them, so the thread caches never keep alive
+		// values which the memory limits don't allow.
+		class ThreadValueCache
+		{
+
+			public :
+
+				ThreadValueCache()
+				{
+					hits = 0;
+				}
+
+				bool get( const IECore::MurmurHash &hash, IECore::ConstObjectPtr &value )
+				{
+					tbb::spin_mutex::scoped_lock lock( m_mutex );
+					const Entry &entry = m_entries[index( hash )];
+					if( entry.value && entry.hash == hash )
+					{
+						value = entry.value;
+						hits++;
+						return true;
+					}
+					return false;
+				}
+
+				void set( const IECore::MurmurHash &hash, const IECore::ConstObjectPtr &value )
+				{
+					tbb::spin_mutex::scoped_lock lock( m_mutex );
+					Entry &entry = m_entries[index( hash )];
+					entry.hash = hash;
+					entry.value = value;
+				}
+
+				void erase( const IECore::MurmurHash &hash )
+				{
+					tbb::spin_mutex::scoped_lock lock( m_mutex );
+					Entry &entry = m_entries[index( hash )];
+					if( entry.hash == hash )
+					{
+						entry.value = NULL;
+					}
+				}
+
+				// Atomic only so that cacheStatistics() may
+				// read it from another thread.
+				tbb::atomic<size_t> hits;
+
+			private :
+
+				struct Entry
+				{
+					IECore::MurmurHash hash;
+					IECore::ConstObjectPtr value;
+				};
+
+				static size_t index( const IECore::MurmurHash &hash )
+				{
+					return hash_value( hash ) % numEntries;
+				}
+
+				static const size_t numEntries = 32;
+				Entry m_entries[numEntries];
+				tbb::spin_mutex m_mutex;
+
+		};
+
+		// Used by memoryUsage() to approximate the size of values
+		// for which memoryUsage() is expensive.
+		struct MemoryEstimate
+		{
+			MemoryEstimate() : memoryUsage( 0 ), count( 0 ) {}
+			size_t memoryUsage;
+			size_t count;
+		};
+		typedef boost::unordered_map<const ValuePlug *, MemoryEstimate> MemoryEstimates;
+		static const size_t memoryEstimateInterval = 16;
+		static const size_t maxMemoryEstimates = 10000;
+
 		// To support multithreading, each thread has it's own state.
 		struct ThreadData
 		{
-			ThreadData() :	hashCacheClearCount( 0 ), errorSource( NULL ) {}
-			int hashCacheClearCount;
-			HashCache hashCache;
-			// Used to protect the computation's use of the hash
-			// cache from clearHashCaches() method.
-			HashCacheMutex hashCacheMutex;
-			// Lock acquired when first computation is pushed
-			// onto computationStack - this prevents clearHashCaches()
-			// from clearing it while it's in use.
-			HashCacheMutex::scoped_lock hashCacheComputationLock;
+			ThreadData() :	errorSource( NULL ), inFlightOwnerships( 0 ) {}
+			ThreadValueCache valueCache;
+			MemoryEstimates memoryEstimates;
 			ComputationStack computationStack;
 			const Plug *errorSource;
+			// The number of entries in the InFlightTable
+			// owned by this thread.
+			int inFlightOwnerships;
 		};
 
 		static tbb::enumerable_thread_specific<ThreadData> g_threadData;
@@ -453,22 +1666,23 @@ class ValuePlug::Computation
 		IECore::ConstObjectPtr m_resultValue;
 		ThreadData *m_threadData;
 
-		static IECore::ObjectPtr nullGetter( const IECore::MurmurHash &h, size_t &cost )
-		{
-			cost = 0;
-			return NULL;
-		}
-
 		// A cache mapping from ValuePlug::hash() to the result of the previous computation
 		// for that hash. This allows us to cache results for faster repeat evaluation. Unlike
 		// the HashCache, the ValueCache persists from one graph evaluation to the next.
-		typedef IECore::LRUCache<IECore::MurmurHash, IECore::ConstObjectPtr> ValueCache;
 		static ValueCache g_valueCache;
 
+		static HashCache g_hashCache;
+
+		static InFlightTable g_inFlightTable;
+		static PersistentCache g_persistentCache;
+
 };
 
 tbb::enumerable_thread_specific<ValuePlug::Computation::ThreadData> ValuePlug::Computation::g_threadData;
-ValuePlug::Computation::ValueCache ValuePlug::Computation::g_valueCache( nullGetter, 1024 * 1024 * 500 );
+ValueCache ValuePlug::Computation::g_valueCache( 1024 * 1024 * 500, ValuePlug::Computation::evictFromThreadCaches );
+HashCache ValuePlug::Computation::g_hashCache;
+InFlightTable ValuePlug::Computation::g_inFlightTable;
+PersistentCache ValuePlug::Computation::g_persistentCache;
 
 //////////////////////////////////////////////////////////////////////////
 // SetValueAction implementation
@@ -554,10 +1768,10 @@ ValuePlug::ValuePlug( const std::string &name, Direction direction, unsigned fla
 
 ValuePlug::~ValuePlug()
 {
-	// Clear hash cache, so that a newly created plug that just
+	// Invalidate hash cache, so that a newly created plug that just
 	// happens to reuse our address won't end up inadvertently also
 	// reusing our cache entries.
-	Computation::clearHashCaches();
+	Computation::invalidateHashCache();
 }
 
 bool ValuePlug::acceptsChild( const GraphComponent *potentialChild ) const
@@ -824,9 +2038,9 @@ void ValuePlug::emitPlugSet()
 void ValuePlug::dirty()
 {
 	/// \todo We might want to investigate methods of doing a
-	/// more fine grained clearing of only the dirtied plugs,
-	/// rather than clearing the whole cache.
-	Computation::clearHashCaches();
+	/// more fine grained invalidation of only the dirtied plugs,
+	/// rather than invalidating the whole cache.
+	Computation::invalidateHashCache();
 }
 
 size_t ValuePlug::getCacheMemoryLimit()
@@ -843,3 +2057,53 @@ size_t ValuePlug::cacheMemoryUsage()
 {
 	return Computation::cacheMemoryUsage();
 }
+
+size_t ValuePlug::getCacheMemoryLimit( IECore::TypeId plugType )
+{
+	return Computation::getCacheMemoryLimit( plugType );
+}
+
+void ValuePlug::setCacheMemoryLimit( IECore::TypeId plugType, size_t bytes )
+{
+	Computation::setCacheMemoryLimit( plugType, bytes );
+}
+
+size_t ValuePlug::cacheMemoryUsage( IECore::TypeId plugType )
+{
+	return Computation::cacheMemoryUsage( plugType );
+}
+
+ValuePlug::CacheStatistics::CacheStatistics()
+	:	hits( 0 ), threadHits( 0 ), misses( 0 ), contentions( 0 ), evictions( 0 )
+{
+}
+
+ValuePlug::CacheStatistics ValuePlug::cacheStatistics()
+{
+	return Computation::cacheStatistics();
+}
+
+void ValuePlug::resetCacheStatistics()
+{
+	Computation::resetCacheStatistics();
+}
+
+std::string ValuePlug::getDiskCacheDirectory()
+{
+	return Computation::getDiskCacheDirectory();
+}
+
+void ValuePlug::setDiskCacheDirectory( const std::string &directory )
+{
+	Computation::setDiskCacheDirectory( directory );
+}
+
+size_t ValuePlug::getDiskCacheSizeLimit()
+{
+	return Computation::getDiskCacheSizeLimit();
+}
+
+void ValuePlug::setDiskCacheSizeLimit( size_t bytes )
+{
+	Computation::setDiskCacheSizeLimit( bytes );
+}
@@ -0,0 +1,93 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2015, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#include "boost/python.hpp"
+
+#include "IECorePython/RefCountedBinding.h"
+
+#include "Gaffer/PerformanceMonitor.h"
+
+#include "GafferBindings/PerformanceMonitorBinding.h"
+
+using namespace boost::python;
+using namespace Gaffer;
+
+namespace
+{
+
+// Returns a list of ( plug, statistics ) tuples.
+list allStatistics( PerformanceMonitor &m )
+{
+	const PerformanceMonitor::StatisticsMap statistics = m.allStatistics();
+
+	list result;
+	for( PerformanceMonitor::StatisticsMap::const_iterator it = statistics.begin(), eIt = statistics.end(); it != eIt; ++it )
+	{
+		result.append( make_tuple( boost::const_pointer_cast<Plug>( it->first ), it->second ) );
+	}
+	return result;
+}
+
+} // namespace
+
+void GafferBindings::bindPerformanceMonitor()
+{
+
+	scope s = IECorePython::RefCountedClass<PerformanceMonitor, IECore::RefCounted>( "PerformanceMonitor" )
+		.def( init<>() )
+		.def( "setActive", &PerformanceMonitor::setActive )
+		.def( "getActive", &PerformanceMonitor::getActive )
+		.def( "allStatistics", &allStatistics )
+		.def( "plugStatistics", &PerformanceMonitor::plugStatistics )
+		.def( "combinedStatistics", &PerformanceMonitor::combinedStatistics )
+		.def( "clear", &PerformanceMonitor::clear )
+		.def( "report", &PerformanceMonitor::report, ( arg( "maxLinesPerMetric" ) = 50 ) )
+	;
+
+	class_<PerformanceMonitor::Statistics>( "Statistics" )
+		.def_readonly( "hashCount", &PerformanceMonitor::Statistics::hashCount )
+		.def_readonly( "computeCount", &PerformanceMonitor::Statistics::computeCount )
+		.def_readonly( "cacheHits", &PerformanceMonitor::Statistics::cacheHits )
+		.def_readonly( "cacheMisses", &PerformanceMonitor::Statistics::cacheMisses )
+		.def_readonly( "cacheMemory", &PerformanceMonitor::Statistics::cacheMemory )
+		.def_readonly( "hashTime", &PerformanceMonitor::Statistics::hashTime )
+		.def_readonly( "computeTime", &PerformanceMonitor::Statistics::computeTime )
+		.def( self == self )
+		.def( self != self )
+	;
+
+}
@@ -151,8 +151,8 @@ std::string PlugSerialiser::directionRepr( Plug::Direction direction )
 
 std::string PlugSerialiser::flagsRepr( unsigned flags )
 {
-	static const Plug::Flags values[] = { Plug::Dynamic, Plug::Serialisable, Plug::AcceptsInputs, Plug::PerformsSubstitutions, Plug::Cacheable, Plug::ReadOnly, Plug::None };
-	static const char *names[] = { "Dynamic", "Serialisable", "AcceptsInputs", "PerformsSubstitutions", "Cacheable", "ReadOnly", 0 };
+	static const Plug::Flags values[] = { Plug::Dynamic, Plug::Serialisable, Plug::AcceptsInputs, Plug::PerformsSubstitutions, Plug::Cacheable, Plug::ReadOnly, Plug::SharedCompute, Plug::DiskCacheable, Plug::None };
+	static const char *names[] = { "Dynamic", "Serialisable", "AcceptsInputs", "PerformsSubstitutions", "Cacheable", "ReadOnly", "SharedCompute", "DiskCacheable", 0 };
 
 	int defaultButOffCount = 0;
 	std::string defaultButOff;
@@ -238,6 +238,8 @@ void GafferBindings::bindPlug()
 			.value( "PerformsSubstitutions", Plug::PerformsSubstitutions )
 			.value( "Cacheable", Plug::Cacheable )
 			.value( "ReadOnly", Plug::ReadOnly )
+			.value( "SharedCompute", Plug::SharedCompute )
+			.value( "DiskCacheable", Plug::DiskCacheable )
 			.value( "Default", Plug::Default )
 			.value( "All", Plug::All )
 		;
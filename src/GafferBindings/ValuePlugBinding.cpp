@@ -265,7 +265,7 @@ bool ValuePlugSerialiser::valueNeedsSerialisation( const Gaffer::ValuePlug *plug
 
 void GafferBindings::bindValuePlug()
 {
-	PlugClass<ValuePlug>()
+	scope s = PlugClass<ValuePlug>()
 		.def( boost::python::init<const std::string &, Plug::Direction, unsigned>(
 				(
 					boost::python::arg_( "name" ) = GraphComponent::defaultName<ValuePlug>(),
@@ -280,14 +280,37 @@ void GafferBindings::bindValuePlug()
 		.def( "isSetToDefault", &ValuePlug::isSetToDefault )
 		.def( "hash", (IECore::MurmurHash (ValuePlug::*)() const)&ValuePlug::hash )
 		.def( "hash", (void (ValuePlug::*)( IECore::MurmurHash & ) const)&ValuePlug::hash )
-		.def( "getCacheMemoryLimit", &ValuePlug::getCacheMemoryLimit )
+		.def( "getCacheMemoryLimit", (size_t (*)())&ValuePlug::getCacheMemoryLimit )
+		.def( "getCacheMemoryLimit", (size_t (*)( IECore::TypeId ))&ValuePlug::getCacheMemoryLimit )
 		.staticmethod( "getCacheMemoryLimit" )
-		.def( "setCacheMemoryLimit", &ValuePlug::setCacheMemoryLimit )
+		.def( "setCacheMemoryLimit", (void (*)( size_t ))&ValuePlug::setCacheMemoryLimit )
+		.def( "setCacheMemoryLimit", (void (*)( IECore::TypeId, size_t ))&ValuePlug::setCacheMemoryLimit )
 		.staticmethod( "setCacheMemoryLimit" )
-		.def( "cacheMemoryUsage", &ValuePlug::cacheMemoryUsage )
+		.def( "cacheMemoryUsage", (size_t (*)())&ValuePlug::cacheMemoryUsage )
+		.def( "cacheMemoryUsage", (size_t (*)( IECore::TypeId ))&ValuePlug::cacheMemoryUsage )
 		.staticmethod( "cacheMemoryUsage" )
+		.def( "cacheStatistics", &ValuePlug::cacheStatistics )
+		.staticmethod( "cacheStatistics" )
+		.def( "resetCacheStatistics", &ValuePlug::resetCacheStatistics )
+		.staticmethod( "resetCacheStatistics" )
+		.def( "getDiskCacheDirectory", &ValuePlug::getDiskCacheDirectory )
+		.staticmethod( "getDiskCacheDirectory" )
+		.def( "setDiskCacheDirectory", &ValuePlug::setDiskCacheDirectory )
+		.staticmethod( "setDiskCacheDirectory" )
+		.def( "getDiskCacheSizeLimit", &ValuePlug::getDiskCacheSizeLimit )
+		.staticmethod( "getDiskCacheSizeLimit" )
+		.def( "setDiskCacheSizeLimit", &ValuePlug::setDiskCacheSizeLimit )
+		.staticmethod( "setDiskCacheSizeLimit" )
 		.def( "__repr__", &repr )
 	;
 
+	class_<ValuePlug::CacheStatistics>( "CacheStatistics" )
+		.def_readonly( "hits", &ValuePlug::CacheStatistics::hits )
+		.def_readonly( "threadHits", &ValuePlug::CacheStatistics::threadHits )
+		.def_readonly( "misses", &ValuePlug::CacheStatistics::misses )
+		.def_readonly( "contentions", &ValuePlug::CacheStatistics::contentions )
+		.def_readonly( "evictions", &ValuePlug::CacheStatistics::evictions )
+	;
+
 	Serialisation::registerSerialiser( Gaffer::ValuePlug::staticTypeId(), new ValuePlugSerialiser );
 }
@@ -47,26 +47,56 @@ using namespace GafferImage;
 
 IE_CORE_DEFINERUNTIMETYPED( ColorProcessor );
 
-size_t ColorProcessor::g_firstPlugIndex = 0;
+namespace
+{
 
-ColorProcessor::ColorProcessor( const std::string &name )
-	:	ImageProcessor( name )
+const std::vector<std::string> &rgbChannelNames()
 {
-	storeIndexOfNextChild( g_firstPlugIndex );
+	static std::vector<std::string> g_names;
+	if( g_names.empty() )
+	{
+		g_names.push_back( "R" );
+		g_names.push_back( "G" );
+		g_names.push_back( "B" );
+	}
+	return g_names;
+}
 
-	addChild(
-		new ObjectPlug(
-			"__colorData",
-			Gaffer::Plug::Out,
-			new ObjectVector
-		)
-	);
+// Creates a context for requesting R, G and B together
+// from multiChannelDataPlug().
+ContextPtr rgbContext( const Context *context )
+{
+	ContextPtr result = new Context( *context, Context::Borrowed );
+	result->remove( ImagePlug::channelNameContextName );
+	result->set( ImagePlug::channelNamesContextName, rgbChannelNames() );
+	return result;
+}
 
-	// Because our implementation of computeChannelData() is so simple,
-	// just copying data out of our intermediate colorDataPlug(), it is
-	// actually quicker not to cache the result.
+// Returns the ColorProcessor whose output provides the input
+// to the specified plug, or NULL if there is no such node.
+const ColorProcessor *colorProcessorInput( const ImagePlug *plug )
+{
+	const ImagePlug *source = plug->source<ImagePlug>();
+	const ColorProcessor *colorProcessor = runTimeCast<const ColorProcessor>( source->node() );
+	if( colorProcessor && source == colorProcessor->outPlug() )
+	{
+		return colorProcessor;
+	}
+	return NULL;
+}
+
+} // namespace
+
+ColorProcessor::ColorProcessor( const std::string &name )
+	:	ImageProcessor( name )
+{
+	// We process R, G and B together in computeMultiChannelData(), and
+	// it is this result that we want to cache. Because our implementation
+	// of computeChannelData() is so simple, just extracting a single channel
+	// from the multi-channel result, it is actually quicker not to cache it.
+	outPlug()->multiChannelDataPlug()->setFlags( Plug::Cacheable, true );
 	outPlug()->channelDataPlug()->setFlags( Plug::Cacheable, false );
-	
+
 	// We don't ever want to change the these, so we make pass-through connections.
 	outPlug()->dataWindowPlug()->setInput( inPlug()->dataWindowPlug() );
 	outPlug()->metadataPlug()->setInput( inPlug()->metadataPlug() );
@@ -77,28 +107,15 @@ ColorProcessor::~ColorProcessor()
 {
 }
 
-Gaffer::ObjectPlug *ColorProcessor::colorDataPlug()
-{
-	return getChild<ObjectPlug>( g_firstPlugIndex );
-}
-
-const Gaffer::ObjectPlug *ColorProcessor::colorDataPlug() const
-{
-	return getChild<ObjectPlug>( g_firstPlugIndex );
-}
-
 void ColorProcessor::affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs ) const
 {
 	ImageProcessor::affects( input, outputs );
 
 	const ImagePlug *in = inPlug();
 	if( affectsColorData( input ) )
-	{
-		outputs.push_back( colorDataPlug() );
-	}
-	else if( input == colorDataPlug()  )
 	{
 		outputs.push_back( outPlug()->channelDataPlug() );
+		outputs.push_back( outPlug()->multiChannelDataPlug() );
 	}
 	else if ( input->parent<ImagePlug>() == in && input != in->channelDataPlug() )
 	{
@@ -116,46 +133,6 @@ bool ColorProcessor::channelEnabled( const std::string &channel ) const
 	return channel == "R" || channel == "G" || channel == "B";
 }
 
-void ColorProcessor::hash( const Gaffer::ValuePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const
-{
-	ImageProcessor::hash( output, context, h );
-
-	if( output == colorDataPlug() )
-	{
-		hashColorData( context, h );
-	}
-}
-
-void ColorProcessor::compute( Gaffer::ValuePlug *output, const Gaffer::Context *context ) const
-{
-	if( output == colorDataPlug() )
-	{
-		FloatVectorDataPtr r, g, b;
-		{
-			ContextPtr tmpContext = new Context( *context, Context::Borrowed );
-			Context::Scope scopedContext( tmpContext.get() );
-			tmpContext->set( ImagePlug::channelNameContextName, string( "R" ) );
-			r = inPlug()->channelDataPlug()->getValue()->copy();
-			tmpContext->set( ImagePlug::channelNameContextName, string( "G" ) );
-			g = inPlug()->channelDataPlug()->getValue()->copy();
-			tmpContext->set( ImagePlug::channelNameContextName, string( "B" ) );
-			b = inPlug()->channelDataPlug()->getValue()->copy();
-		}
-
-		processColorData( context, r.get(), g.get(), b.get() );
-
-		ObjectVectorPtr result = new ObjectVector();
-		result->members().push_back( r );
-		result->members().push_back( g );
-		result->members().push_back( b );
-
-		static_cast<ObjectPlug *>( output )->setValue( result );
-		return;
-	}
-
-	ImageProcessor::compute( output, context );
-}
-
 void ColorProcessor::hashFormat( const GafferImage::ImagePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const
 {
 	h = inPlug()->formatPlug()->hash();
@@ -170,12 +147,21 @@ void ColorProcessor::hashChannelData( const GafferImage::ImagePlug *output, cons
 {
 	ImageProcessor::hashChannelData( output, context, h );
 	h.append( context->get<std::string>( ImagePlug::channelNameContextName ) );
-	colorDataPlug()->hash( h );
+
+	ContextPtr tmpContext = rgbContext( context );
+	Context::Scope scopedContext( tmpContext.get() );
+	outPlug()->multiChannelDataPlug()->hash( h );
 }
 
 IECore::ConstFloatVectorDataPtr ColorProcessor::computeChannelData( const std::string &channelName, const Imath::V2i &tileOrigin, const Gaffer::Context *context, const ImagePlug *parent ) const
 {
-	ConstObjectVectorPtr colorData = boost::static_pointer_cast<const ObjectVector>( colorDataPlug()->getValue() );
+	ConstObjectVectorPtr colorData;
+	{
+		ContextPtr tmpContext = rgbContext( context );
+		Context::Scope scopedContext( tmpContext.get() );
+		colorData = outPlug()->multiChannelDataPlug()->getValue();
+	}
+
 	if( channelName == "R" )
 	{
 		return boost::static_pointer_cast<const FloatVectorData>( colorData->members()[0] );
@@ -193,6 +179,67 @@ IECore::ConstFloatVectorDataPtr ColorProcessor::computeChannelData( const std::s
 	return NULL;
 }
 
+void ColorProcessor::hashMultiChannelData( const GafferImage::ImagePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const
+{
+	const std::vector<std::string> &channelNames = context->get<std::vector<std::string> >( ImagePlug::channelNamesContextName );
+	if( channelNames != rgbChannelNames() )
+	{
+		// Gather R, G and B individually, so they share
+		// the same processed result.
+		ImageProcessor::hashMultiChannelData( output, context, h );
+		return;
+	}
+
+	ComputeNode::hash( output->multiChannelDataPlug(), context, h );
+	hashColorData( context, h );
+}
+
+IECore::ConstObjectVectorPtr ColorProcessor::computeMultiChannelData( const std::vector<std::string> &channelNames, const Imath::V2i &tileOrigin, const Gaffer::Context *context, const ImagePlug *parent ) const
+{
+	if( channelNames != rgbChannelNames() )
+	{
+		return ImageProcessor::computeMultiChannelData( channelNames, tileOrigin, context, parent );
+	}
+
+	// Rather than copying and caching the output of every node in a chain
+	// of ColorProcessors, we gather the chain upstream of us and apply the
+	// whole thing in a single pass. Disabled nodes are skipped, since they
+	// pass through their input unchanged.
+	vector<const ColorProcessor *> chain( 1, this );
+	const ImagePlug *in = inPlug();
+	while( const ColorProcessor *upstream = colorProcessorInput( in ) )
+	{
+		if( upstream->enabled() )
+		{
+			if( !upstream->channelEnabled( "R" ) || !upstream->channelEnabled( "G" ) || !upstream->channelEnabled( "B" ) )
+			{
+				break;
+			}
+			chain.push_back( upstream );
+		}
+		in = upstream->inPlug();
+	}
+
+	// The context already specifies R, G and B, so we can fetch
+	// all three from the input at once.
+	ConstObjectVectorPtr inData = in->multiChannelDataPlug()->getValue();
+	FloatVectorDataPtr r = static_cast<const FloatVectorData *>( inData->members()[0].get() )->copy();
+	FloatVectorDataPtr g = static_cast<const FloatVectorData *>( inData->members()[1].get() )->copy();
+	FloatVectorDataPtr b = static_cast<const FloatVectorData *>( inData->members()[2].get() )->copy();
+
+	for( vector<const ColorProcessor *>::const_reverse_iterator it = chain.rbegin(), eIt = chain.rend(); it != eIt; ++it )
+	{
+		(*it)->processColorData( context, r.get(), g.get(), b.get() );
+	}
+
+	ObjectVectorPtr result = new ObjectVector();
+	result->members().push_back( r );
+	result->members().push_back( g );
+	result->members().push_back( b );
+
+	return result;
+}
+
 bool ColorProcessor::affectsColorData( const Gaffer::Plug *input ) const
 {
 	return input == inPlug()->channelDataPlug();
@@ -200,12 +247,6 @@ bool ColorProcessor::affectsColorData( const Gaffer::Plug *input ) const
 
 void ColorProcessor::hashColorData( const Gaffer::Context *context, IECore::MurmurHash &h ) const
 {
-	ContextPtr tmpContext = new Context( *context, Context::Borrowed );
-	Context::Scope scopedContext( tmpContext.get() );
-	tmpContext->set( ImagePlug::channelNameContextName, string( "R" ) );
-	inPlug()->channelDataPlug()->hash( h );
-	tmpContext->set( ImagePlug::channelNameContextName, string( "G" ) );
-	inPlug()->channelDataPlug()->hash( h );
-	tmpContext->set( ImagePlug::channelNameContextName, string( "B" ) );
-	inPlug()->channelDataPlug()->hash( h );
+	// The context already specifies R, G and B.
+	inPlug()->multiChannelDataPlug()->hash( h );
 }
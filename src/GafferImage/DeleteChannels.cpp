@@ -67,6 +67,7 @@ DeleteChannels::DeleteChannels( const std::string &name )
 	outPlug()->dataWindowPlug()->setInput( inPlug()->dataWindowPlug() );
 	outPlug()->metadataPlug()->setInput( inPlug()->metadataPlug() );
 	outPlug()->channelDataPlug()->setInput( inPlug()->channelDataPlug() );
+	outPlug()->multiChannelDataPlug()->setInput( inPlug()->multiChannelDataPlug() );
 
 }
 
@@ -38,7 +38,9 @@
 #include "boost/bind.hpp"
 #include "boost/bind/placeholders.hpp"
 #include "boost/lexical_cast.hpp"
-#include "boost/multi_array.hpp"
+#include "boost/scoped_array.hpp"
+
+#include "tbb/spin_mutex.h"
 
 #include "IECore/LRUCache.h"
 #include "IECore/DisplayDriverServer.h"
@@ -92,15 +94,14 @@ class GafferDisplayDriver : public IECore::DisplayDriver
 				m_gafferFormat( displayWindow, 1 ),
 				m_gafferDataWindow( m_gafferFormat.yDownToFormatSpace( dataWindow ) )
 		{
-			const V2i dataWindowMinTileIndex = ImagePlug::tileOrigin( m_gafferDataWindow.min ) / ImagePlug::tileSize();
-			const V2i dataWindowMaxTileIndex = ImagePlug::tileOrigin( m_gafferDataWindow.max ) / ImagePlug::tileSize();
+			m_minTileIndex = ImagePlug::tileOrigin( m_gafferDataWindow.min ) / ImagePlug::tileSize();
+			m_numTiles = ImagePlug::tileOrigin( m_gafferDataWindow.max ) / ImagePlug::tileSize() - m_minTileIndex + V2i( 1 );
 
-			m_tiles.resize(
-				TileArray::extent_gen()
-					[TileArray::extent_range( dataWindowMinTileIndex.x, dataWindowMaxTileIndex.x + 1 )]
-					[TileArray::extent_range( dataWindowMinTileIndex.y, dataWindowMaxTileIndex.y + 1 )]
-					[channelNames.size()]
-			);
+			m_tiles.reset( new Tile[m_numTiles.x * m_numTiles.y] );
+			for( int i = 0, e = m_numTiles.x * m_numTiles.y; i < e; ++i )
+			{
+				m_tiles[i].channels.resize( channelNames.size() );
+			}
 
 			m_parameters = parameters ? parameters->copy() : CompoundDataPtr( new CompoundData );
 			instanceCreatedSignal()( this );
@@ -127,46 +128,50 @@ class GafferDisplayDriver : public IECore::DisplayDriver
 
 		virtual void imageData( const Imath::Box2i &box, const float *data, size_t dataSize )
 		{
-			Box2i yUpBox = m_gafferFormat.yDownToFormatSpace( box );
+			const Box2i yUpBox = m_gafferFormat.yDownToFormatSpace( box );
 			const V2i boxMinTileOrigin = ImagePlug::tileOrigin( yUpBox.min );
 			const V2i boxMaxTileOrigin = ImagePlug::tileOrigin( yUpBox.max );
+			const int numChannels = channelNames().size();
+
 			for( int tileOriginY = boxMinTileOrigin.y; tileOriginY <= boxMaxTileOrigin.y; tileOriginY += ImagePlug::tileSize() )
 			{
 				for( int tileOriginX = boxMinTileOrigin.x; tileOriginX <= boxMaxTileOrigin.x; tileOriginX += ImagePlug::tileSize() )
 				{
-					for( int channelIndex = 0, numChannels = channelNames().size(); channelIndex < numChannels; ++channelIndex )
+					const V2i tileOrigin( tileOriginX, tileOriginY );
+					Tile *tile = getTile( tileOrigin );
+					if( !tile )
 					{
-						const V2i tileOrigin( tileOriginX, tileOriginY );
-						ConstFloatVectorDataPtr tileData = getTile( tileOrigin, channelIndex );
-						if( !tileData )
-						{
-							// we've been sent data outside of the data window
-							continue;
-						}
+						// we've been sent data outside of the data window
+						continue;
+					}
+
+					// Only this tile is locked, so buckets which touch
+					// other tiles may be transferred concurrently.
+					tbb::spin_mutex::scoped_lock tileLock( tile->mutex );
 
-						// we must create a new object to hold the updated tile data,
-						// because the old one might well have been returned from
-						// computeChannelData and be being held in the cache.
-						FloatVectorDataPtr updatedTileData = tileData->copy();
-						vector<float> &updatedTile = updatedTileData->writable();
+					vector<float *> channelPointers( numChannels );
+					for( int channelIndex = 0; channelIndex < numChannels; ++channelIndex )
+					{
+						channelPointers[channelIndex] = &(tile->writableChannel( channelIndex )[0]);
+					}
 
-						const Box2i tileBound( tileOrigin, tileOrigin + Imath::V2i( GafferImage::ImagePlug::tileSize() - 1 ) );
-						const Box2i transferBound = IECore::boxIntersection( tileBound, yUpBox );
-						for( int y = transferBound.min.y; y<=transferBound.max.y; ++y )
+					const Box2i tileBound( tileOrigin, tileOrigin + Imath::V2i( GafferImage::ImagePlug::tileSize() - 1 ) );
+					const Box2i transferBound = IECore::boxIntersection( tileBound, yUpBox );
+					for( int y = transferBound.min.y; y<=transferBound.max.y; ++y )
+					{
+						// Walk the interleaved source pixels in order, scattering
+						// each channel into its own tile.
+						const int srcY = m_gafferFormat.formatToYDownSpace( y );
+						const float *src = data + ( ( srcY - box.min.y ) * ( box.size().x + 1 ) + ( transferBound.min.x - box.min.x ) ) * numChannels;
+						const size_t dstIndex = ( y - tileBound.min.y ) * ImagePlug::tileSize() + transferBound.min.x - tileBound.min.x;
+						const size_t dstEndIndex = dstIndex + transferBound.size().x + 1;
+						for( size_t i = dstIndex; i < dstEndIndex; ++i )
 						{
-							int srcY = m_gafferFormat.formatToYDownSpace( y );
-							size_t srcIndex = ( ( srcY - box.min.y ) * ( box.size().x + 1 ) + ( transferBound.min.x - box.min.x ) ) * numChannels + channelIndex;
-							size_t dstIndex = ( y - tileBound.min.y ) * ImagePlug::tileSize() + transferBound.min.x - tileBound.min.x;
-							const size_t srcEndIndex = srcIndex + transferBound.size().x * numChannels;
-							while( srcIndex <= srcEndIndex )
+							for( int channelIndex = 0; channelIndex < numChannels; ++channelIndex )
 							{
-								updatedTile[dstIndex] = data[srcIndex];
-								srcIndex += numChannels;
-								dstIndex++;
+								channelPointers[channelIndex][i] = *src++;
 							}
 						}
-
-						setTile( tileOrigin, channelIndex, updatedTileData );
 					}
 				}
 			}
@@ -197,15 +202,20 @@ class GafferDisplayDriver : public IECore::DisplayDriver
 				return ImagePlug::blackTile();
 			}
 
-			ConstFloatVectorDataPtr tile = getTile( tileOrigin, cIt - channelNames().begin() );
-			if( tile )
+			Tile *tile = getTile( tileOrigin );
+			if( !tile )
 			{
-				return tile;
+				// outside data window
+				return ImagePlug::blackTile();
 			}
-			else
+
+			tbb::spin_mutex::scoped_lock tileLock( tile->mutex );
+			ConstFloatVectorDataPtr result = tile->channels[cIt - channelNames().begin()];
+			if( !result )
 			{
-				return ImagePlug::blackTile();
+				result = ImagePlug::blackTile();
 			}
+			return result;
 		}
 
 		typedef boost::signal<void ( GafferDisplayDriver *, const Imath::Box2i & )> DataReceivedSignal;
@@ -231,43 +241,54 @@ class GafferDisplayDriver : public IECore::DisplayDriver
 
 		static const DisplayDriverDescription<GafferDisplayDriver> g_description;
 
-		ConstFloatVectorDataPtr getTile( const V2i &tileOrigin, size_t channelIndex )
+		// Stores the data for all channels of a single tile. Each tile has
+		// its own lock, so there is no contention between the transfer of
+		// buckets which touch different tiles, or reads of other tiles.
+		struct Tile
 		{
-			V2i tileIndex = tileOrigin / ImagePlug::tileSize();
 
-			if(
-				tileIndex.x < m_tiles.index_bases()[0] ||
-				tileIndex.x >= (int)(m_tiles.index_bases()[0] + m_tiles.shape()[0] ) ||
-				tileIndex.y < m_tiles.index_bases()[1] ||
-				tileIndex.y >= (int)(m_tiles.index_bases()[1] + m_tiles.shape()[1] )
-			)
+			tbb::spin_mutex mutex;
+			std::vector<ConstFloatVectorDataPtr> channels;
+
+			// Returns data for the channel which may be modified in place.
+			// The data is only copied if it is shared with someone else, for
+			// instance because it has been returned from computeChannelData()
+			// and is being held in the cache. Must be called with the mutex
+			// locked.
+			std::vector<float> &writableChannel( size_t channelIndex )
 			{
-				// outside data window
-				return NULL;
+				ConstFloatVectorDataPtr &channel = channels[channelIndex];
+				if( !channel )
+				{
+					channel = ImagePlug::blackTile();
+				}
+				if( channel->refCount() > 1 )
+				{
+					channel = channel->copy();
+				}
+				return const_cast<FloatVectorData *>( channel.get() )->writable();
 			}
 
-			tbb::spin_rw_mutex::scoped_lock tileLock( m_tileMutex, false /* read */ );
+		};
 
-			ConstFloatVectorDataPtr result = m_tiles[tileIndex.x][tileIndex.y][channelIndex];
-			if( !result )
+		Tile *getTile( const V2i &tileOrigin )
+		{
+			const V2i tileIndex = tileOrigin / ImagePlug::tileSize() - m_minTileIndex;
+			if(
+				tileIndex.x < 0 || tileIndex.x >= m_numTiles.x ||
+				tileIndex.y < 0 || tileIndex.y >= m_numTiles.y
+			)
 			{
-				result = ImagePlug::blackTile();
+				// outside data window
+				return NULL;
 			}
 
-			return result;
-		}
-
-		void setTile( const V2i &tileOrigin, size_t channelIndex, ConstFloatVectorDataPtr tile )
-		{
-			V2i tileIndex = tileOrigin / ImagePlug::tileSize();
-			tbb::spin_rw_mutex::scoped_lock tileLock( m_tileMutex, true /* write */ );
-			m_tiles[tileIndex.x][tileIndex.y][channelIndex] = tile;
+			return &m_tiles[tileIndex.y * m_numTiles.x + tileIndex.x];
 		}
 
-		// indexed by tileIndexX, tileIndexY, channelIndex.
-		typedef boost::multi_array<ConstFloatVectorDataPtr, 3> TileArray;
-		TileArray m_tiles;
-		tbb::spin_rw_mutex m_tileMutex;
+		V2i m_minTileIndex;
+		V2i m_numTiles;
+		boost::scoped_array<Tile> m_tiles;
 
 		Format m_gafferFormat;
 		Imath::Box2i m_gafferDataWindow;
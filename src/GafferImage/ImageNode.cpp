@@ -107,6 +107,7 @@ void ImageNode::hash( const Gaffer::ValuePlug *output, const Gaffer::Context *co
 			else
 			{
 				ComputeNode::hash( output, context, h );
+				h.append( ImagePlug::tileSize() );
 			}
 		}
 		else if( output == imagePlug->formatPlug() )
@@ -125,10 +126,24 @@ void ImageNode::hash( const Gaffer::ValuePlug *output, const Gaffer::Context *co
 		{
 			hashChannelNames( imagePlug, context, h );
 		}
+		else if( output == imagePlug->multiChannelDataPlug() )
+		{
+			hashMultiChannelData( imagePlug, context, h );
+		}
+	}
+	else if( imagePlug && output == imagePlug->multiChannelDataPlug() )
+	{
+		// We're disabled, so the channel data will be the default,
+		// but we must still provide one tile per channel.
+		ImageNode::hashMultiChannelData( imagePlug, context, h );
 	}
 	else
 	{
 		ComputeNode::hash( output, context, h );
+		if( imagePlug && output == imagePlug->channelDataPlug() )
+		{
+			h.append( ImagePlug::tileSize() );
+		}
 	}
 }
 
@@ -155,6 +170,27 @@ void ImageNode::hashChannelNames( const GafferImage::ImagePlug *parent, const Ga
 void ImageNode::hashChannelData( const GafferImage::ImagePlug *parent, const Gaffer::Context *context, IECore::MurmurHash &h ) const
 {
 	ComputeNode::hash( parent->channelDataPlug(), context, h );
+	// The tile size can be changed at runtime, so it must be
+	// accounted for to prevent reuse of previously cached tiles.
+	h.append( ImagePlug::tileSize() );
+}
+
+void ImageNode::hashMultiChannelData( const GafferImage::ImagePlug *parent, const Gaffer::Context *context, IECore::MurmurHash &h ) const
+{
+	// We don't call ComputeNode::hash() because our result is entirely
+	// determined by the channel data hashes, so identical results from
+	// different plugs may share the same hash.
+	const vector<string> &channelNames = context->get<vector<string> >( ImagePlug::channelNamesContextName );
+	h.append( (uint64_t)channelNames.size() );
+
+	ContextPtr tmpContext = new Context( *context, Context::Borrowed );
+	tmpContext->remove( ImagePlug::channelNamesContextName );
+	Context::Scope scopedContext( tmpContext.get() );
+	for( vector<string>::const_iterator it = channelNames.begin(), eIt = channelNames.end(); it != eIt; ++it )
+	{
+		tmpContext->set( ImagePlug::channelNameContextName, *it );
+		parent->channelDataPlug()->hash( h );
+	}
 }
 
 void ImageNode::parentChanging( Gaffer::GraphComponent *newParent )
@@ -183,10 +219,35 @@ void ImageNode::compute( ValuePlug *output, const Context *context ) const
 
 	// we're computing part of an ImagePlug
 
+	if( output == imagePlug->multiChannelDataPlug() )
+	{
+		const vector<string> &channelNames = context->get<vector<string> >( ImagePlug::channelNamesContextName );
+		const V2i tileOrigin = context->get<V2i>( ImagePlug::tileOriginContextName );
+		if( tileOrigin.x % ImagePlug::tileSize() || tileOrigin.y % ImagePlug::tileSize() )
+		{
+			throw Exception( "The image:tileOrigin must be a multiple of ImagePlug::tileSize()" );
+		}
+		static_cast<ObjectVectorPlug *>( output )->setValue(
+			enabled() ?
+				computeMultiChannelData( channelNames, tileOrigin, context, imagePlug ) :
+				ImageNode::computeMultiChannelData( channelNames, tileOrigin, context, imagePlug )
+		);
+		return;
+	}
+
 	if( !enabled() )
 	{
 		// disabled nodes just output a default black image.
-		output->setToDefault();
+		if( output == imagePlug->channelDataPlug() )
+		{
+			// The default value was created with the tile size at the time
+			// of construction, so we must use the current black tile instead.
+			static_cast<FloatVectorDataPlug *>( output )->setValue( ImagePlug::blackTile() );
+		}
+		else
+		{
+			output->setToDefault();
+		}
 		return;
 	}
 
@@ -232,7 +293,7 @@ void ImageNode::compute( ValuePlug *output, const Context *context ) const
 		}
 		else
 		{
-			output->setToDefault();
+			static_cast<FloatVectorDataPlug *>( output )->setValue( ImagePlug::blackTile() );
 		}
 	}
 }
@@ -262,10 +323,38 @@ IECore::ConstFloatVectorDataPtr ImageNode::computeChannelData( const std::string
 	throw IECore::NotImplementedException( string( typeName() ) + "::computeChannelData" );
 }
 
+IECore::ConstObjectVectorPtr ImageNode::computeMultiChannelData( const std::vector<std::string> &channelNames, const Imath::V2i &tileOrigin, const Gaffer::Context *context, const ImagePlug *parent ) const
+{
+	ObjectVectorPtr result = new ObjectVector;
+	result->members().reserve( channelNames.size() );
+
+	ContextPtr tmpContext = new Context( *context, Context::Borrowed );
+	tmpContext->remove( ImagePlug::channelNamesContextName );
+	Context::Scope scopedContext( tmpContext.get() );
+	for( vector<string>::const_iterator it = channelNames.begin(), eIt = channelNames.end(); it != eIt; ++it )
+	{
+		tmpContext->set( ImagePlug::channelNameContextName, *it );
+		// The cast is ok, because the result is only ever accessed via
+		// a ConstObjectVectorPtr, so the channel data will not be modified.
+		result->members().push_back( boost::const_pointer_cast<FloatVectorData>( parent->channelDataPlug()->getValue() ) );
+	}
+
+	return result;
+}
+
 void ImageNode::affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs ) const
 {
 	ComputeNode::affects( input, outputs );
 
+	// The default implementation of computeMultiChannelData() depends
+	// on channelDataPlug(), so we must propagate dirtiness from one to
+	// the other.
+	const ImagePlug *imagePlug = input->parent<ImagePlug>();
+	if( imagePlug && imagePlug->direction() == Plug::Out && input == imagePlug->channelDataPlug() )
+	{
+		outputs.push_back( imagePlug->multiChannelDataPlug() );
+	}
+
 	if( input == enabledPlug() )
 	{
 		for( ValuePlugIterator it( outPlug() ); it != it.end(); it++ )
@@ -37,14 +37,18 @@
 
 #include "tbb/tbb.h"
 
+#include "boost/format.hpp"
+
 #include "IECore/Exception.h"
 #include "IECore/BoxOps.h"
 #include "IECore/BoxAlgo.h"
+#include "IECore/MessageHandler.h"
 
 #include "Gaffer/Context.h"
 
 #include "GafferImage/ImagePlug.h"
 #include "GafferImage/FormatPlug.h"
+#include "GafferImage/ImageAlgo.h"
 
 using namespace std;
 using namespace Imath;
@@ -57,8 +61,8 @@ IE_CORE_DEFINERUNTIMETYPED( ImagePlug );
 
 //////////////////////////////////////////////////////////////////////////
 // Implementation of CopyTiles:
-// A simple class for multithreading the copying of
-// image tiles from an input plug to an output plug.
+// A functor for use with parallelProcessTiles(), copying
+// image tiles from an input plug into an ImagePrimitive.
 //////////////////////////////////////////////////////////////////////////
 
 namespace GafferImage
@@ -72,50 +76,33 @@ class CopyTiles
 	public:
 		CopyTiles(
 				const vector<float *> &imageChannelData,
-				const vector<string> &channelNames,
-				const Gaffer::FloatVectorDataPlug *channelDataPlug,
-				const Box2i& dataWindow,
-				const Context *context, const int tileSize
+				const Box2i& dataWindow
 			) :
 				m_imageChannelData( imageChannelData ),
-				m_channelNames( channelNames ),
-				m_channelDataPlug( channelDataPlug ),
-				m_dataWindow( dataWindow ),
-				m_parentContext( context ),
-				m_tileSize( tileSize )
+				m_dataWindow( dataWindow )
 		{}
 
-		void operator()( const blocked_range2d<size_t>& r ) const
+		// Called with image:channelNames and image:tileOrigin
+		// already set in the current context.
+		void operator()( const ImagePlug *imagePlug, const V2i &tileOrigin )
 		{
-			ContextPtr context = new Context( *m_parentContext );
-			const Box2i operationWindow( V2i( r.rows().begin()+m_dataWindow.min.x, r.cols().begin()+m_dataWindow.min.y ), V2i( r.rows().end()+m_dataWindow.min.x-1, r.cols().end()+m_dataWindow.min.y-1 ) );
-			V2i minTileOrigin = ImagePlug::tileOrigin( operationWindow.min );
-			V2i maxTileOrigin = ImagePlug::tileOrigin( operationWindow.max );
-			size_t imageStride = m_dataWindow.size().x + 1;
+			const int tileSize = ImagePlug::tileSize();
+			const Box2i tileBound( tileOrigin, tileOrigin + V2i( tileSize - 1 ) );
+			const Box2i b = boxIntersection( tileBound, m_dataWindow );
+			const size_t imageStride = m_dataWindow.size().x + 1;
+
+			ConstObjectVectorPtr tileData = imagePlug->multiChannelDataPlug()->getValue();
 
-			for( int tileOriginY = minTileOrigin.y; tileOriginY <= maxTileOrigin.y; tileOriginY += m_tileSize )
+			for( size_t i = 0, e = m_imageChannelData.size(); i < e; ++i )
 			{
-				for( int tileOriginX = minTileOrigin.x; tileOriginX <= maxTileOrigin.x; tileOriginX += m_tileSize )
+				const FloatVectorData *channelData = static_cast<const FloatVectorData *>( tileData->members()[i].get() );
+				for( int y = b.min.y; y<=b.max.y; y++ )
 				{
-					for( vector<string>::const_iterator it = m_channelNames.begin(), eIt = m_channelNames.end(); it != eIt; it++ )
+					const float *tilePtr = &(channelData->readable()[0]) + (y - tileOrigin.y) * tileSize + (b.min.x - tileOrigin.x);
+					float *channelPtr = m_imageChannelData[i] + ( m_dataWindow.size().y - ( y - m_dataWindow.min.y ) ) * imageStride + (b.min.x - m_dataWindow.min.x);
+					for( int x = b.min.x; x <= b.max.x; x++ )
 					{
-						context->set( ImagePlug::channelNameContextName, *it );
-						context->set( ImagePlug::tileOriginContextName, V2i( tileOriginX, tileOriginY ) );
-						Context::Scope scope( context.get() );
-						Box2i tileBound( V2i( tileOriginX, tileOriginY ), V2i( tileOriginX + m_tileSize - 1, tileOriginY + m_tileSize - 1 ) );
-						Box2i b = boxIntersection( tileBound, operationWindow );
-
-						ConstFloatVectorDataPtr tileData = m_channelDataPlug->getValue();
-
-						for( int y = b.min.y; y<=b.max.y; y++ )
-						{
-							const float *tilePtr = &(tileData->readable()[0]) + (y - tileOriginY) * m_tileSize + (b.min.x - tileOriginX);
-							float *channelPtr = m_imageChannelData[it-m_channelNames.begin()] + ( m_dataWindow.size().y - ( y - m_dataWindow.min.y ) ) * imageStride + (b.min.x - m_dataWindow.min.x);
-							for( int x = b.min.x; x <= b.max.x; x++ )
-							{
-								*channelPtr++ = *tilePtr++;
-							}
-						}
+						*channelPtr++ = *tilePtr++;
 					}
 				}
 			}
@@ -123,22 +110,20 @@ class CopyTiles
 
 	private:
 		const vector<float *> &m_imageChannelData;
-		const vector<string> &m_channelNames;
-		const Gaffer::FloatVectorDataPlug *m_channelDataPlug;
 		const Box2i &m_dataWindow;
-		const Context *m_parentContext;
-		const int m_tileSize;
 };
 
-};
+} // namespace Detail
 
-};
+} // namespace GafferImage
 
 //////////////////////////////////////////////////////////////////////////
 // Implementation of ImagePlug
 //////////////////////////////////////////////////////////////////////////
 const IECore::InternedString ImagePlug::channelNameContextName = "image:channelName";
+const IECore::InternedString ImagePlug::channelNamesContextName = "image:channelNames";
 const IECore::InternedString ImagePlug::tileOriginContextName = "image:tileOrigin";
+const IECore::InternedString ImagePlug::proxyLevelContextName = "image:proxyLevel";
 
 size_t ImagePlug::g_firstPlugIndex = 0;
 
@@ -204,27 +189,91 @@ ImagePlug::ImagePlug( const std::string &name, Direction direction, unsigned fla
 		)
 	);
 
+	// The default implementation of ImageNode::computeMultiChannelData()
+	// just gathers values which are already cached for channelDataPlug(),
+	// so there is nothing to be gained by caching them again. Nodes which
+	// compute several channels together turn caching back on.
+	addChild(
+		new ObjectVectorPlug(
+			"multiChannelData",
+			direction,
+			new ObjectVector,
+			childFlags & ~Cacheable
+		)
+	);
+
 }
 
 ImagePlug::~ImagePlug()
 {
 }
 
-const IECore::FloatVectorData *ImagePlug::whiteTile()
+namespace
+{
+
+int initialTileSize()
+{
+	if( const char *s = getenv( "GAFFER_IMAGE_TILE_SIZE" ) )
+	{
+		const int tileSize = atoi( s );
+		if( tileSize >= 16 && tileSize <= 1024 && ( tileSize & ( tileSize - 1 ) ) == 0 )
+		{
+			return tileSize;
+		}
+		IECore::msg( IECore::Msg::Warning, "ImagePlug", boost::format( "Invalid GAFFER_IMAGE_TILE_SIZE \"%s\"" ) % s );
+	}
+	return 64;
+}
+
+IECore::ConstFloatVectorDataPtr constantTile( float value )
+{
+	return new IECore::FloatVectorData( std::vector<float>( ImagePlug::tileSize()*ImagePlug::tileSize(), value ) );
+}
+
+// The constant tiles are created on first use, and replaced by
+// setTileSize(). Callers hold their own reference to the tiles,
+// so replacing them doesn't invalidate tiles which are still in use.
+IECore::ConstFloatVectorDataPtr &whiteTileStorage()
+{
+	static IECore::ConstFloatVectorDataPtr g_whiteTile = constantTile( 1.0f );
+	return g_whiteTile;
+}
+
+IECore::ConstFloatVectorDataPtr &blackTileStorage()
+{
+	static IECore::ConstFloatVectorDataPtr g_blackTile = constantTile( 0.0f );
+	return g_blackTile;
+}
+
+} // namespace
+
+int ImagePlug::g_tileSize = initialTileSize();
+
+void ImagePlug::setTileSize( int tileSize )
 {
-	static IECore::ConstFloatVectorDataPtr g_whiteTile( new IECore::FloatVectorData( std::vector<float>( ImagePlug::tileSize()*ImagePlug::tileSize(), 1. ) ) );
-	return g_whiteTile.get();
+	if( tileSize < 16 || tileSize > 1024 || ( tileSize & ( tileSize - 1 ) ) )
+	{
+		throw IECore::Exception( boost::str( boost::format( "Invalid tile size %d - must be a power of two between 16 and 1024" ) % tileSize ) );
+	}
+
+	g_tileSize = tileSize;
+	whiteTileStorage() = constantTile( 1.0f );
+	blackTileStorage() = constantTile( 0.0f );
+}
+
+IECore::ConstFloatVectorDataPtr ImagePlug::whiteTile()
+{
+	return whiteTileStorage();
 };
 
-const IECore::FloatVectorData *ImagePlug::blackTile()
+IECore::ConstFloatVectorDataPtr ImagePlug::blackTile()
 {
-	static IECore::ConstFloatVectorDataPtr g_blackTile( new IECore::FloatVectorData( std::vector<float>( ImagePlug::tileSize()*ImagePlug::tileSize(), 0. ) ) );
-	return g_blackTile.get();
+	return blackTileStorage();
 };
 
 bool ImagePlug::acceptsChild( const GraphComponent *potentialChild ) const
 {
-	return children().size() != 5;
+	return children().size() != 6;
 }
 
 bool ImagePlug::acceptsInput( const Gaffer::Plug *input ) const
@@ -295,11 +344,24 @@ const Gaffer::FloatVectorDataPlug *ImagePlug::channelDataPlug() const
 	return getChild<FloatVectorDataPlug>( g_firstPlugIndex+4 );
 }
 
+Gaffer::ObjectVectorPlug *ImagePlug::multiChannelDataPlug()
+{
+	return getChild<ObjectVectorPlug>( g_firstPlugIndex+5 );
+}
+
+const Gaffer::ObjectVectorPlug *ImagePlug::multiChannelDataPlug() const
+{
+	return getChild<ObjectVectorPlug>( g_firstPlugIndex+5 );
+}
+
 IECore::ConstFloatVectorDataPtr ImagePlug::channelData( const std::string &channelName, const Imath::V2i &tile ) const
 {
 	if( direction()==In && !getInput<Plug>() )
 	{
-		return channelDataPlug()->defaultValue();
+		// We don't use the default value of channelDataPlug(),
+		// because it was created using the tile size at the
+		// time of construction.
+		return blackTile();
 	}
 
 	ContextPtr tmpContext = new Context( *Context::current(), Context::Borrowed );
@@ -319,6 +381,35 @@ IECore::MurmurHash ImagePlug::channelDataHash( const std::string &channelName, c
 	return channelDataPlug()->hash();
 }
 
+IECore::ConstObjectVectorPtr ImagePlug::multiChannelData( const std::vector<std::string> &channelNames, const Imath::V2i &tile ) const
+{
+	if( direction()==In && !getInput<Plug>() )
+	{
+		// The members of an ObjectVector are non-const, so we
+		// can't share the black tile itself. Instead we share
+		// a single copy between all the channels.
+		ObjectVectorPtr result = new ObjectVector;
+		result->members().resize( channelNames.size(), blackTile()->copy() );
+		return result;
+	}
+
+	ContextPtr tmpContext = new Context( *Context::current(), Context::Borrowed );
+	tmpContext->set( ImagePlug::channelNamesContextName, channelNames );
+	tmpContext->set( ImagePlug::tileOriginContextName, tile );
+	Context::Scope scopedContext( tmpContext.get() );
+
+	return multiChannelDataPlug()->getValue();
+}
+
+IECore::MurmurHash ImagePlug::multiChannelDataHash( const std::vector<std::string> &channelNames, const Imath::V2i &tile ) const
+{
+	ContextPtr tmpContext = new Context( *Context::current(), Context::Borrowed );
+	tmpContext->set( ImagePlug::channelNamesContextName, channelNames );
+	tmpContext->set( ImagePlug::tileOriginContextName, tile );
+	Context::Scope scopedContext( tmpContext.get() );
+	return multiChannelDataPlug()->hash();
+}
+
 IECore::ImagePrimitivePtr ImagePlug::image() const
 {
 	Format format = formatPlug()->getValue();
@@ -352,12 +443,56 @@ IECore::ImagePrimitivePtr ImagePlug::image() const
 		imageChannelData.push_back( &(c[0]) );
 	}
 
-	parallel_for( blocked_range2d<size_t>( 0, dataWindow.size().x+1, tileSize(), 0, dataWindow.size().y+1, tileSize() ),
-		      GafferImage::Detail::CopyTiles( imageChannelData, channelNames, channelDataPlug(), dataWindow, Context::current(), tileSize()) );
+	if( direction()==In && !getInput<Plug>() )
+	{
+		// Unconnected, so the channels are already filled
+		// with the correct default values.
+		return result;
+	}
+
+	ContextPtr context = new Context( *Context::current(), Context::Borrowed );
+	context->set( ImagePlug::channelNamesContextName, channelNames );
+	Context::Scope scope( context.get() );
+
+	GafferImage::Detail::CopyTiles copyTiles( imageChannelData, dataWindow );
+	parallelProcessTiles( this, copyTiles, dataWindow );
 
 	return result;
 }
 
+namespace
+{
+
+// Computes the hash of every tile in parallel, storing them
+// so that they can be combined in a deterministic order.
+class HashTiles
+{
+
+	public :
+
+		HashTiles( const vector<string> &channelNames, const V2i &firstTileOrigin, const V2i &numTiles, vector<MurmurHash> &hashes )
+			:	m_channelNames( channelNames ), m_firstTileOrigin( firstTileOrigin ), m_numTiles( numTiles ), m_hashes( hashes )
+		{
+		}
+
+		void operator()( const ImagePlug *imagePlug, const string &channelName, const V2i &tileOrigin )
+		{
+			const size_t channelIndex = find( m_channelNames.begin(), m_channelNames.end(), channelName ) - m_channelNames.begin();
+			const V2i tileIndex = ( tileOrigin - m_firstTileOrigin ) / ImagePlug::tileSize();
+			m_hashes[( channelIndex * m_numTiles.y + tileIndex.y ) * m_numTiles.x + tileIndex.x] = imagePlug->channelDataPlug()->hash();
+		}
+
+	private :
+
+		const vector<string> &m_channelNames;
+		const V2i m_firstTileOrigin;
+		const V2i m_numTiles;
+		vector<MurmurHash> &m_hashes;
+
+};
+
+} // namespace
+
 IECore::MurmurHash ImagePlug::imageHash() const
 {
 	const Box2i dataWindow = dataWindowPlug()->getValue();
@@ -369,23 +504,19 @@ IECore::MurmurHash ImagePlug::imageHash() const
 	result.append( metadataPlug()->hash() );
 	result.append( channelNamesPlug()->hash() );
 
-	V2i minTileOrigin = tileOrigin( dataWindow.min );
-	V2i maxTileOrigin = tileOrigin( dataWindow.max );
+	V2i firstTileOrigin, numTilesXY;
+	const size_t tilesPerChannel = numTiles( dataWindow, firstTileOrigin, numTilesXY );
 
-	ContextPtr context = new Context( *Context::current(), Context::Borrowed );
-	Context::Scope scope( context.get() );
-	
-	for( vector<string>::const_iterator it = channelNames.begin(), eIt = channelNames.end(); it!=eIt; it++ )
+	// The tiles are hashed in parallel, but combined in the order
+	// of channel, then row, then column, so that the result is
+	// independent of the number of threads and the scheduling.
+	vector<MurmurHash> tileHashes( tilesPerChannel * channelNames.size() );
+	HashTiles hashTiles( channelNames, firstTileOrigin, numTilesXY, tileHashes );
+	parallelProcessTiles( this, channelNames, hashTiles, dataWindow );
+
+	for( vector<MurmurHash>::const_iterator it = tileHashes.begin(), eIt = tileHashes.end(); it != eIt; ++it )
 	{
-		context->set( ImagePlug::channelNameContextName, *it );
-		for( int tileOriginY = minTileOrigin.y; tileOriginY<=maxTileOrigin.y; tileOriginY += tileSize() )
-		{
-			for( int tileOriginX = minTileOrigin.x; tileOriginX<=maxTileOrigin.x; tileOriginX += tileSize() )
-			{
-				context->set( ImagePlug::tileOriginContextName, V2i( tileOriginX, tileOriginY ) );
-				channelDataPlug()->hash( result );
-			}
-		}
+		result.append( *it );
 	}
 
 	return result;
@@ -35,10 +35,19 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <cmath>
+#include <limits>
+
 #include "boost/bind.hpp"
+#include "boost/format.hpp"
+#include "boost/unordered_map.hpp"
+
+#include "tbb/enumerable_thread_specific.h"
 
 #include "OpenEXR/half.h"
 
+#include "IECore/LRUCache.h"
+
 #include "OpenImageIO/imagecache.h"
 OIIO_NAMESPACE_USING
 
@@ -265,6 +274,283 @@ void oiioParameterListToMetadata( const ImageIOParameterList &paramList, Compoun
 
 } // namespace
 
+//////////////////////////////////////////////////////////////////////////
+// The ImageSpec lookup in the OIIO cache requires a lock and the channel
+// lookup a linear search, and we were previously doing both for every tile.
+// We instead keep an LRUCache of the per-file information we need,
+// which is cleared whenever the ImageReaders are refreshed.
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// Information about a single mip level of a single subimage.
+struct LevelInfo : public IECore::RefCounted
+{
+
+	LevelInfo( const ustring &fileName, int subimage, int mipLevel, const ImageSpec &spec )
+		:	fileName( fileName ),
+			subimage( subimage ),
+			mipLevel( mipLevel ),
+			format(
+				Imath::Box2i(
+					Imath::V2i( spec.full_x, spec.full_y ),
+					Imath::V2i( spec.full_x + spec.full_width - 1, spec.full_y + spec.full_height - 1 )
+				),
+				spec.get_float_attribute( "PixelAspectRatio", 1.0f )
+			),
+			dataWindow(
+				format.yDownToFormatSpace(
+					Imath::Box2i( Imath::V2i( spec.x, spec.y ), Imath::V2i( spec.width + spec.x - 1, spec.height + spec.y - 1 ) )
+				)
+			),
+			channelNames( new StringVectorData( spec.channelnames ) )
+	{
+		for( size_t i = 0; i < spec.channelnames.size(); ++i )
+		{
+			// Insertion doesn't overwrite, so the first of
+			// any duplicate channels wins, as it did when we
+			// used std::find().
+			channelIndices.insert( ChannelIndices::value_type( spec.channelnames[i], i ) );
+		}
+
+		CompoundObjectPtr m = new CompoundObject;
+		oiioParameterListToMetadata( spec.extra_attribs, m.get() );
+		metadata = m;
+	}
+
+	/// Returns the index of the channel in the file, or -1
+	/// if it doesn't exist.
+	int channelIndex( const std::string &channelName ) const
+	{
+		ChannelIndices::const_iterator it = channelIndices.find( channelName );
+		return it != channelIndices.end() ? it->second : -1;
+	}
+
+	const ustring fileName;
+	const int subimage;
+	const int mipLevel;
+
+	const Format format;
+	const Imath::Box2i dataWindow;
+	ConstStringVectorDataPtr channelNames;
+	ConstCompoundObjectPtr metadata;
+
+	typedef boost::unordered_map<std::string, int> ChannelIndices;
+	ChannelIndices channelIndices;
+
+};
+
+IE_CORE_DECLAREPTR( LevelInfo )
+
+struct FileInfo : public IECore::RefCounted
+{
+
+	typedef std::vector<ConstLevelInfoPtr> MipLevels;
+	std::vector<MipLevels> subimages;
+
+};
+
+IE_CORE_DECLAREPTR( FileInfo )
+
+ConstFileInfoPtr fileInfoGetter( const std::string &fileName, size_t &cost )
+{
+	ustring uFileName( fileName.c_str() );
+	int numSubimages = 0;
+	if( !imageCache()->get_image_info( uFileName, 0, 0, ustring( "subimages" ), TypeDesc::INT, &numSubimages ) )
+	{
+		// clear error on failure to prevent error buffer overflow crash.
+		imageCache()->geterror();
+		// The ImageCache remembers the failure too, so we must
+		// invalidate it in case the file is created later.
+		imageCache()->invalidate( uFileName );
+		cost = 1;
+		return NULL;
+	}
+
+	FileInfoPtr result = new FileInfo;
+	result->subimages.resize( numSubimages );
+	for( int subimage = 0; subimage < numSubimages; ++subimage )
+	{
+		int numMipLevels = 1;
+		imageCache()->get_image_info( uFileName, subimage, 0, ustring( "miplevels" ), TypeDesc::INT, &numMipLevels );
+		for( int mipLevel = 0; mipLevel < numMipLevels; ++mipLevel )
+		{
+			const ImageSpec *spec = imageCache()->imagespec( uFileName, subimage, mipLevel );
+			if( !spec )
+			{
+				imageCache()->geterror();
+				break;
+			}
+			result->subimages[subimage].push_back( new LevelInfo( uFileName, subimage, mipLevel, *spec ) );
+		}
+	}
+
+	cost = 1;
+	return result;
+}
+
+typedef LRUCache<std::string, ConstFileInfoPtr> FileInfoCache;
+
+FileInfoCache *fileInfoCache()
+{
+	static FileInfoCache *c = new FileInfoCache( fileInfoGetter, 200 );
+	return c;
+}
+
+/// Returns the information for the file, or NULL if it cannot be
+/// opened. Failures are not kept in the cache, so that a file which
+/// is created later will be found without needing a refresh.
+ConstFileInfoPtr fileInfo( const std::string &fileName )
+{
+	ConstFileInfoPtr result = fileInfoCache()->get( fileName );
+	if( !result )
+	{
+		fileInfoCache()->erase( fileName );
+	}
+	return result;
+}
+
+/// Returns the information for the specified level of the file, clamping
+/// the mip level to the levels available, so that proxy levels may be
+/// requested for any file. Throws if the file cannot be opened or doesn't
+/// contain the subimage.
+ConstLevelInfoPtr levelInfo( const std::string &fileName, int subimage, int mipLevel )
+{
+	ConstFileInfoPtr fileInfo = ::fileInfo( fileName );
+	if( !fileInfo )
+	{
+		throw IECore::Exception( boost::str( boost::format( "Unable to open file \"%s\"" ) % fileName ) );
+	}
+
+	if( subimage < 0 || subimage >= (int)fileInfo->subimages.size() || fileInfo->subimages[subimage].empty() )
+	{
+		throw IECore::Exception( boost::str( boost::format( "File \"%s\" has no subimage %d" ) % fileName % subimage ) );
+	}
+
+	const FileInfo::MipLevels &mipLevels = fileInfo->subimages[subimage];
+	return mipLevels[std::max( 0, std::min( mipLevel, (int)mipLevels.size() - 1 ) )];
+}
+
+/// Returns the level the reader outputs, as specified by its mip level plug.
+ConstLevelInfoPtr levelInfo( const ImageReader *reader )
+{
+	return levelInfo(
+		reader->fileNamePlug()->getValue(),
+		reader->subimagePlug()->getValue(),
+		reader->mipLevelPlug()->getValue()
+	);
+}
+
+/// Returns the level that pixels should be read from. This is lower
+/// resolution than the output level when a proxy level is requested via
+/// the context, but the pixels are still output at the resolution of the
+/// output level, so that proxying doesn't change the format or data window
+/// seen by downstream nodes.
+ConstLevelInfoPtr sourceLevelInfo( const ImageReader *reader, const Context *context )
+{
+	return levelInfo(
+		reader->fileNamePlug()->getValue(),
+		reader->subimagePlug()->getValue(),
+		reader->mipLevelPlug()->getValue() + context->get<int>( ImagePlug::proxyLevelContextName, 0 )
+	);
+}
+
+// Interleaved scratch space for reading several channels at once,
+// kept per thread to avoid reallocating it for every tile.
+typedef tbb::enumerable_thread_specific<std::vector<float> > TileBuffers;
+TileBuffers g_tileBuffers;
+
+// Reads channels [chBegin, chEnd) of a tile into `buffer`, which is
+// interleaved with the given number of channels in total. We pass a
+// negative y stride so that OIIO writes the last row first, which flips the
+// tile from OIIO's y-down space into ours without any further copying.
+void readTile( const LevelInfo *info, const Imath::V2i &tileOrigin, int chBegin, int chEnd, float *buffer, int numInterleavedChannels )
+{
+	const int tileSize = ImagePlug::tileSize();
+	const int yBegin = info->format.formatToYDownSpace( tileOrigin.y + tileSize - 1 );
+	const stride_t xStride = numInterleavedChannels * sizeof( float );
+	const stride_t yStride = xStride * tileSize;
+
+	imageCache()->get_pixels(
+		info->fileName,
+		info->subimage, info->mipLevel,
+		tileOrigin.x, tileOrigin.x + tileSize,
+		yBegin, yBegin + tileSize,
+		0, 1,
+		chBegin, chEnd,
+		TypeDesc::FLOAT,
+		buffer + ( tileSize - 1 ) * tileSize * numInterleavedChannels,
+		xStride,
+		-yStride,
+		AutoStride
+	);
+}
+
+// As above, but reading the pixels from a lower resolution source level,
+// and upsampling them to fill the tile at the resolution of the output level.
+// Each pixel takes the value of the source pixel covering its centre.
+void readTile( const LevelInfo *info, const LevelInfo *source, const Imath::V2i &tileOrigin, int chBegin, int chEnd, float *buffer, int numInterleavedChannels )
+{
+	if( source == info )
+	{
+		readTile( info, tileOrigin, chBegin, chEnd, buffer, numInterleavedChannels );
+		return;
+	}
+
+	const int tileSize = ImagePlug::tileSize();
+	const Box2i &displayWindow = info->format.getDisplayWindow();
+	const Box2i &sourceDisplayWindow = source->format.getDisplayWindow();
+	const V2f scale(
+		(float)source->format.width() / (float)info->format.width(),
+		(float)source->format.height() / (float)info->format.height()
+	);
+
+	vector<int> sourceX( tileSize );
+	vector<int> sourceY( tileSize );
+	for( int i = 0; i < tileSize; ++i )
+	{
+		sourceX[i] = sourceDisplayWindow.min.x + (int)floorf( ( (float)( tileOrigin.x + i - displayWindow.min.x ) + 0.5f ) * scale.x );
+		sourceY[i] = sourceDisplayWindow.min.y + (int)floorf( ( (float)( tileOrigin.y + i - displayWindow.min.y ) + 0.5f ) * scale.y );
+	}
+
+	// Read the region of the source covering the tile, flipping it
+	// into our y-up space in the same way as above.
+	const int width = sourceX.back() - sourceX.front() + 1;
+	const int height = sourceY.back() - sourceY.front() + 1;
+	const int yBegin = source->format.formatToYDownSpace( sourceY.back() );
+	const stride_t xStride = numInterleavedChannels * sizeof( float );
+	const stride_t yStride = xStride * width;
+
+	vector<float> region( width * height * numInterleavedChannels );
+	imageCache()->get_pixels(
+		source->fileName,
+		source->subimage, source->mipLevel,
+		sourceX.front(), sourceX.front() + width,
+		yBegin, yBegin + height,
+		0, 1,
+		chBegin, chEnd,
+		TypeDesc::FLOAT,
+		&(region[0]) + ( height - 1 ) * width * numInterleavedChannels,
+		xStride,
+		-yStride,
+		AutoStride
+	);
+
+	float *out = buffer;
+	for( int y = 0; y < tileSize; ++y )
+	{
+		const float *row = &(region[0]) + ( sourceY[y] - sourceY.front() ) * width * numInterleavedChannels;
+		for( int x = 0; x < tileSize; ++x )
+		{
+			const float *in = row + ( sourceX[x] - sourceX.front() ) * numInterleavedChannels;
+			out = std::copy( in, in + numInterleavedChannels, out );
+		}
+	}
+}
+
+} // namespace
+
 //////////////////////////////////////////////////////////////////////////
 // ImageReader implementation
 //////////////////////////////////////////////////////////////////////////
@@ -279,6 +565,8 @@ ImageReader::ImageReader( const std::string &name )
 	storeIndexOfNextChild( g_firstPlugIndex );
 	addChild( new StringPlug( "fileName" ) );
 	addChild( new IntPlug( "refreshCount" ) );
+	addChild( new IntPlug( "subimage", Plug::In, 0, 0 ) );
+	addChild( new IntPlug( "mipLevel", Plug::In, 0, 0 ) );
 
 	// disable caching on our outputs, as OIIO is already doing caching for us.
 	for( OutputPlugIterator it( outPlug() ); it!=it.end(); it++ )
@@ -313,22 +601,39 @@ const Gaffer::IntPlug *ImageReader::refreshCountPlug() const
 	return getChild<IntPlug>( g_firstPlugIndex + 1 );
 }
 
+Gaffer::IntPlug *ImageReader::subimagePlug()
+{
+	return getChild<IntPlug>( g_firstPlugIndex + 2 );
+}
+
+const Gaffer::IntPlug *ImageReader::subimagePlug() const
+{
+	return getChild<IntPlug>( g_firstPlugIndex + 2 );
+}
+
+Gaffer::IntPlug *ImageReader::mipLevelPlug()
+{
+	return getChild<IntPlug>( g_firstPlugIndex + 3 );
+}
+
+const Gaffer::IntPlug *ImageReader::mipLevelPlug() const
+{
+	return getChild<IntPlug>( g_firstPlugIndex + 3 );
+}
+
 bool ImageReader::enabled() const
 {
 	std::string fileName = fileNamePlug()->getValue();
 	
-	/// \todo We get the spec here, and then we go and get it again in the
+	/// \todo We get the file info here, and then we go and get it again in the
 	/// hash()/compute() functions if we turn out to be enabled. This overhead
 	/// is a fundamental problem with the whole enabled() mechanism - we should
 	/// stop using it, and just deal with missing files in the various methods
 	/// that try to access them.
 	/// \todo This is swallowing errors when we should be reporting them via
 	/// exceptions. Fix it.
-	const ImageSpec *spec = imageCache()->imagespec( ustring( fileName.c_str() ) );
-	if( spec == 0 )
+	if( !fileInfo( fileName ) )
 	{
-		// clear error on failure to prevent error buffer overflow crash.
-		imageCache()->geterror();
 		return false;
 	}
 	
@@ -363,7 +668,7 @@ void ImageReader::affects( const Gaffer::Plug *input, AffectedPlugsContainer &ou
 {
 	ImageNode::affects( input, outputs );
 
-	if( input == fileNamePlug() || input == refreshCountPlug() )
+	if( input == fileNamePlug() || input == refreshCountPlug() || input == subimagePlug() || input == mipLevelPlug() )
 	{
 		for( ValuePlugIterator it( outPlug() ); it != it.end(); it++ )
 		{
@@ -375,74 +680,45 @@ void ImageReader::affects( const Gaffer::Plug *input, AffectedPlugsContainer &ou
 void ImageReader::hashFormat( const GafferImage::ImagePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const
 {
 	ImageNode::hashFormat( output, context, h );
-	fileNamePlug()->hash( h );
-	refreshCountPlug()->hash( h );
+	hashFileAndLevel( h );
 }
 
 GafferImage::Format ImageReader::computeFormat( const Gaffer::Context *context, const ImagePlug *parent ) const
 {
-	std::string fileName = fileNamePlug()->getValue();
-	const ImageSpec *spec = imageCache()->imagespec( ustring( fileName.c_str() ) );
-
-	return GafferImage::Format(
-		Imath::Box2i(
-			Imath::V2i( spec->full_x, spec->full_y ),
-			Imath::V2i( spec->full_x + spec->full_width - 1, spec->full_y + spec->full_height - 1 )
-		),
-		spec->get_float_attribute( "PixelAspectRatio", 1.0f )
-	);
+	return levelInfo( this )->format;
 }
 
 void ImageReader::hashDataWindow( const GafferImage::ImagePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const
 {
 	ImageNode::hashDataWindow( output, context, h );
-	fileNamePlug()->hash( h );
-	refreshCountPlug()->hash( h );
+	hashFileAndLevel( h );
 }
 
 Imath::Box2i ImageReader::computeDataWindow( const Gaffer::Context *context, const ImagePlug *parent ) const
 {
-	std::string fileName = fileNamePlug()->getValue();
-	const ImageSpec *spec = imageCache()->imagespec( ustring( fileName.c_str() ) );
-
-	Format format( Imath::Box2i( Imath::V2i( spec->full_x, spec->full_y ), Imath::V2i( spec->full_width + spec->full_x - 1, spec->full_height + spec->full_y - 1 ) ) );
-	Imath::Box2i dataWindow( Imath::V2i( spec->x, spec->y ), Imath::V2i( spec->width + spec->x - 1, spec->height + spec->y - 1 ) );
-
-	return format.yDownToFormatSpace( dataWindow );
+	return levelInfo( this )->dataWindow;
 }
 
 void ImageReader::hashMetadata( const GafferImage::ImagePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const
 {
 	ImageNode::hashMetadata( output, context, h );
-	fileNamePlug()->hash( h );
-	refreshCountPlug()->hash( h );
+	hashFileAndLevel( h );
 }
 
 IECore::ConstCompoundObjectPtr ImageReader::computeMetadata( const Gaffer::Context *context, const ImagePlug *parent ) const
 {
-	std::string fileName = fileNamePlug()->getValue();
-	const ImageSpec *spec = imageCache()->imagespec( ustring( fileName.c_str() ) );
-	
-	CompoundObjectPtr result = new CompoundObject;
-	oiioParameterListToMetadata( spec->extra_attribs, result.get() );
-	
-	return result;
+	return levelInfo( this )->metadata;
 }
 
 void ImageReader::hashChannelNames( const GafferImage::ImagePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const
 {
 	ImageNode::hashChannelNames( output, context, h );
-	fileNamePlug()->hash( h );
-	refreshCountPlug()->hash( h );
+	hashFileAndLevel( h );
 }
 
 IECore::ConstStringVectorDataPtr ImageReader::computeChannelNames( const Gaffer::Context *context, const ImagePlug *parent ) const
 {
-	std::string fileName = fileNamePlug()->getValue();
-	const ImageSpec *spec = imageCache()->imagespec( ustring( fileName.c_str() ) );
-	StringVectorDataPtr result = new StringVectorData();
-	result->writable() = spec->channelnames;
-	return result;
+	return levelInfo( this )->channelNames;
 }
 
 void ImageReader::hashChannelData( const GafferImage::ImagePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const
@@ -450,52 +726,152 @@ void ImageReader::hashChannelData( const GafferImage::ImagePlug *output, const G
 	ImageNode::hashChannelData( output, context, h );
 	h.append( context->get<V2i>( ImagePlug::tileOriginContextName ) );
 	h.append( context->get<std::string>( ImagePlug::channelNameContextName ) );
-	fileNamePlug()->hash( h );
-	refreshCountPlug()->hash( h );
+	hashFileAndLevel( h );
+	// The proxy level affects only the pixels, not the format or data window.
+	h.append( context->get<int>( ImagePlug::proxyLevelContextName, 0 ) );
 }
 
 IECore::ConstFloatVectorDataPtr ImageReader::computeChannelData( const std::string &channelName, const Imath::V2i &tileOrigin, const Gaffer::Context *context, const ImagePlug *parent ) const
 {
-	std::string fileName = fileNamePlug()->getValue();
-	ustring uFileName( fileName.c_str() );
-	const ImageSpec *spec = imageCache()->imagespec( uFileName );
+	ConstLevelInfoPtr info = levelInfo( this );
+	ConstLevelInfoPtr source = sourceLevelInfo( this, context );
 
-	vector<string>::const_iterator channelIt = find( spec->channelnames.begin(), spec->channelnames.end(), channelName );
-	if( channelIt == spec->channelnames.end() )
+	const int channelIndex = info->channelIndex( channelName );
+	if( channelIndex < 0 )
 	{
+		return ImagePlug::blackTile();
+	}
+
+	FloatVectorDataPtr resultData = new FloatVectorData;
+	vector<float> &result = resultData->writable();
+	result.resize( ImagePlug::tileSize() * ImagePlug::tileSize() );
+
+	readTile( info.get(), source.get(), tileOrigin, channelIndex, channelIndex + 1, &(result[0]), 1 );
+
+	return resultData;
+}
+
+void ImageReader::hashMultiChannelData( const GafferImage::ImagePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const
+{
+	ComputeNode::hash( output->multiChannelDataPlug(), context, h );
+	const vector<string> &channelNames = context->get<vector<string> >( ImagePlug::channelNamesContextName );
+	for( vector<string>::const_iterator it = channelNames.begin(), eIt = channelNames.end(); it != eIt; ++it )
+	{
+		h.append( *it );
+	}
+	h.append( (uint64_t)channelNames.size() );
+	h.append( context->get<V2i>( ImagePlug::tileOriginContextName ) );
+	h.append( ImagePlug::tileSize() );
+	hashFileAndLevel( h );
+	h.append( context->get<int>( ImagePlug::proxyLevelContextName, 0 ) );
+}
+
+namespace
+{
+
+// The members of an ObjectVector are non-const, so we can't share
+// ImagePlug::blackTile() itself. Instead we make a single copy on
+// demand and share it between all the missing channels.
+FloatVectorDataPtr missingChannel( FloatVectorDataPtr &blackTile )
+{
+	if( !blackTile )
+	{
+		blackTile = ImagePlug::blackTile()->copy();
+	}
+	return blackTile;
+}
+
+} // namespace
+
+IECore::ConstObjectVectorPtr ImageReader::computeMultiChannelData( const std::vector<std::string> &channelNames, const Imath::V2i &tileOrigin, const Gaffer::Context *context, const ImagePlug *parent ) const
+{
+	ConstLevelInfoPtr info = levelInfo( this );
+	ConstLevelInfoPtr source = sourceLevelInfo( this, context );
+
+	// Find the range of channels we need from the file.
+	vector<int> channelIndices;
+	channelIndices.reserve( channelNames.size() );
+	int chBegin = std::numeric_limits<int>::max();
+	int chEnd = 0;
+	for( vector<string>::const_iterator it = channelNames.begin(), eIt = channelNames.end(); it != eIt; ++it )
+	{
+		const int channelIndex = info->channelIndex( *it );
+		channelIndices.push_back( channelIndex );
+		if( channelIndex >= 0 )
 		{
-			return parent->channelDataPlug()->defaultValue();
+			chBegin = std::min( chBegin, channelIndex );
+			chEnd = std::max( chEnd, channelIndex + 1 );
 		}
 	}
 
-	Format format( Imath::Box2i( Imath::V2i( spec->full_x, spec->full_y ), Imath::V2i( spec->full_width + spec->full_x - 1, spec->full_height + spec->full_y - 1 ) ) );
-	const int newY = format.formatToYDownSpace( tileOrigin.y + ImagePlug::tileSize() - 1 );
+	ObjectVectorPtr result = new ObjectVector;
+	result->members().reserve( channelNames.size() );
+	// Shared by all the channels missing from the file.
+	FloatVectorDataPtr blackTile;
 
-	std::vector<float> channelData( ImagePlug::tileSize() * ImagePlug::tileSize() );
-	size_t channelIndex = channelIt - spec->channelnames.begin();
-	imageCache()->get_pixels(
-		uFileName,
-		0, 0, // subimage, miplevel
-		tileOrigin.x, tileOrigin.x + ImagePlug::tileSize(),
-		newY, newY + ImagePlug::tileSize(),
-		0, 1,
-		channelIndex, channelIndex + 1,
-		TypeDesc::FLOAT,
-		&(channelData[0])
-	);
+	const int tileSize = ImagePlug::tileSize();
+	const size_t numPixels = tileSize * tileSize;
+	const int numInterleavedChannels = chEnd - chBegin;
+	if( numInterleavedChannels > (int)channelNames.size() * 2 )
+	{
+		// The channels are too sparsely distributed in the file for a
+		// combined read to pay off, so we read each one directly.
+		for( vector<int>::const_iterator it = channelIndices.begin(), eIt = channelIndices.end(); it != eIt; ++it )
+		{
+			if( *it < 0 )
+			{
+				result->members().push_back( missingChannel( blackTile ) );
+				continue;
+			}
+			FloatVectorDataPtr channelData = new FloatVectorData;
+			channelData->writable().resize( numPixels );
+			readTile( info.get(), source.get(), tileOrigin, *it, *it + 1, &(channelData->writable()[0]), 1 );
+			result->members().push_back( channelData );
+		}
+		return result;
+	}
 
-	// Create the output data buffer.
-	FloatVectorDataPtr resultData = new FloatVectorData;
-	vector<float> &result = resultData->writable();
-	result.resize( ImagePlug::tileSize() * ImagePlug::tileSize() );
+	// Read all the channels in a single call, and then
+	// deinterleave them into the individual tiles.
+	vector<float> *buffer = NULL;
+	if( numInterleavedChannels > 0 )
+	{
+		buffer = &g_tileBuffers.local();
+		buffer->resize( numPixels * numInterleavedChannels );
+		readTile( info.get(), source.get(), tileOrigin, chBegin, chEnd, &((*buffer)[0]), numInterleavedChannels );
+	}
 
-	// Flip the tile in the Y axis to convert it to our internal image data representation.
-	for( int y = 0; y < ImagePlug::tileSize(); ++y )
+	for( vector<int>::const_iterator it = channelIndices.begin(), eIt = channelIndices.end(); it != eIt; ++it )
 	{
-		memcpy( &(result[ ( ImagePlug::tileSize() - y - 1 ) * ImagePlug::tileSize() ]), &(channelData[ y * ImagePlug::tileSize() ]), sizeof(float)*ImagePlug::tileSize()  );
+		if( *it < 0 )
+		{
+			result->members().push_back( missingChannel( blackTile ) );
+			continue;
+		}
+
+		FloatVectorDataPtr channelData = new FloatVectorData;
+		vector<float> &channel = channelData->writable();
+		channel.resize( numPixels );
+		const float *in = &((*buffer)[*it - chBegin]);
+		for( vector<float>::iterator outIt = channel.begin(), eOutIt = channel.end(); outIt != eOutIt; ++outIt )
+		{
+			*outIt = *in;
+			in += numInterleavedChannels;
+		}
+		result->members().push_back( channelData );
 	}
 
-	return resultData;
+	return result;
+}
+
+void ImageReader::hashFileAndLevel( IECore::MurmurHash &h ) const
+{
+	fileNamePlug()->hash( h );
+	refreshCountPlug()->hash( h );
+	subimagePlug()->hash( h );
+	// We hash the requested level rather than the level we'll actually
+	// read, so that we don't need to access the file to compute the hash.
+	mipLevelPlug()->hash( h );
 }
 
 void ImageReader::plugSet( Gaffer::Plug *plug )
@@ -505,5 +881,6 @@ void ImageReader::plugSet( Gaffer::Plug *plug )
 	if( plug == refreshCountPlug() )
 	{
 		imageCache()->invalidate_all( true );
+		fileInfoCache()->clear();
 	}
 }
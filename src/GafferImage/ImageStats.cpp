@@ -36,19 +36,169 @@
 
 #include "boost/bind.hpp"
 
+#include "IECore/SimpleTypedData.h"
+#include "IECore/VectorTypedData.h"
+
 #include "Gaffer/TypedPlug.h"
 #include "Gaffer/BoxPlug.h"
 #include "Gaffer/Context.h"
 #include "Gaffer/ScriptNode.h"
 
 #include "GafferImage/ImageStats.h"
-#include "GafferImage/Sampler.h"
+#include "GafferImage/ImageAlgo.h"
 #include "GafferImage/ChannelMaskPlug.h"
 #include "GafferImage/Format.h"
 
+using namespace std;
+using namespace Imath;
+using namespace IECore;
 using namespace GafferImage;
 using namespace Gaffer;
 
+//////////////////////////////////////////////////////////////////////////
+// Internal utilities
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+Box2i intersection( const Box2i &a, const Box2i &b )
+{
+	return Box2i(
+		V2i( max( a.min.x, b.min.x ), max( a.min.y, b.min.y ) ),
+		V2i( min( a.max.x, b.max.x ), min( a.max.y, b.max.y ) )
+	);
+}
+
+uint64_t area( const Box2i &b )
+{
+	if( b.isEmpty() )
+	{
+		return 0;
+	}
+	return uint64_t( b.max.x - b.min.x + 1 ) * uint64_t( b.max.y - b.min.y + 1 );
+}
+
+/// Maps values into histogram bins, clamping values outside
+/// the range into the first and last bins.
+class Binner
+{
+
+	public :
+
+		Binner( const V2f &range, int numBins )
+			:	m_min( range[0] ), m_scale( range[1] > range[0] ? numBins / ( range[1] - range[0] ) : 0.0f ), m_maxBin( numBins - 1 )
+		{
+		}
+
+		int operator()( float v ) const
+		{
+			const float f = ( v - m_min ) * m_scale;
+			// Written so that NaNs end up in the first bin.
+			if( f >= (float)m_maxBin )
+			{
+				return m_maxBin;
+			}
+			return f > 0.0f ? (int)f : 0;
+		}
+
+	private :
+
+		float m_min;
+		float m_scale;
+		int m_maxBin;
+
+};
+
+class GatherTileStats
+{
+
+	public :
+
+		GatherTileStats( const CompoundObjectPlug *tileStatsPlug, const V2i &firstTileOrigin, const V2i &numTiles, vector<ConstCompoundObjectPtr> &stats )
+			:	m_tileStatsPlug( tileStatsPlug ), m_firstTileOrigin( firstTileOrigin ), m_numTiles( numTiles ), m_stats( stats )
+		{
+		}
+
+		void operator()( const ImagePlug *imagePlug, const V2i &tileOrigin )
+		{
+			m_stats[index( tileOrigin )] = m_tileStatsPlug->getValue();
+		}
+
+	private :
+
+		size_t index( const V2i &tileOrigin ) const
+		{
+			const V2i tileIndex = ( tileOrigin - m_firstTileOrigin ) / ImagePlug::tileSize();
+			return tileIndex.y * m_numTiles.x + tileIndex.x;
+		}
+
+		const CompoundObjectPlug *m_tileStatsPlug;
+		const V2i m_firstTileOrigin;
+		const V2i m_numTiles;
+		vector<ConstCompoundObjectPtr> &m_stats;
+
+};
+
+class HashTileStats
+{
+
+	public :
+
+		HashTileStats( const CompoundObjectPlug *tileStatsPlug, const V2i &firstTileOrigin, const V2i &numTiles, vector<MurmurHash> &hashes )
+			:	m_tileStatsPlug( tileStatsPlug ), m_firstTileOrigin( firstTileOrigin ), m_numTiles( numTiles ), m_hashes( hashes )
+		{
+		}
+
+		void operator()( const ImagePlug *imagePlug, const V2i &tileOrigin )
+		{
+			const V2i tileIndex = ( tileOrigin - m_firstTileOrigin ) / ImagePlug::tileSize();
+			m_hashes[tileIndex.y * m_numTiles.x + tileIndex.x] = m_tileStatsPlug->hash();
+		}
+
+	private :
+
+		const CompoundObjectPlug *m_tileStatsPlug;
+		const V2i m_firstTileOrigin;
+		const V2i m_numTiles;
+		vector<MurmurHash> &m_hashes;
+
+};
+
+float percentileFromStats( const CompoundObject *stats, const V2f &range, float percentile )
+{
+	const float minValue = stats->member<FloatData>( "min" )->readable();
+	const float maxValue = stats->member<FloatData>( "max" )->readable();
+	const vector<uint64_t> &histogram = stats->member<UInt64VectorData>( "histogram" )->readable();
+	const uint64_t count = stats->member<UInt64Data>( "count" )->readable();
+
+	const double target = max( 0.0f, min( percentile, 100.0f ) ) / 100.0 * count;
+	const float binWidth = ( range[1] - range[0] ) / histogram.size();
+
+	float result = maxValue;
+	uint64_t cumulative = 0;
+	for( size_t i = 0, e = histogram.size(); i < e; ++i )
+	{
+		if( histogram[i] && cumulative + histogram[i] >= target )
+		{
+			const double fraction = ( target - cumulative ) / histogram[i];
+			result = range[0] + ( i + fraction ) * binWidth;
+			break;
+		}
+		cumulative += histogram[i];
+	}
+
+	// The first and last bins also hold any values outside the histogram
+	// range, and the true extremes are known exactly, so clamp to them.
+	return max( minValue, min( result, maxValue ) );
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// ImageStats
+//////////////////////////////////////////////////////////////////////////
+
 IE_CORE_DEFINERUNTIMETYPED( ImageStats );
 
 size_t ImageStats::g_firstPlugIndex = 0;
@@ -70,6 +220,13 @@ ImageStats::ImageStats( const std::string &name )
 	addChild( new Color4fPlug( "average", Gaffer::Plug::Out ) );
 	addChild( new Color4fPlug( "min", Gaffer::Plug::Out ) );
 	addChild( new Color4fPlug( "max", Gaffer::Plug::Out ) );
+	addChild( new V2fPlug( "histogramRange", Gaffer::Plug::In, V2f( 0, 1 ) ) );
+	addChild( new IntPlug( "histogramBins", Gaffer::Plug::In, 256, 1, 65536 ) );
+	addChild( new FloatPlug( "percentile", Gaffer::Plug::In, 50, 0, 100 ) );
+	addChild( new CompoundObjectPlug( "histogram", Gaffer::Plug::Out, new CompoundObject ) );
+	addChild( new Color4fPlug( "percentileValue", Gaffer::Plug::Out ) );
+	addChild( new CompoundObjectPlug( "__tileStats", Gaffer::Plug::Out, new CompoundObject ) );
+	addChild( new CompoundObjectPlug( "__channelStats", Gaffer::Plug::Out, new CompoundObject ) );
 	plugInputChangedSignal().connect( boost::bind( &ImageStats::inputChanged, this, ::_1 ) );
 }
 
@@ -137,6 +294,76 @@ const Color4fPlug *ImageStats::maxPlug() const
 	return getChild<Color4fPlug>( g_firstPlugIndex + 5 );
 }
 
+V2fPlug *ImageStats::histogramRangePlug()
+{
+	return getChild<V2fPlug>( g_firstPlugIndex + 6 );
+}
+
+const V2fPlug *ImageStats::histogramRangePlug() const
+{
+	return getChild<V2fPlug>( g_firstPlugIndex + 6 );
+}
+
+IntPlug *ImageStats::histogramBinsPlug()
+{
+	return getChild<IntPlug>( g_firstPlugIndex + 7 );
+}
+
+const IntPlug *ImageStats::histogramBinsPlug() const
+{
+	return getChild<IntPlug>( g_firstPlugIndex + 7 );
+}
+
+FloatPlug *ImageStats::percentilePlug()
+{
+	return getChild<FloatPlug>( g_firstPlugIndex + 8 );
+}
+
+const FloatPlug *ImageStats::percentilePlug() const
+{
+	return getChild<FloatPlug>( g_firstPlugIndex + 8 );
+}
+
+CompoundObjectPlug *ImageStats::histogramPlug()
+{
+	return getChild<CompoundObjectPlug>( g_firstPlugIndex + 9 );
+}
+
+const CompoundObjectPlug *ImageStats::histogramPlug() const
+{
+	return getChild<CompoundObjectPlug>( g_firstPlugIndex + 9 );
+}
+
+Color4fPlug *ImageStats::percentileValuePlug()
+{
+	return getChild<Color4fPlug>( g_firstPlugIndex + 10 );
+}
+
+const Color4fPlug *ImageStats::percentileValuePlug() const
+{
+	return getChild<Color4fPlug>( g_firstPlugIndex + 10 );
+}
+
+CompoundObjectPlug *ImageStats::tileStatsPlug()
+{
+	return getChild<CompoundObjectPlug>( g_firstPlugIndex + 11 );
+}
+
+const CompoundObjectPlug *ImageStats::tileStatsPlug() const
+{
+	return getChild<CompoundObjectPlug>( g_firstPlugIndex + 11 );
+}
+
+CompoundObjectPlug *ImageStats::channelStatsPlug()
+{
+	return getChild<CompoundObjectPlug>( g_firstPlugIndex + 12 );
+}
+
+const CompoundObjectPlug *ImageStats::channelStatsPlug() const
+{
+	return getChild<CompoundObjectPlug>( g_firstPlugIndex + 12 );
+}
+
 void ImageStats::inputChanged( Gaffer::Plug *plug )
 {
 	const Imath::Box2i regionOfInterest( regionOfInterestPlug()->getValue() );
@@ -173,76 +400,112 @@ void ImageStats::parentChanging( Gaffer::GraphComponent *newParent )
 void ImageStats::affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs ) const
 {
 	ComputeNode::affects( input, outputs );
-	if (
-			input == channelsPlug() ||
-			input->parent<ImagePlug>() == inPlug() ||
-			regionOfInterestPlug()->isAncestorOf( input )
-	   )
+
+	if(
+		input == inPlug()->channelDataPlug() ||
+		input == inPlug()->dataWindowPlug() ||
+		regionOfInterestPlug()->isAncestorOf( input ) ||
+		histogramRangePlug()->isAncestorOf( input ) ||
+		input == histogramBinsPlug()
+	)
+	{
+		outputs.push_back( tileStatsPlug() );
+	}
+
+	if( input == tileStatsPlug() )
+	{
+		outputs.push_back( channelStatsPlug() );
+	}
+
+	if(
+		input == channelsPlug() ||
+		input->parent<ImagePlug>() == inPlug() ||
+		regionOfInterestPlug()->isAncestorOf( input ) ||
+		input == channelStatsPlug()
+	)
 	{
 		for( unsigned int i = 0; i < 4; ++i )
 		{
 			outputs.push_back( minPlug()->getChild(i) );
 			outputs.push_back( averagePlug()->getChild(i) );
 			outputs.push_back( maxPlug()->getChild(i) );
+			outputs.push_back( percentileValuePlug()->getChild(i) );
 		}
+		outputs.push_back( histogramPlug() );
 		return;
 	}
+
+	if( input == percentilePlug() )
+	{
+		for( unsigned int i = 0; i < 4; ++i )
+		{
+			outputs.push_back( percentileValuePlug()->getChild(i) );
+		}
+	}
 }
 
 void ImageStats::hash( const ValuePlug *output, const Context *context, IECore::MurmurHash &h ) const
 {
 	ComputeNode::hash( output, context, h);
 
-	bool earlyOut = true;
-	for( int i = 0; i < 4; ++i )
+	if( output == tileStatsPlug() )
 	{
-		if (
-				output == minPlug()->getChild(i) ||
-				output == maxPlug()->getChild(i) ||
-				output == averagePlug()->getChild(i)
-		   )
-		{
-			earlyOut = false;
-			break;
-		}
+		hashTileStats( context, h );
+		return;
 	}
-	if( earlyOut )
+	else if( output == channelStatsPlug() )
 	{
+		hashChannelStats( context, h );
 		return;
 	}
 
 	const Imath::Box2i regionOfInterest( regionOfInterestPlug()->getValue() );
-	regionOfInterestPlug()->hash( h );
-	inPlug()->channelNamesPlug()->hash( h );
-	inPlug()->dataWindowPlug()->hash( h );
 
-	IECore::ConstStringVectorDataPtr channelNamesData = inPlug()->channelNamesPlug()->getValue();
-	std::vector<std::string> maskChannels = channelNamesData->readable();
-	channelsPlug()->maskChannels( maskChannels );
-	const int nChannels( maskChannels.size() );
+	if( output == histogramPlug() )
+	{
+		if( regionOfInterest.isEmpty() )
+		{
+			return;
+		}
+		const vector<string> channels = maskedChannels();
+		for( vector<string>::const_iterator it = channels.begin(), eIt = channels.end(); it != eIt; ++it )
+		{
+			h.append( *it );
+			h.append( channelStatsHash( *it ) );
+		}
+		return;
+	}
 
-	if ( nChannels > 0 )
+	const GraphComponent *parent = output->parent<GraphComponent>();
+	if(
+		parent != minPlug() &&
+		parent != maxPlug() &&
+		parent != averagePlug() &&
+		parent != percentileValuePlug()
+	)
+	{
+		return;
+	}
+
+	std::string channel;
+	if( !regionOfInterest.isEmpty() )
 	{
-		std::vector<std::string> uniqueChannels = maskChannels;
-		GafferImage::ChannelMaskPlug::removeDuplicateIndices( uniqueChannels );
-		std::string channel;
 		channelNameFromOutput( output, channel );
+	}
 
-		if ( !channel.empty() )
+	if ( !channel.empty() )
+	{
+		h.append( channel );
+		h.append( channelStatsHash( channel ) );
+		if( parent == percentileValuePlug() )
 		{
-			h.append( channel );
-			Sampler s( inPlug(), channel, regionOfInterest );
-			s.hash( h );
-			return;
+			percentilePlug()->hash( h );
 		}
+		return;
 	}
 
 	// If our node is not enabled then we just append the default value that we will give the plug.
-	if(
-			output == maxPlug()->getChild(3) ||
-			output == minPlug()->getChild(3) ||
-			output == averagePlug()->getChild(3)
-	  )
+	if( output == parent->getChild( 3 ) )
 	{
 		h.append( 0 );
 	}
@@ -252,23 +515,28 @@ void ImageStats::hash( const ValuePlug *output, const Context *context, IECore::
 	}
 }
 
-void ImageStats::channelNameFromOutput( const ValuePlug *output, std::string &channelName ) const
+std::vector<std::string> ImageStats::maskedChannels() const
 {
 	IECore::ConstStringVectorDataPtr channelNamesData = inPlug()->channelNamesPlug()->getValue();
 	std::vector<std::string> maskChannels = channelNamesData->readable();
 	channelsPlug()->maskChannels( maskChannels );
+	return maskChannels;
+}
 
+void ImageStats::channelNameFromOutput( const ValuePlug *output, std::string &channelName ) const
+{
 	/// As the channelMaskPlug allows any combination of channels to be input we need to make sure that
 	/// the channels that it masks each have a distinct channelIndex. Otherwise multiple channels would be
 	/// outputting to the same plug.
-	std::vector<std::string> uniqueChannels = maskChannels;
+	std::vector<std::string> uniqueChannels = maskedChannels();
 	GafferImage::ChannelMaskPlug::removeDuplicateIndices( uniqueChannels );
 
 	for( int channelIndex = 0; channelIndex < 4; ++channelIndex )
 	{
 		if ( output == minPlug()->getChild( channelIndex ) ||
 			 output == maxPlug()->getChild( channelIndex ) ||
-			 output == averagePlug()->getChild( channelIndex )
+			 output == averagePlug()->getChild( channelIndex ) ||
+			 output == percentileValuePlug()->getChild( channelIndex )
 		   )
 		{
 			for( std::vector<std::string>::iterator it( uniqueChannels.begin() ); it != uniqueChannels.end(); ++it )
@@ -286,11 +554,7 @@ void ImageStats::channelNameFromOutput( const ValuePlug *output, std::string &ch
 
 void ImageStats::setOutputToDefault( FloatPlug *output ) const
 {
-	if (
-			output == minPlug()->getChild(3) ||
-			output == maxPlug()->getChild(3) ||
-			output == averagePlug()->getChild(3)
-	   )
+	if( output == output->parent<GraphComponent>()->getChild( 3 ) )
 	{
 		output->setValue( 1. );
 	}
@@ -300,65 +564,249 @@ void ImageStats::setOutputToDefault( FloatPlug *output ) const
 	}
 }
 
-void ImageStats::compute( ValuePlug *output, const Context *context ) const
+IECore::ConstCompoundObjectPtr ImageStats::channelStats( const std::string &channelName ) const
 {
-	const Imath::Box2i &regionOfInterest( regionOfInterestPlug()->getValue() );
-	if( regionOfInterest.isEmpty() )
+	ContextPtr tmpContext = new Context( *Context::current(), Context::Borrowed );
+	tmpContext->set( ImagePlug::channelNameContextName, channelName );
+	Context::Scope scopedContext( tmpContext.get() );
+	return channelStatsPlug()->getValue();
+}
+
+IECore::MurmurHash ImageStats::channelStatsHash( const std::string &channelName ) const
+{
+	ContextPtr tmpContext = new Context( *Context::current(), Context::Borrowed );
+	tmpContext->set( ImagePlug::channelNameContextName, channelName );
+	Context::Scope scopedContext( tmpContext.get() );
+	return channelStatsPlug()->hash();
+}
+
+void ImageStats::hashTileStats( const Gaffer::Context *context, IECore::MurmurHash &h ) const
+{
+	const V2i tileOrigin = context->get<V2i>( ImagePlug::tileOriginContextName );
+	const Box2i tileBound( tileOrigin, tileOrigin + V2i( ImagePlug::tileSize() - 1 ) );
+	const Box2i region = intersection( tileBound, regionOfInterestPlug()->getValue() );
+	const Box2i validRegion = intersection( region, inPlug()->dataWindowPlug()->getValue() );
+
+	// Tiles with identical contents and coverage yield identical statistics,
+	// so we hash the regions rather than the tile origin and channel name.
+	h.append( region );
+	h.append( validRegion );
+	if( !validRegion.isEmpty() )
 	{
-		setOutputToDefault( static_cast<FloatPlug*>( output ) );
-		return;
+		inPlug()->channelDataPlug()->hash( h );
 	}
+	histogramRangePlug()->hash( h );
+	histogramBinsPlug()->hash( h );
+}
 
-	std::string channelName;
-	channelNameFromOutput( output, channelName );
-	if ( channelName.empty() )
+IECore::ConstCompoundObjectPtr ImageStats::computeTileStats( const Gaffer::Context *context ) const
+{
+	const V2i tileOrigin = context->get<V2i>( ImagePlug::tileOriginContextName );
+	const Box2i tileBound( tileOrigin, tileOrigin + V2i( ImagePlug::tileSize() - 1 ) );
+	const Box2i region = intersection( tileBound, regionOfInterestPlug()->getValue() );
+	const Box2i validRegion = intersection( region, inPlug()->dataWindowPlug()->getValue() );
+	const Binner binner( histogramRangePlug()->getValue(), histogramBinsPlug()->getValue() );
+
+	float minValue = numeric_limits<float>::max();
+	float maxValue = -numeric_limits<float>::max();
+	double sum = 0.0;
+	UInt64VectorDataPtr histogramData = new UInt64VectorData;
+	vector<uint64_t> &histogram = histogramData->writable();
+	histogram.resize( histogramBinsPlug()->getValue(), 0 );
+
+	// Pixels outside the data window are black, so we account for
+	// them in bulk without needing to visit them.
+	const uint64_t count = area( region );
+	const uint64_t numBlack = count - area( validRegion );
+	if( numBlack )
+	{
+		minValue = min( minValue, 0.0f );
+		maxValue = max( maxValue, 0.0f );
+		histogram[binner( 0.0f )] += numBlack;
+	}
+
+	if( !validRegion.isEmpty() )
+	{
+		ConstFloatVectorDataPtr channelData = inPlug()->channelDataPlug()->getValue();
+		const float *data = &channelData->readable().front();
+		const int tileSize = ImagePlug::tileSize();
+		for( int y = validRegion.min.y; y <= validRegion.max.y; ++y )
+		{
+			const float *p = data + ( y - tileOrigin.y ) * tileSize + ( validRegion.min.x - tileOrigin.x );
+			for( int x = validRegion.min.x; x <= validRegion.max.x; ++x, ++p )
+			{
+				const float v = *p;
+				minValue = min( v, minValue );
+				maxValue = max( v, maxValue );
+				sum += v;
+				histogram[binner( v )]++;
+			}
+		}
+	}
+
+	CompoundObjectPtr result = new CompoundObject;
+	result->members()["min"] = new FloatData( minValue );
+	result->members()["max"] = new FloatData( maxValue );
+	result->members()["sum"] = new DoubleData( sum );
+	result->members()["count"] = new UInt64Data( count );
+	result->members()["histogram"] = histogramData;
+	return result;
+}
+
+void ImageStats::hashChannelStats( const Gaffer::Context *context, IECore::MurmurHash &h ) const
+{
+	const Box2i regionOfInterest = regionOfInterestPlug()->getValue();
+	h.append( regionOfInterest );
+
+	// The tiles are hashed in parallel, but combined in order so
+	// that the result is independent of scheduling.
+	V2i firstTileOrigin, numTilesXY;
+	vector<MurmurHash> tileHashes( numTiles( regionOfInterest, firstTileOrigin, numTilesXY ) );
+	if( tileHashes.empty() )
 	{
-		setOutputToDefault( static_cast<FloatPlug*>( output ) );
 		return;
 	}
 
-	int channelIndex = GafferImage::ChannelMaskPlug::channelIndex( channelName );
+	HashTileStats hashTileStats( tileStatsPlug(), firstTileOrigin, numTilesXY, tileHashes );
+	parallelProcessTiles( inPlug(), hashTileStats, regionOfInterest );
 
-	// Set up the execution context.
-	ContextPtr tmpContext = new Context( *context, Context::Borrowed );
-	tmpContext->set( ImagePlug::channelNameContextName, channelName );
-	Context::Scope scopedContext( tmpContext.get() );
+	for( vector<MurmurHash>::const_iterator it = tileHashes.begin(), eIt = tileHashes.end(); it != eIt; ++it )
+	{
+		h.append( *it );
+	}
+}
+
+IECore::ConstCompoundObjectPtr ImageStats::computeChannelStats( const Gaffer::Context *context ) const
+{
+	const Box2i regionOfInterest = regionOfInterestPlug()->getValue();
+
+	V2i firstTileOrigin, numTilesXY;
+	vector<ConstCompoundObjectPtr> tileStats( numTiles( regionOfInterest, firstTileOrigin, numTilesXY ) );
+	if( tileStats.empty() )
+	{
+		return tileStatsPlug()->defaultValue();
+	}
+
+	GatherTileStats gatherTileStats( tileStatsPlug(), firstTileOrigin, numTilesXY, tileStats );
+	parallelProcessTiles( inPlug(), gatherTileStats, regionOfInterest );
 
-	// Loop over the ROI and compute the min, max and average channel values and then set our outputs.
-	Sampler s( inPlug(), channelName, regionOfInterest );
+	// Reduce serially and in a fixed order, so that the sum is
+	// deterministic regardless of how the tiles were scheduled.
+	float minValue = numeric_limits<float>::max();
+	float maxValue = -numeric_limits<float>::max();
+	double sum = 0.0;
+	uint64_t count = 0;
+	UInt64VectorDataPtr histogramData = new UInt64VectorData;
+	vector<uint64_t> &histogram = histogramData->writable();
+
+	for( vector<ConstCompoundObjectPtr>::const_iterator it = tileStats.begin(), eIt = tileStats.end(); it != eIt; ++it )
+	{
+		const CompoundObject *stats = it->get();
+		minValue = min( minValue, stats->member<FloatData>( "min" )->readable() );
+		maxValue = max( maxValue, stats->member<FloatData>( "max" )->readable() );
+		sum += stats->member<DoubleData>( "sum" )->readable();
+		count += stats->member<UInt64Data>( "count" )->readable();
+
+		const vector<uint64_t> &tileHistogram = stats->member<UInt64VectorData>( "histogram" )->readable();
+		if( histogram.empty() )
+		{
+			histogram = tileHistogram;
+		}
+		else
+		{
+			for( size_t i = 0, e = histogram.size(); i < e; ++i )
+			{
+				histogram[i] += tileHistogram[i];
+			}
+		}
+	}
+
+	CompoundObjectPtr result = new CompoundObject;
+	result->members()["min"] = new FloatData( minValue );
+	result->members()["max"] = new FloatData( maxValue );
+	result->members()["sum"] = new DoubleData( sum );
+	result->members()["count"] = new UInt64Data( count );
+	result->members()["histogram"] = histogramData;
+	return result;
+}
+
+void ImageStats::compute( ValuePlug *output, const Context *context ) const
+{
+	if( output == tileStatsPlug() )
+	{
+		static_cast<CompoundObjectPlug *>( output )->setValue( computeTileStats( context ) );
+		return;
+	}
+	else if( output == channelStatsPlug() )
+	{
+		static_cast<CompoundObjectPlug *>( output )->setValue( computeChannelStats( context ) );
+		return;
+	}
 
-	float min = std::numeric_limits<float>::max();
-	float max = std::numeric_limits<float>::min();
-	float average = 0.f;
+	const Imath::Box2i regionOfInterest( regionOfInterestPlug()->getValue() );
 
-	double sum = 0.;
-	for( int y = regionOfInterest.min.y; y <= regionOfInterest.max.y; ++y )
+	if( output == histogramPlug() )
 	{
-		for( int x = regionOfInterest.min.x; x <= regionOfInterest.max.x; ++x )
+		CompoundObjectPtr result = new CompoundObject;
+		if( !regionOfInterest.isEmpty() )
 		{
-			float v = s.sample( x, y );
-			min = std::min( v, min );
-			max = std::max( v, max );
-			sum += v;
+			const vector<string> channels = maskedChannels();
+			for( vector<string>::const_iterator it = channels.begin(), eIt = channels.end(); it != eIt; ++it )
+			{
+				ConstCompoundObjectPtr stats = channelStats( *it );
+				// Cast is OK - the histogram is shared rather than modified.
+				result->members()[*it] = const_cast<UInt64VectorData *>( stats->member<UInt64VectorData>( "histogram" ) );
+			}
 		}
+		static_cast<CompoundObjectPlug *>( output )->setValue( result );
+		return;
 	}
-	average = sum / double( (regionOfInterest.size().x+1) * (regionOfInterest.size().y+1) );
 
-	if ( minPlug()->getChild( channelIndex ) == output )
+	const GraphComponent *parent = output->parent<GraphComponent>();
+	if(
+		parent != minPlug() &&
+		parent != maxPlug() &&
+		parent != averagePlug() &&
+		parent != percentileValuePlug()
+	)
 	{
-		static_cast<FloatPlug *>( output )->setValue( min );
+		ComputeNode::compute( output, context );
+		return;
 	}
-	else if ( maxPlug()->getChild( channelIndex ) == output )
+
+	if( regionOfInterest.isEmpty() )
 	{
-		static_cast<FloatPlug *>( output )->setValue( max );
+		setOutputToDefault( static_cast<FloatPlug*>( output ) );
+		return;
 	}
-	else if ( averagePlug()->getChild( channelIndex ) == output )
+
+	std::string channelName;
+	channelNameFromOutput( output, channelName );
+	if ( channelName.empty() )
 	{
-		static_cast<FloatPlug *>( output )->setValue( average );
+		setOutputToDefault( static_cast<FloatPlug*>( output ) );
+		return;
+	}
+
+	ConstCompoundObjectPtr stats = channelStats( channelName );
+
+	float value = 0;
+	if( parent == minPlug() )
+	{
+		value = stats->member<FloatData>( "min" )->readable();
+	}
+	else if( parent == maxPlug() )
+	{
+		value = stats->member<FloatData>( "max" )->readable();
+	}
+	else if( parent == averagePlug() )
+	{
+		value = stats->member<DoubleData>( "sum" )->readable() / (double)stats->member<UInt64Data>( "count" )->readable();
 	}
 	else
 	{
-		static_cast<FloatPlug *>( output )->setValue( 0 );
+		value = percentileFromStats( stats.get(), histogramRangePlug()->getValue(), percentilePlug()->getValue() );
 	}
-}
 
+	static_cast<FloatPlug *>( output )->setValue( value );
+}
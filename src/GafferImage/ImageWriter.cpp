@@ -39,6 +39,9 @@
 #include "boost/bind.hpp"
 #include "boost/filesystem.hpp"
 
+#include "tbb/pipeline.h"
+#include "tbb/task_scheduler_init.h"
+
 #include "OpenImageIO/imageio.h"
 OIIO_NAMESPACE_USING
 
@@ -216,6 +219,223 @@ void metadataToImageSpecAttributes( const CompoundObject *metadata, ImageSpec &s
 
 } // namespace
 
+//////////////////////////////////////////////////////////////////////////
+// Pipeline for streaming the image to file. Rather than building the
+// whole image in memory before writing it, we divide it into horizontal
+// bands of rows. A tbb::pipeline computes bands in parallel and writes
+// them in order as they complete, so computation overlaps with writing
+// and only a bounded number of bands are held in memory at once.
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// A band of rows of the output file, interleaved ready for writing.
+struct Band
+{
+	int yBegin; // in OIIO's y-down space
+	int yEnd;
+	std::vector<float> pixels;
+};
+
+// State shared by all the filters of the pipeline.
+struct WriteState
+{
+
+	const ImagePlug *image;
+	const Context *context;
+	std::vector<std::string> channelNames;
+	Format format;
+	// In Gaffer space, or empty if the image is black.
+	Box2i dataWindow;
+	// In OIIO's y-down space, inclusive.
+	Box2i fileDataWindow;
+	bool tiled;
+	ImageOutput *out;
+	std::string fileName;
+
+	// Buffers are reused round robin. This is safe because the pipeline
+	// is run with at most bands.size() tokens in flight, and the final
+	// filter is serial_in_order, so the band used for any token has
+	// always been written before the token which reuses it is started.
+	std::vector<Band> bands;
+
+	int width() const
+	{
+		return fileDataWindow.size().x + 1;
+	}
+
+	// Returns the end of the band starting at yBegin. In tiled mode bands
+	// must correspond to rows of tiles in the file, and in scanline mode
+	// we match rows of tiles in the ImagePlug so each tile is only needed
+	// by a single band.
+	int bandEnd( int yBegin ) const
+	{
+		const int tileSize = ImagePlug::tileSize();
+		int result;
+		if( tiled || dataWindow.isEmpty() )
+		{
+			result = yBegin + tileSize;
+		}
+		else
+		{
+			const int tileOriginY = ImagePlug::tileOrigin( V2i( 0, format.yDownToFormatSpace( yBegin ) ) ).y;
+			result = format.formatToYDownSpace( tileOriginY ) + 1;
+		}
+		return std::min( result, fileDataWindow.max.y + 1 );
+	}
+
+};
+
+class BandIteratorFilter : public tbb::filter
+{
+
+	public :
+
+		BandIteratorFilter( WriteState &state )
+			:	tbb::filter( tbb::filter::serial_in_order ), m_state( state ), m_y( state.fileDataWindow.min.y ), m_count( 0 )
+		{
+		}
+
+		virtual void *operator()( void *item )
+		{
+			if( m_y > m_state.fileDataWindow.max.y )
+			{
+				return NULL;
+			}
+
+			Band *band = &m_state.bands[m_count++ % m_state.bands.size()];
+			band->yBegin = m_y;
+			band->yEnd = m_state.bandEnd( m_y );
+			m_y = band->yEnd;
+			return band;
+		}
+
+	private :
+
+		WriteState &m_state;
+		int m_y;
+		size_t m_count;
+
+};
+
+class BandComputeFilter : public tbb::filter
+{
+
+	public :
+
+		BandComputeFilter( const WriteState &state )
+			:	tbb::filter( tbb::filter::parallel ), m_state( state )
+		{
+		}
+
+		virtual void *operator()( void *item )
+		{
+			Band *band = static_cast<Band *>( item );
+
+			const int nChannels = m_state.channelNames.size();
+			const int width = m_state.width();
+			band->pixels.resize( nChannels * width * ( band->yEnd - band->yBegin ) );
+
+			const Box2i &dataWindow = m_state.dataWindow;
+			if( dataWindow.isEmpty() )
+			{
+				std::fill( band->pixels.begin(), band->pixels.end(), 0.0f );
+				return band;
+			}
+
+			// We're running on a TBB worker thread, so must
+			// specify the context for the computations ourselves.
+			Context::Scope scopedContext( m_state.context );
+
+			const int tileSize = ImagePlug::tileSize();
+			const Format &format = m_state.format;
+			// Range of rows we need, in Gaffer space.
+			const int yMin = format.yDownToFormatSpace( band->yEnd - 1 );
+			const int yMax = format.yDownToFormatSpace( band->yBegin );
+
+			const V2i firstTileOrigin = ImagePlug::tileOrigin( V2i( dataWindow.min.x, yMin ) );
+			for( int tileOriginY = firstTileOrigin.y; tileOriginY <= yMax; tileOriginY += tileSize )
+			{
+				for( int tileOriginX = firstTileOrigin.x; tileOriginX <= dataWindow.max.x; tileOriginX += tileSize )
+				{
+					ConstObjectVectorPtr tiles = m_state.image->multiChannelData( m_state.channelNames, V2i( tileOriginX, tileOriginY ) );
+
+					const int xBegin = std::max( tileOriginX, dataWindow.min.x );
+					const int xEnd = std::min( tileOriginX + tileSize - 1, dataWindow.max.x ) + 1;
+					const int yBegin = std::max( tileOriginY, yMin );
+					const int yEnd = std::min( tileOriginY + tileSize - 1, yMax ) + 1;
+
+					for( int c = 0; c < nChannels; ++c )
+					{
+						const float *tile = &(static_cast<const FloatVectorData *>( tiles->members()[c].get() )->readable()[0]);
+						for( int y = yBegin; y < yEnd; ++y )
+						{
+							const int row = format.formatToYDownSpace( y ) - band->yBegin;
+							const float *in = tile + ( y - tileOriginY ) * tileSize + ( xBegin - tileOriginX );
+							float *out = &(band->pixels[0]) + ( row * width + xBegin - dataWindow.min.x ) * nChannels + c;
+							for( int x = xBegin; x < xEnd; ++x, out += nChannels )
+							{
+								*out = *in++;
+							}
+						}
+					}
+				}
+			}
+
+			return band;
+		}
+
+	private :
+
+		const WriteState &m_state;
+
+};
+
+class BandOutputFilter : public tbb::filter
+{
+
+	public :
+
+		BandOutputFilter( const WriteState &state )
+			:	tbb::filter( tbb::filter::serial_in_order ), m_state( state )
+		{
+		}
+
+		virtual void *operator()( void *item )
+		{
+			const Band *band = static_cast<const Band *>( item );
+			bool success;
+			if( m_state.tiled )
+			{
+				success = m_state.out->write_tiles(
+					m_state.fileDataWindow.min.x, m_state.fileDataWindow.max.x + 1,
+					band->yBegin, band->yEnd,
+					0, 1,
+					TypeDesc::FLOAT, &(band->pixels[0])
+				);
+			}
+			else
+			{
+				success = m_state.out->write_scanlines( band->yBegin, band->yEnd, 0, TypeDesc::FLOAT, &(band->pixels[0]) );
+			}
+
+			if( !success )
+			{
+				throw IECore::Exception( boost::str( boost::format( "Could not write to \"%s\", error = %s" ) % m_state.fileName % m_state.out->geterror() ) );
+			}
+
+			return NULL;
+		}
+
+	private :
+
+		const WriteState &m_state;
+
+};
+
+} // namespace
+
 //////////////////////////////////////////////////////////////////////////
 // ImageWriter implementation
 //////////////////////////////////////////////////////////////////////////
@@ -346,9 +566,6 @@ IECore::MurmurHash ImageWriter::hash( const Context *context ) const
 	return h;
 }
 
-///\todo: We are currently computing all of the channels regardless of whether or not we are outputting them.
-/// Change the execute() method to only compute the channels that are masked by the channelsPlug().
-
 ///\todo: It seems that if a JPG is written with RGBA channels the output is wrong but it should be supported. Find out why and fix it.
 /// There is a test case in ImageWriterTest which checks the output of the jpg writer against an incorrect image and it will fail if it is equal to the writer output.
 void ImageWriter::execute() const
@@ -367,43 +584,35 @@ void ImageWriter::execute() const
 		throw IECore::Exception( boost::str( boost::format( "Invalid filename: %s" ) % fileName ) );
 	}
 
+	WriteState state;
+	state.image = inPlug();
+	state.context = Context::current();
+	state.out = out.get();
+	state.fileName = fileName;
+
 	// Grab the intersection of the channels from the "channels" plug and the image input to see which channels we are to write out.
 	IECore::ConstStringVectorDataPtr channelNamesData = inPlug()->channelNamesPlug()->getValue();
-	std::vector<std::string> maskChannels = channelNamesData->readable();
-	channelsPlug()->maskChannels( maskChannels );
+	state.channelNames = channelNamesData->readable();
+	channelsPlug()->maskChannels( state.channelNames );
+	const std::vector<std::string> &maskChannels = state.channelNames;
 	const int nChannels = maskChannels.size();
 
-	// Get the image channel data.
-	IECore::ImagePrimitivePtr imagePtr( inPlug()->image() );
-
-	// Get the image's display window.
-	const Imath::Box2i displayWindow( imagePtr->getDisplayWindow() );
-	const int displayWindowWidth = displayWindow.size().x+1;
-	const int displayWindowHeight = displayWindow.size().y+1;
-
-	// Get the image's data window and if it then set a flag.
-	bool imageIsBlack = false;
-	Imath::Box2i dataWindow( imagePtr->getDataWindow() );
-	if ( inPlug()->dataWindowPlug()->getValue().isEmpty() )
-	{
-		dataWindow = displayWindow;
-		imageIsBlack = true;
-	}
-
-	int dataWindowWidth = dataWindow.size().x+1;
-	int dataWindowHeight = dataWindow.size().y+1;
+	// Get the image's display and data windows. If the data
+	// window is empty, we write a black image the size of the
+	// display window.
+	state.format = inPlug()->formatPlug()->getValue();
+	const Imath::Box2i displayWindow = state.format.getDisplayWindow();
+	state.dataWindow = inPlug()->dataWindowPlug()->getValue();
+	state.fileDataWindow = state.dataWindow.isEmpty() ? displayWindow : state.format.formatToYDownSpace( state.dataWindow );
 
 	// Create the image header.
-	ImageSpec spec( dataWindowWidth, dataWindowHeight, nChannels, TypeDesc::FLOAT );
+	ImageSpec spec( state.fileDataWindow.size().x + 1, state.fileDataWindow.size().y + 1, nChannels, TypeDesc::FLOAT );
 
-	// Add the channel names to the header whilst getting pointers to the channel data.
-	std::vector<const float*> channelPtrs;
+	// Add the channel names to the header.
 	spec.channelnames.clear();
-	for ( std::vector<std::string>::iterator channelIt( maskChannels.begin() ); channelIt != maskChannels.end(); channelIt++ )
+	for ( std::vector<std::string>::const_iterator channelIt( maskChannels.begin() ); channelIt != maskChannels.end(); channelIt++ )
 	{
 		spec.channelnames.push_back( *channelIt );
-		IECore::FloatVectorDataPtr dataPtr = imagePtr->getChannel<float>( *channelIt );
-		channelPtrs.push_back( &(dataPtr->readable()[0]) );
 
 		// OIIO has a special attribute for the Alpha and Z channels. If we find some, we should tag them...
 		if ( *channelIt == "A" )
@@ -418,10 +627,17 @@ void ImageWriter::execute() const
 	// Specify the display window.
 	spec.full_x = displayWindow.min.x;
 	spec.full_y = displayWindow.min.y;
-	spec.full_width = displayWindowWidth;
-	spec.full_height = displayWindowHeight;
-	spec.x = dataWindow.min.x;
-	spec.y = dataWindow.min.y;
+	spec.full_width = displayWindow.size().x + 1;
+	spec.full_height = displayWindow.size().y + 1;
+	spec.x = state.fileDataWindow.min.x;
+	spec.y = state.fileDataWindow.min.y;
+
+	// Only allow tiled output if our file format supports it.
+	state.tiled = writeModePlug()->getValue() == Tile && out->supports( "tiles" );
+	if( state.tiled )
+	{
+		spec.tile_width = spec.tile_height = ImagePlug::tileSize();
+	}
 
 	// Add common attribs to the spec
 	std::string software = ( boost::format( "Gaffer %d.%d.%d.%d" ) % GAFFER_MILESTONE_VERSION % GAFFER_MAJOR_VERSION % GAFFER_MINOR_VERSION % GAFFER_PATCH_VERSION ).str();
@@ -463,7 +679,7 @@ void ImageWriter::execute() const
 	metadataToImageSpecAttributes( metadata.get(), spec );
 	
 	// PixelAspectRatio must be defined by the FormatPlug
-	spec.attribute( "PixelAspectRatio", (float)inPlug()->formatPlug()->getValue().getPixelAspect() );
+	spec.attribute( "PixelAspectRatio", (float)state.format.getPixelAspect() );
 	
 	// create the directories before opening the file
 	boost::filesystem::path directory = boost::filesystem::path( fileName ).parent_path();
@@ -477,104 +693,17 @@ void ImageWriter::execute() const
 		throw IECore::Exception( boost::str( boost::format( "Could not open \"%s\", error = %s" ) % fileName % out->geterror() ) );
 	}
 
-	// Only allow tiled output if our file format supports it.
-	int writeMode = writeModePlug()->getValue() & out->supports( "tile" );
-
-	if ( writeMode == Scanline )
-	{
-		// Create a buffer for the scanline.
-		float scanline[ nChannels*dataWindowWidth ];
-
-		if ( imageIsBlack )
-		{
-			memset( scanline, 0, sizeof(float) * nChannels*dataWindowWidth );
-
-			for ( int y = spec.y; y < spec.y + dataWindowHeight; ++y )
-			{
-				if ( !out->write_scanline( y, 0, TypeDesc::FLOAT, &scanline[0] ) )
-				{
-					throw IECore::Exception( boost::str( boost::format( "Could not write scanline to \"%s\", error = %s" ) % fileName % out->geterror() ) );
-				}
-			}
-		}
-		else
-		{
-			// Interleave the channel data and write it by scanline to the file.
-			for ( int y = spec.y; y < spec.y + dataWindowHeight; ++y )
-			{
-				for ( std::vector<const float *>::iterator channelDataIt( channelPtrs.begin() ); channelDataIt != channelPtrs.end(); channelDataIt++ )
-				{
-					float *outPtr = &scanline[0] + (channelDataIt - channelPtrs.begin()); // The pointer that we are writing to.
-					// The row that we are reading from is flipped (in the Y) as we use a different image space internally to OpenEXR and OpenImageIO.
-					const float *inRowPtr = (*channelDataIt) + ( y - spec.y ) * dataWindowWidth;
-					const int inc = channelPtrs.size();
-					for ( int x = 0; x < dataWindowWidth; ++x, outPtr += inc )
-					{
-						*outPtr = *inRowPtr++;
-					}
-				}
-
-				if ( !out->write_scanline( y, 0, TypeDesc::FLOAT, &scanline[0] ) )
-				{
-					throw IECore::Exception( boost::str( boost::format( "Could not write scanline to \"%s\", error = %s" ) % fileName % out->geterror() ) );
-				}
-			}
-		}
-	}
-	// Tiled output
-	else
-	{
-		// Create a buffer for the tile.
-		const int tileSize = ImagePlug::tileSize();
-		float tile[ nChannels*tileSize*tileSize ];
-
-		if ( imageIsBlack )
-		{
-			memset( tile, 0,  sizeof(float) * nChannels*tileSize*tileSize );
-			for ( int tileY = 0; tileY < dataWindowHeight; tileY += tileSize )
-			{
-				for ( int tileX = 0; tileX < dataWindowWidth; tileX += tileSize )
-				{
-					if ( !out->write_tile( tileX+dataWindow.min.x, tileY+spec.y, 0, TypeDesc::FLOAT, &tile[0] ) )
-					{
-						throw IECore::Exception( boost::str( boost::format( "Could not write tile to \"%s\", error = %s" ) % fileName % out->geterror() ) );
-					}
-				}
-			}
-		}
-		else
-		{
-			// Interleave the channel data and write it to the file tile-by-tile.
-			for ( int tileY = 0; tileY < dataWindowHeight; tileY += tileSize )
-			{
-				for ( int tileX = 0; tileX < dataWindowWidth; tileX += tileSize )
-				{
-					float *outPtr = &tile[0];
-
-					const int r = std::min( tileSize+tileX, dataWindowWidth );
-					const int t = std::min( tileSize+tileY, dataWindowHeight );
-
-					for ( int y = 0; y < t; ++y )
-					{
-						for ( std::vector<const float *>::iterator channelDataIt( channelPtrs.begin() ); channelDataIt != channelPtrs.end(); channelDataIt++ )
-						{
-							const int inc = channelPtrs.size();
-							const float *inRowPtr = (*channelDataIt) + ( tileY + t - y - 1 ) * dataWindowWidth;
-							for ( int x = 0; x < r; ++x, outPtr += inc )
-							{
-								*outPtr = *inRowPtr+(tileX+x);
-							}
-						}
-					}
-
-					if ( !out->write_tile( tileX+dataWindow.min.x, tileY+spec.y, 0, TypeDesc::FLOAT, &tile[0] ) )
-					{
-						throw IECore::Exception( boost::str( boost::format( "Could not write tile to \"%s\", error = %s" ) % fileName % out->geterror() ) );
-					}
-				}
-			}
-		}
-	}
+	// Stream the image to the file.
+	state.bands.resize( tbb::task_scheduler_init::default_num_threads() );
+	BandIteratorFilter iterator( state );
+	BandComputeFilter compute( state );
+	BandOutputFilter output( state );
+
+	tbb::pipeline pipeline;
+	pipeline.add_filter( iterator );
+	pipeline.add_filter( compute );
+	pipeline.add_filter( output );
+	pipeline.run( state.bands.size() );
 
 	out->close();
 }
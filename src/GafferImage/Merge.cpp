@@ -37,24 +37,103 @@
 #include "IECore/BoxAlgo.h"
 #include "IECore/BoxOps.h"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
+#include "Gaffer/Context.h"
+
 #include "GafferImage/Merge.h"
 
 using namespace IECore;
 using namespace Gaffer;
 
-// Create a set of functions to perform the different operations.
-typedef float (*Op)( float A, float B, float a, float b );
-float opAdd( float A, float B, float a, float b){ return A + B; }
-float opAtop( float A, float B, float a, float b){ return A*b + B*(1.-a); }
-float opDivide( float A, float B, float a, float b){ return A / B; }
-float opIn( float A, float B, float a, float b){ return A*b; }
-float opOut( float A, float B, float a, float b){ return A*(1.-b); }
-float opMask( float A, float B, float a, float b){ return B*a; }
-float opMatte( float A, float B, float a, float b){ return A*a + B*(1.-a); }
-float opMultiply( float A, float B, float a, float b){ return A * B; }
-float opOver( float A, float B, float a, float b){ return A + B*(1.-a); }
-float opSubtract( float A, float B, float a, float b){ return A - B; }
-float opUnder( float A, float B, float a, float b){ return A*(1.-b) + B; }
+// Create a set of functors to perform the different operations. These are
+// passed to Merge::doMergeOperation() by value so that they can be inlined
+// into its inner loop. The skipEmptyB member is true for operations where a
+// black B input leaves A unchanged, so that empty inputs can be skipped.
+namespace
+{
+
+struct OpAdd { static const bool skipEmptyB = true; float operator()( float A, float B, float a, float b ) const { return A + B; } };
+struct OpAtop { static const bool skipEmptyB = false; float operator()( float A, float B, float a, float b ) const { return A*b + B*(1.-a); } };
+struct OpDivide { static const bool skipEmptyB = false; float operator()( float A, float B, float a, float b ) const { return A / B; } };
+struct OpIn { static const bool skipEmptyB = false; float operator()( float A, float B, float a, float b ) const { return A*b; } };
+struct OpOut { static const bool skipEmptyB = true; float operator()( float A, float B, float a, float b ) const { return A*(1.-b); } };
+struct OpMask { static const bool skipEmptyB = false; float operator()( float A, float B, float a, float b ) const { return B*a; } };
+struct OpMatte { static const bool skipEmptyB = false; float operator()( float A, float B, float a, float b ) const { return A*a + B*(1.-a); } };
+struct OpMultiply { static const bool skipEmptyB = false; float operator()( float A, float B, float a, float b ) const { return A * B; } };
+struct OpOver { static const bool skipEmptyB = true; float operator()( float A, float B, float a, float b ) const { return A + B*(1.-a); } };
+struct OpSubtract { static const bool skipEmptyB = true; float operator()( float A, float B, float a, float b ) const { return A - B; } };
+struct OpUnder { static const bool skipEmptyB = true; float operator()( float A, float B, float a, float b ) const { return A*(1.-b) + B; } };
+
+/// Fetches the channel and alpha data for several inputs in parallel.
+/// Inputs which are null are skipped.
+class FetchInputs
+{
+
+	public :
+
+		FetchInputs( const std::vector<const GafferImage::ImagePlug *> &inputs, const Context *context, std::vector<ConstFloatVectorDataPtr> &data, std::vector<ConstFloatVectorDataPtr> &alpha )
+			:	m_inputs( inputs ), m_context( context ), m_data( data ), m_alpha( alpha )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			Context::Scope scopedContext( m_context );
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				if( !m_inputs[i] )
+				{
+					continue;
+				}
+				ConstObjectVectorPtr d = m_inputs[i]->multiChannelDataPlug()->getValue();
+				m_data[i] = boost::static_pointer_cast<const FloatVectorData>( d->members()[0] );
+				m_alpha[i] = boost::static_pointer_cast<const FloatVectorData>( d->members()[1] );
+			}
+		}
+
+	private :
+
+		const std::vector<const GafferImage::ImagePlug *> &m_inputs;
+		const Context *m_context;
+		std::vector<ConstFloatVectorDataPtr> &m_data;
+		std::vector<ConstFloatVectorDataPtr> &m_alpha;
+
+};
+
+/// Hashes the channel and alpha data for several inputs in parallel.
+class HashInputs
+{
+
+	public :
+
+		HashInputs( const std::vector<const GafferImage::ImagePlug *> &inputs, const Context *context, std::vector<MurmurHash> &hashes )
+			:	m_inputs( inputs ), m_context( context ), m_hashes( hashes )
+		{
+		}
+
+		void operator()( const tbb::blocked_range<size_t> &r ) const
+		{
+			Context::Scope scopedContext( m_context );
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				if( m_inputs[i] )
+				{
+					m_hashes[i] = m_inputs[i]->multiChannelDataPlug()->hash();
+				}
+			}
+		}
+
+	private :
+
+		const std::vector<const GafferImage::ImagePlug *> &m_inputs;
+		const Context *m_context;
+		std::vector<MurmurHash> &m_hashes;
+
+};
+
+} // namespace
 
 namespace GafferImage
 {
@@ -209,55 +288,108 @@ IECore::ConstStringVectorDataPtr Merge::computeChannelNames( const Gaffer::Conte
 	return inPlug()->channelNamesPlug()->defaultValue();
 }
 
+bool Merge::inputIsEmpty( const ImagePlug *input, const Imath::V2i &tileOrigin ) const
+{
+	const Imath::Box2i dataWindow = input->dataWindowPlug()->getValue();
+	return
+		dataWindow.isEmpty() ||
+		dataWindow.max.x < tileOrigin.x || dataWindow.min.x >= tileOrigin.x + ImagePlug::tileSize() ||
+		dataWindow.max.y < tileOrigin.y || dataWindow.min.y >= tileOrigin.y + ImagePlug::tileSize();
+}
+
 void Merge::hashChannelData( const GafferImage::ImagePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const
 {
 	ImageProcessor::hashChannelData( output, context, h );
-	
-	const ImagePlugList &inputs( m_inputs.inputs() );
+
+	const Imath::V2i tileOrigin = context->get<Imath::V2i>( ImagePlug::tileOriginContextName );
+
+	// We fetch the channel and alpha together - see computeChannelData().
+	std::vector<std::string> channelNames;
+	channelNames.push_back( context->get<std::string>( ImagePlug::channelNameContextName ) );
+	channelNames.push_back( "A" );
+
+	ContextPtr tmpContext = new Context( *context, Context::Borrowed );
+	tmpContext->remove( ImagePlug::channelNameContextName );
+	tmpContext->set( ImagePlug::channelNamesContextName, channelNames );
+	Context::Scope scopedContext( tmpContext.get() );
+
+	// Inputs which are empty over this tile are left null, so
+	// that they aren't hashed.
+	std::vector<const ImagePlug *> inputs;
 	const ImagePlugList::const_iterator end( m_inputs.endIterator() );
-	for ( ImagePlugList::const_iterator it( inputs.begin() ); it != end; ++it )
+	for ( ImagePlugList::const_iterator it( m_inputs.inputs().begin() ); it != end; ++it )
 	{
 		if ( (*it)->getInput<ValuePlug>() )
 		{
-			(*it)->channelDataPlug()->hash( h );
+			inputs.push_back( inputIsEmpty( it->get(), tileOrigin ) ? NULL : it->get() );
 		}
 	}
-	
+
+	std::vector<MurmurHash> hashes( inputs.size() );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, inputs.size(), 1 ), HashInputs( inputs, tmpContext.get(), hashes ) );
+
+	for( size_t i = 0; i < inputs.size(); ++i )
+	{
+		h.append( hashes[i] );
+		h.append( inputs[i] != NULL );
+	}
+
 	operationPlug()->hash( h );
 }
 
 IECore::ConstFloatVectorDataPtr Merge::computeChannelData( const std::string &channelName, const Imath::V2i &tileOrigin, const Gaffer::Context *context, const ImagePlug *parent ) const
 {
-	std::vector< ConstFloatVectorDataPtr > inData;
-	std::vector< ConstFloatVectorDataPtr > inAlpha;
-
+	// Fetch the channel and alpha from each input with a single
+	// request, rather than one request for each.
+	std::vector<std::string> channelNames;
+	channelNames.push_back( channelName );
+	channelNames.push_back( "A" );
+
+	ContextPtr tmpContext = new Context( *context, Context::Borrowed );
+	tmpContext->remove( ImagePlug::channelNameContextName );
+	tmpContext->set( ImagePlug::channelNamesContextName, channelNames );
+	Context::Scope scopedContext( tmpContext.get() );
+
+	// Inputs which are empty over this tile are left null, so
+	// that they aren't computed.
+	std::vector<const ImagePlug *> inputs;
 	const ImagePlugList::const_iterator end( m_inputs.endIterator() );
 	for( ImagePlugList::const_iterator it( m_inputs.inputs().begin() ); it != end; it++ )
 	{
 		if ( (*it)->getInput<ValuePlug>() )
 		{
-			inData.push_back( (*it)->channelData( channelName, tileOrigin ) );
-			inAlpha.push_back( (*it)->channelData( "A", tileOrigin ) );
+			inputs.push_back( inputIsEmpty( it->get(), tileOrigin ) ? NULL : it->get() );
 		}
 	}
 
+	if( std::count( inputs.begin(), inputs.end(), (const ImagePlug *)NULL ) == (int)inputs.size() )
+	{
+		return ImagePlug::blackTile();
+	}
+
+	// Fetch the inputs in parallel, as for deep stacks of inputs
+	// each may require significant upstream computation.
+	std::vector< ConstFloatVectorDataPtr > inData( inputs.size() );
+	std::vector< ConstFloatVectorDataPtr > inAlpha( inputs.size() );
+	tbb::parallel_for( tbb::blocked_range<size_t>( 0, inputs.size(), 1 ), FetchInputs( inputs, tmpContext.get(), inData, inAlpha ) );
+
 	// Get a pointer to the operation that we wish to perform.
 	Operation operation = (Operation)operationPlug()->getValue();
 	switch( operation )
 	{
-		case( Add ): return doMergeOperation( opAdd, inData, inAlpha, tileOrigin ); break;
-		case( Atop ): return doMergeOperation( opAtop, inData, inAlpha, tileOrigin ); break;
-		case( Divide ): return doMergeOperation( opDivide, inData, inAlpha, tileOrigin ); break;
-		case( In ): return doMergeOperation( opIn, inData, inAlpha, tileOrigin ); break;
-		case( Out ): return doMergeOperation( opOut, inData, inAlpha, tileOrigin ); break;
-		case( Mask ): return doMergeOperation( opMask, inData, inAlpha, tileOrigin ); break;
-		case( Matte ): return doMergeOperation( opMatte, inData, inAlpha, tileOrigin ); break;
-		case( Multiply ): return doMergeOperation( opMultiply, inData, inAlpha, tileOrigin ); break;
-		case( Over ): return doMergeOperation( opOver, inData, inAlpha, tileOrigin ); break;
-		case( Subtract ): return doMergeOperation( opSubtract, inData, inAlpha, tileOrigin ); break;
-		case( Under ): return doMergeOperation( opUnder, inData, inAlpha, tileOrigin ); break;
+		case( Add ): return doMergeOperation( OpAdd(), inData, inAlpha, tileOrigin ); break;
+		case( Atop ): return doMergeOperation( OpAtop(), inData, inAlpha, tileOrigin ); break;
+		case( Divide ): return doMergeOperation( OpDivide(), inData, inAlpha, tileOrigin ); break;
+		case( In ): return doMergeOperation( OpIn(), inData, inAlpha, tileOrigin ); break;
+		case( Out ): return doMergeOperation( OpOut(), inData, inAlpha, tileOrigin ); break;
+		case( Mask ): return doMergeOperation( OpMask(), inData, inAlpha, tileOrigin ); break;
+		case( Matte ): return doMergeOperation( OpMatte(), inData, inAlpha, tileOrigin ); break;
+		case( Multiply ): return doMergeOperation( OpMultiply(), inData, inAlpha, tileOrigin ); break;
+		case( Over ): return doMergeOperation( OpOver(), inData, inAlpha, tileOrigin ); break;
+		case( Subtract ): return doMergeOperation( OpSubtract(), inData, inAlpha, tileOrigin ); break;
+		case( Under ): return doMergeOperation( OpUnder(), inData, inAlpha, tileOrigin ); break;
 	}
-	
+
 	throw Exception( "Merge::computeChannelData : Invalid operation mode." );
 }
 
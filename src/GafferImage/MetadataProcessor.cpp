@@ -51,6 +51,7 @@ MetadataProcessor::MetadataProcessor( const std::string &name )
 	outPlug()->dataWindowPlug()->setInput( inPlug()->dataWindowPlug() );
 	outPlug()->channelNamesPlug()->setInput( inPlug()->channelNamesPlug() );
 	outPlug()->channelDataPlug()->setInput( inPlug()->channelDataPlug() );
+	outPlug()->multiChannelDataPlug()->setInput( inPlug()->multiChannelDataPlug() );
 }
 
 MetadataProcessor::~MetadataProcessor()
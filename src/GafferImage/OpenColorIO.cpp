@@ -35,11 +35,15 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include <cmath>
+
 #include "tbb/mutex.h"
 #include "tbb/null_mutex.h"
 
 #include "OpenColorIO/OpenColorIO.h"
 
+#include "IECore/LRUCache.h"
+
 #include "Gaffer/StringPlug.h"
 
 #include "GafferImage/OpenColorIO.h"
@@ -71,6 +75,201 @@ typedef tbb::null_mutex OCIOMutex;
 
 static OCIOMutex g_ocioMutex;
 
+//////////////////////////////////////////////////////////////////////////
+// Processor cache
+//////////////////////////////////////////////////////////////////////////
+
+// Creating a processor is expensive, and used to be done for every tile.
+// Instead we cache them, keyed by the cache id of the config and the
+// names of the colour spaces, separated by newlines. Processors are
+// immutable once created, so can be applied concurrently without locking.
+
+string processorCacheKey( ::OpenColorIO::ConstConfigRcPtr config, const string &inputSpace, const string &outputSpace )
+{
+	return string( config->getCacheID() ) + "\n" + inputSpace + "\n" + outputSpace;
+}
+
+void colorSpacesFromCacheKey( const string &key, string &inputSpace, string &outputSpace )
+{
+	const size_t first = key.find( '\n' );
+	const size_t second = key.find( '\n', first + 1 );
+	inputSpace = key.substr( first + 1, second - first - 1 );
+	outputSpace = key.substr( second + 1 );
+}
+
+::OpenColorIO::ConstProcessorRcPtr processorGetter( const string &key, size_t &cost )
+{
+	string inputSpace, outputSpace;
+	colorSpacesFromCacheKey( key, inputSpace, outputSpace );
+
+	cost = 1;
+	OCIOMutex::scoped_lock lock( g_ocioMutex );
+	::OpenColorIO::ConstConfigRcPtr config = ::OpenColorIO::GetCurrentConfig();
+	return config->getProcessor( inputSpace.c_str(), outputSpace.c_str() );
+}
+
+typedef LRUCache<string, ::OpenColorIO::ConstProcessorRcPtr> ProcessorCache;
+
+ProcessorCache *processorCache()
+{
+	static ProcessorCache *c = new ProcessorCache( processorGetter, 200 );
+	return c;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Baked LUTs
+//////////////////////////////////////////////////////////////////////////
+
+// An approximation of a processor, baked into a 3D LUT. The input is first
+// remapped by a shaper function derived from the allocation of the input
+// colour space, in the same way as for the GPU path in OpenColorIO, so that
+// high dynamic range inputs are sampled sensibly.
+class BakedLUT : public IECore::RefCounted
+{
+
+	public :
+
+		BakedLUT( ::OpenColorIO::ConstProcessorRcPtr processor, ::OpenColorIO::ConstColorSpaceRcPtr inputSpace )
+			:	m_logShaper( false ), m_min( 0.0f ), m_max( 1.0f ), m_offset( 0.0f )
+		{
+			if( inputSpace )
+			{
+				float vars[3] = { 0.0f, 1.0f, 0.0f };
+				int numVars = inputSpace->getAllocationNumVars();
+				if( numVars <= 3 )
+				{
+					inputSpace->getAllocationVars( vars );
+				}
+				else
+				{
+					numVars = 0;
+				}
+				m_logShaper = inputSpace->getAllocation() == ::OpenColorIO::ALLOCATION_LG2;
+				if( m_logShaper && numVars < 2 )
+				{
+					vars[0] = -15.0f;
+					vars[1] = 6.0f;
+				}
+				m_min = vars[0];
+				m_max = vars[1] > vars[0] ? vars[1] : vars[0] + 1.0f;
+				m_offset = numVars > 2 ? vars[2] : 0.0f;
+			}
+
+			// Evaluate the processor at every point of the lattice.
+			m_data.resize( g_size * g_size * g_size * 3 );
+			vector<float>::iterator it = m_data.begin();
+			for( int b = 0; b < g_size; ++b )
+			{
+				for( int g = 0; g < g_size; ++g )
+				{
+					for( int r = 0; r < g_size; ++r )
+					{
+						*it++ = inverseShaper( r / float( g_size - 1 ) );
+						*it++ = inverseShaper( g / float( g_size - 1 ) );
+						*it++ = inverseShaper( b / float( g_size - 1 ) );
+					}
+				}
+			}
+
+			::OpenColorIO::PackedImageDesc image( &m_data.front(), g_size * g_size * g_size, 1, 3 );
+			processor->apply( image );
+		}
+
+		void apply( float *r, float *g, float *b, size_t size ) const
+		{
+			const float *data = &m_data.front();
+			const int stride[3] = { 3, 3 * g_size, 3 * g_size * g_size };
+			for( size_t i = 0; i < size; ++i )
+			{
+				int index[3];
+				float fraction[3];
+				const float rgb[3] = { r[i], g[i], b[i] };
+				for( int c = 0; c < 3; ++c )
+				{
+					const float t = shaper( rgb[c] ) * ( g_size - 1 );
+					index[c] = std::min( int( t ), g_size - 2 );
+					fraction[c] = t - index[c];
+				}
+
+				// Trilinear interpolation of the eight surrounding lattice points.
+				const float *p = data + index[0] * stride[0] + index[1] * stride[1] + index[2] * stride[2];
+				float result[3];
+				for( int c = 0; c < 3; ++c )
+				{
+					const float c00 = lerp( p[c], p[stride[0]+c], fraction[0] );
+					const float c10 = lerp( p[stride[1]+c], p[stride[1]+stride[0]+c], fraction[0] );
+					const float c01 = lerp( p[stride[2]+c], p[stride[2]+stride[0]+c], fraction[0] );
+					const float c11 = lerp( p[stride[2]+stride[1]+c], p[stride[2]+stride[1]+stride[0]+c], fraction[0] );
+					result[c] = lerp( lerp( c00, c10, fraction[1] ), lerp( c01, c11, fraction[1] ), fraction[2] );
+				}
+
+				r[i] = result[0];
+				g[i] = result[1];
+				b[i] = result[2];
+			}
+		}
+
+	private :
+
+		static inline float lerp( float a, float b, float t )
+		{
+			return a + ( b - a ) * t;
+		}
+
+		// Maps from the input colour space to the 0-1 range of the lattice.
+		inline float shaper( float v ) const
+		{
+			if( m_logShaper )
+			{
+				v = log2f( std::max( v + m_offset, 1e-10f ) );
+			}
+			const float t = ( v - m_min ) / ( m_max - m_min );
+			// Written so that NaNs map to 0.
+			return t > 0.0f ? std::min( t, 1.0f ) : 0.0f;
+		}
+
+		inline float inverseShaper( float t ) const
+		{
+			const float v = m_min + t * ( m_max - m_min );
+			return m_logShaper ? exp2f( v ) - m_offset : v;
+		}
+
+		static const int g_size = 32;
+
+		bool m_logShaper;
+		float m_min;
+		float m_max;
+		float m_offset;
+		vector<float> m_data;
+
+};
+
+IE_CORE_DECLAREPTR( BakedLUT )
+
+ConstBakedLUTPtr bakedLUTGetter( const string &key, size_t &cost )
+{
+	string inputSpace, outputSpace;
+	colorSpacesFromCacheKey( key, inputSpace, outputSpace );
+
+	::OpenColorIO::ConstProcessorRcPtr processor = processorCache()->get( key );
+	::OpenColorIO::ConstColorSpaceRcPtr colorSpace;
+	{
+		OCIOMutex::scoped_lock lock( g_ocioMutex );
+		colorSpace = ::OpenColorIO::GetCurrentConfig()->getColorSpace( inputSpace.c_str() );
+	}
+
+	cost = 1;
+	return new BakedLUT( processor, colorSpace );
+}
+
+typedef LRUCache<string, ConstBakedLUTPtr> BakedLUTCache;
+
+BakedLUTCache *bakedLUTCache()
+{
+	static BakedLUTCache *c = new BakedLUTCache( bakedLUTGetter, 50 );
+	return c;
+}
+
 } // namespace Detail
 
 IE_CORE_DEFINERUNTIMETYPED( OpenColorIO );
@@ -83,6 +282,7 @@ OpenColorIO::OpenColorIO( const std::string &name )
 	storeIndexOfNextChild( g_firstPlugIndex );
 	addChild( new StringPlug( "inputSpace" ) );
 	addChild( new StringPlug( "outputSpace" ) );
+	addChild( new BoolPlug( "bakedLUT" ) );
 }
 
 OpenColorIO::~OpenColorIO()
@@ -109,6 +309,16 @@ const Gaffer::StringPlug *OpenColorIO::outputSpacePlug() const
 	return getChild<StringPlug>( g_firstPlugIndex + 1 );
 }
 
+Gaffer::BoolPlug *OpenColorIO::bakedLUTPlug()
+{
+	return getChild<BoolPlug>( g_firstPlugIndex + 2 );
+}
+
+const Gaffer::BoolPlug *OpenColorIO::bakedLUTPlug() const
+{
+	return getChild<BoolPlug>( g_firstPlugIndex + 2 );
+}
+
 bool OpenColorIO::enabled() const
 {
 	if( !ColorProcessor::enabled() )
@@ -130,7 +340,7 @@ bool OpenColorIO::affectsColorData( const Gaffer::Plug *input ) const
 	{
 		return true;
 	}
-	return input == inputSpacePlug() || input == outputSpacePlug();
+	return input == inputSpacePlug() || input == outputSpacePlug() || input == bakedLUTPlug();
 }
 
 void OpenColorIO::hashColorData( const Gaffer::Context *context, IECore::MurmurHash &h ) const
@@ -139,6 +349,7 @@ void OpenColorIO::hashColorData( const Gaffer::Context *context, IECore::MurmurH
 
 	inputSpacePlug()->hash( h );
 	outputSpacePlug()->hash( h );
+	bakedLUTPlug()->hash( h );
 }
 
 void OpenColorIO::processColorData( const Gaffer::Context *context, IECore::FloatVectorData *r, IECore::FloatVectorData *g, IECore::FloatVectorData *b ) const
@@ -146,13 +357,19 @@ void OpenColorIO::processColorData( const Gaffer::Context *context, IECore::Floa
 	string inputSpace( inputSpacePlug()->getValue() );
 	string outputSpace( outputSpacePlug()->getValue() );
 
-	::OpenColorIO::ConstProcessorRcPtr processor;
+	// Querying the config is threadsafe, so we only need to take
+	// g_ocioMutex when the caches create a processor.
+	const string key = Detail::processorCacheKey( ::OpenColorIO::GetCurrentConfig(), inputSpace, outputSpace );
+
+	if( bakedLUTPlug()->getValue() )
 	{
-		Detail::OCIOMutex::scoped_lock lock( Detail::g_ocioMutex );
-		::OpenColorIO::ConstConfigRcPtr config = ::OpenColorIO::GetCurrentConfig();
-		processor = config->getProcessor( inputSpace.c_str(), outputSpace.c_str() );
+		Detail::ConstBakedLUTPtr lut = Detail::bakedLUTCache()->get( key );
+		lut->apply( r->baseWritable(), g->baseWritable(), b->baseWritable(), r->readable().size() );
+		return;
 	}
 
+	::OpenColorIO::ConstProcessorRcPtr processor = Detail::processorCache()->get( key );
+
 	::OpenColorIO::PlanarImageDesc image(
 		r->baseWritable(),
 		g->baseWritable(),
@@ -35,9 +35,12 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include "Gaffer/Context.h"
+
 #include "GafferImage/Reformat.h"
 #include "GafferImage/Sampler.h"
 
+using namespace std;
 using namespace Gaffer;
 using namespace IECore;
 using namespace GafferImage;
@@ -52,7 +55,8 @@ Reformat::Reformat( const std::string &name )
 	storeIndexOfNextChild( g_firstPlugIndex );
 	addChild( new FormatPlug( "format" ) );
 	addChild( new FilterPlug( "filter" ) );
-	
+	addChild( new FloatVectorDataPlug( "__horizontalPass", Gaffer::Plug::Out, new FloatVectorData ) );
+
 	// We don't ever want to change these, so we make pass-through connections.
 	outPlug()->metadataPlug()->setInput( inPlug()->metadataPlug() );
 	outPlug()->channelNamesPlug()->setInput( inPlug()->channelNamesPlug() );
@@ -82,6 +86,16 @@ const GafferImage::FilterPlug *Reformat::filterPlug() const
 	return getChild<GafferImage::FilterPlug>( g_firstPlugIndex+1 );
 }
 
+Gaffer::FloatVectorDataPlug *Reformat::horizontalPassPlug()
+{
+	return getChild<FloatVectorDataPlug>( g_firstPlugIndex+2 );
+}
+
+const Gaffer::FloatVectorDataPlug *Reformat::horizontalPassPlug() const
+{
+	return getChild<FloatVectorDataPlug>( g_firstPlugIndex+2 );
+}
+
 void Reformat::affects( const Gaffer::Plug *input, AffectedPlugsContainer &outputs ) const
 {
 	ImageProcessor::affects( input, outputs );
@@ -91,12 +105,23 @@ void Reformat::affects( const Gaffer::Plug *input, AffectedPlugsContainer &outpu
 		outputs.push_back( outPlug()->formatPlug() );
 		outputs.push_back( outPlug()->dataWindowPlug() );
 		outputs.push_back( outPlug()->channelDataPlug() );
+		outputs.push_back( horizontalPassPlug() );
 	}
 	else if ( input == filterPlug() )
 	{
 		outputs.push_back( outPlug()->channelDataPlug() );
+		outputs.push_back( horizontalPassPlug() );
+	}
+	else if (
+		input == inPlug()->channelDataPlug() ||
+		input == inPlug()->dataWindowPlug() ||
+		input == inPlug()->formatPlug()
+	)
+	{
+		outputs.push_back( outPlug()->channelDataPlug() );
+		outputs.push_back( horizontalPassPlug() );
 	}
-	else if ( input == inPlug()->channelDataPlug() )
+	else if ( input == horizontalPassPlug() )
 	{
 		outputs.push_back( outPlug()->channelDataPlug() );
 	}
@@ -174,20 +199,217 @@ Imath::V2d Reformat::scale() const
 	return scale;
 }
 
-struct Contribution
+//////////////////////////////////////////////////////////////////////////
+// Resampling utilities
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+/// The input pixels and normalised weights which contribute to a run of
+/// consecutive output pixels along a single axis. These are the same for
+/// every tile in a row (or column) of tiles, and are computed once per
+/// tile and shared by every scanline within it.
+struct Contributions
 {
-	int pixel;
-	float weight;
+
+	Contributions( const Filter *filter, double scale, double inOffset, double outOffset, int outMin, int size )
+		:	width( filter->width() ), taps( size ), weights( size * filter->width() )
+	{
+		for( int i = 0; i < size; ++i )
+		{
+			// Filter::tap() truncates towards zero, so requires a positive
+			// center. We offset into positive space and back again so that
+			// the first tap is rounded down regardless of sign.
+			const float center = ( outMin + i + 0.5 - outOffset ) / scale + inOffset;
+			const int offset = fastFloatFloor( center ) - width;
+			taps[i] = filter->tap( center - offset ) + offset;
+
+			float *w = &weights[i*width];
+			const float sum = filter->weights( center, taps[i], w );
+			const float normalise = sum != 0.f ? 1.f / sum : 0.f;
+			for( int j = 0; j < width; ++j )
+			{
+				w[j] *= normalise;
+			}
+		}
+
+		minTap = taps.front();
+		maxTap = taps.back() + width - 1;
+	}
+
+	const int width;
+	vector<int> taps;
+	vector<float> weights;
+	// The range of input pixels covered by all the taps.
+	int minTap;
+	int maxTap;
+
 };
 
+inline int clamp( int v, int min, int max )
+{
+	return std::max( min, std::min( v, max ) );
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// Hashing and computation
+//////////////////////////////////////////////////////////////////////////
+
+// The image is resampled with two separable passes. The horizontal pass
+// is computed by the internal __horizontalPass plug, which holds tiles
+// which are already resampled horizontally but not vertically : they have
+// the x coordinates of the output image and the y coordinates of the input
+// image. Because these tiles are cached, each horizontal filtering operation
+// is performed only once, and then shared by all the output tiles whose
+// vertical kernels overlap it. This means that the cost per output pixel is
+// proportional to the sum of the filter widths rather than their product.
+
+void Reformat::hash( const Gaffer::ValuePlug *output, const Gaffer::Context *context, IECore::MurmurHash &h ) const
+{
+	ImageProcessor::hash( output, context, h );
+
+	if( output == horizontalPassPlug() )
+	{
+		hashHorizontalPass( context, h );
+	}
+}
+
+void Reformat::compute( Gaffer::ValuePlug *output, const Gaffer::Context *context ) const
+{
+	if( output == horizontalPassPlug() )
+	{
+		static_cast<FloatVectorDataPlug *>( output )->setValue( computeHorizontalPass( context ) );
+		return;
+	}
+
+	ImageProcessor::compute( output, context );
+}
+
+void Reformat::hashHorizontalPass( const Gaffer::Context *context, IECore::MurmurHash &h ) const
+{
+	const string &channelName = context->get<string>( ImagePlug::channelNameContextName );
+	const Imath::V2i tileOrigin = context->get<Imath::V2i>( ImagePlug::tileOriginContextName );
+	const Imath::Box2i inDataWindow = inPlug()->dataWindowPlug()->getValue();
+
+	h.append( ImagePlug::tileSize() );
+	h.append( tileOrigin );
+	h.append( inDataWindow );
+	filterPlug()->hash( h );
+
+	const Format format = formatPlug()->getValue();
+	h.append( format.getDisplayWindow() );
+	const Format inFormat = inPlug()->formatPlug()->getValue();
+	h.append( inFormat.getDisplayWindow() );
+
+	if( inDataWindow.isEmpty() )
+	{
+		return;
+	}
+
+	// Hash all the input tiles which contribute to this one.
+	const Imath::V2d scaleFactor( scale() );
+	ConstFilterPtr f = Filter::create( filterPlug()->getValue(), 1.f / scaleFactor.x );
+	const Contributions contributions( f.get(), scaleFactor.x, inFormat.getDisplayWindow().min.x, format.getDisplayWindow().min.x, tileOrigin.x, ImagePlug::tileSize() );
+
+	const int minX = ImagePlug::tileOrigin( Imath::V2i( clamp( contributions.minTap, inDataWindow.min.x, inDataWindow.max.x ), 0 ) ).x;
+	const int maxX = clamp( contributions.maxTap, inDataWindow.min.x, inDataWindow.max.x );
+	for( int x = minX; x <= maxX; x += ImagePlug::tileSize() )
+	{
+		h.append( inPlug()->channelDataHash( channelName, Imath::V2i( x, tileOrigin.y ) ) );
+	}
+}
+
+IECore::ConstFloatVectorDataPtr Reformat::computeHorizontalPass( const Gaffer::Context *context ) const
+{
+	const string &channelName = context->get<string>( ImagePlug::channelNameContextName );
+	const Imath::V2i tileOrigin = context->get<Imath::V2i>( ImagePlug::tileOriginContextName );
+	const Imath::Box2i inDataWindow = inPlug()->dataWindowPlug()->getValue();
+	const int tileSize = ImagePlug::tileSize();
+
+	FloatVectorDataPtr resultData = new FloatVectorData;
+	vector<float> &result = resultData->writable();
+	result.resize( tileSize * tileSize, 0.0f );
+
+	const int minY = std::max( tileOrigin.y, inDataWindow.min.y );
+	const int maxY = std::min( tileOrigin.y + tileSize - 1, inDataWindow.max.y );
+	if( minY > maxY || inDataWindow.isEmpty() )
+	{
+		return resultData;
+	}
+
+	const Imath::V2d scaleFactor( scale() );
+	ConstFilterPtr f = Filter::create( filterPlug()->getValue(), 1.f / scaleFactor.x );
+	const Contributions contributions(
+		f.get(), scaleFactor.x,
+		inPlug()->formatPlug()->getValue().getDisplayWindow().min.x,
+		formatPlug()->getValue().getDisplayWindow().min.x,
+		tileOrigin.x, tileSize
+	);
+
+	// Fetch all the input tiles we need.
+	const int clampedMinX = clamp( contributions.minTap, inDataWindow.min.x, inDataWindow.max.x );
+	const int clampedMaxX = clamp( contributions.maxTap, inDataWindow.min.x, inDataWindow.max.x );
+	const int firstTileX = ImagePlug::tileOrigin( Imath::V2i( clampedMinX, 0 ) ).x;
+	vector<ConstFloatVectorDataPtr> tiles;
+	for( int x = firstTileX; x <= clampedMaxX; x += tileSize )
+	{
+		tiles.push_back( inPlug()->channelData( channelName, Imath::V2i( x, tileOrigin.y ) ) );
+	}
+
+	// For each scanline, gather the input pixels into a contiguous buffer,
+	// clamping at the edges of the data window, and then filter the buffer.
+	vector<float> span( clampedMaxX - clampedMinX + 1 );
+	vector<float> row( contributions.maxTap - contributions.minTap + 1 );
+	for( int y = minY; y <= maxY; ++y )
+	{
+		const int tileRowOffset = ( y - tileOrigin.y ) * tileSize;
+
+		int x = clampedMinX;
+		vector<float>::iterator spanIt = span.begin();
+		while( x <= clampedMaxX )
+		{
+			const int tileIndex = ( x - firstTileX ) / tileSize;
+			const int tileX = firstTileX + tileIndex * tileSize;
+			const int runEnd = std::min( clampedMaxX, tileX + tileSize - 1 );
+			const float *tileRow = &tiles[tileIndex]->readable()[tileRowOffset];
+			spanIt = std::copy( tileRow + x - tileX, tileRow + runEnd - tileX + 1, spanIt );
+			x = runEnd + 1;
+		}
+
+		for( int i = 0, e = row.size(); i < e; ++i )
+		{
+			row[i] = span[clamp( contributions.minTap + i, clampedMinX, clampedMaxX ) - clampedMinX];
+		}
+
+		float *out = &result[tileRowOffset];
+		for( int i = 0; i < tileSize; ++i )
+		{
+			out[i] = GafferImage::Detail::dot( &row[contributions.taps[i] - contributions.minTap], &contributions.weights[i*contributions.width], contributions.width );
+		}
+	}
+
+	return resultData;
+}
+
+IECore::ConstFloatVectorDataPtr Reformat::horizontalPass( const Imath::V2i &tileOrigin ) const
+{
+	ContextPtr tmpContext = new Context( *Context::current(), Context::Borrowed );
+	tmpContext->set( ImagePlug::tileOriginContextName, tileOrigin );
+	Context::Scope scopedContext( tmpContext.get() );
+	return horizontalPassPlug()->getValue();
+}
+
 void Reformat::hashChannelData( const GafferImage::ImagePlug *parent, const Gaffer::Context *context, IECore::MurmurHash &h ) const
 {
 	ImageProcessor::hashChannelData( parent, context, h );
 
-	inPlug()->channelDataPlug()->hash( h );
 	filterPlug()->hash( h );
 
-	h.append( inPlug()->dataWindowPlug()->getValue() );
+	const Imath::Box2i inDataWindow = inPlug()->dataWindowPlug()->getValue();
+	h.append( inDataWindow );
 
 	Format format = formatPlug()->getValue();
 	h.append( format.getDisplayWindow() );
@@ -196,23 +418,46 @@ void Reformat::hashChannelData( const GafferImage::ImagePlug *parent, const Gaff
 	Format inFormat = inPlug()->formatPlug()->getValue();
 	h.append( inFormat.getDisplayWindow() );
 	h.append( inFormat.getPixelAspect() );
-}
 
-IECore::ConstFloatVectorDataPtr Reformat::computeChannelData( const std::string &channelName, const Imath::V2i &tileOrigin, const Gaffer::Context *context, const ImagePlug *parent ) const
-{
-	// Allocate the new tile
-	FloatVectorDataPtr outDataPtr = new FloatVectorData;
-	std::vector<float> &out = outDataPtr->writable();
-	out.resize( ImagePlug::tileSize() * ImagePlug::tileSize() );
+	if( inDataWindow.isEmpty() )
+	{
+		return;
+	}
 
-	// Create some useful variables...
-	Imath::V2f scaleFactor( scale() );
-	Imath::V2d inFormatOffset( inPlug()->formatPlug()->getValue().getDisplayWindow().min );
-	Imath::V2d outFormatOffset( formatPlug()->getValue().getDisplayWindow().min );
+	const Imath::V2i tileOrigin = context->get<Imath::V2i>( ImagePlug::tileOriginContextName );
+	const Imath::V2d scaleFactor( scale() );
+	ConstFilterPtr f = Filter::create( filterPlug()->getValue(), 1.f / scaleFactor.y );
 
-	Imath::Box2i outTile( tileOrigin, Imath::V2i( tileOrigin.x + ImagePlug::tileSize() - 1, tileOrigin.y + ImagePlug::tileSize() - 1 ) );
+	if ( static_cast<GafferImage::TypeId>( f->typeId() ) == GafferImage::BoxFilterTypeId )
+	{
+		// The box filter samples the input directly, rather than via the horizontal pass.
+		const string &channelName = context->get<string>( ImagePlug::channelNameContextName );
+		Sampler sampler( inPlug(), channelName, boxFilterSampleBox( tileOrigin ), f, Sampler::Clamp );
+		sampler.hash( h );
+		return;
+	}
 
-	Imath::Box2f inTile(
+	const Contributions contributions( f.get(), scaleFactor.y, inFormat.getDisplayWindow().min.y, format.getDisplayWindow().min.y, tileOrigin.y, ImagePlug::tileSize() );
+	const int minY = ImagePlug::tileOrigin( Imath::V2i( 0, clamp( contributions.minTap, inDataWindow.min.y, inDataWindow.max.y ) ) ).y;
+	const int maxY = clamp( contributions.maxTap, inDataWindow.min.y, inDataWindow.max.y );
+
+	ContextPtr tmpContext = new Context( *context, Context::Borrowed );
+	Context::Scope scopedContext( tmpContext.get() );
+	for( int y = minY; y <= maxY; y += ImagePlug::tileSize() )
+	{
+		tmpContext->set( ImagePlug::tileOriginContextName, Imath::V2i( tileOrigin.x, y ) );
+		horizontalPassPlug()->hash( h );
+	}
+}
+
+Imath::Box2i Reformat::boxFilterSampleBox( const Imath::V2i &tileOrigin ) const
+{
+	const Imath::V2f scaleFactor( scale() );
+	const Imath::V2d inFormatOffset( inPlug()->formatPlug()->getValue().getDisplayWindow().min );
+	const Imath::V2d outFormatOffset( formatPlug()->getValue().getDisplayWindow().min );
+
+	const Imath::Box2i outTile( tileOrigin, Imath::V2i( tileOrigin.x + ImagePlug::tileSize() - 1, tileOrigin.y + ImagePlug::tileSize() - 1 ) );
+	const Imath::Box2f inTile(
 		Imath::V2f(
 			double( outTile.min.x - outFormatOffset.x ) / scaleFactor.x + inFormatOffset.x,
 			double( outTile.min.y - outFormatOffset.y ) / scaleFactor.y + inFormatOffset.y
@@ -223,6 +468,31 @@ IECore::ConstFloatVectorDataPtr Reformat::computeChannelData( const std::string
 		)
 	);
 
+	return Imath::Box2i(
+		Imath::V2i( IECore::fastFloatFloor( inTile.min.x ), IECore::fastFloatCeil( inTile.min.y ) ),
+		Imath::V2i( IECore::fastFloatFloor( inTile.max.x ), IECore::fastFloatCeil( inTile.max.y ) )
+	);
+}
+
+IECore::ConstFloatVectorDataPtr Reformat::computeChannelData( const std::string &channelName, const Imath::V2i &tileOrigin, const Gaffer::Context *context, const ImagePlug *parent ) const
+{
+	const int tileSize = ImagePlug::tileSize();
+	const Imath::Box2i inDataWindow = inPlug()->dataWindowPlug()->getValue();
+	if( inDataWindow.isEmpty() )
+	{
+		return ImagePlug::blackTile();
+	}
+
+	// Allocate the new tile
+	FloatVectorDataPtr outDataPtr = new FloatVectorData;
+	std::vector<float> &out = outDataPtr->writable();
+	out.resize( tileSize * tileSize, 0.0f );
+
+	// Create some useful variables...
+	const Imath::V2f scaleFactor( scale() );
+	const Imath::V2d inFormatOffset( inPlug()->formatPlug()->getValue().getDisplayWindow().min );
+	const Imath::V2d outFormatOffset( formatPlug()->getValue().getDisplayWindow().min );
+
 	// Create our filter.
 	FilterPtr f = Filter::create( filterPlug()->getValue(), 1.f / scaleFactor.y );
 
@@ -230,163 +500,51 @@ IECore::ConstFloatVectorDataPtr Reformat::computeChannelData( const std::string
 	// at all and just integer sample instead...
 	if ( static_cast<GafferImage::TypeId>( f->typeId() ) == GafferImage::BoxFilterTypeId )
 	{
-		Imath::Box2i sampleBox(
-			Imath::V2i( IECore::fastFloatFloor( inTile.min.x ), IECore::fastFloatCeil( inTile.min.y ) ),
-			Imath::V2i( IECore::fastFloatFloor( inTile.max.x ), IECore::fastFloatCeil( inTile.max.y ) )
-		);
-
-		Sampler sampler( inPlug(), channelName, sampleBox, f, Sampler::Clamp );
-		for ( int y = outTile.min.y, ty = 0; y <= outTile.max.y; ++y, ++ty )
+		Sampler sampler( inPlug(), channelName, boxFilterSampleBox( tileOrigin ), f, Sampler::Clamp );
+		for ( int y = tileOrigin.y, ty = 0; ty < tileSize; ++y, ++ty )
 		{
-			for ( int x = outTile.min.x, tx = 0; x <= outTile.max.x; ++x, ++tx )
+			for ( int x = tileOrigin.x, tx = 0; tx < tileSize; ++x, ++tx )
 			{
 				float value = sampler.sample( float( ( x + .5f - outFormatOffset.x ) / scaleFactor.x + inFormatOffset.x ), float( ( y + .5f - outFormatOffset.y ) / scaleFactor.y + inFormatOffset.y ) );
-				out[ tx + ImagePlug::tileSize() * ty ] = value;
+				out[ tx + tileSize * ty ] = value;
 			}
 		}
 		return outDataPtr;
 	}
 
-	// Get the dimensions of our filter and create a box that we can use to define the bounds of our input.
-	int fHeight = f->width();
+	// Vertical pass. Fetch the horizontally resampled tiles covering
+	// the input rows we need, and filter them to produce the output.
+	const Contributions contributions( f.get(), scaleFactor.y, inFormatOffset.y, outFormatOffset.y, tileOrigin.y, tileSize );
+	const int firstTileY = ImagePlug::tileOrigin( Imath::V2i( 0, clamp( contributions.minTap, inDataWindow.min.y, inDataWindow.max.y ) ) ).y;
+	const int maxY = clamp( contributions.maxTap, inDataWindow.min.y, inDataWindow.max.y );
 
-	int sampleMinY = f->tap( inTile.min.y );
-	int sampleMaxY = f->tap( inTile.max.y );
-
-	f->setScale( 1.f / scaleFactor.x );
-	int sampleMinX = f->tap( inTile.min.x );
-	int sampleMaxX = f->tap( inTile.max.x );
-
-	int fWidth = f->width();
-
-	Imath::Box2i sampleBox(
-		Imath::V2i( sampleMinX, sampleMinY ),
-		Imath::V2i( sampleMaxX + fWidth, sampleMaxY + fHeight )
-	);
-
-	int sampleBoxWidth = sampleBox.size().x + 1;
-	int sampleBoxHeight = sampleBox.size().y + 1;
-
-	// Create a temporary buffer that we can write the result of the first pass to.
-	// We extend the buffer vertically as we will need additional information in the
-	// vertical squash (the second pass) to properly convolve the filter.
-	float buffer[ ImagePlug::tileSize() * sampleBoxHeight ];
-
-	// Create several buffers for each pixel in the output row (or column depending on the pass)
-	// into which we can place the indices for the pixels that are contribute to it's result and
-	// their weight.
-
-	// A buffer that holds a list of pixel contributions and their weights for every pixel in the output buffer.
-	// As it gets reused for both passes we make it large enough to hold both so that we don't have to resize it later.
-	std::vector<Contribution> contribution( ImagePlug::tileSize() * ( sampleBoxHeight > sampleBoxWidth ? sampleBoxHeight : sampleBoxWidth ) );
-
-	// The total number of pixels that contribute towards each pixel in th resulting image.
-	std::vector<int> coverageTotal( ImagePlug::tileSize() );
-
-	// The total weighted sum of contribution that each pixel in the output gets.
-	// This value is used to normalize the result.
-	std::vector<float> weightedSum( ImagePlug::tileSize() );
-
-	// Horizontal Pass
-	// Here we build a row buffer of contributing pixels and their weights for every pixel in the row.
-	int contributionIdx = 0;
-	for ( int i = 0; i < ImagePlug::tileSize(); ++i, contributionIdx += fWidth )
-	{
-		float center = ( outTile.min.x + i + 0.5 - outFormatOffset.x ) / scaleFactor.x + inFormatOffset.x;
-		int tap = f->tap( center );
-
-		int n = 0;
-		weightedSum[i] = 0.;
-		for ( int j = tap; j < tap+fWidth; ++j )
-		{
-			float weight = f->weight( center, j );
-			if ( weight == 0 )
-			{
-				continue;
-			}
-
-			contribution[contributionIdx+n].pixel = j;
-			weightedSum[i] += contribution[contributionIdx+n].weight = weight;
-			n++;
-		}
-		coverageTotal[i] = n;
-	}
-
-	// Now that we know the contribution of each pixel from the others on the row, compute the
-	// horizontally scaled buffer which we will use as input in the vertical scale pass.
-	Sampler sampler( inPlug(), channelName, sampleBox, f, Sampler::Clamp );
-	for ( int k = 0; k < sampleBoxHeight; ++k )
+	vector<ConstFloatVectorDataPtr> tiles;
+	for( int y = firstTileY; y <= maxY; y += tileSize )
 	{
-		for ( int i = 0, contributionIdx = 0; i < ImagePlug::tileSize(); ++i, contributionIdx += fWidth )
-		{
-			float intensity = 0;
-
-			for ( int j = 0; j < coverageTotal[i]; ++j )
-			{
-				Contribution &contributor( contribution[ contributionIdx+j ] );
-
-				if ( contributor.weight == 0. )
-				{
-					continue;
-				}
-
-				float value = sampler.sample( contributor.pixel, k + sampleBox.min.y );
-				intensity += value * contributor.weight;
-			}
-
-			buffer[i + ImagePlug::tileSize() * k] = intensity / weightedSum[i];
-		}
+		tiles.push_back( horizontalPass( Imath::V2i( tileOrigin.x, y ) ) );
 	}
 
-	// Vertical Pass
-	// Build the column buffer of contributing pixels and their weights for each pixel in the column.
-	f->setScale( 1.f / scaleFactor.y );
-	for ( int i = 0, contributionIdx = 0; i < ImagePlug::tileSize(); ++i, contributionIdx += fHeight )
+	for( int i = 0; i < tileSize; ++i )
 	{
-		float center = ( outTile.min.y - outFormatOffset.y + i + 0.5 ) / scaleFactor.y - sampleBox.min.y + inFormatOffset.y;
-		int tap = f->tap( center );
-
-		int n = 0;
-		weightedSum[i] = 0.;
-		for ( int j = tap; j < tap+fHeight; ++j )
+		float *outRow = &out[i * tileSize];
+		const float *weights = &contributions.weights[i * contributions.width];
+		for( int j = 0; j < contributions.width; ++j )
 		{
-			float weight = f->weight( center, j );
-			if ( weight == 0 )
+			const float weight = weights[j];
+			if( weight == 0.0f )
 			{
 				continue;
 			}
 
-			contribution[contributionIdx+n].pixel = j;
-			weightedSum[i] += contribution[contributionIdx+n].weight = weight;
-			n++;
-		}
-		coverageTotal[i] = n;
-	}
-
-	// Use the column buffer of pixel contributions to scale the temporary buffer vertically.
-	// Write the result into the output buffer.
-	for ( int k = 0; k < ImagePlug::tileSize(); ++k )
-	{
-		for ( int i = 0, contributionIdx = 0; i < ImagePlug::tileSize(); ++i, contributionIdx += fHeight )
-		{
-			float intensity = 0;
-
-			for ( int j = 0; j < coverageTotal[i]; ++j )
+			const int y = clamp( contributions.taps[i] + j, inDataWindow.min.y, inDataWindow.max.y );
+			const int tileIndex = ( y - firstTileY ) / tileSize;
+			const float *inRow = &tiles[tileIndex]->readable()[( y - firstTileY - tileIndex * tileSize ) * tileSize];
+			for( int k = 0; k < tileSize; ++k )
 			{
-				Contribution &contributor( contribution[ contributionIdx+j ] );
-
-				if ( contributor.weight == 0. )
-				{
-					continue;
-				}
-
-				intensity += buffer[ k + ImagePlug::tileSize() * contributor.pixel ] * contributor.weight;
+				outRow[k] += weight * inRow[k];
 			}
-
-			out[k + ImagePlug::tileSize() * i] = intensity / weightedSum[i];
 		}
 	}
 
 	return outDataPtr;
 }
-
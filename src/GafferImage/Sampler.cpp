@@ -44,7 +44,8 @@ Sampler::Sampler( const GafferImage::ImagePlug *plug, const std::string &channel
 	: m_plug( plug ),
 	m_channelName( channelName ),
 	m_boundingMode( boundingMode ),
-	m_filter( Filter::create( Filter::defaultFilter() ) )
+	m_filter( Filter::create( Filter::defaultFilter() ) ),
+	m_isBoxFilter( static_cast<GafferImage::TypeId>( m_filter->typeId() ) == GafferImage::BoxFilterTypeId )
 {
 	setSampleWindow( window );
 }
@@ -53,7 +54,8 @@ Sampler::Sampler( const GafferImage::ImagePlug *plug, const std::string &channel
 	: m_plug( plug ),
 	m_channelName( channelName ),
 	m_boundingMode( boundingMode ),
-	m_filter( filter )
+	m_filter( filter ),
+	m_isBoxFilter( static_cast<GafferImage::TypeId>( m_filter->typeId() ) == GafferImage::BoxFilterTypeId )
 {
 	setSampleWindow( window );
 }
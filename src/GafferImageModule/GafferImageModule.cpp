@@ -36,6 +36,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "boost/python.hpp"
+#include "boost/python/suite/indexing/container_utils.hpp"
 
 #include "IECorePython/ScopedGILRelease.h"
 
@@ -82,6 +83,21 @@ static IECore::FloatVectorDataPtr channelData( const ImagePlug &plug,  const std
 	return d ? d->copy() : 0;
 }
 
+static IECore::ObjectVectorPtr multiChannelData( const ImagePlug &plug, object channelNames, const Imath::V2i &tile )
+{
+	std::vector<std::string> names;
+	boost::python::container_utils::extend_container( names, channelNames );
+	IECore::ConstObjectVectorPtr d = plug.multiChannelData( names, tile );
+	return d ? d->copy() : 0;
+}
+
+static IECore::MurmurHash multiChannelDataHash( const ImagePlug &plug, object channelNames, const Imath::V2i &tile )
+{
+	std::vector<std::string> names;
+	boost::python::container_utils::extend_container( names, channelNames );
+	return plug.multiChannelDataHash( names, tile );
+}
+
 static IECore::ImagePrimitivePtr image( const ImagePlug &plug )
 {
 	IECorePython::ScopedGILRelease gilRelease;
@@ -104,9 +120,12 @@ BOOST_PYTHON_MODULE( _GafferImage )
 		)
 		.def( "channelData", &channelData )
 		.def( "channelDataHash", &ImagePlug::channelDataHash )
+		.def( "multiChannelData", &multiChannelData )
+		.def( "multiChannelDataHash", &multiChannelDataHash )
 		.def( "image", &image )
 		.def( "imageHash", &ImagePlug::imageHash )
 		.def( "tileSize", &ImagePlug::tileSize ).staticmethod( "tileSize" )
+		.def( "setTileSize", &ImagePlug::setTileSize ).staticmethod( "setTileSize" )
 		.def( "tileBound", &ImagePlug::tileBound ).staticmethod( "tileBound" )
 		.def( "tileOrigin", &ImagePlug::tileOrigin ).staticmethod( "tileOrigin" )
 	;
@@ -41,14 +41,19 @@
 #include "boost/bind/placeholders.hpp"
 #include "boost/format.hpp"
 
+#include "tbb/task_group.h"
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include "tbb/mutex.h"
+#include "tbb/atomic.h"
+
 #include "OpenEXR/ImathColorAlgo.h"
 
 #include "IECore/FastFloat.h"
 #include "IECore/BoxOps.h"
 #include "IECore/BoxAlgo.h"
 
-#include "IECoreGL/ToGLTextureConverter.h"
-#include "IECoreGL/TextureLoader.h"
+#include "IECoreGL/GL.h"
 #include "IECoreGL/Texture.h"
 #include "IECoreGL/ShaderLoader.h"
 #include "IECoreGL/Shader.h"
@@ -86,6 +91,372 @@ namespace GafferImageUI
 namespace Detail
 {
 
+//////////////////////////////////////////////////////////////////////////
+// ImageTiles
+//////////////////////////////////////////////////////////////////////////
+
+/// Maintains a GL texture for each tile of an image, so that when the
+/// image changes, only the tiles which are visible and whose hashes
+/// have changed need to be recomputed and uploaded. Tiles are computed
+/// in the background so that the UI remains interactive - textures are
+/// uploaded and drawn on the UI thread in render().
+class ImageTiles : public IECore::RefCounted
+{
+
+	public :
+
+		/// Tiles are computed from plug, and a render is requested from
+		/// renderRequestGadget whenever new tiles become available. Both
+		/// must remain alive until cancel() has been called for the last
+		/// time.
+		ImageTiles( const ImagePlug *plug, Gadget *renderRequestGadget )
+			:	m_plug( plug ), m_renderRequestGadget( renderRequestGadget ), m_displayWindow( V2i( 0 ) ), m_dataWindow( V2i( 0 ) )
+		{
+			m_cancelled = false;
+		}
+
+		virtual ~ImageTiles()
+		{
+			cancel();
+		}
+
+		/// Stops any background computation, waiting for tiles which are
+		/// currently being computed to complete. Tiles which were left
+		/// uncomputed remain stale, and will be scheduled again by the
+		/// next render. Must be called on the UI thread.
+		void cancel()
+		{
+			m_cancelled = true;
+			m_taskGroup.wait();
+			m_cancelled = false;
+
+			tbb::mutex::scoped_lock lock( m_mutex );
+			for( TileMap::iterator it = m_tiles.begin(), eIt = m_tiles.end(); it != eIt; ++it )
+			{
+				it->second.computing = false;
+			}
+		}
+
+		/// Updates the image windows and channels from the plug, using the specified
+		/// context. Tiles are not recomputed immediately - instead they are flagged
+		/// to have their hashes checked the next time they are rendered. Until then
+		/// the previous textures continue to be drawn. Must be called on the UI thread.
+		void update( const Context *context )
+		{
+			cancel();
+
+			ContextPtr tileContext = new Context( *context );
+			Context::Scope scopedContext( tileContext.get() );
+
+			const Format format = m_plug->formatPlug()->getValue();
+			const Box2i dataWindow = m_plug->dataWindowPlug()->getValue();
+			ConstStringVectorDataPtr channelNamesData = m_plug->channelNamesPlug()->getValue();
+
+			std::vector<std::string> channelNames;
+			for( size_t i = 0; i < 4; ++i )
+			{
+				const std::string &channelName = rgbaChannelNames()[i];
+				if( std::find( channelNamesData->readable().begin(), channelNamesData->readable().end(), channelName ) != channelNamesData->readable().end() )
+				{
+					channelNames.push_back( channelName );
+				}
+			}
+
+			tbb::mutex::scoped_lock lock( m_mutex );
+			if( format.getDisplayWindow() != m_displayWindow || channelNames != m_channelNames )
+			{
+				// Either the format or the channels have changed,
+				// so none of our tiles are of any further use.
+				m_tiles.clear();
+			}
+			else
+			{
+				for( TileMap::iterator it = m_tiles.begin(), eIt = m_tiles.end(); it != eIt; ++it )
+				{
+					it->second.stale = true;
+				}
+			}
+
+			tileContext->set( ImagePlug::channelNamesContextName, channelNames );
+
+			m_context = tileContext;
+			m_displayWindow = format.getDisplayWindow();
+			m_dataWindow = dataWindow;
+			m_channelNames = channelNames;
+		}
+
+		/// The display window of the image, in the pixel space of the tiles.
+		const Box2i &displayWindow() const
+		{
+			return m_displayWindow;
+		}
+
+		bool hasAlpha() const
+		{
+			return std::find( m_channelNames.begin(), m_channelNames.end(), "A" ) != m_channelNames.end();
+		}
+
+		/// Draws all tiles intersecting region, which is specified in the
+		/// pixel space of the tiles. Tiles which are not yet up to date are
+		/// scheduled for computation in the background. Must be called on the
+		/// UI thread, with a shader suitable for drawing texture unit 0 already
+		/// bound.
+		void render( const Box2i &region )
+		{
+			const Box2i bound = boxIntersection( region, m_dataWindow );
+			if( bound.isEmpty() || m_channelNames.empty() )
+			{
+				return;
+			}
+
+			// Find the tiles we need while holding the lock, taking any data
+			// computed since the last render. The textures are only accessed
+			// on the UI thread, so we can upload and draw them without the
+			// lock, leaving the background tasks free to continue.
+			std::vector<V2i> tilesToCompute;
+			std::vector<std::pair<Tile *, V2i> > tilesToDraw;
+			std::vector<ConstObjectVectorPtr> tilesToUpload;
+			{
+				tbb::mutex::scoped_lock lock( m_mutex );
+
+				const int tileSize = ImagePlug::tileSize();
+				const V2i minTileOrigin = ImagePlug::tileOrigin( bound.min );
+				const V2i maxTileOrigin = ImagePlug::tileOrigin( bound.max );
+				for( int y = minTileOrigin.y; y <= maxTileOrigin.y; y += tileSize )
+				{
+					for( int x = minTileOrigin.x; x <= maxTileOrigin.x; x += tileSize )
+					{
+						const V2i tileOrigin( x, y );
+						Tile &tile = m_tiles[tileOrigin];
+						tilesToDraw.push_back( std::make_pair( &tile, tileOrigin ) );
+						tilesToUpload.push_back( tile.pendingData );
+						tile.pendingData = NULL;
+
+						if( tile.stale && !tile.computing )
+						{
+							tile.computing = true;
+							tilesToCompute.push_back( tileOrigin );
+						}
+					}
+				}
+			}
+
+			// Tiles are only removed from the map by update(), on the UI
+			// thread, so the pointers remain valid after we release the lock.
+			const int tileSize = ImagePlug::tileSize();
+			for( size_t i = 0, e = tilesToDraw.size(); i < e; ++i )
+			{
+				Tile &tile = *tilesToDraw[i].first;
+				const V2i &tileOrigin = tilesToDraw[i].second;
+				if( tilesToUpload[i] )
+				{
+					tile.texture = texture( tilesToUpload[i].get() );
+				}
+
+				if( !tile.texture )
+				{
+					continue;
+				}
+
+				const Box2i tileBound( tileOrigin, tileOrigin + V2i( tileSize - 1 ) );
+				const Box2i b = boxIntersection( tileBound, m_dataWindow );
+				const V2f texMin = V2f( b.min - tileOrigin ) / tileSize;
+				const V2f texMax = V2f( b.max + V2i( 1 ) - tileOrigin ) / tileSize;
+
+				tile.texture->bind();
+				glBegin( GL_QUADS );
+
+					glTexCoord2f( texMax.x, texMin.y );
+					glVertex2f( b.max.x + 1, b.min.y );
+					glTexCoord2f( texMax.x, texMax.y );
+					glVertex2f( b.max.x + 1, b.max.y + 1 );
+					glTexCoord2f( texMin.x, texMax.y );
+					glVertex2f( b.min.x, b.max.y + 1 );
+					glTexCoord2f( texMin.x, texMin.y );
+					glVertex2f( b.min.x, b.min.y );
+
+				glEnd();
+			}
+
+			if( tilesToCompute.size() )
+			{
+				m_taskGroup.run( ComputeTiles( this, tilesToCompute ) );
+			}
+		}
+
+	private :
+
+		static const std::vector<std::string> &rgbaChannelNames()
+		{
+			static std::vector<std::string> g_names;
+			if( g_names.empty() )
+			{
+				g_names.push_back( "R" );
+				g_names.push_back( "G" );
+				g_names.push_back( "B" );
+				g_names.push_back( "A" );
+			}
+			return g_names;
+		}
+
+		struct Tile
+		{
+			Tile() : stale( true ), computing( false ) {}
+			// The hash of the data last computed for the tile.
+			IECore::MurmurHash hash;
+			// True if the hash needs to be checked against the plug.
+			bool stale;
+			bool computing;
+			// Data which has been computed but not yet uploaded.
+			IECore::ConstObjectVectorPtr pendingData;
+			IECoreGL::TexturePtr texture;
+		};
+
+		// Computes the specified tiles in parallel, and then requests
+		// a render so that they may be uploaded.
+		class ComputeTiles
+		{
+
+			public :
+
+				ComputeTiles( ImageTiles *imageTiles, const std::vector<V2i> &tileOrigins )
+					:	m_imageTiles( imageTiles ), m_tileOrigins( tileOrigins )
+				{
+				}
+
+				void operator()() const
+				{
+					tbb::parallel_for( tbb::blocked_range<size_t>( 0, m_tileOrigins.size() ), *this );
+					Gadget::executeOnUIThread( boost::bind( &requestRender, GadgetPtr( m_imageTiles->m_renderRequestGadget ) ) );
+				}
+
+				void operator()( const tbb::blocked_range<size_t> &r ) const
+				{
+					for( size_t i = r.begin(); i != r.end(); ++i )
+					{
+						if( m_imageTiles->m_cancelled )
+						{
+							return;
+						}
+						m_imageTiles->computeTile( m_tileOrigins[i] );
+					}
+				}
+
+			private :
+
+				static void requestRender( GadgetPtr gadget )
+				{
+					gadget->renderRequestSignal()( gadget.get() );
+				}
+
+				ImageTiles *m_imageTiles;
+				std::vector<V2i> m_tileOrigins;
+
+		};
+
+		void computeTile( const V2i &tileOrigin )
+		{
+			ContextPtr context = new Context( *m_context, Context::Borrowed );
+			context->set( ImagePlug::tileOriginContextName, tileOrigin );
+			Context::Scope scopedContext( context.get() );
+
+			IECore::MurmurHash hash;
+			ConstObjectVectorPtr data;
+			try
+			{
+				hash = m_plug->multiChannelDataPlug()->hash();
+				bool changed;
+				{
+					tbb::mutex::scoped_lock lock( m_mutex );
+					changed = hash != m_tiles[tileOrigin].hash;
+				}
+				if( changed )
+				{
+					data = m_plug->multiChannelDataPlug()->getValue();
+				}
+			}
+			catch( ... )
+			{
+				// Errors are reported via the nodes themselves, so
+				// we just leave the tile as it was.
+			}
+
+			tbb::mutex::scoped_lock lock( m_mutex );
+			Tile &tile = m_tiles[tileOrigin];
+			tile.stale = false;
+			tile.computing = false;
+			if( data )
+			{
+				tile.hash = hash;
+				tile.pendingData = data;
+			}
+		}
+
+		IECoreGL::TexturePtr texture( const ObjectVector *data ) const
+		{
+			const int tileSize = ImagePlug::tileSize();
+			const size_t numPixels = tileSize * tileSize;
+
+			// Interleave the channels. The rows of the tile are ordered
+			// from the bottom up, which is just what GL expects.
+			std::vector<float> rgba( numPixels * 4, 0.0f );
+			if( !hasAlpha() )
+			{
+				for( size_t i = 0; i < numPixels; ++i )
+				{
+					rgba[i*4+3] = 1.0f;
+				}
+			}
+
+			for( size_t c = 0; c < m_channelNames.size(); ++c )
+			{
+				const size_t offset = std::find( rgbaChannelNames().begin(), rgbaChannelNames().end(), m_channelNames[c] ) - rgbaChannelNames().begin();
+				const std::vector<float> &channel = static_cast<const FloatVectorData *>( data->members()[c].get() )->readable();
+				for( size_t i = 0; i < numPixels; ++i )
+				{
+					rgba[i*4+offset] = channel[i];
+				}
+			}
+
+			GLuint texture;
+			glGenTextures( 1, &texture );
+			glBindTexture( GL_TEXTURE_2D, texture );
+			glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA16F_ARB, tileSize, tileSize, 0, GL_RGBA, GL_FLOAT, &rgba.front() );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+
+			return new IECoreGL::Texture( texture );
+		}
+
+		const ImagePlug *m_plug;
+		Gadget *m_renderRequestGadget;
+
+		ContextPtr m_context;
+		Box2i m_displayWindow;
+		Box2i m_dataWindow;
+		std::vector<std::string> m_channelNames;
+
+		struct TileOriginLess
+		{
+			bool operator()( const V2i &a, const V2i &b ) const
+			{
+				return a.y < b.y || ( a.y == b.y && a.x < b.x );
+			}
+		};
+
+		typedef std::map<V2i, Tile, TileOriginLess> TileMap;
+		TileMap m_tiles;
+		tbb::mutex m_mutex;
+
+		tbb::task_group m_taskGroup;
+		tbb::atomic<bool> m_cancelled;
+
+};
+
+IE_CORE_DECLAREPTR( ImageTiles )
+
 /// \todo Refactor all the colour sampling and swatch drawing out of here.
 /// Sampled colours should be available on the ImageView as output plugs,
 /// and a new FooterToolbar type thing in the Viewer should be used for drawing
@@ -100,7 +471,9 @@ class ImageViewGadget : public GafferUI::Gadget
 	public :
 
 		ImageViewGadget(
-			IECore::ConstImagePrimitivePtr image,
+			ImageTilesPtr tiles,
+			const Imath::Box2i &displayWindow,
+			const Imath::Box2i &dataWindow,
 			GafferImage::ImageStatsPtr imageStats,
 			GafferImage::ImageSamplerPtr imageSampler,
 			ConstContextPtr context,
@@ -112,11 +485,13 @@ class ImageViewGadget : public GafferUI::Gadget
 			Color4f &averageColor
 		)
 			:	Gadget( defaultName<ImageViewGadget>() ),
-				m_displayBound( image->bound() ),
-				m_displayWindow( image->getDisplayWindow() ),
-				m_dataWindow( image->getDataWindow() ),
-				m_image( image->copy() ),
-				m_texture( 0 ),
+				m_displayBound(
+					V3f( -( displayWindow.size().x + 1 ) / 2.0f, -( displayWindow.size().y + 1 ) / 2.0f, 0.0f ),
+					V3f( ( displayWindow.size().x + 1 ) / 2.0f, ( displayWindow.size().y + 1 ) / 2.0f, 0.0f )
+				),
+				m_displayWindow( displayWindow ),
+				m_dataWindow( dataWindow ),
+				m_tiles( tiles ),
 				m_mousePos( mousePos ),
 				m_sampleColor( 0.f ),
 				m_dragSelecting( false ),
@@ -173,9 +548,7 @@ class ImageViewGadget : public GafferUI::Gadget
 			m_colorUiElements[3].name = "Mean"; // The mean color within a selection.
 			m_colorUiElements[3].position = V2i( 635, 19 );
 
-			std::vector< std::string > channelNames;
-			m_image->channelNames( channelNames );
-			m_hasAlpha = std::find( channelNames.begin(), channelNames.end(), "A" ) != channelNames.end();
+			m_hasAlpha = m_tiles->hasAlpha();
 		}
 
 		virtual ~ImageViewGadget()
@@ -277,38 +650,45 @@ class ImageViewGadget : public GafferUI::Gadget
 			return g_shader.get();
 		}
 
-		void renderImageWindow( const Imath::Box2f &box, const IECoreGL::Texture *texture, int channelToView ) const
+		void renderTiles() const
 		{
-			glPushAttrib( GL_COLOR_BUFFER_BIT );
+			glPushAttrib( GL_COLOR_BUFFER_BIT | GL_ENABLE_BIT | GL_TEXTURE_BIT );
 
 			glEnable( GL_BLEND );
 			glBlendFunc( GL_ONE, GL_ONE_MINUS_SRC_ALPHA );
 
 			glEnable( GL_TEXTURE_2D );
 			glActiveTexture( GL_TEXTURE0 );
-			texture->bind();
 
+			// The "texture" sampler uses texture unit 0 by default, which is
+			// where the tiles bind their textures as they are drawn.
 			IECoreGL::Shader::SetupPtr setup( new IECoreGL::Shader::Setup( shader() ) );
-			setup->addUniformParameter( "texture", texture );
-
-			const IECore::IntDataPtr channelToViewData( new IECore::IntData( channelToView ) );
+			const IECore::IntDataPtr channelToViewData( new IECore::IntData( m_channelToView ) );
 			setup->addUniformParameter( "channelToView", boost::static_pointer_cast<const IECore::Data>( channelToViewData ) );
 			IECoreGL::Shader::Setup::ScopedBinding b( *setup );
 
 			glColor3f( 1.0f, 1.0f, 1.0f );
 
-			glBegin( GL_QUADS );
+			// The display window is centred on the origin in gadget space.
+			const Box2i &tilesDisplayWindow = m_tiles->displayWindow();
+			const V2f center = V2f( tilesDisplayWindow.min + tilesDisplayWindow.max + V2i( 1 ) ) / 2.0f;
 
-			glTexCoord2f( 1, 0 );
-			glVertex2f( box.max.x, box.min.y );
-			glTexCoord2f( 1, 1 );
-			glVertex2f( box.max.x, box.max.y );
-			glTexCoord2f( 0, 1 );
-			glVertex2f( box.min.x, box.max.y );
-			glTexCoord2f( 0, 0 );
-			glVertex2f( box.min.x, box.min.y );
+			// Find the region of the tiles that is visible in the viewport.
+			const ViewportGadget *viewportGadget = ancestor<ViewportGadget>();
+			const V3f corner0 = viewportGadget->rasterToGadgetSpace( V2f( 0 ), this ).p0;
+			const V3f corner1 = viewportGadget->rasterToGadgetSpace( V2f( viewportGadget->getViewport() ), this ).p0;
+			Box2f visibleBound;
+			visibleBound.extendBy( V2f( corner0.x, corner0.y ) + center );
+			visibleBound.extendBy( V2f( corner1.x, corner1.y ) + center );
+			const Box2i visibleRegion(
+				V2i( (int)floorf( visibleBound.min.x ), (int)floorf( visibleBound.min.y ) ),
+				V2i( (int)ceilf( visibleBound.max.x ), (int)ceilf( visibleBound.max.y ) )
+			);
 
-			glEnd();
+			glPushMatrix();
+			glTranslatef( -center.x, -center.y, 0.0f );
+			m_tiles->render( visibleRegion );
+			glPopMatrix();
 
 			glPopAttrib();
 		}
@@ -612,19 +992,6 @@ class ImageViewGadget : public GafferUI::Gadget
 		virtual void doRender( const Style *style ) const
 		{
 
-			if( !m_texture )
-			{
-				// convert image to texture
-				ToGLTextureConverterPtr converter = new ToGLTextureConverter( boost::static_pointer_cast<const ImagePrimitive>( m_image ), true );
-				m_texture = IECore::runTimeCast<IECoreGL::Texture>( converter->convert() );
-
-				{
-					Texture::ScopedBinding scope( *m_texture );
-					glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
-					glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
-				}
-			}
-
 			// Transform them to Raster Space
 			///\todo: The RasterScope class transforms Gadgets into a space where coordinate (0, 0) is in the top left corner.
 			/// If we are rasterizing gadgets in 2D then we want (0, 0) to be in the bottom left corner. Perhaps we should write
@@ -644,11 +1011,7 @@ class ImageViewGadget : public GafferUI::Gadget
 			}
 
 			// Draw the image data.
-			{
-				// Get the bounds of the data window in Gadget space.
-				Box2f b( V2f( m_dataBound.min.x, m_dataBound.min.y ), V2f( m_dataBound.max.x, m_dataBound.max.y ) );
-				renderImageWindow( b, (const Texture *)m_texture.get(), m_channelToView );
-			}
+			renderTiles();
 
 			ViewportGadget::RasterScope rasterScope( viewportGadget );
 
@@ -878,8 +1241,7 @@ class ImageViewGadget : public GafferUI::Gadget
 		Imath::Box3f m_dataBound;
 		Imath::Box2i m_displayWindow;
 		Imath::Box2i m_dataWindow;
-		ConstImagePrimitivePtr m_image;
-		mutable ConstTexturePtr m_texture;
+		ImageTilesPtr m_tiles;
 
 		Imath::V2f &m_mousePos;
 		Imath::V3f m_dragStartPosition;
@@ -911,6 +1273,10 @@ IE_CORE_DEFINERUNTIMETYPED( ImageView );
 
 ImageView::ViewDescription<ImageView> ImageView::g_viewDescription( GafferImage::ImagePlug::staticTypeId() );
 
+// Level 4 reads at 1/16th resolution, at which point there is
+// little to be gained from going further.
+const int ImageView::g_maxProxyLevel = 4;
+
 ImageView::ImageView( const std::string &name )
 	:	View( name, new GafferImage::ImagePlug() ),
 		m_channelToView( 0 ),
@@ -918,7 +1284,8 @@ ImageView::ImageView( const std::string &name )
 		m_sampleColor( Imath::Color4f( 0.0f ) ),
 		m_minColor( Imath::Color4f( 0.0f ) ),
 		m_maxColor( Imath::Color4f( 0.0f ) ),
-		m_averageColor( Imath::Color4f( 0.0f ) )
+		m_averageColor( Imath::Color4f( 0.0f ) ),
+		m_proxyLevel( 0 )
 {
 
 	// build the preprocessor we use for applying colour
@@ -975,9 +1342,15 @@ ImageView::ImageView( const std::string &name )
 
 	setPreprocessor( preprocessor );
 
+	// create the tiles we use to draw the image
+
+	m_imageTiles = new Detail::ImageTiles( preprocessedInPlug<ImagePlug>(), viewportGadget() );
+
 	// connect up to some signals
 
 	plugSetSignal().connect( boost::bind( &ImageView::plugSet, this, ::_1 ) );
+	viewportGadget()->viewportChangedSignal().connect( boost::bind( &ImageView::viewportChanged, this ) );
+	viewportGadget()->cameraChangedSignal().connect( boost::bind( &ImageView::viewportChanged, this ) );
 
 	// get our display transform right
 
@@ -1018,6 +1391,11 @@ void ImageView::insertConverter( Gaffer::NodePtr converter )
 
 ImageView::~ImageView()
 {
+	// The viewport may outlive us, but the tiles must not continue
+	// to compute from our preprocessor, so we remove the gadget which
+	// would otherwise render them.
+	m_imageTiles->cancel();
+	viewportGadget()->setPrimaryChild( NULL );
 }
 
 Gaffer::BoolPlug *ImageView::clippingPlug()
@@ -1102,10 +1480,32 @@ const GafferImage::Grade *ImageView::gradeNode() const
 
 void ImageView::update()
 {
-	Context::Scope context( getContext() );
-	ConstImagePrimitivePtr image = preprocessedInPlug<ImagePlug>()->image();
+	m_proxyLevel = idealProxyLevel();
 
-	Detail::ImageViewGadgetPtr imageViewGadget = new Detail::ImageViewGadget( image, imageStatsNode(), imageSamplerNode(), getContext(), m_channelToView, m_mousePos, m_sampleColor, m_minColor, m_maxColor, m_averageColor );
+	{
+		ContextPtr proxyContext = new Context( *getContext(), Context::Borrowed );
+		if( m_proxyLevel )
+		{
+			proxyContext->set( ImagePlug::proxyLevelContextName, m_proxyLevel );
+		}
+		m_imageTiles->update( proxyContext.get() );
+	}
+
+	// The proxy level doesn't affect the format or data window, so the
+	// gadget, tiles, sampler and stats nodes all share the same pixel space.
+	// We compute the windows exactly as ImagePlug::image() would.
+	Box2i displayWindow;
+	Box2i dataWindow;
+	{
+		Context::Scope context( getContext() );
+		const ImagePlug *imagePlug = preprocessedInPlug<ImagePlug>();
+		const Format format = imagePlug->formatPlug()->getValue();
+		displayWindow = format.getDisplayWindow();
+		dataWindow = imagePlug->dataWindowPlug()->getValue();
+		dataWindow = dataWindow.isEmpty() ? Box2i( V2i( 0 ) ) : format.yDownToFormatSpace( dataWindow );
+	}
+
+	Detail::ImageViewGadgetPtr imageViewGadget = new Detail::ImageViewGadget( m_imageTiles, displayWindow, dataWindow, imageStatsNode(), imageSamplerNode(), getContext(), m_channelToView, m_mousePos, m_sampleColor, m_minColor, m_maxColor, m_averageColor );
 	bool hadChild = viewportGadget()->getPrimaryChild();
 	viewportGadget()->setPrimaryChild( imageViewGadget );
 	if( !hadChild )
@@ -1114,6 +1514,52 @@ void ImageView::update()
 	}
 }
 
+void ImageView::plugDirtied( const Gaffer::Plug *plug )
+{
+	View::plugDirtied( plug );
+
+	// The tiles being computed in the background are now out of date,
+	// so we stop computing them. Dirtiness may be signalled on any
+	// thread, but the tiles are managed on the UI thread. Note that we
+	// may be called from within our constructor, before the tiles have
+	// been created.
+	if( m_imageTiles && plug == preprocessedInPlug<ImagePlug>() )
+	{
+		Gadget::executeOnUIThread( boost::bind( &Detail::ImageTiles::cancel, m_imageTiles ) );
+	}
+}
+
+int ImageView::idealProxyLevel() const
+{
+	const Gadget *gadget = viewportGadget()->getPrimaryChild();
+	if( !gadget )
+	{
+		return 0;
+	}
+
+	// Measure the size of a single image pixel on screen, and use the
+	// lowest resolution at which proxy pixels are still no smaller than
+	// screen pixels.
+	const V2f p0 = viewportGadget()->gadgetToRasterSpace( V3f( 0 ), gadget );
+	const V2f p1 = viewportGadget()->gadgetToRasterSpace( V3f( 1, 0, 0 ), gadget );
+	const float pixelSize = ( p1 - p0 ).length();
+
+	int result = 0;
+	while( result < g_maxProxyLevel && pixelSize * (float)( 2 << result ) <= 1.0f )
+	{
+		result++;
+	}
+	return result;
+}
+
+void ImageView::viewportChanged()
+{
+	if( idealProxyLevel() != m_proxyLevel )
+	{
+		updateRequestSignal()( this );
+	}
+}
+
 void ImageView::plugSet( Gaffer::Plug *plug )
 {
 	if( plug == clippingPlug() )
@@ -89,6 +89,7 @@
 #include "GafferBindings/LeafPathFilterBinding.h"
 #include "GafferBindings/MatchPatternPathFilterBinding.h"
 #include "GafferBindings/FileSystemPathBinding.h"
+#include "GafferBindings/PerformanceMonitorBinding.h"
 
 using namespace boost::python;
 using namespace Gaffer;
@@ -182,6 +183,7 @@ BOOST_PYTHON_MODULE( _Gaffer )
 	bindLeafPathFilter();
 	bindMatchPatternPathFilter();
 	bindFileSystemPath();
+	bindPerformanceMonitor();
 
 	NodeClass<Backdrop>();
 
@@ -40,7 +40,6 @@
 #include "Gaffer/Context.h"
 
 #include "GafferScene/ScenePlug.h"
-#include "GafferScene/SceneProcedural.h"
 #include "GafferScene/ExecutableRender.h"
 #include "GafferScene/RendererAlgo.h"
 
@@ -148,7 +147,8 @@ void ExecutableRender::execute() const
 
 void ExecutableRender::outputWorldProcedural( const ScenePlug *scene, IECore::Renderer *renderer ) const
 {
-	renderer->procedural( new SceneProcedural( scene, Context::current() ) );
+	ConstCompoundObjectPtr globals = scene->globalsPlug()->getValue();
+	outputWorld( scene, globals.get(), renderer );
 }
 
 std::string ExecutableRender::command() const
@@ -36,14 +36,10 @@
 
 #include "boost/bind.hpp"
 
-#include "tbb/task.h"
-#include "tbb/task_scheduler_init.h"
-#include "tbb/compat/thread"
-
 #include "IECore/WorldBlock.h"
+#include "IECore/AttributeBlock.h"
 #include "IECore/EditBlock.h"
 #include "IECore/MessageHandler.h"
-#include "IECore/SceneInterface.h"
 
 #include "Gaffer/Context.h"
 #include "Gaffer/ScriptNode.h"
@@ -61,82 +57,10 @@ using namespace GafferScene;
 
 IE_CORE_DEFINERUNTIMETYPED( InteractiveRender );
 
-//////////////////////////////////////////////////////////////////////////
-// SceneGraph implementation
-//
-// This is a node in a scene hierarchy, which gets built when the
-// interactive render starts up. Each node stores the attribute hash of
-// the input scene at its corresponding location in the hierarchy, so
-// when the incoming scene updates, we are able to determine the locations
-// at which the attributes have changed since the last update, reevaluate
-// those attributes and send updates to the renderer.
-//
-// \todo: This is very similar to the SceneGraph mechanism in
-// GafferSceneUI::SceneGadget. At some point it would be good to refactor
-// this and use the same class for both of them. See the comments in
-// src/GafferSceneUI/SceneGadget.cpp for details.
-//
-//////////////////////////////////////////////////////////////////////////
-
-class InteractiveRender::SceneGraph
-{
-
-	public :
-
-		SceneGraph() : m_parent( NULL ), m_locationPresent( true )
-		{
-		}
-
-		~SceneGraph()
-		{
-			for( std::vector<SceneGraph *>::const_iterator it = m_children.begin(), eIt = m_children.end(); it != eIt; ++it )
-			{
-				delete *it;
-			}
-		}
-		
-		void path( ScenePlug::ScenePath &p )
-		{
-			if( !m_parent )
-			{
-				return;
-			}
-			m_parent->path( p );
-			p.push_back( m_name );
-		}
-
-	private :
-		
-		friend class SceneGraphBuildTask;
-		friend class ChildNamesUpdateTask;
-		
-		friend class SceneGraphIteratorFilter;
-		friend class SceneGraphEvaluatorFilter;
-		friend class SceneGraphOutputFilter;
-		
-		// scene structure data:
-		IECore::InternedString m_name;
-		SceneGraph *m_parent;
-		std::vector<InteractiveRender::SceneGraph *> m_children;
-		
-		// hashes as of the most recent evaluation:
-		IECore::MurmurHash m_attributesHash;
-		IECore::MurmurHash m_childNamesHash;
-		
-		// actual scene data:
-		IECore::ConstCompoundObjectPtr m_attributes;
-		IECore::ConstObjectPtr m_object;
-		Imath::M44f m_transform;
-		
-		// flag indicating if this location is currently present - (used
-		// when the child names change)
-		bool m_locationPresent;
-};
-
 size_t InteractiveRender::g_firstPlugIndex = 0;
 
 InteractiveRender::InteractiveRender( const std::string &name )
-	:	Node( name ), m_lightsDirty( true ), m_attributesDirty( true ), m_camerasDirty( true ), m_coordinateSystemsDirty( true )
+	:	Node( name ), m_attributesGeneration( 0 ), m_transformsGeneration( 0 ), m_objectsGeneration( 0 ), m_outputGeneration( 0 ), m_lightsDirty( true ), m_attributesDirty( true ), m_transformsDirty( true ), m_objectsDirty( true ), m_camerasDirty( true ), m_coordinateSystemsDirty( true )
 {
 	storeIndexOfNextChild( g_firstPlugIndex );
 	addChild( new ScenePlug( "in" ) );
@@ -147,6 +71,8 @@ InteractiveRender::InteractiveRender( const std::string &name )
 	addChild( new BoolPlug( "updateAttributes", Plug::In, true ) );
 	addChild( new BoolPlug( "updateCameras", Plug::In, true ) );
 	addChild( new BoolPlug( "updateCoordinateSystems", Plug::In, true ) );
+	addChild( new BoolPlug( "updateTransforms", Plug::In, true ) );
+	addChild( new BoolPlug( "updateObjects", Plug::In, true ) );
 
 	plugDirtiedSignal().connect( boost::bind( &InteractiveRender::plugDirtied, this, ::_1 ) );
 	parentChangedSignal().connect( boost::bind( &InteractiveRender::parentChanged, this, ::_1, ::_2 ) );
@@ -229,118 +155,25 @@ const Gaffer::BoolPlug *InteractiveRender::updateCoordinateSystemsPlug() const
 	return getChild<BoolPlug>( g_firstPlugIndex + 6 );
 }
 
-//////////////////////////////////////////////////////////////////////////
-// ChildNamesUpdateTask implementation
-//
-// We use this tbb::task to traverse the input scene and check if the child
-// names are still valid at each location. If not, we flag the location as
-// not present so it doesn't get traversed during an update
-//
-//////////////////////////////////////////////////////////////////////////
-
-class InteractiveRender::ChildNamesUpdateTask : public tbb::task
+Gaffer::BoolPlug *InteractiveRender::updateTransformsPlug()
 {
+	return getChild<BoolPlug>( g_firstPlugIndex + 7 );
+}
 
-	public :
-
-		ChildNamesUpdateTask( const ScenePlug *scene, const Context *context, SceneGraph *sceneGraph, const ScenePlug::ScenePath &scenePath )
-			:	m_scene( scene ),
-				m_context( context ),
-				m_sceneGraph( sceneGraph ),
-				m_scenePath( scenePath )
-		{
-		}
-
-		~ChildNamesUpdateTask()
-		{
-		}
-
-		virtual task *execute()
-		{
-			ContextPtr context = new Context( *m_context, Context::Borrowed );
-			context->set( ScenePlug::scenePathContextName, m_scenePath );
-			Context::Scope scopedContext( context.get() );
-			
-			IECore::MurmurHash childNamesHash = m_scene->childNamesPlug()->hash();
-			
-			if( childNamesHash != m_sceneGraph->m_childNamesHash )
-			{
-				// child names have changed - we need to update m_locationPresent on the children:
-				m_sceneGraph->m_childNamesHash = childNamesHash;
-				
-				// read updated child names:
-				IECore::ConstInternedStringVectorDataPtr childNamesData = m_scene->childNamesPlug()->getValue( &m_sceneGraph->m_childNamesHash );
-				std::vector<IECore::InternedString> childNames = childNamesData->readable();
-				
-				// m_sceneGraph->m_children should be sorted by name. Sort this list too so we can
-				// compare the two easily:
-				std::sort( childNames.begin(), childNames.end() );
-				
-				std::vector<InternedString>::iterator childNamesBegin = childNames.begin();
-				for( std::vector<SceneGraph *>::const_iterator it = m_sceneGraph->m_children.begin(), eIt = m_sceneGraph->m_children.end(); it != eIt; ++it )
-				{
-					// try and find the current child name in the list of child names:
-					std::vector<InternedString>::iterator nameIt = std::find( childNamesBegin, childNames.end(), (*it)->m_name );
-					if( nameIt != childNames.end() )
-					{
-						// ok, it's there - mark this child as still present
-						(*it)->m_locationPresent = true;
-						
-						// As both the name lists are sorted, no further child names will be found beyond nameIt
-						// in the list, nor will they be found at nameIt as there shouldn't be any duplicates.
-						// This means we can move the start of the child names list one position past nameIt
-						// to save a bit of time:
-						/// \todo Note that if all the children have changed names, we never end up in here, and
-						/// we will end up with quadratic behaviour calling find (a linear search N times).
-						childNamesBegin = nameIt;
-						++childNamesBegin;
-					}
-					else
-					{
-						(*it)->m_locationPresent = false;
-					}
-				}
-			}
-			
-			// count children currently present in the scene:
-			size_t numPresentChildren = 0;
-			for( std::vector<SceneGraph *>::const_iterator it = m_sceneGraph->m_children.begin(), eIt = m_sceneGraph->m_children.end(); it != eIt; ++it )
-			{
-				numPresentChildren += (*it)->m_locationPresent;
-			}
-			
-			// spawn child tasks:
-			set_ref_count( 1 + numPresentChildren );
-			ScenePlug::ScenePath childPath = m_scenePath;
-			childPath.push_back( IECore::InternedString() ); // space for the child name
-			for( std::vector<SceneGraph *>::const_iterator it = m_sceneGraph->m_children.begin(), eIt = m_sceneGraph->m_children.end(); it != eIt; ++it )
-			{
-				if( (*it)->m_locationPresent )
-				{
-					childPath.back() = (*it)->m_name;
-					ChildNamesUpdateTask *t = new( allocate_child() ) ChildNamesUpdateTask(
-						m_scene,
-						m_context,
-						(*it),
-						childPath
-					);
-
-					spawn( *t );
-				}
-			}
-			wait_for_all();
-
-			return NULL;
-		}
-
-	private :
+const Gaffer::BoolPlug *InteractiveRender::updateTransformsPlug() const
+{
+	return getChild<BoolPlug>( g_firstPlugIndex + 7 );
+}
 
-		const ScenePlug *m_scene;
-		const Context *m_context;
-		SceneGraph *m_sceneGraph;
-		ScenePlug::ScenePath m_scenePath;
-};
+Gaffer::BoolPlug *InteractiveRender::updateObjectsPlug()
+{
+	return getChild<BoolPlug>( g_firstPlugIndex + 8 );
+}
 
+const Gaffer::BoolPlug *InteractiveRender::updateObjectsPlug() const
+{
+	return getChild<BoolPlug>( g_firstPlugIndex + 8 );
+}
 
 void InteractiveRender::plugDirtied( const Gaffer::Plug *plug )
 {
@@ -356,6 +189,11 @@ void InteractiveRender::plugDirtied( const Gaffer::Plug *plug )
 		m_lightsDirty = true;
 		m_camerasDirty = true;
 		m_coordinateSystemsDirty = true;
+		m_transformsDirty = true;
+		if( m_sceneMirror && plug == inPlug()->transformPlug() )
+		{
+			m_sceneMirror->dirty( SceneMirror::TransformDirty );
+		}
 	}
 	else if( plug == inPlug()->objectPlug() )
 	{
@@ -363,33 +201,34 @@ void InteractiveRender::plugDirtied( const Gaffer::Plug *plug )
 		m_lightsDirty = true;
 		m_camerasDirty = true;
 		m_coordinateSystemsDirty = true;
+		m_objectsDirty = true;
+		if( m_sceneMirror )
+		{
+			m_sceneMirror->dirty( SceneMirror::ObjectDirty );
+		}
 	}
 	else if( plug == inPlug()->attributesPlug() )
 	{
 		// as above.
 		m_attributesDirty = true;
 		m_lightsDirty = true;
+		if( m_sceneMirror )
+		{
+			m_sceneMirror->dirty( SceneMirror::AttributesDirty );
+		}
 	}
 	else if( plug == inPlug()->childNamesPlug() )
 	{
-		if( m_sceneGraph.get() )
+		if( m_sceneMirror )
 		{
-			// child names may have changed: we need to run through the scene graph data structure
-			// checking for locations that are no longer present, and flag them as absent if this
-			// is the case:
-			/// \todo doing this directly here is out of keeping with the basic structure
-			/// of this node. Everything else just figures out what is dirty here, and then
-			/// waits until update() to do the work. Since we'll most likely delay calls to update()
-			/// further in the future, we should fix this.
-			ChildNamesUpdateTask *task = new( tbb::task::allocate_root() ) ChildNamesUpdateTask( inPlug(), m_context.get(), m_sceneGraph.get(), ScenePlug::ScenePath() );
-			try
-			{
-				tbb::task::spawn_root_and_wait( *task );
-			}
-			catch( const std::exception& e )
-			{
-				IECore::msg( IECore::Msg::Error, "InteractiveRender::update", e.what() );
-			}
+			m_sceneMirror->dirty( SceneMirror::ChildNamesDirty );
+		}
+	}
+	else if( plug == inPlug()->boundPlug() )
+	{
+		if( m_sceneMirror )
+		{
+			m_sceneMirror->dirty( SceneMirror::BoundDirty );
 		}
 	}
 	else if(
@@ -398,6 +237,8 @@ void InteractiveRender::plugDirtied( const Gaffer::Plug *plug )
 		plug == updateAttributesPlug() ||
 		plug == updateCamerasPlug() ||
 		plug == updateCoordinateSystemsPlug() ||
+		plug == updateTransformsPlug() ||
+		plug == updateObjectsPlug() ||
 		plug == statePlug()
 	)
 	{
@@ -434,422 +275,152 @@ void InteractiveRender::parentChanged( GraphComponent *child, GraphComponent *ol
 
 
 //////////////////////////////////////////////////////////////////////////
-// BuildTask implementation
-//
-// We use this tbb::task to traverse the input scene and build the
-// hierarchy for the first time. Recursion is terminated for locations
-// at which scene:visible is set to false, so this task also computes
-// and stores the attributes.
+// Scene output
 //
+// The scene is evaluated in parallel by a SceneMirror of our input plug.
+// We then traverse the mirror
+// serially to output the scene to the renderer, either in full or as edits
+// for the locations which have changed since we last synchronised with it.
 //////////////////////////////////////////////////////////////////////////
 
-class InteractiveRender::SceneGraphBuildTask : public tbb::task
+void InteractiveRender::outputScene( bool update )
 {
+	const bool updateAttributes = !update || ( m_attributesDirty && updateAttributesPlug()->getValue() );
+	const bool updateTransforms = !update || ( m_transformsDirty && updateTransformsPlug()->getValue() );
+	const bool updateObjects = !update || ( m_objectsDirty && updateObjectsPlug()->getValue() );
 
-	public :
-
-		SceneGraphBuildTask( const ScenePlug *scene, const Context *context, SceneGraph *sceneGraph, const ScenePlug::ScenePath &scenePath )
-			:	m_scene( scene ),
-				m_context( context ),
-				m_sceneGraph( sceneGraph ),
-				m_scenePath( scenePath )
-		{
-		}
-
-		~SceneGraphBuildTask()
-		{
-		}
-
-		virtual task *execute()
-		{
-			ContextPtr context = new Context( *m_context, Context::Borrowed );
-			context->set( ScenePlug::scenePathContextName, m_scenePath );
-			Context::Scope scopedContext( context.get() );
-
-			// we need the attributes so we can terminate recursion at invisible locations, so
-			// we might as well store them in the scene graph, along with the hash:
-
-			m_sceneGraph->m_attributesHash = m_scene->attributesPlug()->hash();
-			
-			// use the precomputed hash in getValue() to save a bit of time:
-			
-			m_sceneGraph->m_attributes = m_scene->attributesPlug()->getValue( &m_sceneGraph->m_attributesHash );
-			const BoolData *visibilityData = m_sceneGraph->m_attributes->member<BoolData>( SceneInterface::visibilityName );
-			if( visibilityData && !visibilityData->readable() )
-			{
-				// terminate recursion for invisible locations
-				return NULL;
-			}
-
-			// store the hash of the child names so we know when they change:
-			m_sceneGraph->m_childNamesHash = m_scene->childNamesPlug()->hash();
-
-			// compute child names:
-			IECore::ConstInternedStringVectorDataPtr childNamesData = m_scene->childNamesPlug()->getValue( &m_sceneGraph->m_childNamesHash );
-
-			std::vector<IECore::InternedString> childNames = childNamesData->readable();
-			if( childNames.empty() )
-			{
-				// nothing more to do
-				return NULL;
-			}
-			
-			// sort the child names so we can compare child name lists easily in ChildNamesUpdateTask:
-			std::sort( childNames.begin(), childNames.end() );
-
-			// add children for this location:
-			std::vector<InteractiveRender::SceneGraph *> children;
-			for( std::vector<IECore::InternedString>::const_iterator it = childNames.begin(), eIt = childNames.end(); it != eIt; ++it )
-			{
-				SceneGraph *child = new SceneGraph();
-				child->m_name = *it;
-				child->m_parent = m_sceneGraph;
-				children.push_back( child );
-			}
-
-			// spawn child tasks:
-			set_ref_count( 1 + children.size() );
-			ScenePlug::ScenePath childPath = m_scenePath;
-			childPath.push_back( IECore::InternedString() ); // space for the child name
-			for( std::vector<SceneGraph *>::const_iterator it = children.begin(), eIt = children.end(); it != eIt; ++it )
-			{
-				childPath.back() = (*it)->m_name;
-				SceneGraphBuildTask *t = new( allocate_child() ) SceneGraphBuildTask(
-					m_scene,
-					m_context,
-					(*it),
-					childPath
-				);
-				
-				spawn( *t );
-			}
+	SceneMirror::Mutex::scoped_lock lock( m_sceneMirror->mutex() );
+	m_sceneMirror->update();
 
-			wait_for_all();
-			
-			// add visible children to m_sceneGraph->m_children:
-			for( std::vector<SceneGraph *>::const_iterator it = children.begin(), eIt = children.end(); it != eIt; ++it )
-			{
-				const BoolData *visibilityData = (*it)->m_attributes->member<BoolData>( SceneInterface::visibilityName );
-				if( visibilityData && !visibilityData->readable() )
-				{
-					continue;
-				}
-				m_sceneGraph->m_children.push_back( *it );
-			}
-			
-			return NULL;
-		}
+	if( !update )
+	{
+		outputLocation( m_sceneMirror->root() );
+	}
+	else
+	{
+		outputEdits(
+			m_sceneMirror->root(),
+			M44f(),
+			false,
+			updateAttributes ? m_attributesGeneration : m_sceneMirror->generation(),
+			updateTransforms ? m_transformsGeneration : m_sceneMirror->generation(),
+			updateObjects ? m_objectsGeneration : m_sceneMirror->generation()
+		);
+	}
 
-	private :
+	const size_t generation = m_sceneMirror->generation();
+	m_attributesGeneration = updateAttributes ? generation : m_attributesGeneration;
+	m_transformsGeneration = updateTransforms ? generation : m_transformsGeneration;
+	m_objectsGeneration = updateObjects ? generation : m_objectsGeneration;
+	m_outputGeneration = update ? m_outputGeneration : generation;
+}
 
-		const ScenePlug *m_scene;
-		const Context *m_context;
-		SceneGraph *m_sceneGraph;
-		ScenePlug::ScenePath m_scenePath;
-};
+void InteractiveRender::outputLocation( const SceneMirror::Location *location )
+{
+	if( !location->visible() )
+	{
+		return;
+	}
 
+	ScenePlug::ScenePath path;
+	location->path( path );
+	std::string name;
+	ScenePlug::pathToString( path, name );
 
-//////////////////////////////////////////////////////////////////////////
-// SceneGraphIteratorFilter implementation
-//
-// Does a serial, depth first traversal of a SceneGraph hierarchy based at
-// "start", and spits out SceneGraph* tokens:
-//
-//////////////////////////////////////////////////////////////////////////
+	AttributeBlock attributeBlock( m_renderer );
 
-class InteractiveRender::SceneGraphIteratorFilter : public tbb::filter
-{
-	public:
-		SceneGraphIteratorFilter( InteractiveRender::SceneGraph *start ) :
-			tbb::filter( tbb::filter::serial_in_order ), m_current( start )
-		{
-			m_childIndices.push_back( 0 );
-		}
-		
-		virtual void *operator()( void *item )
+	try
+	{
+		m_renderer->setAttribute( "name", new StringData( name ) );
+		m_renderer->concatTransform( location->transform() );
+		if( location->attributes() )
 		{
-			if( m_childIndices.empty() )
-			{
-				// we've finished the iteration
-				return NULL;
-			}
-			InteractiveRender::SceneGraph *s = m_current;
-			next();
-			return s;
+			outputAttributes( location->attributes(), m_renderer.get() );
 		}
-	
-	private:
-		
-		void next()
+		if( const VisibleRenderable *renderable = runTimeCast<const VisibleRenderable>( location->object() ) )
 		{
-			// go down one level in the hierarchy if we can:
-			for( size_t i=0; i < m_current->m_children.size(); ++i )
-			{
-				// skip out locations that aren't present
-				if( m_current->m_children[i]->m_locationPresent )
-				{
-					m_current = m_current->m_children[i];
-					m_childIndices.push_back(i);
-					return;
-				}
-			}
-			
-			while( m_childIndices.size() )
-			{
-				
-				// increment child index:
-				++m_childIndices.back();
-				
-				// find parent's child count - for the root we define this as 1:
-				size_t parentNumChildren = m_current->m_parent ? m_current->m_parent->m_children.size() : 1;
-				
-				if( m_childIndices.back() == parentNumChildren )
-				{
-					// we've got to the end of the child list, jump up one level:
-					m_childIndices.pop_back();
-					m_current = m_current->m_parent;
-					continue;
-				}
-				else if( m_current->m_parent->m_children[ m_childIndices.back() ]->m_locationPresent )
-				{
-					// move to next child of the parent, if it is still present in the scene:
-					m_current = m_current->m_parent->m_children[ m_childIndices.back() ];
-					return;
-				}
-			}
+			renderable->render( m_renderer.get() );
 		}
-		
-		SceneGraph *m_current;
-		std::vector<size_t> m_childIndices;
-};
-
+	}
+	catch( const std::exception &e )
+	{
+		IECore::msg( IECore::Msg::Error, "InteractiveRender::update", name + ": " + e.what() );
+	}
 
-//////////////////////////////////////////////////////////////////////////
-// SceneGraphEvaluatorFilter implementation
-//
-// This parallel filter computes the data living at the scene graph
-// location it receives. If the "onlyChanged" flag is set to true, it
-// only recomputes data when the hashes change, otherwise it computes
-// all non null scene data.
-//
-//////////////////////////////////////////////////////////////////////////
+	const SceneMirror::Location::Children &children = location->children();
+	for( SceneMirror::Location::Children::const_iterator it = children.begin(), eIt = children.end(); it != eIt; ++it )
+	{
+		outputLocation( *it );
+	}
+}
 
-class InteractiveRender::SceneGraphEvaluatorFilter : public tbb::filter
+void InteractiveRender::outputEdits( const SceneMirror::Location *location, const M44f &parentTransform, bool parentTransformChanged, size_t attributesGeneration, size_t transformsGeneration, size_t objectsGeneration )
 {
-	public:
-		SceneGraphEvaluatorFilter( const ScenePlug *scene, const Context *context, bool update ) :
-			tbb::filter( tbb::filter::parallel ), m_scene( scene ), m_context( context ), m_update( update )
-		{
-		}
+	const bool attributesChanged = location->changes( attributesGeneration ) & SceneMirror::AttributesDirty;
+	if( !location->visible() && !attributesChanged )
+	{
+		return;
+	}
 
-		virtual void *operator()( void *item )
-		{
-			SceneGraph *s = (SceneGraph*)item;
-			ScenePlug::ScenePath path;
-			s->path( path );
+	// The renderer holds the full transform for each location, so a change
+	// to any ancestor's transform requires an edit for every descendant.
+	const M44f fullTransform = location->transform() * parentTransform;
+	const bool transformChanged = parentTransformChanged || ( location->changes( transformsGeneration ) & SceneMirror::TransformDirty );
+	const bool objectChanged = location->changes( objectsGeneration ) & SceneMirror::ObjectDirty;
 
-			try
-			{
-				ContextPtr context = new Context( *m_context, Context::Borrowed );
-				context->set( ScenePlug::scenePathContextName, path );
-				Context::Scope scopedContext( context.get() );
-			
-				if( m_update )
-				{
-					// we're re-traversing this location, so lets only recompute attributes where
-					// their hashes change:
-
-					IECore::MurmurHash attributesHash = m_scene->attributesPlug()->hash();
-					if( attributesHash != s->m_attributesHash )
-					{
-						s->m_attributes = m_scene->attributesPlug()->getValue( &attributesHash );
-						s->m_attributesHash = attributesHash;
-					}
-				}
-				else
-				{
-					// First traversal: attributes and attribute hash should have been computed
-					// by the SceneGraphBuildTasks, so we only need to compute the object/transform:
+	if( attributesChanged || transformChanged || objectChanged )
+	{
+		ScenePlug::ScenePath path;
+		location->path( path );
+		std::string name;
+		ScenePlug::pathToString( path, name );
 
-					s->m_object = m_scene->objectPlug()->getValue();
-					s->m_transform = m_scene->transformPlug()->getValue();
+		CompoundDataMap parameters;
+		parameters["exactscopename"] = new StringData( name );
 
-				}
-			}
-			catch( const std::exception &e )
+		try
+		{
+			if( attributesChanged && location->attributes() )
 			{
-				std::string name;
-				ScenePlug::pathToString( path, name );
-			
-				IECore::msg( IECore::Msg::Error, "InteractiveRender::update", name + ": " + e.what() );
+				EditBlock edit( m_renderer.get(), "attribute", parameters );
+				outputAttributes( location->attributes(), m_renderer.get() );
 			}
 
-			return s;
-		}
-
-	private:
-
-		const ScenePlug *m_scene;
-		const Context *m_context;
-		const bool m_update;
-};
-
-//////////////////////////////////////////////////////////////////////////
-// SceneGraphOutputFilter implementation
-//
-// This serial thread bound filter outputs scene data to a renderer on
-// the main thread, then discards that data to save memory. If the
-// editMode flag is set to true, the filter outputs edits, otherwise
-// it renders the data directly.
-//
-//////////////////////////////////////////////////////////////////////////
-
-class InteractiveRender::SceneGraphOutputFilter : public tbb::thread_bound_filter
-{
-	public:
-	
-		SceneGraphOutputFilter( Renderer *renderer, bool editMode ) :
-			tbb::thread_bound_filter( tbb::filter::serial_in_order ), 
-			m_renderer( renderer ),
-			m_attrBlockCounter( 0 ),
-			m_editMode( editMode )
-		{
-		}
-		
-		virtual ~SceneGraphOutputFilter()
-		{
-			// close pending attribute blocks:
-			while( m_attrBlockCounter )
+			if( transformChanged && location->visible() )
 			{
-				--m_attrBlockCounter;
-				m_renderer->attributeEnd();
+				EditBlock edit( m_renderer.get(), "transform", parameters );
+				m_renderer->setTransform( fullTransform );
 			}
-		}
-		
-		virtual void *operator()( void *item )
-		{
-			SceneGraph *s = (SceneGraph*)item;
-			ScenePlug::ScenePath path;
-			s->path( path );
-			
-			std::string name;
-			ScenePlug::pathToString( path, name );
-			
-			try
-			{
-				if( !m_editMode )
-				{
-					// outputting scene for the first time - do some attribute block tracking:
-					if( path.size() )
-					{
-						for( int i = m_previousPath.size(); i >= (int)path.size(); --i )
-						{
-							--m_attrBlockCounter;
-							m_renderer->attributeEnd();
-						}
-					}
-
-					m_previousPath = path;
-
-					++m_attrBlockCounter;
-					m_renderer->attributeBegin();
-
-					// set the name for this location:
-					m_renderer->setAttribute( "name", new StringData( name ) );
-
-				}
-
-				// transform:
-				if( !m_editMode )
-				{
-					m_renderer->concatTransform( s->m_transform );
-				}
 
-				// attributes:
-				if( s->m_attributes )
-				{
-					if( m_editMode )
-					{
-						CompoundDataMap parameters;
-						parameters["exactscopename"] = new StringData( name );
-						m_renderer->editBegin( "attribute", parameters );
-					}
-
-					outputAttributes( s->m_attributes.get(), m_renderer );
-					s->m_attributes = NULL;
-
-					if( m_editMode )
-					{
-						m_renderer->editEnd();
-					}
-
-				}
-
-				// object:
-				if( s->m_object && !m_editMode )
+			if( objectChanged && location->visible() )
+			{
+				if( const VisibleRenderable *renderable = runTimeCast<const VisibleRenderable>( location->object() ) )
 				{
-					if( const VisibleRenderable *renderable = runTimeCast< const VisibleRenderable >( s->m_object.get() ) )
-					{
-						renderable->render( m_renderer );
-					}
-					s->m_object = 0;
+					EditBlock edit( m_renderer.get(), "object", parameters );
+					renderable->render( m_renderer.get() );
 				}
 			}
-			catch( const std::exception &e )
-			{
-				IECore::msg( IECore::Msg::Error, "InteractiveRender::update", name + ": " + e.what() );
-			}
-
-			return NULL;
 		}
-		
-	private:
-		
-		Renderer *m_renderer;
-		ScenePlug::ScenePath m_previousPath;
-		int m_attrBlockCounter;
-		bool m_editMode;
-};
-
-void InteractiveRender::runPipeline(tbb::pipeline *p)
-{
-	// \todo: tune this number to find a balance between memory and speed once
-	// we have a load of production data:
-	
-	p->run( 2 * tbb::task_scheduler_init::default_num_threads() );
-}
+		catch( const std::exception &e )
+		{
+			IECore::msg( IECore::Msg::Error, "InteractiveRender::update", name + ": " + e.what() );
+		}
+	}
 
-void InteractiveRender::outputScene( bool update )
-{
-	
-	SceneGraphIteratorFilter iterator( m_sceneGraph.get() );
-
-	SceneGraphEvaluatorFilter evaluator(
-		inPlug(),
-		m_context.get(),
-		update // only recompute locations whose hashes have changed if true:
-	);
-
-	SceneGraphOutputFilter output( 
-		m_renderer.get(),
-		update // edit mode if true
-	);
-
-	tbb::pipeline p;
-	p.add_filter( iterator );
-	p.add_filter( evaluator );
-	p.add_filter( output );
-
-	 // Another thread initiates execution of the pipeline
-	std::thread pipelineThread( runPipeline, &p );
-
-	// Process the SceneGraphOutputFilter with the current thread:
-	while( output.process_item() != tbb::thread_bound_filter::end_of_stream )
+	// We can't add or remove locations via edits, so if the children have
+	// been replaced since the last full output, we can't know which of them
+	// the renderer has seen, and must leave them alone until the render is
+	// restarted.
+	if( location->changes( m_outputGeneration ) & SceneMirror::ChildNamesDirty )
 	{
-		continue;
+		return;
+	}
+
+	const SceneMirror::Location::Children &children = location->children();
+	for( SceneMirror::Location::Children::const_iterator it = children.begin(), eIt = children.end(); it != eIt; ++it )
+	{
+		outputEdits( *it, fullTransform, transformChanged, attributesGeneration, transformsGeneration, objectsGeneration );
 	}
-	pipelineThread.join();
-	
 }
 
 void InteractiveRender::update()
@@ -898,18 +469,18 @@ void InteractiveRender::update()
 			outputCoordinateSystems( inPlug(), globals.get(), m_renderer.get() );
 			outputLightsInternal( globals.get(), /* editing = */ false );
 			
-			// build the scene graph structure in parallel:
-			m_sceneGraph.reset( new SceneGraph );
-			SceneGraphBuildTask *task = new( tbb::task::allocate_root() ) SceneGraphBuildTask( inPlug(), m_context.get(), m_sceneGraph.get(), ScenePlug::ScenePath() );
-			tbb::task::spawn_root_and_wait( *task );
-			
-			// output the scene for the first time:
+			// output the scene for the first time, using a mirror
+			// of our input plug. We mirror the plug itself rather than
+			// its source, so that the mirror follows any reconnections
+			// upstream. We need the whole scene:
+			m_sceneMirror = SceneMirror::acquire( inPlug(), m_context.get() );
+			m_sceneMirror->setExpansion( this, NULL );
 			outputScene( false );
 		}
 
 		m_scene = requiredScene;
 		m_state = Running;
-		m_lightsDirty = m_attributesDirty = m_camerasDirty = false;
+		m_lightsDirty = m_attributesDirty = m_transformsDirty = m_objectsDirty = m_camerasDirty = false;
 	}
 
 	// Make sure the paused/running state is as we want.
@@ -933,7 +504,7 @@ void InteractiveRender::update()
 	{
 		EditBlock edit( m_renderer.get(), "suspendrendering", CompoundDataMap() );
 		updateLights();
-		updateAttributes();
+		updateScene();
 		updateCameras();
 		updateCoordinateSystems();
 	}
@@ -1015,17 +586,23 @@ void InteractiveRender::outputLightsInternal( const IECore::CompoundObject *glob
 	}
 }
 
-void InteractiveRender::updateAttributes()
+void InteractiveRender::updateScene()
 {
-	if( !m_attributesDirty || !updateAttributesPlug()->getValue() )
+	const bool updateAttributes = m_attributesDirty && updateAttributesPlug()->getValue();
+	const bool updateTransforms = m_transformsDirty && updateTransformsPlug()->getValue();
+	const bool updateObjects = m_objectsDirty && updateObjectsPlug()->getValue();
+	if( !updateAttributes && !updateTransforms && !updateObjects )
 	{
 		return;
 	}
-	
-	// output the scene, updating locations whose hashes have changed since last time:
+
+	// output the scene in a single pass, sending edits for the
+	// locations whose hashes have changed since last time:
 	outputScene( true );
-	
-	m_attributesDirty = false;
+
+	m_attributesDirty = m_attributesDirty && !updateAttributes;
+	m_transformsDirty = m_transformsDirty && !updateTransforms;
+	m_objectsDirty = m_objectsDirty && !updateObjects;
 }
 
 void InteractiveRender::updateCameras()
@@ -1087,6 +664,11 @@ void InteractiveRender::stop()
 	m_scene = NULL;
 	m_state = Stopped;
 	m_lightHandles.clear();
-	m_attributesDirty = m_lightsDirty = m_camerasDirty = true;
-	m_sceneGraph.reset( (SceneGraph*)NULL );
+	m_attributesDirty = m_transformsDirty = m_objectsDirty = m_lightsDirty = m_camerasDirty = true;
+	if( m_sceneMirror )
+	{
+		m_sceneMirror->removeExpansion( this );
+		m_sceneMirror = NULL;
+	}
+	m_attributesGeneration = m_transformsGeneration = m_objectsGeneration = m_outputGeneration = 0;
 }
@@ -74,18 +74,12 @@ PathMatcher::Node::Node()
 }
 
 PathMatcher::Node::Node( const Node &other )
-	:	terminator( other.terminator )
+	:	terminator( other.terminator ), children( other.children )
 {
-	ChildMapIterator hint = children.begin();
-	for( ConstChildMapIterator it = other.children.begin(), eIt = other.children.end(); it != eIt; it++ )
-	{
-		hint = children.insert( hint, ChildMapValue( it->first, new Node( *(it->second) ) ) );
-	}
 }
 
 PathMatcher::Node::~Node()
 {
-	clearChildren();
 }
 
 inline PathMatcher::Node::ConstChildMapIterator PathMatcher::Node::wildcardsBegin() const
@@ -100,7 +94,7 @@ inline PathMatcher::Node *PathMatcher::Node::child( const Name &name )
 	ChildMapIterator it = children.find( name );
 	if( it != children.end() )
 	{
-		return it->second;
+		return it->second.get();
 	}
 	return NULL;
 }
@@ -110,13 +104,19 @@ inline const PathMatcher::Node *PathMatcher::Node::child( const Name &name ) con
 	ConstChildMapIterator it = children.find( name );
 	if( it != children.end() )
 	{
-		return it->second;
+		return it->second.get();
 	}
 	return NULL;
 }
 
 bool PathMatcher::Node::operator == ( const Node &other ) const
 {
+	if( this == &other )
+	{
+		// Shared subtrees are trivially equal.
+		return true;
+	}
+
 	if( terminator != other.terminator )
 	{
 		return false;
@@ -151,16 +151,11 @@ bool PathMatcher::Node::operator != ( const Node &other )
 bool PathMatcher::Node::clearChildren()
 {
 	const bool result = !children.empty();
-	ChildMap::iterator it, eIt;
-	for( it = children.begin(), eIt = children.end(); it != eIt; it++ )
-	{
-		delete it->second;
-	}
 	children.clear();
 	return result;
 }
 
-bool PathMatcher::Node::isEmpty()
+bool PathMatcher::Node::isEmpty() const
 {
 	return !terminator && children.empty();
 }
@@ -170,18 +165,18 @@ bool PathMatcher::Node::isEmpty()
 //////////////////////////////////////////////////////////////////////////
 
 PathMatcher::PathMatcher()
+	:	m_root( new Node )
 {
-	m_root = boost::shared_ptr<Node>( new Node );
 }
 
 PathMatcher::PathMatcher( const PathMatcher &other )
+	:	m_root( other.m_root )
 {
-	m_root = boost::shared_ptr<Node>( new Node( *(other.m_root) ) );
 }
 
 void PathMatcher::clear()
 {
-	m_root = boost::shared_ptr<Node>( new Node );
+	m_root = new Node;
 }
 
 bool PathMatcher::isEmpty() const
@@ -217,11 +212,11 @@ unsigned PathMatcher::match( const std::string &path ) const
 
 unsigned PathMatcher::match( const std::vector<IECore::InternedString> &path ) const
 {
-   Node *node = m_root.get();
-   if( !node )
-   {
-       return Filter::NoMatch;
-   }
+	const Node *node = m_root.get();
+	if( !node )
+	{
+		return Filter::NoMatch;
+	}
 
 	unsigned result = Filter::NoMatch;
 	matchWalk( node, path.begin(), path.end(), result );
@@ -275,7 +270,7 @@ void PathMatcher::matchWalk( const Node *node, const NameIterator &start, const
 	if( childIt != childItEnd )
 	{
 		NameIterator newStart = start + 1;
-		matchWalk( childIt->second, newStart, end, result );
+		matchWalk( childIt->second.get(), newStart, end, result );
 		// if we've found every kind of match then we can terminate early,
 		// but otherwise we need to keep going even though we may
 		// have found some of the match types already.
@@ -294,14 +289,14 @@ void PathMatcher::matchWalk( const Node *node, const NameIterator &start, const
 		if( childIt->first.name == g_ellipsis )
 		{
 			// store for use in next block.
-			ellipsis = childIt->second;
+			ellipsis = childIt->second.get();
 			continue;
 		}
 
 		NameIterator newStart = start + 1;
 		if( Gaffer::match( start->c_str(), childIt->first.name.c_str() ) )
 		{
-			matchWalk( childIt->second, newStart, end, result );
+			matchWalk( childIt->second.get(), newStart, end, result );
 			if( result == Filter::EveryMatch )
 			{
 				return;
@@ -348,22 +343,28 @@ bool PathMatcher::addPath( const std::vector<IECore::InternedString> &path )
 template<typename NameIterator>
 bool PathMatcher::addPath( const NameIterator &start, const NameIterator &end )
 {
-	Node *node = m_root.get();
+	// Avoid duplicating any shared nodes if
+	// the path is already present.
+	const Node *existing = find( start, end );
+	if( existing && existing->terminator )
+	{
+		return false;
+	}
+
+	Node *node = writableRoot();
 	for( NameIterator it = start; it != end; ++it )
 	{
 		const Name name( *it );
-		Node *nextNode = node->child( name );
-		if( !nextNode )
+		Node::ChildMapIterator childIt = node->children.find( name );
+		if( childIt == node->children.end() )
 		{
-			nextNode = new Node;
-			node->children.insert( Node::ChildMapValue( name, nextNode ) );
+			childIt = node->children.insert( Node::ChildMapValue( name, new Node ) ).first;
 		}
-		node = nextNode;
+		node = writableChild( childIt );
 	}
 
-	bool result = !node->terminator;
 	node->terminator = true;
-	return result;
+	return true;
 }
 
 bool PathMatcher::removePath( const std::string &path )
@@ -375,19 +376,48 @@ bool PathMatcher::removePath( const std::string &path )
 
 bool PathMatcher::removePath( const std::vector<IECore::InternedString> &path )
 {
+	const Node *existing = find( path.begin(), path.end() );
+	if( !existing || !existing->terminator )
+	{
+		return false;
+	}
+
 	bool result = false;
-	removeWalk( m_root.get(), path.begin(), path.end(), /* prune = */ false, result );
+	removeWalk( writableRoot(), path.begin(), path.end(), /* prune = */ false, result );
 	return result;
 }
 
 bool PathMatcher::addPaths( const PathMatcher &paths )
 {
-	return addPathsWalk( m_root.get(), paths.m_root.get() );
+	if( m_root == paths.m_root )
+	{
+		return false;
+	}
+	else if( isEmpty() )
+	{
+		// Just share the whole tree.
+		m_root = paths.m_root;
+		return !isEmpty();
+	}
+
+	NodePtr root = addPathsWalk( m_root.get(), paths.m_root.get(), m_root->refCount() == 1 );
+	if( !root )
+	{
+		return false;
+	}
+	m_root = root;
+	return true;
 }
 
 bool PathMatcher::removePaths( const PathMatcher &paths )
 {
-	return removePathsWalk( m_root.get(), paths.m_root.get() );
+	NodePtr root = removePathsWalk( m_root.get(), paths.m_root.get(), m_root->refCount() == 1 );
+	if( !root )
+	{
+		return false;
+	}
+	m_root = root;
+	return true;
 }
 
 bool PathMatcher::prune( const std::string &path )
@@ -399,8 +429,14 @@ bool PathMatcher::prune( const std::string &path )
 
 bool PathMatcher::prune( const std::vector<IECore::InternedString> &path )
 {
+	const Node *existing = find( path.begin(), path.end() );
+	if( !existing || existing->isEmpty() )
+	{
+		return false;
+	}
+
 	bool result = false;
-	removeWalk( m_root.get(), path.begin(), path.end(), /* prune = */ true, result );
+	removeWalk( writableRoot(), path.begin(), path.end(), /* prune = */ true, result );
 	return result;
 }
 
@@ -414,6 +450,39 @@ PathMatcher::RawIterator PathMatcher::end() const
 	return RawIterator( *this, true );
 }
 
+PathMatcher::Node *PathMatcher::writableRoot()
+{
+	if( m_root->refCount() > 1 )
+	{
+		m_root = new Node( *m_root );
+	}
+	return m_root.get();
+}
+
+PathMatcher::Node *PathMatcher::writableChild( Node::ChildMapIterator it )
+{
+	// Because the parent is writable, it is the only
+	// owner of its reference to the child. So if the
+	// child has any other references, they come from
+	// another tree.
+	if( it->second->refCount() > 1 )
+	{
+		it->second = new Node( *(it->second) );
+	}
+	return it->second.get();
+}
+
+template<typename NameIterator>
+const PathMatcher::Node *PathMatcher::find( const NameIterator &start, const NameIterator &end ) const
+{
+	const Node *node = m_root.get();
+	for( NameIterator it = start; it != end && node; ++it )
+	{
+		node = node->child( Name( *it ) );
+	}
+	return node;
+}
+
 template<typename NameIterator>
 void PathMatcher::removeWalk( Node *node, const NameIterator &start, const NameIterator &end, const bool prune, bool &removed )
 {
@@ -436,70 +505,103 @@ void PathMatcher::removeWalk( Node *node, const NameIterator &start, const NameI
 		return;
 	}
 
-	Node *childNode = childIt->second;
+	Node *childNode = writableChild( childIt );
 
 	NameIterator childStart = start; childStart++;
 	removeWalk( childNode, childStart, end, prune, removed );
 	if( childNode->isEmpty() )
 	{
-		delete childNode;
 		node->children.erase( childIt );
 	}
 }
 
-bool PathMatcher::addPathsWalk( Node *node, const Node *srcNode )
+PathMatcher::Node *PathMatcher::writable( Node *node, bool unique, NodePtr &result )
 {
-	bool result = false;
+	if( !result )
+	{
+		result = unique ? node : new Node( *node );
+	}
+	return result.get();
+}
+
+PathMatcher::NodePtr PathMatcher::addPathsWalk( Node *node, const Node *srcNode, bool unique )
+{
+	// The writable version of node, created
+	// lazily only when something changes.
+	NodePtr result;
+
 	if( !node->terminator && srcNode->terminator )
 	{
-		node->terminator = result = true;
+		writable( node, unique, result )->terminator = true;
 	}
 
-	for( Node::ChildMap::const_iterator it = srcNode->children.begin(), eIt = srcNode->children.end(); it != eIt; ++it )
+	for( Node::ConstChildMapIterator it = srcNode->children.begin(), eIt = srcNode->children.end(); it != eIt; ++it )
 	{
-		const Node *srcChild = it->second;
-		if( Node *child = node->child( it->first ) )
+		Node::ConstChildMapIterator childIt = node->children.find( it->first );
+		if( childIt == node->children.end() )
 		{
-			// result must be on right of ||, to avoid short-circuiting addPathsWalk().
-			result = addPathsWalk( child, srcChild ) || result;
+			// Share the source subtree rather than copying it.
+			writable( node, unique, result )->children.insert( *it );
 		}
-		else
+		else if( childIt->second != it->second )
 		{
-			node->children.insert( Node::ChildMapValue( it->first, new Node( *srcChild ) ) );
-			result = true; // source node can only exist if it or a descendant is a terminator
+			NodePtr child = addPathsWalk( childIt->second.get(), it->second.get(), unique && childIt->second->refCount() == 1 );
+			if( child && child != childIt->second )
+			{
+				writable( node, unique, result )->children[it->first] = child;
+			}
+			else if( child )
+			{
+				// Modified in place.
+				writable( node, unique, result );
+			}
 		}
 	}
 
 	return result;
 }
 
-bool PathMatcher::removePathsWalk( Node *node, const Node *srcNode )
+PathMatcher::NodePtr PathMatcher::removePathsWalk( Node *node, const Node *srcNode, bool unique )
 {
-	bool result = false;
+	if( node == srcNode )
+	{
+		// Everything is removed.
+		return node->isEmpty() ? NULL : new Node;
+	}
+
+	// The writable version of node, created
+	// lazily only when something changes.
+	NodePtr result;
+
 	if( node->terminator && srcNode->terminator )
 	{
-		node->terminator = false;
-		result = true;
+		writable( node, unique, result )->terminator = false;
 	}
 
-	for( Node::ChildMap::const_iterator it = srcNode->children.begin(), eIt = srcNode->children.end(); it != eIt; ++it )
+	for( Node::ConstChildMapIterator it = srcNode->children.begin(), eIt = srcNode->children.end(); it != eIt; ++it )
 	{
-		const Node::ChildMapIterator childIt = node->children.find( it->first );
-		if( childIt != node->children.end() )
+		Node::ConstChildMapIterator childIt = node->children.find( it->first );
+		if( childIt == node->children.end() )
 		{
-			Node *child = childIt->second;
-			if( removePathsWalk( child, it->second ) )
-			{
-				result = true;
-				if( child->isEmpty() )
-				{
-					node->children.erase( childIt );
-					delete child;
-				}
-			}
+			continue;
+		}
+
+		NodePtr child = removePathsWalk( childIt->second.get(), it->second.get(), unique && childIt->second->refCount() == 1 );
+		if( !child )
+		{
+			continue;
+		}
+
+		Node *w = writable( node, unique, result );
+		if( child->isEmpty() )
+		{
+			w->children.erase( it->first );
+		}
+		else
+		{
+			w->children[it->first] = child;
 		}
 	}
 
 	return result;
 }
-
@@ -32,8 +32,6 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
-#include "IECore/MessageHandler.h"
-
 #include "GafferScene/PathMatcherData.h"
 #include "IECore/TypedData.inl"
 
@@ -89,18 +87,40 @@ namespace IECore
 
 IECORE_RUNTIMETYPED_DEFINETEMPLATESPECIALISATION( IECore::PathMatcherData, GafferScene::PathMatcherDataTypeId )
 
+static const IndexedIO::EntryID g_pathsEntry( "paths" );
+
 template<>
 void PathMatcherData::save( SaveContext *context ) const
 {
 	Data::save( context );
-	msg( Msg::Warning, "PathMatcherData::save", "Not implemented" );
+
+	std::vector<std::string> paths;
+	readable().paths( paths );
+
+	IndexedIO *container = context->rawContainer();
+	if( paths.size() )
+	{
+		container->write( g_pathsEntry, &paths[0], paths.size() );
+	}
 }
 
 template<>
 void PathMatcherData::load( LoadContextPtr context )
 {
 	Data::load( context );
-	msg( Msg::Warning, "PathMatcherData::load", "Not implemented" );
+
+	const IndexedIO *container = context->rawContainer();
+	if( !container->hasEntry( g_pathsEntry ) )
+	{
+		// Empty matcher.
+		writable().clear();
+		return;
+	}
+
+	std::vector<std::string> paths( container->entry( g_pathsEntry ).arrayLength() );
+	std::string *p = &paths[0];
+	container->read( g_pathsEntry, p, paths.size() );
+	writable().init( paths.begin(), paths.end() );
 }
 
 // Our hash is complicated by the fact that PathMatcher::Iterator doesn't
@@ -34,9 +34,18 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include "tbb/pipeline.h"
+#include "tbb/tbb_thread.h"
+#include "tbb/task_scheduler_init.h"
+#include "tbb/task_arena.h"
+#include "tbb/concurrent_queue.h"
+
 #include "boost/filesystem.hpp"
+#include "boost/scoped_ptr.hpp"
 #include "boost/algorithm/string/predicate.hpp"
 
+#include "OpenEXR/ImathFun.h"
+
 #include "IECore/PreWorldRenderable.h"
 #include "IECore/Camera.h"
 #include "IECore/WorldBlock.h"
@@ -46,11 +55,13 @@
 #include "IECore/TransformBlock.h"
 #include "IECore/CoordinateSystem.h"
 #include "IECore/ClippingPlane.h"
+#include "IECore/MotionBlock.h"
+#include "IECore/Primitive.h"
+#include "IECore/MessageHandler.h"
 
 #include "Gaffer/Context.h"
 
 #include "GafferScene/RendererAlgo.h"
-#include "GafferScene/SceneProcedural.h"
 #include "GafferScene/PathMatcherData.h"
 #include "GafferScene/SceneAlgo.h"
 
@@ -59,6 +70,550 @@ using namespace Imath;
 using namespace IECore;
 using namespace Gaffer;
 
+//////////////////////////////////////////////////////////////////////////
+// WorldOutput implementation
+//
+// Outputs the body of the world by performing our own parallel traversal
+// of the scene, rather than relying on a hierarchy of SceneProcedurals
+// being expanded by the renderer. The traversal is a three stage
+// tbb::parallel_pipeline :
+//
+// - Generate : serially walks the hierarchy depth first, evaluating
+//   the attributes and child names needed to decide which locations
+//   are visible and what to visit next.
+// - Evaluate : computes the transform and object samples for each
+//   location in parallel. This is where the bulk of the work is.
+// - Enqueue : serially passes the evaluated locations, in their
+//   original order, to a bounded queue.
+//
+// The pipeline is run from a dedicated thread, within a tbb::task_arena
+// which bounds the number of threads it uses. Meanwhile the thread that
+// called output() pops locations from the queue and emits them to the
+// renderer, so the renderer is only ever called from that one thread.
+// Because the pipeline has a thread of its own, the traversal progresses
+// even when no TBB worker threads are available to help with it.
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+struct BlurAttributes
+{
+
+	BlurAttributes()
+		:	transformBlur( true ), transformBlurSegments( 1 ), deformationBlur( true ), deformationBlurSegments( 1 )
+	{
+	}
+
+	void update( const CompoundObject *attributes, const std::string &prefix )
+	{
+		if( const BoolData *transformBlurData = attributes->member<BoolData>( prefix + "gaffer:transformBlur" ) )
+		{
+			transformBlur = transformBlurData->readable();
+		}
+
+		if( const IntData *transformBlurSegmentsData = attributes->member<IntData>( prefix + "gaffer:transformBlurSegments" ) )
+		{
+			transformBlurSegments = transformBlurSegmentsData->readable();
+		}
+
+		if( const BoolData *deformationBlurData = attributes->member<BoolData>( prefix + "gaffer:deformationBlur" ) )
+		{
+			deformationBlur = deformationBlurData->readable();
+		}
+
+		if( const IntData *deformationBlurSegmentsData = attributes->member<IntData>( prefix + "gaffer:deformationBlurSegments" ) )
+		{
+			deformationBlurSegments = deformationBlurSegmentsData->readable();
+		}
+	}
+
+	bool transformBlur;
+	int transformBlurSegments;
+	bool deformationBlur;
+	int deformationBlurSegments;
+
+};
+
+// Everything needed to emit a single location to the renderer.
+struct Location
+{
+
+	ScenePlug::ScenePath path;
+	ConstCompoundObjectPtr attributes;
+	BlurAttributes blurAttributes;
+
+	std::set<float> transformTimes;
+	std::vector<M44f> transforms;
+
+	std::set<float> deformationTimes;
+	std::vector<ConstObjectPtr> objects;
+
+};
+
+class WorldOutput
+{
+
+	public :
+
+		WorldOutput( const ScenePlug *scene, const CompoundObject *globals, Renderer *renderer )
+			:	m_scene( scene ), m_renderer( renderer ), m_context( new Context( *Context::current() ) ), m_rootVisited( false )
+		{
+			m_cancelled = false;
+			m_failed = false;
+
+			const BoolData *transformBlurData = globals->member<BoolData>( "option:render:transformBlur" );
+			m_transformBlur = transformBlurData ? transformBlurData->readable() : false;
+
+			const BoolData *deformationBlurData = globals->member<BoolData>( "option:render:deformationBlur" );
+			m_deformationBlur = deformationBlurData ? deformationBlurData->readable() : false;
+
+			const V2fData *shutterData = globals->member<V2fData>( "option:render:shutter" );
+			m_shutter = shutterData ? shutterData->readable() : V2f( -0.25, 0.25 );
+			m_shutter += V2f( m_context->getFrame() );
+
+			m_globalBlurAttributes.update( globals, "attribute:" );
+
+			const IntData *threadsData = globals->member<IntData>( "option:render:translationThreads" );
+			m_threads = threadsData ? threadsData->readable() : 0;
+			if( m_threads <= 0 )
+			{
+				m_threads = tbb::task_scheduler_init::default_num_threads();
+			}
+
+			m_queue.set_capacity( m_threads * 4 );
+		}
+
+		void output()
+		{
+			tbb::tbb_thread pipelineThread( RunPipeline( this ) );
+
+			try
+			{
+				while( true )
+				{
+					Location *l;
+					m_queue.pop( l );
+					if( !l )
+					{
+						break;
+					}
+					boost::scoped_ptr<Location> location( l );
+					emit( *location );
+				}
+			}
+			catch( ... )
+			{
+				// Stop the pipeline, and drain the queue so that
+				// it can't block waiting for us.
+				m_cancelled = true;
+				Location *l;
+				do
+				{
+					m_queue.pop( l );
+					delete l;
+				} while( l );
+				pipelineThread.join();
+				throw;
+			}
+
+			pipelineThread.join();
+			if( m_failed )
+			{
+				throw IECore::Exception( m_error );
+			}
+
+			while( m_openDepths.size() )
+			{
+				m_renderer->attributeEnd();
+				m_openDepths.pop_back();
+			}
+		}
+
+	private :
+
+		// Pipeline stages
+		// ===============
+
+		class Generate
+		{
+
+			public :
+
+				Generate( WorldOutput *worldOutput )
+					:	m_worldOutput( worldOutput )
+				{
+				}
+
+				Location *operator()( tbb::flow_control &flowControl ) const
+				{
+					return m_worldOutput->generate( flowControl );
+				}
+
+			private :
+
+				WorldOutput *m_worldOutput;
+
+		};
+
+		class Evaluate
+		{
+
+			public :
+
+				Evaluate( const WorldOutput *worldOutput )
+					:	m_worldOutput( worldOutput )
+				{
+				}
+
+				Location *operator()( Location *location ) const
+				{
+					m_worldOutput->evaluate( location );
+					return location;
+				}
+
+			private :
+
+				const WorldOutput *m_worldOutput;
+
+		};
+
+		class Enqueue
+		{
+
+			public :
+
+				Enqueue( WorldOutput *worldOutput )
+					:	m_worldOutput( worldOutput )
+				{
+				}
+
+				void operator()( Location *location ) const
+				{
+					m_worldOutput->m_queue.push( location );
+				}
+
+			private :
+
+				WorldOutput *m_worldOutput;
+
+		};
+
+		// Entry point for the dedicated pipeline thread. The arena bounds the
+		// concurrency of the pipeline, with our thread occupying one of its
+		// slots, so it runs entirely on our thread if no workers are available.
+		class RunPipeline
+		{
+
+			public :
+
+				RunPipeline( WorldOutput *worldOutput )
+					:	m_worldOutput( worldOutput )
+				{
+				}
+
+				void operator()() const
+				{
+					tbb::task_arena arena( m_worldOutput->m_threads );
+					RunPipelineInArena f( m_worldOutput );
+					arena.execute( f );
+				}
+
+			private :
+
+				WorldOutput *m_worldOutput;
+
+		};
+
+		// Runs the pipeline, capturing any exception so that output()
+		// can rethrow it on the calling thread.
+		class RunPipelineInArena
+		{
+
+			public :
+
+				RunPipelineInArena( WorldOutput *worldOutput )
+					:	m_worldOutput( worldOutput )
+				{
+				}
+
+				void operator()() const
+				{
+					try
+					{
+						tbb::parallel_pipeline(
+							m_worldOutput->m_threads * 4,
+							tbb::make_filter<void, Location *>( tbb::filter::serial_in_order, Generate( m_worldOutput ) ) &
+							tbb::make_filter<Location *, Location *>( tbb::filter::parallel, Evaluate( m_worldOutput ) ) &
+							tbb::make_filter<Location *, void>( tbb::filter::serial_in_order, Enqueue( m_worldOutput ) )
+						);
+					}
+					catch( const std::exception &e )
+					{
+						m_worldOutput->m_failed = true;
+						m_worldOutput->m_error = e.what();
+					}
+					catch( ... )
+					{
+						m_worldOutput->m_failed = true;
+						m_worldOutput->m_error = "Unknown error";
+					}
+					// Signal the end of the traversal.
+					m_worldOutput->m_queue.push( NULL );
+				}
+
+			private :
+
+				WorldOutput *m_worldOutput;
+
+		};
+
+		// Called serially by the Generate stage.
+		Location *generate( tbb::flow_control &flowControl )
+		{
+			while( !m_cancelled )
+			{
+				ScenePlug::ScenePath path;
+				BlurAttributes blurAttributes;
+				if( m_stack.empty() )
+				{
+					if( m_rootVisited )
+					{
+						break;
+					}
+					m_rootVisited = true;
+					blurAttributes = m_globalBlurAttributes;
+				}
+				else
+				{
+					StackEntry &parent = m_stack.back();
+					const std::vector<InternedString> &childNames = parent.childNames->readable();
+					if( parent.nextChild == childNames.size() )
+					{
+						m_stack.pop_back();
+						continue;
+					}
+					path = parent.path;
+					path.push_back( childNames[parent.nextChild++] );
+					blurAttributes = parent.blurAttributes;
+				}
+
+				if( Location *location = visit( path, blurAttributes ) )
+				{
+					return location;
+				}
+			}
+
+			flowControl.stop();
+			return NULL;
+		}
+
+		// Returns a new Location if the path is visible, pushing
+		// its children onto the stack for subsequent visiting.
+		Location *visit( const ScenePlug::ScenePath &path, const BlurAttributes &parentBlurAttributes )
+		{
+			try
+			{
+				ContextPtr context = locationContext( path );
+				Context::Scope scopedContext( context.get() );
+
+				ConstCompoundObjectPtr attributes = m_scene->attributesPlug()->getValue();
+				const BoolData *visibilityData = attributes->member<BoolData>( "scene:visible" );
+				if( visibilityData && !visibilityData->readable() )
+				{
+					return NULL;
+				}
+
+				ConstInternedStringVectorDataPtr childNames = m_scene->childNamesPlug()->getValue();
+
+				Location *location = new Location;
+				location->path = path;
+				location->attributes = attributes;
+				location->blurAttributes = parentBlurAttributes;
+				location->blurAttributes.update( attributes.get(), "" );
+
+				if( childNames->readable().size() )
+				{
+					m_stack.push_back( StackEntry( path, childNames, location->blurAttributes ) );
+				}
+
+				return location;
+			}
+			catch( const std::exception &e )
+			{
+				std::string name;
+				ScenePlug::pathToString( path, name );
+				IECore::msg( IECore::Msg::Error, "outputWorld " + name, e.what() );
+				return NULL;
+			}
+		}
+
+		// Called concurrently by the Evaluate stage.
+		void evaluate( Location *location ) const
+		{
+			try
+			{
+				ContextPtr context = locationContext( location->path );
+				Context::Scope scopedContext( context.get() );
+
+				const BlurAttributes &blurAttributes = location->blurAttributes;
+
+				motionTimes( ( m_transformBlur && blurAttributes.transformBlur ) ? blurAttributes.transformBlurSegments : 0, location->transformTimes );
+				for( std::set<float>::const_iterator it = location->transformTimes.begin(), eIt = location->transformTimes.end(); it != eIt; ++it )
+				{
+					context->setFrame( *it );
+					location->transforms.push_back( m_scene->transformPlug()->getValue() );
+				}
+
+				motionTimes( ( m_deformationBlur && blurAttributes.deformationBlur ) ? blurAttributes.deformationBlurSegments : 0, location->deformationTimes );
+				for( std::set<float>::const_iterator it = location->deformationTimes.begin(), eIt = location->deformationTimes.end(); it != eIt; ++it )
+				{
+					context->setFrame( *it );
+					ConstObjectPtr object = m_scene->objectPlug()->getValue();
+					if( !runTimeCast<const Primitive>( object.get() ) )
+					{
+						// Only primitives can be motion blurred, so we output
+						// a single sample and don't evaluate any further ones.
+						if( location->objects.empty() )
+						{
+							location->objects.push_back( object );
+						}
+						location->objects.resize( 1 );
+						break;
+					}
+					location->objects.push_back( object );
+				}
+			}
+			catch( const std::exception &e )
+			{
+				location->transforms.clear();
+				location->objects.clear();
+				std::string name;
+				ScenePlug::pathToString( location->path, name );
+				IECore::msg( IECore::Msg::Error, "outputWorld " + name, e.what() );
+			}
+		}
+
+		// Called by the thread which called output().
+		void emit( const Location &location )
+		{
+			// Close the blocks of any locations which aren't
+			// ancestors of this one.
+			const size_t depth = location.path.size();
+			while( m_openDepths.size() && m_openDepths.back() >= depth )
+			{
+				m_renderer->attributeEnd();
+				m_openDepths.pop_back();
+			}
+
+			m_renderer->attributeBegin();
+			m_openDepths.push_back( depth );
+
+			std::string name;
+			ScenePlug::pathToString( location.path, name );
+			m_renderer->setAttribute( "name", new StringData( name ) );
+
+			// transform
+
+			if( location.transforms.size() )
+			{
+				MotionBlock motionBlock( m_renderer, location.transformTimes, location.transforms.size() > 1 );
+				for( std::vector<M44f>::const_iterator it = location.transforms.begin(), eIt = location.transforms.end(); it != eIt; ++it )
+				{
+					m_renderer->concatTransform( *it );
+				}
+			}
+
+			// attributes
+
+			outputAttributes( location.attributes.get(), m_renderer );
+
+			// object
+
+			if( location.objects.size() > 1 )
+			{
+				// Evaluate guarantees these are all primitives.
+				MotionBlock motionBlock( m_renderer, location.deformationTimes );
+				for( std::vector<ConstObjectPtr>::const_iterator it = location.objects.begin(), eIt = location.objects.end(); it != eIt; ++it )
+				{
+					static_cast<const Primitive *>( it->get() )->render( m_renderer );
+				}
+			}
+			else if( location.objects.size() )
+			{
+				if( const VisibleRenderable *renderable = runTimeCast<const VisibleRenderable>( location.objects[0].get() ) )
+				{
+					renderable->render( m_renderer );
+				}
+			}
+		}
+
+		ContextPtr locationContext( const ScenePlug::ScenePath &path ) const
+		{
+			ContextPtr result = new Context( *m_context, Context::Borrowed );
+			result->set( ScenePlug::scenePathContextName, path );
+			return result;
+		}
+
+		void motionTimes( unsigned segments, std::set<float> &times ) const
+		{
+			if( !segments )
+			{
+				times.insert( m_context->getFrame() );
+			}
+			else
+			{
+				for( unsigned i = 0; i<segments + 1; i++ )
+				{
+					times.insert( lerp( m_shutter[0], m_shutter[1], (float)i / (float)segments ) );
+				}
+			}
+		}
+
+		struct StackEntry
+		{
+
+			StackEntry( const ScenePlug::ScenePath &path, ConstInternedStringVectorDataPtr childNames, const BlurAttributes &blurAttributes )
+				:	path( path ), childNames( childNames ), nextChild( 0 ), blurAttributes( blurAttributes )
+			{
+			}
+
+			ScenePlug::ScenePath path;
+			ConstInternedStringVectorDataPtr childNames;
+			size_t nextChild;
+			BlurAttributes blurAttributes;
+
+		};
+
+		const ScenePlug *m_scene;
+		Renderer *m_renderer;
+		ConstContextPtr m_context;
+
+		bool m_transformBlur;
+		bool m_deformationBlur;
+		V2f m_shutter;
+		BlurAttributes m_globalBlurAttributes;
+		int m_threads;
+
+		// Used only by Generate.
+		std::vector<StackEntry> m_stack;
+		bool m_rootVisited;
+
+		tbb::concurrent_bounded_queue<Location *> m_queue;
+		tbb::atomic<bool> m_cancelled;
+
+		// Written by the pipeline thread, and read by output()
+		// only after that thread has been joined.
+		bool m_failed;
+		std::string m_error;
+
+		// Used only by emit().
+		std::vector<size_t> m_openDepths;
+
+};
+
+} // namespace
+
 namespace GafferScene
 {
 
@@ -75,11 +630,16 @@ void outputScene( const ScenePlug *scene, IECore::Renderer *renderer )
 		outputCoordinateSystems( scene, globals.get(), renderer );
 		outputLights( scene, globals.get(), renderer );
 
-		SceneProceduralPtr proc = new SceneProcedural( scene, Context::current() );
-		renderer->procedural( proc );
+		outputWorld( scene, globals.get(), renderer );
 	}
 }
 
+void outputWorld( const ScenePlug *scene, const IECore::CompoundObject *globals, IECore::Renderer *renderer )
+{
+	WorldOutput worldOutput( scene, globals, renderer );
+	worldOutput.output();
+}
+
 void outputOutputs( const IECore::CompoundObject *globals, IECore::Renderer *renderer )
 {
 	CompoundObject::ObjectMap::const_iterator it, eIt;
@@ -0,0 +1,535 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2015, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "tbb/task.h"
+#include "tbb/mutex.h"
+
+#include "IECore/SimpleTypedData.h"
+
+#include "GafferScene/SceneMirror.h"
+
+using namespace std;
+using namespace Imath;
+using namespace IECore;
+using namespace Gaffer;
+using namespace GafferScene;
+
+//////////////////////////////////////////////////////////////////////////
+// Registry of live mirrors
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+typedef std::pair<const ScenePlug *, const Context *> MirrorKey;
+typedef std::map<MirrorKey, SceneMirror *> MirrorMap;
+
+MirrorMap &mirrors()
+{
+	static MirrorMap m;
+	return m;
+}
+
+tbb::mutex g_mirrorsMutex;
+
+const size_t g_numComponents = 5;
+
+size_t componentIndex( unsigned dirtyFlag )
+{
+	switch( dirtyFlag )
+	{
+		case SceneMirror::BoundDirty :
+			return 0;
+		case SceneMirror::TransformDirty :
+			return 1;
+		case SceneMirror::AttributesDirty :
+			return 2;
+		case SceneMirror::ObjectDirty :
+			return 3;
+		default :
+			return 4;
+	}
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// Location implementation
+//////////////////////////////////////////////////////////////////////////
+
+SceneMirror::Location::Location( const IECore::InternedString &name, const Location *parent, size_t generation )
+	:	m_name( name ), m_parent( parent ), m_visible( true ), m_expanded( false ), m_hasChildren( false )
+{
+	for( size_t i = 0; i < g_numComponents; ++i )
+	{
+		m_generations[i] = generation;
+	}
+}
+
+SceneMirror::Location::~Location()
+{
+	clearChildren();
+}
+
+const IECore::InternedString &SceneMirror::Location::name() const
+{
+	return m_name;
+}
+
+const SceneMirror::Location *SceneMirror::Location::parent() const
+{
+	return m_parent;
+}
+
+void SceneMirror::Location::path( ScenePlug::ScenePath &path ) const
+{
+	if( !m_parent )
+	{
+		return;
+	}
+	m_parent->path( path );
+	path.push_back( m_name );
+}
+
+bool SceneMirror::Location::visible() const
+{
+	return m_visible;
+}
+
+bool SceneMirror::Location::expanded() const
+{
+	return m_expanded;
+}
+
+bool SceneMirror::Location::hasChildren() const
+{
+	return m_hasChildren;
+}
+
+const IECore::CompoundObject *SceneMirror::Location::attributes() const
+{
+	return m_attributes.get();
+}
+
+const Imath::M44f &SceneMirror::Location::transform() const
+{
+	return m_transform;
+}
+
+const IECore::Object *SceneMirror::Location::object() const
+{
+	return m_object.get();
+}
+
+const Imath::Box3f &SceneMirror::Location::bound() const
+{
+	return m_bound;
+}
+
+const SceneMirror::Location::Children &SceneMirror::Location::children() const
+{
+	return m_children;
+}
+
+unsigned SceneMirror::Location::changes( size_t sinceGeneration ) const
+{
+	unsigned result = NothingDirty;
+	for( size_t i = 0; i < g_numComponents; ++i )
+	{
+		if( m_generations[i] > sinceGeneration )
+		{
+			result |= 1 << i;
+		}
+	}
+	return result;
+}
+
+void SceneMirror::Location::clearChildren()
+{
+	for( Children::const_iterator it = m_children.begin(), eIt = m_children.end(); it != eIt; ++it )
+	{
+		delete *it;
+	}
+	m_children.clear();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// UpdateTask implementation
+//
+// Recurses through the hierarchy in parallel, reevaluating only the dirty
+// components whose hashes have changed. This is the same scheme that
+// SceneGadget used before it became a client of the SceneMirror.
+//////////////////////////////////////////////////////////////////////////
+
+class SceneMirror::UpdateTask : public tbb::task
+{
+
+	public :
+
+		UpdateTask( const SceneMirror *mirror, Location *location, unsigned dirtyFlags, const ScenePlug::ScenePath &scenePath )
+			:	m_mirror( mirror ),
+				m_location( location ),
+				m_dirtyFlags( dirtyFlags ),
+				m_scenePath( scenePath )
+		{
+		}
+
+		virtual task *execute()
+		{
+			const ScenePlug *scene = m_mirror->m_scene.get();
+			const size_t generation = m_mirror->m_generation;
+
+			ContextPtr context = new Context( *m_mirror->m_context, Context::Borrowed );
+			context->set( ScenePlug::scenePathContextName, m_scenePath );
+			Context::Scope scopedContext( context.get() );
+
+			// Update attributes, and compute visibility.
+
+			const bool previouslyVisible = m_location->m_visible;
+			if( m_dirtyFlags & AttributesDirty )
+			{
+				const IECore::MurmurHash attributesHash = scene->attributesPlug()->hash();
+				if( attributesHash != m_location->m_attributesHash )
+				{
+					m_location->m_attributes = scene->attributesPlug()->getValue( &attributesHash );
+					const BoolData *visibilityData = m_location->m_attributes->member<BoolData>( "scene:visible" );
+					m_location->m_visible = visibilityData ? visibilityData->readable() : true;
+					m_location->m_attributesHash = attributesHash;
+					changed( AttributesDirty, generation );
+				}
+			}
+
+			if( !m_location->m_visible )
+			{
+				// No need to update further since we're not visible.
+				if( m_location->m_children.size() )
+				{
+					m_location->clearChildren();
+					changed( ChildNamesDirty, generation );
+				}
+				m_location->m_childNamesHash = IECore::MurmurHash();
+				m_location->m_expanded = false;
+				return NULL;
+			}
+			else if( !previouslyVisible )
+			{
+				// We didn't perform any updates when we were invisible,
+				// so we need to update everything now.
+				m_dirtyFlags = AllDirty;
+			}
+
+			// Update the object and transform
+
+			if( m_dirtyFlags & ObjectDirty )
+			{
+				const IECore::MurmurHash objectHash = scene->objectPlug()->hash();
+				if( objectHash != m_location->m_objectHash )
+				{
+					m_location->m_object = scene->objectPlug()->getValue( &objectHash );
+					m_location->m_objectHash = objectHash;
+					changed( ObjectDirty, generation );
+				}
+			}
+
+			if( m_dirtyFlags & TransformDirty )
+			{
+				const IECore::MurmurHash transformHash = scene->transformPlug()->hash();
+				if( transformHash != m_location->m_transformHash )
+				{
+					m_location->m_transform = scene->transformPlug()->getValue( &transformHash );
+					m_location->m_transformHash = transformHash;
+					changed( TransformDirty, generation );
+				}
+			}
+
+			// Update the expansion state
+
+			const bool previouslyExpanded = m_location->m_expanded;
+			if( m_dirtyFlags & ExpansionDirty )
+			{
+				m_location->m_expanded = m_mirror->expanded( m_scenePath );
+			}
+
+			if( m_dirtyFlags & ChildNamesDirty || previouslyExpanded != m_location->m_expanded )
+			{
+				const IECore::MurmurHash childNamesHash = scene->childNamesPlug()->hash();
+				if( childNamesHash != m_location->m_childNamesHash || previouslyExpanded != m_location->m_expanded )
+				{
+					ConstInternedStringVectorDataPtr childNamesData = scene->childNamesPlug()->getValue( &childNamesHash );
+					const std::vector<InternedString> &childNames = childNamesData->readable();
+					m_location->m_hasChildren = childNames.size();
+					m_location->m_childNamesHash = childNamesHash;
+
+					if( !m_location->m_expanded )
+					{
+						if( m_location->m_children.size() )
+						{
+							m_location->clearChildren();
+							changed( ChildNamesDirty, generation );
+						}
+					}
+					else if( !existingChildNamesValid( childNames ) )
+					{
+						m_location->clearChildren();
+						for( std::vector<InternedString>::const_iterator it = childNames.begin(), eIt = childNames.end(); it != eIt; ++it )
+						{
+							m_location->m_children.push_back( new Location( *it, m_location, generation ) );
+						}
+						changed( ChildNamesDirty, generation );
+						m_dirtyFlags = AllDirty; // We've made brand new children, so they need a full update.
+					}
+				}
+			}
+
+			if( !m_location->m_expanded )
+			{
+				// We're not expanded, so we early out before updating the children,
+				// tracking the bound instead so that clients can draw a proxy for them.
+				if( m_dirtyFlags & BoundDirty || previouslyExpanded )
+				{
+					const IECore::MurmurHash boundHash = scene->boundPlug()->hash();
+					if( boundHash != m_location->m_boundHash )
+					{
+						m_location->m_bound = scene->boundPlug()->getValue( &boundHash );
+						m_location->m_boundHash = boundHash;
+						changed( BoundDirty, generation );
+					}
+				}
+				return NULL;
+			}
+
+			// We are expanded, so we need to visit all the children
+			// and update those too.
+
+			m_location->m_boundHash = IECore::MurmurHash();
+			if( !previouslyExpanded )
+			{
+				m_dirtyFlags = AllDirty;
+			}
+
+			if( m_location->m_children.size() )
+			{
+				set_ref_count( 1 + m_location->m_children.size() );
+
+				ScenePlug::ScenePath childPath = m_scenePath;
+				childPath.push_back( IECore::InternedString() ); // space for the child name
+				for( Location::Children::const_iterator it = m_location->m_children.begin(), eIt = m_location->m_children.end(); it != eIt; ++it )
+				{
+					childPath.back() = (*it)->m_name;
+					UpdateTask *t = new( allocate_child() ) UpdateTask( m_mirror, *it, m_dirtyFlags, childPath );
+					spawn( *t );
+				}
+
+				wait_for_all();
+			}
+
+			return NULL;
+		}
+
+	private :
+
+		void changed( unsigned dirtyFlag, size_t generation )
+		{
+			m_location->m_generations[componentIndex( dirtyFlag )] = generation;
+		}
+
+		bool existingChildNamesValid( const vector<IECore::InternedString> &childNames ) const
+		{
+			if( m_location->m_children.size() != childNames.size() )
+			{
+				return false;
+			}
+			for( size_t i = 0, e = childNames.size(); i < e; ++i )
+			{
+				if( m_location->m_children[i]->m_name != childNames[i] )
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		const SceneMirror *m_mirror;
+		Location *m_location;
+		unsigned m_dirtyFlags;
+		ScenePlug::ScenePath m_scenePath;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+// SceneMirror implementation
+//////////////////////////////////////////////////////////////////////////
+
+SceneMirror::SceneMirror( const ScenePlug *scene, const Gaffer::Context *context )
+	:	m_scene( scene ), m_context( context ), m_dirtyFlags( AllDirty ), m_generation( 0 ), m_root( new Location( InternedString(), NULL, 0 ) )
+{
+}
+
+SceneMirror::~SceneMirror()
+{
+	delete m_root;
+}
+
+SceneMirrorPtr SceneMirror::acquire( const ScenePlug *scene, const Gaffer::Context *context )
+{
+	tbb::mutex::scoped_lock lock( g_mirrorsMutex );
+	SceneMirror *&mirror = mirrors()[MirrorKey( scene, context )];
+	if( !mirror )
+	{
+		mirror = new SceneMirror( scene, context );
+	}
+	return mirror;
+}
+
+const ScenePlug *SceneMirror::scene() const
+{
+	return m_scene.get();
+}
+
+const Gaffer::Context *SceneMirror::context() const
+{
+	return m_context.get();
+}
+
+void SceneMirror::dirty( unsigned dirtyFlags )
+{
+	Mutex::scoped_lock lock( m_mutex );
+	m_dirtyFlags |= dirtyFlags;
+}
+
+void SceneMirror::setExpansion( const void *client, ConstPathMatcherDataPtr expandedPaths, size_t minimumExpansionDepth )
+{
+	Mutex::scoped_lock lock( m_mutex );
+	Expansion &expansion = m_expansions[client];
+	expansion.paths = expandedPaths;
+	expansion.minimumDepth = minimumExpansionDepth;
+	m_dirtyFlags |= ExpansionDirty;
+}
+
+void SceneMirror::removeExpansion( const void *client )
+{
+	Mutex::scoped_lock lock( m_mutex );
+	if( m_expansions.erase( client ) )
+	{
+		m_dirtyFlags |= ExpansionDirty;
+	}
+}
+
+bool SceneMirror::expanded( const ScenePlug::ScenePath &path ) const
+{
+	if( m_expansions.empty() )
+	{
+		return true;
+	}
+
+	for( Expansions::const_iterator it = m_expansions.begin(), eIt = m_expansions.end(); it != eIt; ++it )
+	{
+		if( !it->second.paths || it->second.minimumDepth >= path.size() )
+		{
+			return true;
+		}
+		if( it->second.paths->readable().match( path ) & Filter::ExactMatch )
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void SceneMirror::update()
+{
+	Mutex::scoped_lock lock( m_mutex );
+
+	if( !m_dirtyFlags )
+	{
+		return;
+	}
+
+	m_generation++;
+	try
+	{
+		UpdateTask *task = new( tbb::task::allocate_root() ) UpdateTask( this, m_root, m_dirtyFlags, ScenePlug::ScenePath() );
+		tbb::task::spawn_root_and_wait( *task );
+	}
+	catch( ... )
+	{
+		// Start again from scratch next time, with all
+		// locations reported as new.
+		delete m_root;
+		m_root = new Location( InternedString(), NULL, m_generation );
+		m_dirtyFlags = AllDirty;
+		throw;
+	}
+
+	m_dirtyFlags = NothingDirty;
+}
+
+size_t SceneMirror::generation() const
+{
+	return m_generation;
+}
+
+const SceneMirror::Location *SceneMirror::root() const
+{
+	return m_root;
+}
+
+SceneMirror::Mutex &SceneMirror::mutex() const
+{
+	return m_mutex;
+}
+
+void GafferScene::intrusive_ptr_release( const SceneMirror *mirror )
+{
+	{
+		// All releases are serialised with acquire(), so that
+		// once we have seen the last reference, no other thread
+		// can obtain a new one from the registry.
+		tbb::mutex::scoped_lock lock( g_mirrorsMutex );
+		if( mirror->refCount() > 1 )
+		{
+			mirror->removeRef();
+			return;
+		}
+		mirrors().erase( MirrorKey( mirror->m_scene.get(), mirror->m_context.get() ) );
+	}
+
+	// We hold the only reference, and the mirror is no
+	// longer registered, so we can destroy it without
+	// holding the lock.
+	mirror->removeRef();
+}
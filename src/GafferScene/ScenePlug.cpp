@@ -35,7 +35,10 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+#include "tbb/atomic.h"
+
 #include "IECore/NullObject.h"
+#include "IECore/LRUCache.h"
 
 #include "Gaffer/Context.h"
 #include "Gaffer/StringAlgo.h"
@@ -46,14 +49,224 @@
 using namespace Gaffer;
 using namespace GafferScene;
 
+//////////////////////////////////////////////////////////////////////////
+// Internal utilities for accumulating transforms and attributes
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// The full transform and attributes at a location are built by
+// extending the result for the parent location, and the results
+// for each ancestor are cached. This means that when visiting all
+// the children of a location, the ancestors are only evaluated
+// once rather than once per child. The cache is keyed by a hash
+// accumulated from the root downwards, so the key for a location
+// is derived from the key for its parent. The accumulated hashes
+// are themselves cached per location, so that a query only needs
+// to hash the ancestors which haven't been visited before.
+struct Accumulation
+{
+
+	Accumulation( const ValuePlug *plug, uint64_t plugId, uint64_t plugDirtyCount, const ScenePlug::ScenePath &path, Context *context )
+		:	plug( plug ), plugId( plugId ), plugDirtyCount( plugDirtyCount ), path( path ), context( context )
+	{
+	}
+
+	// Returns the hash accumulated from the root down
+	// to the location at the specified depth.
+	IECore::MurmurHash fullHash( size_t depth ) const;
+
+	// Sets the context up for evaluating the location
+	// at the specified depth.
+	void setDepth( size_t depth ) const
+	{
+		context->set( ScenePlug::scenePathContextName, ScenePlug::ScenePath( path.begin(), path.begin() + depth ) );
+	}
+
+	const ValuePlug *plug;
+	// Identify the ScenePlug and the number of times it has been
+	// dirtied, so that accumulated hashes are only reused while the
+	// plug is clean.
+	uint64_t plugId;
+	uint64_t plugDirtyCount;
+	const ScenePlug::ScenePath &path;
+	Context *context;
+
+};
+
+// Source of the ids used to identify each ScenePlug.
+tbb::atomic<uint64_t> g_nextAccumulationId;
+
+struct FullHashCacheKey
+{
+
+	FullHashCacheKey( const Accumulation &accumulation, size_t depth )
+		:	accumulation( &accumulation ), depth( depth )
+	{
+		accumulation.setDepth( depth );
+		hash = accumulation.context->hash();
+		hash.append( (uint64_t)accumulation.plug );
+		hash.append( accumulation.plugId );
+		hash.append( accumulation.plugDirtyCount );
+	}
+
+	bool operator == ( const FullHashCacheKey &other ) const
+	{
+		return hash == other.hash;
+	}
+
+	IECore::MurmurHash hash;
+	// Only valid for the duration of the call
+	// to get(), and only used by the getter.
+	mutable const Accumulation *accumulation;
+	size_t depth;
+
+};
+
+inline size_t tbb_hasher( const FullHashCacheKey &cacheKey )
+{
+	return tbb_hasher( cacheKey.hash );
+}
+
+IECore::MurmurHash fullHashGetter( const FullHashCacheKey &key, size_t &cost );
+
+typedef IECore::LRUCache<FullHashCacheKey, IECore::MurmurHash> FullHashCache;
+FullHashCache g_fullHashCache( fullHashGetter, 100000 );
+
+IECore::MurmurHash fullHashGetter( const FullHashCacheKey &key, size_t &cost )
+{
+	cost = 1;
+	const Accumulation *accumulation = key.accumulation;
+	key.accumulation = NULL;
+
+	if( !key.depth )
+	{
+		return IECore::MurmurHash();
+	}
+
+	// The key constructor left the context set up for this depth.
+	const IECore::MurmurHash localHash = accumulation->plug->hash();
+	IECore::MurmurHash result = accumulation->fullHash( key.depth - 1 );
+	result.append( localHash );
+	return result;
+}
+
+IECore::MurmurHash Accumulation::fullHash( size_t depth ) const
+{
+	return g_fullHashCache.get( FullHashCacheKey( *this, depth ) );
+}
+
+struct AccumulationCacheKey
+{
+
+	AccumulationCacheKey( const ScenePlug *scene, const Accumulation &accumulation, size_t depth )
+		:	hash( accumulation.fullHash( depth ) ), scene( scene ), accumulation( &accumulation ), depth( depth )
+	{
+	}
+
+	bool operator == ( const AccumulationCacheKey &other ) const
+	{
+		return hash == other.hash;
+	}
+
+	IECore::MurmurHash hash;
+	// These are only valid for the duration of the
+	// call to get(), and are only used by the getters.
+	mutable const ScenePlug *scene;
+	mutable const Accumulation *accumulation;
+	size_t depth;
+
+};
+
+inline size_t tbb_hasher( const AccumulationCacheKey &cacheKey )
+{
+	return tbb_hasher( cacheKey.hash );
+}
+
+Imath::M44f fullTransformGetter( const AccumulationCacheKey &key, size_t &cost );
+IECore::ConstCompoundObjectPtr fullAttributesGetter( const AccumulationCacheKey &key, size_t &cost );
+
+typedef IECore::LRUCache<AccumulationCacheKey, Imath::M44f> FullTransformCache;
+FullTransformCache g_fullTransformCache( fullTransformGetter, 100000 );
+
+typedef IECore::LRUCache<AccumulationCacheKey, IECore::ConstCompoundObjectPtr> FullAttributesCache;
+FullAttributesCache g_fullAttributesCache( fullAttributesGetter, 10000 );
+
+Imath::M44f fullTransformGetter( const AccumulationCacheKey &key, size_t &cost )
+{
+	cost = 1;
+	const ScenePlug *scene = key.scene;
+	const Accumulation *accumulation = key.accumulation;
+	key.scene = NULL;
+	key.accumulation = NULL;
+
+	if( !key.depth )
+	{
+		return Imath::M44f();
+	}
+
+	accumulation->setDepth( key.depth );
+	const Imath::M44f transform = scene->transformPlug()->getValue();
+	return transform * g_fullTransformCache.get( AccumulationCacheKey( scene, *accumulation, key.depth - 1 ) );
+}
+
+IECore::ConstCompoundObjectPtr fullAttributesGetter( const AccumulationCacheKey &key, size_t &cost )
+{
+	cost = 1;
+	const ScenePlug *scene = key.scene;
+	const Accumulation *accumulation = key.accumulation;
+	key.scene = NULL;
+	key.accumulation = NULL;
+
+	if( !key.depth )
+	{
+		return new IECore::CompoundObject;
+	}
+
+	accumulation->setDepth( key.depth );
+	IECore::ConstCompoundObjectPtr attributes = scene->attributesPlug()->getValue();
+	IECore::ConstCompoundObjectPtr parentAttributes = g_fullAttributesCache.get( AccumulationCacheKey( scene, *accumulation, key.depth - 1 ) );
+
+	// Share the parent's result, or the local attributes,
+	// wherever one of them contributes nothing.
+	if( attributes->members().empty() )
+	{
+		return parentAttributes;
+	}
+	else if( parentAttributes->members().empty() )
+	{
+		return attributes;
+	}
+
+	IECore::CompoundObjectPtr result = new IECore::CompoundObject;
+	IECore::CompoundObject::ObjectMap &resultMembers = result->members();
+	resultMembers = parentAttributes->members();
+	const IECore::CompoundObject::ObjectMap &members = attributes->members();
+	for( IECore::CompoundObject::ObjectMap::const_iterator it = members.begin(), eIt = members.end(); it != eIt; ++it )
+	{
+		resultMembers[it->first] = it->second;
+	}
+
+	return result;
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// ScenePlug
+//////////////////////////////////////////////////////////////////////////
+
 IE_CORE_DEFINERUNTIMETYPED( ScenePlug );
 
 const IECore::InternedString ScenePlug::scenePathContextName( "scene:path" );
 const IECore::InternedString ScenePlug::setNameContextName( "scene:setName" );
 
 ScenePlug::ScenePlug( const std::string &name, Direction direction, unsigned flags )
-	:	CompoundPlug( name, direction, flags )
+	:	CompoundPlug( name, direction, flags ), m_accumulationId( g_nextAccumulationId++ )
 {
+	m_dirtyCount = 0;
+
 	// we don't want the children to be serialised in any way - we always create
 	// them ourselves in this constructor so they aren't Dynamic, and we don't ever
 	// want to store their values because they are meaningless without an input
@@ -138,6 +351,12 @@ ScenePlug::~ScenePlug()
 {
 }
 
+void ScenePlug::dirty()
+{
+	CompoundPlug::dirty();
+	m_dirtyCount++;
+}
+
 bool ScenePlug::acceptsChild( const GraphComponent *potentialChild ) const
 {
 	return children().size() != 8;
@@ -262,16 +481,8 @@ Imath::M44f ScenePlug::fullTransform( const ScenePath &scenePath ) const
 	ContextPtr tmpContext = new Context( *Context::current(), Context::Borrowed );
 	Context::Scope scopedContext( tmpContext.get() );
 
-	Imath::M44f result;
-	ScenePath path( scenePath );
-	while( path.size() )
-	{
-		tmpContext->set( scenePathContextName, path );
-		result = result * transformPlug()->getValue();
-		path.pop_back();
-	}
-
-	return result;
+	Accumulation accumulation( transformPlug(), m_accumulationId, m_dirtyCount, scenePath, tmpContext.get() );
+	return g_fullTransformCache.get( AccumulationCacheKey( this, accumulation, scenePath.size() ) );
 }
 
 IECore::ConstCompoundObjectPtr ScenePlug::attributes( const ScenePath &scenePath ) const
@@ -287,24 +498,13 @@ IECore::CompoundObjectPtr ScenePlug::fullAttributes( const ScenePath &scenePath
 	ContextPtr tmpContext = new Context( *Context::current(), Context::Borrowed );
 	Context::Scope scopedContext( tmpContext.get() );
 
-	IECore::CompoundObjectPtr result = new IECore::CompoundObject;
-	IECore::CompoundObject::ObjectMap &resultMembers = result->members();
-	ScenePath path( scenePath );
-	while( path.size() )
-	{
-		tmpContext->set( scenePathContextName, path );
-		IECore::ConstCompoundObjectPtr a = attributesPlug()->getValue();
-		const IECore::CompoundObject::ObjectMap &aMembers = a->members();
-		for( IECore::CompoundObject::ObjectMap::const_iterator it = aMembers.begin(), eIt = aMembers.end(); it != eIt; it++ )
-		{
-			if( resultMembers.find( it->first ) == resultMembers.end() )
-			{
-				resultMembers.insert( *it );
-			}
-		}
-		path.pop_back();
-	}
+	Accumulation accumulation( attributesPlug(), m_accumulationId, m_dirtyCount, scenePath, tmpContext.get() );
+	IECore::ConstCompoundObjectPtr attributes = g_fullAttributesCache.get( AccumulationCacheKey( this, accumulation, scenePath.size() ) );
 
+	// The cached result is shared, so we return a shallow
+	// copy that the caller is free to modify.
+	IECore::CompoundObjectPtr result = new IECore::CompoundObject;
+	result->members() = attributes->members();
 	return result;
 }
 
@@ -353,16 +553,8 @@ IECore::MurmurHash ScenePlug::fullTransformHash( const ScenePath &scenePath ) co
 	ContextPtr tmpContext = new Context( *Context::current(), Context::Borrowed );
 	Context::Scope scopedContext( tmpContext.get() );
 
-	IECore::MurmurHash result;
-	ScenePath path( scenePath );
-	while( path.size() )
-	{
-		tmpContext->set( scenePathContextName, path );
-		transformPlug()->hash( result );
-		path.pop_back();
-	}
-
-	return result;
+	Accumulation accumulation( transformPlug(), m_accumulationId, m_dirtyCount, scenePath, tmpContext.get() );
+	return accumulation.fullHash( scenePath.size() );
 }
 
 IECore::MurmurHash ScenePlug::attributesHash( const ScenePath &scenePath ) const
@@ -378,16 +570,38 @@ IECore::MurmurHash ScenePlug::fullAttributesHash( const ScenePath &scenePath ) c
 	ContextPtr tmpContext = new Context( *Context::current(), Context::Borrowed );
 	Context::Scope scopedContext( tmpContext.get() );
 
-	IECore::MurmurHash result;
-	ScenePath path( scenePath );
-	while( path.size() )
-	{
-		tmpContext->set( scenePathContextName, path );
-		attributesPlug()->hash( result );
-		path.pop_back();
-	}
+	Accumulation accumulation( attributesPlug(), m_accumulationId, m_dirtyCount, scenePath, tmpContext.get() );
+	return accumulation.fullHash( scenePath.size() );
+}
 
-	return result;
+size_t ScenePlug::getFullTransformCacheLimit()
+{
+	return g_fullTransformCache.getMaxCost();
+}
+
+void ScenePlug::setFullTransformCacheLimit( size_t entries )
+{
+	g_fullTransformCache.setMaxCost( entries );
+}
+
+size_t ScenePlug::getFullAttributesCacheLimit()
+{
+	return g_fullAttributesCache.getMaxCost();
+}
+
+void ScenePlug::setFullAttributesCacheLimit( size_t entries )
+{
+	g_fullAttributesCache.setMaxCost( entries );
+}
+
+size_t ScenePlug::getFullHashCacheLimit()
+{
+	return g_fullHashCache.getMaxCost();
+}
+
+void ScenePlug::setFullHashCacheLimit( size_t entries )
+{
+	g_fullHashCache.setMaxCost( entries );
 }
 
 IECore::MurmurHash ScenePlug::objectHash( const ScenePath &scenePath ) const
@@ -91,17 +91,14 @@ using namespace GafferScene;
 // each trying to use N threads may not occur. What other renderers do in this
 // situation is unknown.
 //
-// I strongly suspect that the long term solution to this is to abandon using
-// a procedural hierarchy matching the scene hierarchy, and to do our own
-// threaded traversal of the scene, outputting the results to the renderer via
-// a single master thread. We could then be sure of our resource usage, and
-// also get better performance with renderers unable to make best use of
-// procedural concurrency.
-//
-// In the meantime, we introduce a hack. The GAFFERSCENE_SCENEPROCEDURAL_THREADS
-// environment variable may be used to clamp the number of threads used by any
-// given master thread. We sincerely hope to have a better solution before too
-// long.
+// The real solution to this is to abandon using a procedural hierarchy
+// matching the scene hierarchy, and to do our own threaded traversal of the
+// scene, outputting the results to the renderer via a single master thread.
+// That is what outputWorld() in RendererAlgo.cpp does, and it is what
+// ExecutableRender uses by default. SceneProcedurals are still needed for
+// deferred loading via renderer-side procedurals though, so for those we
+// retain a hack. The GAFFERSCENE_SCENEPROCEDURAL_THREADS environment variable
+// may be used to clamp the number of threads used by any given master thread.
 //
 // Worthwhile reading :
 //
@@ -74,6 +74,9 @@ SceneReader::SceneReader( const std::string &name )
 	addChild( new StringPlug( "fileName" ) );
 	addChild( new IntPlug( "refreshCount" ) );
 	addChild( new StringPlug( "tags" ) );
+	// Loading objects is expensive, and the same object is often
+	// requested by many threads at once, so we share the work.
+	outPlug()->objectPlug()->setFlags( Plug::SharedCompute, true );
 	plugSetSignal().connect( boost::bind( &SceneReader::plugSet, this, ::_1 ) );
 }
 
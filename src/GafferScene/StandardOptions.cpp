@@ -68,6 +68,10 @@ StandardOptions::StandardOptions( const std::string &name )
 	options->addOptionalMember( "render:deformationBlur", new IECore::BoolData( false ), "deformationBlur", Gaffer::Plug::Default, false );
 	options->addOptionalMember( "render:shutter", new IECore::V2fData( Imath::V2f( -0.25, 0.25 ) ), "shutter", Gaffer::Plug::Default, false );
 
+	// performance
+
+	options->addOptionalMember( "render:translationThreads", new IntPlug( "value", Plug::In, 0, 0 ), "translationThreads", false );
+
 }
 
 StandardOptions::~StandardOptions()
@@ -274,6 +274,19 @@ void GafferSceneBindings::bindScenePlug()
 		.staticmethod( "stringToPath" )
 		.def( "pathToString", &ScenePlug::pathToString )
 		.staticmethod( "pathToString" )
+		// cache management
+		.def( "getFullTransformCacheLimit", &ScenePlug::getFullTransformCacheLimit )
+		.staticmethod( "getFullTransformCacheLimit" )
+		.def( "setFullTransformCacheLimit", &ScenePlug::setFullTransformCacheLimit )
+		.staticmethod( "setFullTransformCacheLimit" )
+		.def( "getFullAttributesCacheLimit", &ScenePlug::getFullAttributesCacheLimit )
+		.staticmethod( "getFullAttributesCacheLimit" )
+		.def( "setFullAttributesCacheLimit", &ScenePlug::setFullAttributesCacheLimit )
+		.staticmethod( "setFullAttributesCacheLimit" )
+		.def( "getFullHashCacheLimit", &ScenePlug::getFullHashCacheLimit )
+		.staticmethod( "getFullHashCacheLimit" )
+		.def( "setFullHashCacheLimit", &ScenePlug::setFullHashCacheLimit )
+		.staticmethod( "setFullHashCacheLimit" )
 ;
 
 	ScenePathFromInternedStringVectorData();
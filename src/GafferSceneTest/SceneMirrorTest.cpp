@@ -0,0 +1,237 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2015, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "Gaffer/Context.h"
+#include "Gaffer/TransformPlug.h"
+
+#include "GafferTest/Assert.h"
+
+#include "GafferScene/SceneMirror.h"
+#include "GafferScene/Sphere.h"
+#include "GafferScene/Plane.h"
+#include "GafferScene/Group.h"
+
+#include "GafferSceneTest/SceneMirrorTest.h"
+
+using namespace Imath;
+using namespace IECore;
+using namespace Gaffer;
+using namespace GafferScene;
+
+namespace
+{
+
+const SceneMirror::Location *child( const SceneMirror::Location *location, const char *name )
+{
+	const SceneMirror::Location::Children &children = location->children();
+	for( SceneMirror::Location::Children::const_iterator it = children.begin(), eIt = children.end(); it != eIt; ++it )
+	{
+		if( (*it)->name() == name )
+		{
+			return *it;
+		}
+	}
+	return NULL;
+}
+
+} // namespace
+
+void GafferSceneTest::testSceneMirrorChanges()
+{
+	SpherePtr sphere = new Sphere;
+	PlanePtr plane = new Plane;
+	GroupPtr group = new Group;
+	group->nextInPlug()->setInput( sphere->outPlug() );
+	group->nextInPlug()->setInput( plane->outPlug() );
+
+	ContextPtr context = new Context;
+
+	{
+		SceneMirrorPtr mirror = SceneMirror::acquire( group->outPlug(), context.get() );
+		GAFFERTEST_ASSERT( SceneMirror::acquire( group->outPlug(), context.get() ) == mirror );
+		GAFFERTEST_ASSERT( mirror->generation() == 0 );
+
+		SceneMirror::Mutex::scoped_lock lock( mirror->mutex() );
+
+		// Everything is new in the first generation.
+
+		mirror->update();
+		GAFFERTEST_ASSERT( mirror->generation() == 1 );
+
+		const SceneMirror::Location *groupLocation = child( mirror->root(), "group" );
+		GAFFERTEST_ASSERT( groupLocation );
+		const SceneMirror::Location *sphereLocation = child( groupLocation, "sphere" );
+		const SceneMirror::Location *planeLocation = child( groupLocation, "plane" );
+		GAFFERTEST_ASSERT( sphereLocation && planeLocation );
+		GAFFERTEST_ASSERT( sphereLocation->object() );
+
+		const unsigned newFlags = SceneMirror::AttributesDirty | SceneMirror::TransformDirty | SceneMirror::ObjectDirty;
+		GAFFERTEST_ASSERT( ( sphereLocation->changes( 0 ) & newFlags ) == newFlags );
+		GAFFERTEST_ASSERT( mirror->root()->changes( 0 ) & SceneMirror::ChildNamesDirty );
+		GAFFERTEST_ASSERT( sphereLocation->changes( 1 ) == SceneMirror::NothingDirty );
+
+		// Updating when nothing is dirty doesn't make a new generation.
+
+		mirror->update();
+		GAFFERTEST_ASSERT( mirror->generation() == 1 );
+
+		// Dirtying without changing anything makes a new generation,
+		// but doesn't report any changes.
+
+		mirror->dirty( SceneMirror::AllDirty );
+		mirror->update();
+		GAFFERTEST_ASSERT( mirror->generation() == 2 );
+		GAFFERTEST_ASSERT( child( mirror->root(), "group" ) == groupLocation );
+		GAFFERTEST_ASSERT( groupLocation->changes( 1 ) == SceneMirror::NothingDirty );
+		GAFFERTEST_ASSERT( sphereLocation->changes( 1 ) == SceneMirror::NothingDirty );
+		GAFFERTEST_ASSERT( planeLocation->changes( 1 ) == SceneMirror::NothingDirty );
+
+		// Moving the sphere changes only its transform.
+
+		sphere->transformPlug()->translatePlug()->setValue( V3f( 1, 0, 0 ) );
+		mirror->dirty( SceneMirror::TransformDirty | SceneMirror::BoundDirty );
+		mirror->update();
+		GAFFERTEST_ASSERT( mirror->generation() == 3 );
+		GAFFERTEST_ASSERT( sphereLocation->changes( 2 ) == SceneMirror::TransformDirty );
+		GAFFERTEST_ASSERT( sphereLocation->transform() == M44f().translate( V3f( 1, 0, 0 ) ) );
+		GAFFERTEST_ASSERT( planeLocation->changes( 2 ) == SceneMirror::NothingDirty );
+		GAFFERTEST_ASSERT( groupLocation->changes( 2 ) == SceneMirror::NothingDirty );
+
+		// Changing the radius changes only the object. Changes
+		// since earlier generations accumulate.
+
+		sphere->radiusPlug()->setValue( 2 );
+		mirror->dirty( SceneMirror::ObjectDirty | SceneMirror::BoundDirty );
+		mirror->update();
+		GAFFERTEST_ASSERT( mirror->generation() == 4 );
+		GAFFERTEST_ASSERT( sphereLocation->changes( 3 ) == SceneMirror::ObjectDirty );
+		GAFFERTEST_ASSERT( sphereLocation->changes( 2 ) == ( SceneMirror::ObjectDirty | SceneMirror::TransformDirty ) );
+		GAFFERTEST_ASSERT( planeLocation->changes( 2 ) == SceneMirror::NothingDirty );
+
+		// Renaming the plane replaces the children of the group,
+		// and the new children report everything as changed.
+
+		plane->namePlug()->setValue( "ground" );
+		mirror->dirty( SceneMirror::AllDirty );
+		mirror->update();
+		GAFFERTEST_ASSERT( mirror->generation() == 5 );
+		GAFFERTEST_ASSERT( groupLocation->changes( 4 ) == SceneMirror::ChildNamesDirty );
+		GAFFERTEST_ASSERT( !child( groupLocation, "plane" ) );
+		const SceneMirror::Location *groundLocation = child( groupLocation, "ground" );
+		GAFFERTEST_ASSERT( groundLocation );
+		GAFFERTEST_ASSERT( ( groundLocation->changes( 4 ) & newFlags ) == newFlags );
+		GAFFERTEST_ASSERT( groundLocation->changes( 5 ) == SceneMirror::NothingDirty );
+	}
+
+	// When the last reference is released, the mirror is
+	// destroyed, and a new one is made by the next acquire().
+
+	SceneMirrorPtr mirror = SceneMirror::acquire( group->outPlug(), context.get() );
+	GAFFERTEST_ASSERT( mirror->generation() == 0 );
+}
+
+void GafferSceneTest::testSceneMirrorExpansion()
+{
+	SpherePtr sphere = new Sphere;
+	GroupPtr group = new Group;
+	group->nextInPlug()->setInput( sphere->outPlug() );
+
+	ContextPtr context = new Context;
+	SceneMirrorPtr mirror = SceneMirror::acquire( group->outPlug(), context.get() );
+	SceneMirror::Mutex::scoped_lock lock( mirror->mutex() );
+
+	int client1, client2;
+
+	// With no clients requesting expansion,
+	// the whole scene is mirrored.
+
+	mirror->update();
+	const SceneMirror::Location *groupLocation = child( mirror->root(), "group" );
+	GAFFERTEST_ASSERT( groupLocation );
+	GAFFERTEST_ASSERT( groupLocation->expanded() );
+	GAFFERTEST_ASSERT( child( groupLocation, "sphere" ) );
+
+	// One client expanding only the root.
+
+	mirror->setExpansion( &client1, new PathMatcherData, 0 );
+	mirror->update();
+	GAFFERTEST_ASSERT( child( mirror->root(), "group" ) == groupLocation );
+	GAFFERTEST_ASSERT( !groupLocation->expanded() );
+	GAFFERTEST_ASSERT( groupLocation->children().empty() );
+	GAFFERTEST_ASSERT( groupLocation->hasChildren() );
+	{
+		Context::Scope scopedContext( context.get() );
+		ScenePlug::ScenePath groupPath;
+		groupPath.push_back( "group" );
+		GAFFERTEST_ASSERT( groupLocation->bound() == group->outPlug()->bound( groupPath ) );
+	}
+
+	// A second client expanding "/group". The mirror
+	// expands the union of the two.
+
+	PathMatcherDataPtr groupExpanded = new PathMatcherData;
+	groupExpanded->writable().addPath( "/group" );
+	mirror->setExpansion( &client2, groupExpanded, 0 );
+	mirror->update();
+	GAFFERTEST_ASSERT( groupLocation->expanded() );
+	GAFFERTEST_ASSERT( child( groupLocation, "sphere" ) );
+	GAFFERTEST_ASSERT( groupLocation->changes( mirror->generation() - 1 ) & SceneMirror::ChildNamesDirty );
+
+	// Removing the second client collapses the group again.
+
+	mirror->removeExpansion( &client2 );
+	mirror->update();
+	GAFFERTEST_ASSERT( !groupLocation->expanded() );
+	GAFFERTEST_ASSERT( groupLocation->children().empty() );
+
+	// A null expansion requests the whole scene, regardless
+	// of the other clients.
+
+	mirror->setExpansion( &client2, NULL );
+	mirror->update();
+	GAFFERTEST_ASSERT( groupLocation->expanded() );
+	GAFFERTEST_ASSERT( child( groupLocation, "sphere" ) );
+
+	// The minimum expansion depth also contributes
+	// to the union.
+
+	mirror->removeExpansion( &client2 );
+	mirror->setExpansion( &client1, new PathMatcherData, 1 );
+	mirror->update();
+	GAFFERTEST_ASSERT( groupLocation->expanded() );
+	GAFFERTEST_ASSERT( child( groupLocation, "sphere" ) );
+	GAFFERTEST_ASSERT( !child( groupLocation, "sphere" )->expanded() );
+}
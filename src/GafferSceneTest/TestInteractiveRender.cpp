@@ -0,0 +1,322 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2015, Image Engine Design Inc. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//      * Redistributions of source code must retain the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer.
+//
+//      * Redistributions in binary form must reproduce the above
+//        copyright notice, this list of conditions and the following
+//        disclaimer in the documentation and/or other materials provided with
+//        the distribution.
+//
+//      * Neither the name of John Haddon nor the names of
+//        any other contributors to this software may be used to endorse or
+//        promote products derived from this software without specific prior
+//        written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "IECore/Renderer.h"
+#include "IECore/SimpleTypedData.h"
+#include "IECore/CompoundData.h"
+
+#include "GafferSceneTest/TestInteractiveRender.h"
+
+using namespace std;
+using namespace Imath;
+using namespace IECore;
+using namespace GafferSceneTest;
+
+//////////////////////////////////////////////////////////////////////////
+// Implementation of a Renderer which records the calls made to it.
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+class RecordingRenderer : public IECore::Renderer
+{
+
+	public :
+
+		RecordingRenderer( ObjectVectorPtr log )
+			:	m_log( log )
+		{
+		}
+
+		virtual void setOption( const std::string &name, ConstDataPtr value )
+		{
+			record( "setOption" )->writable()["name"] = new StringData( name );
+		}
+
+		virtual ConstDataPtr getOption( const std::string &name ) const
+		{
+			return NULL;
+		}
+
+		virtual void camera( const std::string &name, const CompoundDataMap &parameters )
+		{
+			record( "camera" )->writable()["name"] = new StringData( name );
+		}
+
+		virtual void display( const std::string &name, const std::string &type, const std::string &data, const CompoundDataMap &parameters )
+		{
+			record( "display" )->writable()["name"] = new StringData( name );
+		}
+
+		virtual void worldBegin()
+		{
+			record( "worldBegin" );
+		}
+
+		virtual void worldEnd()
+		{
+			record( "worldEnd" );
+		}
+
+		virtual void transformBegin()
+		{
+			record( "transformBegin" );
+		}
+
+		virtual void transformEnd()
+		{
+			record( "transformEnd" );
+		}
+
+		virtual void setTransform( const M44f &m )
+		{
+			record( "setTransform" )->writable()["transform"] = new M44fData( m );
+		}
+
+		virtual void setTransform( const std::string &coordinateSystem )
+		{
+			record( "setTransform" )->writable()["name"] = new StringData( coordinateSystem );
+		}
+
+		virtual M44f getTransform() const
+		{
+			return M44f();
+		}
+
+		virtual M44f getTransform( const std::string &coordinateSystem ) const
+		{
+			return M44f();
+		}
+
+		virtual void concatTransform( const M44f &m )
+		{
+			record( "concatTransform" )->writable()["transform"] = new M44fData( m );
+		}
+
+		virtual void coordinateSystem( const std::string &name )
+		{
+			record( "coordinateSystem" )->writable()["name"] = new StringData( name );
+		}
+
+		virtual void attributeBegin()
+		{
+			record( "attributeBegin" );
+		}
+
+		virtual void attributeEnd()
+		{
+			record( "attributeEnd" );
+		}
+
+		virtual void setAttribute( const std::string &name, ConstDataPtr value )
+		{
+			CompoundDataPtr call = record( "setAttribute" );
+			call->writable()["name"] = new StringData( name );
+			if( value )
+			{
+				call->writable()["value"] = value->copy();
+			}
+		}
+
+		virtual ConstDataPtr getAttribute( const std::string &name ) const
+		{
+			return NULL;
+		}
+
+		virtual void shader( const std::string &type, const std::string &name, const CompoundDataMap &parameters )
+		{
+			record( "shader" )->writable()["name"] = new StringData( name );
+		}
+
+		virtual void light( const std::string &name, const std::string &handle, const CompoundDataMap &parameters )
+		{
+			record( "light" )->writable()["name"] = new StringData( handle );
+		}
+
+		virtual void illuminate( const std::string &lightHandle, bool on )
+		{
+			record( "illuminate" )->writable()["name"] = new StringData( lightHandle );
+		}
+
+		virtual void motionBegin( const std::set<float> &times )
+		{
+			record( "motionBegin" );
+		}
+
+		virtual void motionEnd()
+		{
+			record( "motionEnd" );
+		}
+
+		virtual void points( size_t numPoints, const PrimitiveVariableMap &primVars )
+		{
+			record( "points" );
+		}
+
+		virtual void disk( float radius, float z, float thetaMax, const PrimitiveVariableMap &primVars )
+		{
+			record( "disk" );
+		}
+
+		virtual void curves( const CubicBasisf &basis, bool periodic, ConstIntVectorDataPtr numVertices, const PrimitiveVariableMap &primVars )
+		{
+			record( "curves" );
+		}
+
+		virtual void text( const std::string &font, const std::string &text, float kerning, const PrimitiveVariableMap &primVars )
+		{
+			record( "text" );
+		}
+
+		virtual void sphere( float radius, float zMin, float zMax, float thetaMax, const PrimitiveVariableMap &primVars )
+		{
+			record( "sphere" );
+		}
+
+		virtual void image( const Box2i &dataWindow, const Box2i &displayWindow, const PrimitiveVariableMap &primVars )
+		{
+			record( "image" );
+		}
+
+		virtual void mesh( ConstIntVectorDataPtr vertsPerFace, ConstIntVectorDataPtr vertIds, const std::string &interpolation, const PrimitiveVariableMap &primVars )
+		{
+			record( "mesh" );
+		}
+
+		virtual void nurbs( int uOrder, ConstFloatVectorDataPtr uKnot, float uMin, float uMax, int vOrder, ConstFloatVectorDataPtr vKnot, float vMin, float vMax, const PrimitiveVariableMap &primVars )
+		{
+			record( "nurbs" );
+		}
+
+		virtual void patchMesh( const CubicBasisf &uBasis, const CubicBasisf &vBasis, int nu, bool uPeriodic, int nv, bool vPeriodic, const PrimitiveVariableMap &primVars )
+		{
+			record( "patchMesh" );
+		}
+
+		virtual void geometry( const std::string &type, const CompoundDataMap &topology, const PrimitiveVariableMap &primVars )
+		{
+			record( "geometry" )->writable()["type"] = new StringData( type );
+		}
+
+		virtual void procedural( Renderer::ProceduralPtr proc )
+		{
+			record( "procedural" );
+		}
+
+		virtual void instanceBegin( const std::string &name, const CompoundDataMap &parameters )
+		{
+			record( "instanceBegin" )->writable()["name"] = new StringData( name );
+		}
+
+		virtual void instanceEnd()
+		{
+			record( "instanceEnd" );
+		}
+
+		virtual void instance( const std::string &name )
+		{
+			record( "instance" )->writable()["name"] = new StringData( name );
+		}
+
+		virtual DataPtr command( const std::string &name, const CompoundDataMap &parameters )
+		{
+			record( "command" )->writable()["name"] = new StringData( name );
+			return NULL;
+		}
+
+		virtual void editBegin( const std::string &editType, const CompoundDataMap &parameters )
+		{
+			CompoundDataPtr call = record( "editBegin" );
+			call->writable()["type"] = new StringData( editType );
+			CompoundDataMap::const_iterator it = parameters.find( "exactscopename" );
+			if( it != parameters.end() )
+			{
+				call->writable()["scope"] = it->second->copy();
+			}
+		}
+
+		virtual void editEnd()
+		{
+			record( "editEnd" );
+		}
+
+	private :
+
+		CompoundDataPtr record( const std::string &call )
+		{
+			CompoundDataPtr result = new CompoundData;
+			result->writable()["call"] = new StringData( call );
+			m_log->members().push_back( result );
+			return result;
+		}
+
+		ObjectVectorPtr m_log;
+
+};
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// TestInteractiveRender implementation
+//////////////////////////////////////////////////////////////////////////
+
+IE_CORE_DEFINERUNTIMETYPED( TestInteractiveRender )
+
+TestInteractiveRender::TestInteractiveRender( const std::string &name )
+	:	InteractiveRender( name ), m_log( new ObjectVector )
+{
+}
+
+TestInteractiveRender::~TestInteractiveRender()
+{
+}
+
+const IECore::ObjectVector *TestInteractiveRender::log() const
+{
+	return m_log.get();
+}
+
+void TestInteractiveRender::clearLog()
+{
+	m_log->members().clear();
+}
+
+IECore::RendererPtr TestInteractiveRender::createRenderer() const
+{
+	m_log->members().clear();
+	return new RecordingRenderer( m_log );
+}
@@ -47,6 +47,8 @@
 #include "GafferSceneTest/TestLight.h"
 #include "GafferSceneTest/ScenePlugTest.h"
 #include "GafferSceneTest/PathMatcherTest.h"
+#include "GafferSceneTest/SceneMirrorTest.h"
+#include "GafferSceneTest/TestInteractiveRender.h"
 
 using namespace boost::python;
 using namespace GafferSceneTest;
@@ -57,12 +59,21 @@ static void traverseSceneWrapper( GafferScene::ScenePlug *scenePlug )
 	traverseScene( scenePlug );
 }
 
+static IECore::ObjectVectorPtr testInteractiveRenderLog( const TestInteractiveRender &r )
+{
+	return r.log()->copy();
+}
+
 BOOST_PYTHON_MODULE( _GafferSceneTest )
 {
 
 	GafferBindings::DependencyNodeClass<CompoundObjectSource>();
 	GafferBindings::NodeClass<TestShader>();
 	GafferBindings::NodeClass<TestLight>();
+	GafferBindings::NodeClass<TestInteractiveRender>()
+		.def( "log", &testInteractiveRenderLog )
+		.def( "clearLog", &TestInteractiveRender::clearLog )
+	;
 
 	def( "traverseScene", &traverseSceneWrapper );
 	def( "testManyStringToPathCalls", &testManyStringToPathCalls );
@@ -70,4 +81,7 @@ BOOST_PYTHON_MODULE( _GafferSceneTest )
 	def( "testPathMatcherRawIterator", &testPathMatcherRawIterator );
 	def( "testPathMatcherIteratorPrune", &testPathMatcherIteratorPrune );
 
+	def( "testSceneMirrorChanges", &testSceneMirrorChanges );
+	def( "testSceneMirrorExpansion", &testSceneMirrorExpansion );
+
 }
@@ -396,6 +396,31 @@ IECoreGL::ConstRenderablePtr objectToRenderable( const IECore::Object *object )
 	}
 }
 
+// Returns the bound of everything at and below the mirrored location.
+// The mirror only tracks the bound for locations it hasn't expanded,
+// so for the rest we must accumulate it from the children.
+Box3f mirrorBound( const SceneMirror::Location *location )
+{
+	if( !location->expanded() )
+	{
+		return location->bound();
+	}
+
+	Box3f result;
+	if( const IECore::VisibleRenderable *renderable = IECore::runTimeCast<const IECore::VisibleRenderable>( location->object() ) )
+	{
+		result.extendBy( renderable->bound() );
+	}
+
+	const SceneMirror::Location::Children &children = location->children();
+	for( SceneMirror::Location::Children::const_iterator it = children.begin(), eIt = children.end(); it != eIt; ++it )
+	{
+		result.extendBy( transform( mirrorBound( *it ), (*it)->transform() ) );
+	}
+
+	return result;
+}
+
 } // namespace
 
 //////////////////////////////////////////////////////////////////////////
@@ -453,7 +478,7 @@ void doPendingReferenceRemovals()
 //   promising to have this class implement IECore::SceneInterface, or
 //   a future version tailored a little for broader use cases such as this
 //   (the existing interface is a little file-specific).
-// - Refactor UpdateTask into a class which couples Gaffer to
+// - Refactor SyncTask into a class which couples the SceneMirror to
 //   IECore::SceneInterfaces, performing minimal edits as necessary to
 //   reflect changes in Gaffer.
 // - Implement our renderer backends for RenderMan, Arnold etc as
@@ -461,7 +486,14 @@ void doPendingReferenceRemovals()
 //   but the hope is that the SceneInterface is a better API for performing
 //   render edits for IPR, rather than the nasty RI style API we currently
 //   have.
-// - Reuse the new UpdateTask in the InteractiveRender node.
+// - Reuse the new SyncTask in the InteractiveRender node.
+//
+// The Gaffer side of things already uses the same code as InteractiveRender :
+// the scene is evaluated by a SceneMirror, and the SyncTask merely converts
+// the locations which have changed since our last update into IECoreGL
+// objects. Note that the mirror itself isn't shared with InteractiveRender,
+// because we view the output of the SceneView's preprocessor rather than the
+// plug the render is connected to.
 //
 //////////////////////////////////////////////////////////////////////////
 
@@ -576,12 +608,11 @@ class SceneGadget::SceneGraph
 			deferReferenceRemoval( m_renderable );
 			deferReferenceRemoval( m_boundRenderable );
 			clearChildren();
-			m_objectHash = m_attributesHash = IECore::MurmurHash();
 		}
 
 	private :
 
-		friend class UpdateTask;
+		friend class SyncTask;
 
 		void clearChildren()
 		{
@@ -671,132 +702,80 @@ class SceneGadget::SceneGraph
 		bool m_visible;
 		bool m_expanded;
 
-		IECore::MurmurHash m_objectHash;
-		IECore::MurmurHash m_attributesHash;
-
 };
 
-class SceneGadget::UpdateTask : public tbb::task
+class SceneGadget::SyncTask : public tbb::task
 {
 
 	public :
 
-		enum DirtyFlags
-		{
-			NothingDirty = 0,
-			BoundDirty = 1,
-			TransformDirty = 2,
-			AttributesDirty = 4,
-			ObjectDirty = 8,
-			ChildNamesDirty = 16,
-			ExpansionDirty = 32,
-			AllDirty = BoundDirty | TransformDirty | AttributesDirty | ObjectDirty | ChildNamesDirty | ExpansionDirty
-		};
-
-		UpdateTask( const SceneGadget *sceneGadget, SceneGraph *sceneGraph, unsigned dirtyFlags, const ScenePlug::ScenePath &scenePath )
-			:	m_sceneGadget( sceneGadget ),
-				m_sceneGraph( sceneGraph ),
-				m_dirtyFlags( dirtyFlags ),
+		SyncTask( SceneGraph *sceneGraph, const SceneMirror::Location *location, size_t sinceGeneration, bool force, const PathMatcher &expandedPaths, size_t minimumExpansionDepth, const ScenePlug::ScenePath &scenePath )
+			:	m_sceneGraph( sceneGraph ),
+				m_location( location ),
+				m_sinceGeneration( sinceGeneration ),
+				m_force( force ),
+				m_expandedPaths( expandedPaths ),
+				m_minimumExpansionDepth( minimumExpansionDepth ),
 				m_scenePath( scenePath )
 		{
 		}
 
 		virtual task *execute()
 		{
-			ContextPtr context = new Context( *m_sceneGadget->m_context, Context::Borrowed );
-			context->set( ScenePlug::scenePathContextName, m_scenePath );
-			Context::Scope scopedContext( context.get() );
+			const unsigned changes = m_force ? SceneMirror::AllDirty : m_location->changes( m_sinceGeneration );
 
-			// Update attributes, and compute visibility.
+			// Update the state, and visibility.
 
-			const bool previouslyVisible = m_sceneGraph->m_visible;
-			if( m_dirtyFlags & AttributesDirty )
+			if( changes & SceneMirror::AttributesDirty && m_location->attributes() )
 			{
-				const IECore::MurmurHash attributesHash = m_sceneGadget->m_scene->attributesPlug()->hash();
-				if( attributesHash != m_sceneGraph->m_attributesHash )
-				{
-					IECore::ConstCompoundObjectPtr attributes = m_sceneGadget->m_scene->attributesPlug()->getValue( &attributesHash );
-					const IECore::BoolData *visibilityData = attributes->member<IECore::BoolData>( "scene:visible" );
-					m_sceneGraph->m_visible = visibilityData ? visibilityData->readable() : true;
-
-					IECore::ConstRunTimeTypedPtr glState = IECoreGL::CachedConverter::defaultCachedConverter()->convert( attributes.get() );
-					deferReferenceRemoval( m_sceneGraph->m_state );
-					m_sceneGraph->m_state = IECore::runTimeCast<const IECoreGL::State>( glState );
-
-					m_sceneGraph->m_attributesHash = attributesHash;
-				}
+				IECore::ConstRunTimeTypedPtr glState = IECoreGL::CachedConverter::defaultCachedConverter()->convert( m_location->attributes() );
+				deferReferenceRemoval( m_sceneGraph->m_state );
+				m_sceneGraph->m_state = IECore::runTimeCast<const IECoreGL::State>( glState );
 			}
 
+			m_sceneGraph->m_visible = m_location->visible();
 			if( !m_sceneGraph->m_visible )
 			{
-				// No need to update further since we're not visible.
+				// The mirror doesn't update invisible locations,
+				// so neither do we.
 				return NULL;
 			}
-			else if( !previouslyVisible )
-			{
-				// We didn't perform any updates when we were invisible,
-				// so we need to update everything now.
-				m_dirtyFlags = AllDirty;
-			}
 
 			// Update the object - converting it into an IECoreGL::Renderable
 
-			if( m_dirtyFlags & ObjectDirty )
+			if( changes & SceneMirror::ObjectDirty )
 			{
-				const IECore::MurmurHash objectHash = m_sceneGadget->m_scene->objectPlug()->hash();
-				if( objectHash != m_sceneGraph->m_objectHash )
+				deferReferenceRemoval( m_sceneGraph->m_renderable );
+				const IECore::Object *object = m_location->object();
+				if( object && !object->isInstanceOf( IECore::NullObjectTypeId ) )
 				{
-					IECore::ConstObjectPtr object = m_sceneGadget->m_scene->objectPlug()->getValue( &objectHash );
-					deferReferenceRemoval( m_sceneGraph->m_renderable );
-					if( !object->isInstanceOf( IECore::NullObjectTypeId ) )
-					{
-						m_sceneGraph->m_renderable = objectToRenderable( object.get() );
-					}
-					m_sceneGraph->m_objectHash = objectHash;
+					m_sceneGraph->m_renderable = objectToRenderable( object );
 				}
 			}
 
 			// Update the transform and bound
 
-			if( m_dirtyFlags & TransformDirty )
+			if( changes & SceneMirror::TransformDirty )
 			{
-				m_sceneGraph->m_transform = m_sceneGadget->m_scene->transformPlug()->getValue();
+				m_sceneGraph->m_transform = m_location->transform();
 			}
 
 			m_sceneGraph->m_bound = m_sceneGraph->m_renderable ? m_sceneGraph->m_renderable->bound() : Box3f();
 
-			// Update the expansion state
-
-			const bool previouslyExpanded = m_sceneGraph->m_expanded;
-			if( m_dirtyFlags & ExpansionDirty )
-			{
-				m_sceneGraph->m_expanded = m_sceneGadget->m_minimumExpansionDepth >= m_scenePath.size();
-				if( !m_sceneGraph->m_expanded )
-				{
-					m_sceneGraph->m_expanded = m_sceneGadget->m_expandedPaths->readable().match( m_scenePath ) & Filter::ExactMatch;
-				}
-			}
-
 			// If we're not expanded, then we can early out after creating a bounding box.
+			// The mirror may be shared with clients which have expanded more of the
+			// scene than we have, so we must apply our own expansion too.
 
+			m_sceneGraph->m_expanded = m_location->expanded() && (
+				m_scenePath.size() <= m_minimumExpansionDepth ||
+				m_expandedPaths.match( m_scenePath ) & Filter::ExactMatch
+			);
 			deferReferenceRemoval( m_sceneGraph->m_boundRenderable );
 			if( !m_sceneGraph->m_expanded )
 			{
-				// We're not expanded, so we early out before updating the children.
-				// We do however need to see if we have any children, and arrange to
-				// draw their bounding box if we do.
-				bool haveChildren = m_sceneGraph->m_children.size();
-				if( m_dirtyFlags & ChildNamesDirty || !previouslyExpanded )
-				{
-					IECore::ConstInternedStringVectorDataPtr childNamesData = m_sceneGadget->m_scene->childNamesPlug()->getValue();
-					haveChildren = childNamesData->readable().size();
-				}
-
 				m_sceneGraph->clearChildren();
-
-				m_sceneGraph->m_bound.extendBy( m_sceneGadget->m_scene->boundPlug()->getValue() );
-
-				if( haveChildren )
+				m_sceneGraph->m_bound.extendBy( mirrorBound( m_location ) );
+				if( m_location->hasChildren() )
 				{
 					IECore::CurvesPrimitivePtr curvesBound = IECore::CurvesPrimitive::createBox( m_sceneGraph->m_bound );
 					m_sceneGraph->m_boundRenderable = boost::static_pointer_cast<const IECoreGL::Renderable>(
@@ -806,33 +785,21 @@ class SceneGadget::UpdateTask : public tbb::task
 				return NULL;
 			}
 
-			// We are expanded, so we need to visit all the children
-			// and update those too.
-
-			if( !previouslyExpanded )
-			{
-				m_dirtyFlags = AllDirty;
-			}
-
-			// Make sure we have a child for each child name
+			// We are expanded, so we need a child for each of the
+			// children in the mirror.
 
-			if( m_dirtyFlags & ChildNamesDirty )
+			const SceneMirror::Location::Children &locationChildren = m_location->children();
+			bool forceChildren = m_force;
+			if( changes & SceneMirror::ChildNamesDirty || m_sceneGraph->m_children.size() != locationChildren.size() )
 			{
-				IECore::ConstInternedStringVectorDataPtr childNamesData = m_sceneGadget->m_scene->childNamesPlug()->getValue();
-				const std::vector<IECore::InternedString> &childNames = childNamesData->readable();
-				if( !existingChildNamesValid( childNames ) )
+				m_sceneGraph->clearChildren();
+				for( SceneMirror::Location::Children::const_iterator it = locationChildren.begin(), eIt = locationChildren.end(); it != eIt; ++it )
 				{
-					m_sceneGraph->clearChildren();
-
-					for( std::vector<IECore::InternedString>::const_iterator it = childNames.begin(), eIt = childNames.end(); it != eIt; ++it )
-					{
-						SceneGraph *child = new SceneGraph();
-						child->m_name = *it;
-						m_sceneGraph->m_children.push_back( child );
-					}
-
-					m_dirtyFlags = AllDirty; // We've made brand new children, so they need a full update.
+					SceneGraph *child = new SceneGraph();
+					child->m_name = (*it)->name();
+					m_sceneGraph->m_children.push_back( child );
 				}
+				forceChildren = true; // We've made brand new children, so they need a full update.
 			}
 
 			// And then update each child
@@ -843,10 +810,10 @@ class SceneGadget::UpdateTask : public tbb::task
 
 				ScenePlug::ScenePath childPath = m_scenePath;
 				childPath.push_back( IECore::InternedString() ); // space for the child name
-				for( std::vector<SceneGraph *>::const_iterator it = m_sceneGraph->m_children.begin(), eIt = m_sceneGraph->m_children.end(); it != eIt; ++it )
+				for( size_t i = 0, e = m_sceneGraph->m_children.size(); i < e; ++i )
 				{
-					childPath.back() = (*it)->m_name;
-					UpdateTask *t = new( allocate_child() ) UpdateTask( m_sceneGadget, *it, m_dirtyFlags, childPath );
+					childPath.back() = locationChildren[i]->name();
+					SyncTask *t = new( allocate_child() ) SyncTask( m_sceneGraph->m_children[i], locationChildren[i], m_sinceGeneration, forceChildren, m_expandedPaths, m_minimumExpansionDepth, childPath );
 					spawn( *t );
 				}
 
@@ -866,25 +833,12 @@ class SceneGadget::UpdateTask : public tbb::task
 
 	private :
 
-		bool existingChildNamesValid( const vector<IECore::InternedString> &childNames )
-		{
-			if( m_sceneGraph->m_children.size() != childNames.size() )
-			{
-				return false;
-			}
-			for( size_t i = 0, e = childNames.size(); i < e; ++i )
-			{
-				if( m_sceneGraph->m_children[i]->m_name != childNames[i] )
-				{
-					return false;
-				}
-			}
-			return true;
-		}
-
-		const SceneGadget *m_sceneGadget;
 		SceneGraph *m_sceneGraph;
-		unsigned m_dirtyFlags;
+		const SceneMirror::Location *m_location;
+		size_t m_sinceGeneration;
+		bool m_force;
+		const PathMatcher &m_expandedPaths;
+		size_t m_minimumExpansionDepth;
 		ScenePlug::ScenePath m_scenePath;
 
 };
@@ -897,11 +851,12 @@ SceneGadget::SceneGadget()
 	:	Gadget( defaultName<SceneGadget>() ),
 		m_scene( NULL ),
 		m_context( NULL ),
-		m_dirtyFlags( UpdateTask::AllDirty ),
+		m_dirtyFlags( SceneMirror::AllDirty ),
 		m_expandedPaths( new PathMatcherData ),
 		m_minimumExpansionDepth( 0 ),
 		m_baseState( new IECoreGL::State( true ) ),
 		m_sceneGraph( new SceneGraph ),
+		m_generation( 0 ),
 		m_selection( new PathMatcherData )
 {
 	setContext( new Context );
@@ -909,6 +864,7 @@ SceneGadget::SceneGadget()
 
 SceneGadget::~SceneGadget()
 {
+	releaseSceneMirror();
 }
 
 void SceneGadget::setScene( GafferScene::ConstScenePlugPtr scene )
@@ -928,7 +884,8 @@ void SceneGadget::setScene( GafferScene::ConstScenePlugPtr scene )
 		m_plugDirtiedConnection.disconnect();
 	}
 
-	m_dirtyFlags = UpdateTask::AllDirty;
+	releaseSceneMirror();
+	m_dirtyFlags = SceneMirror::AllDirty;
 	requestRender();
 }
 
@@ -946,6 +903,8 @@ void SceneGadget::setContext( Gaffer::ContextPtr context )
 
 	m_context = context;
 	m_contextChangedConnection = m_context->changedSignal().connect( boost::bind( &SceneGadget::contextChanged, this, ::_2 ) );
+	releaseSceneMirror();
+	m_dirtyFlags = SceneMirror::AllDirty;
 	requestRender();
 }
 
@@ -962,7 +921,7 @@ const Gaffer::Context *SceneGadget::getContext() const
 void SceneGadget::setExpandedPaths( GafferScene::ConstPathMatcherDataPtr expandedPaths )
 {
 	m_expandedPaths = expandedPaths;
-	m_dirtyFlags |= UpdateTask::ExpansionDirty;
+	m_dirtyFlags |= SceneMirror::ExpansionDirty;
 	requestRender();
 }
 
@@ -978,7 +937,7 @@ void SceneGadget::setMinimumExpansionDepth( size_t depth )
 		return;
 	}
 	m_minimumExpansionDepth = depth;
-	m_dirtyFlags |= UpdateTask::ExpansionDirty;
+	m_dirtyFlags |= SceneMirror::ExpansionDirty;
 	requestRender();
 }
 
@@ -1095,23 +1054,23 @@ void SceneGadget::plugDirtied( const Gaffer::Plug *plug )
 {
 	if( plug == m_scene->boundPlug() )
 	{
-		m_dirtyFlags |= UpdateTask::BoundDirty;
+		m_dirtyFlags |= SceneMirror::BoundDirty;
 	}
 	else if( plug == m_scene->transformPlug() )
 	{
-		m_dirtyFlags |= UpdateTask::TransformDirty;
+		m_dirtyFlags |= SceneMirror::TransformDirty;
 	}
 	else if( plug == m_scene->attributesPlug() )
 	{
-		m_dirtyFlags |= UpdateTask::AttributesDirty;
+		m_dirtyFlags |= SceneMirror::AttributesDirty;
 	}
 	else if( plug == m_scene->objectPlug() )
 	{
-		m_dirtyFlags |= UpdateTask::ObjectDirty;
+		m_dirtyFlags |= SceneMirror::ObjectDirty;
 	}
 	else if( plug == m_scene->childNamesPlug() )
 	{
-		m_dirtyFlags |= UpdateTask::ChildNamesDirty;
+		m_dirtyFlags |= SceneMirror::ChildNamesDirty;
 	}
 	else
 	{
@@ -1125,34 +1084,52 @@ void SceneGadget::contextChanged( const IECore::InternedString &name )
 {
 	if( !boost::starts_with( name.string(), "ui:" ) )
 	{
-		m_dirtyFlags = UpdateTask::AllDirty;
+		m_dirtyFlags = SceneMirror::AllDirty;
 		requestRender();
 	}
 }
 
 void SceneGadget::updateSceneGraph() const
 {
-	if( !m_dirtyFlags )
+	if( !m_dirtyFlags || !m_scene )
 	{
 		return;
 	}
 
-	if( !m_sceneGraph->valid() )
+	bool force = false;
+	if( !m_sceneGraph->valid() || !m_sceneMirror )
 	{
-		// The previous attempt at an update failed - so
-		// we need to update everything this time.
-		m_dirtyFlags = UpdateTask::AllDirty;
+		// The previous attempt at an update failed, or we've
+		// not done one yet - so we need to update everything
+		// this time.
+		m_dirtyFlags = SceneMirror::AllDirty;
+		force = true;
 	}
 
 	try
 	{
-		UpdateTask *task = new( tbb::task::allocate_root() ) UpdateTask( this, m_sceneGraph.get(), m_dirtyFlags, ScenePlug::ScenePath() );
-		tbb::task::spawn_root_and_wait( *task );
+		if( !m_sceneMirror )
+		{
+			m_sceneMirror = SceneMirror::acquire( m_scene.get(), m_context.get() );
+		}
+
+		SceneMirror::Mutex::scoped_lock lock( m_sceneMirror->mutex() );
 
-		if( m_dirtyFlags && UpdateTask::ChildNamesDirty )
+		if( m_dirtyFlags & SceneMirror::ExpansionDirty )
 		{
-			m_sceneGraph->applySelection( m_selection->readable() );
+			m_sceneMirror->setExpansion( this, m_expandedPaths, m_minimumExpansionDepth );
 		}
+		m_sceneMirror->dirty( m_dirtyFlags );
+		m_sceneMirror->update();
+
+		SyncTask *task = new( tbb::task::allocate_root() ) SyncTask(
+			m_sceneGraph.get(), m_sceneMirror->root(), m_generation, force,
+			m_expandedPaths->readable(), m_minimumExpansionDepth, ScenePlug::ScenePath()
+		);
+		tbb::task::spawn_root_and_wait( *task );
+		m_generation = m_sceneMirror->generation();
+
+		m_sceneGraph->applySelection( m_selection->readable() );
 	}
 	catch( const std::exception& e )
 	{
@@ -1166,7 +1143,18 @@ void SceneGadget::updateSceneGraph() const
 	// When something is next dirtied we'll turn on all the dirty
 	// flags (see above) to ensure that the next update is a complete
 	// one.
-	m_dirtyFlags = UpdateTask::NothingDirty;
+	m_dirtyFlags = SceneMirror::NothingDirty;
+}
+
+void SceneGadget::releaseSceneMirror()
+{
+	if( m_sceneMirror )
+	{
+		SceneMirror::Mutex::scoped_lock lock( m_sceneMirror->mutex() );
+		m_sceneMirror->removeExpansion( this );
+	}
+	m_sceneMirror = NULL;
+	m_generation = 0;
 }
 
 void SceneGadget::renderSceneGraph( const IECoreGL::State *stateToBind ) const
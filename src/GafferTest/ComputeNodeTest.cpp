@@ -39,6 +39,8 @@
 
 #include "IECore/Timer.h"
 
+#include "Gaffer/Context.h"
+
 #include "GafferTest/Assert.h"
 #include "GafferTest/MultiplyNode.h"
 #include "GafferTest/ComputeNodeTest.h"
@@ -103,8 +105,65 @@ struct Compute
 
 };
 
+struct ChainHash
+{
+
+	ChainHash( size_t chainLength, size_t numContexts )
+		:	m_numContexts( numContexts )
+	{
+		GafferTest::MultiplyNodePtr previous;
+		for( size_t i = 0; i < chainLength; ++i )
+		{
+			GafferTest::MultiplyNodePtr node = new GafferTest::MultiplyNode;
+			if( previous )
+			{
+				node->op1Plug()->setInput( previous->productPlug() );
+			}
+			else
+			{
+				node->op1Plug()->setValue( 1 );
+			}
+			node->op2Plug()->setValue( 1 );
+			m_nodes.push_back( node );
+			previous = node;
+		}
+	}
+
+	void operator()( const blocked_range<size_t> &r ) const
+	{
+		Gaffer::ContextPtr context = new Gaffer::Context;
+		for( size_t i=r.begin(); i!=r.end(); ++i )
+		{
+			// Many threads share each context, so will all be
+			// asking for the same hashes along the chain.
+			context->setFrame( i % m_numContexts );
+			Gaffer::Context::Scope scope( context.get() );
+			m_nodes.back()->productPlug()->hash();
+		}
+	}
+
+	private :
+
+		std::vector<GafferTest::MultiplyNodePtr> m_nodes;
+		size_t m_numContexts;
+
+};
+
 } // namespace
 
+void GafferTest::testComputeNodeChainHashThreading()
+{
+	// Hash a long chain of nodes from many threads at once,
+	// in a small number of distinct contexts. This is a good
+	// benchmark for the sharing of hash cache entries between
+	// threads.
+	ChainHash c( 100, 10 );
+	IECore::Timer t;
+	parallel_for( blocked_range<size_t>( 0, 100000 ), c );
+	// Uncomment for timing information.
+	//std::cerr << t.stop() << std::endl;
+}
+
 void GafferTest::testComputeNodeThreading()
 {
 	// Set up an asynchronous task to be creating and
@@ -67,5 +67,6 @@ BOOST_PYTHON_MODULE( _GafferTest )
 	def( "testManySubstitutions", &testManySubstitutions );
 	def( "testManyEnvironmentSubstitutions", &testManyEnvironmentSubstitutions );
 	def( "testComputeNodeThreading", &testComputeNodeThreading );
+	def( "testComputeNodeChainHashThreading", &testComputeNodeChainHashThreading );
 
 }
@@ -142,11 +142,34 @@ struct KeySlotCaller
 	}
 };
 
+// The UI thread functions are C++, and may need to wait for work on
+// other threads which itself needs the GIL, so we release it while
+// they run.
+struct GILReleaseUIThreadFunction
+{
+
+	GILReleaseUIThreadFunction( Gadget::UIThreadFunction function )
+		:	m_function( function )
+	{
+	}
+
+	void operator()() const
+	{
+		IECorePython::ScopedGILRelease gilRelease;
+		m_function();
+	}
+
+	private :
+
+		Gadget::UIThreadFunction m_function;
+
+};
+
 struct ExecuteOnUIThreadSlotCaller
 {
 	boost::signals::detail::unusable operator()( boost::python::object slot, Gadget::UIThreadFunction function )
 	{
-		object pythonFunction = make_function( function, default_call_policies(), boost::mpl::vector<void>() );
+		object pythonFunction = make_function( GILReleaseUIThreadFunction( function ), default_call_policies(), boost::mpl::vector<void>() );
 		try
 		{
 			slot( pythonFunction );